@@ -0,0 +1,884 @@
+/*
+  cpu15.h（CPU_emulator.c の CPU コア部分 / 命令セット・状態・1命令実行）
+
+  【このヘッダの位置づけ】
+  - もともと CPU_emulator.c の main() の中にあった Fetch → Decode → Execute の1ステップを、
+    他のツール（フォールト注入・ファジングなど）からも使えるように切り出したもの。
+  - CPU の状態はすべて struct cpu15 にまとめてある。
+    グローバル変数を使わないので、状態のコピー（スナップショット）や
+    複数の CPU を同時に動かすことが memcpy 1回でできる。
+  - 関数はすべて static inline にしてあり、.c 側で #include するだけで使える
+    （リンクする .c ファイルを増やさずに済む）。
+
+  命令フォーマット（16bit）：
+     [15:11] opcode (5bit)
+     [10:8]  regA  (3bit)  ※命令によっては使わない
+     [7:5]   regB  (3bit)  ※命令によっては使わない
+     [7:0]   imm/addr (8bit) ※LDL/LDH/ADDI/JE/JMP/JCC/LD/STなど
+     [4:2]   regC  (3bit)  ※MCPY/MSET の語数レジスタだけ
+
+  JCC（条件分岐）だけは [10:8] を regA ではなく条件コード（CC_EQ..CC_AE）として使う。
+  CALL/RET/PUSH/POP は RAM の 63 番地から下へ伸びるスタック（sp）を使う。
+  LDR/STR は regB の下位8bitをアドレスにし、[0] が 1 なら regB を +1 する（ポストインクリメント）。
+  SWAP も regB の下位8bitをアドレスにし、regA と ram[regB] を入れ替える（ロックを作るための不可分な命令）。
+*/
+
+#ifndef CPU15_H
+#define CPU15_H
+
+#include <stdint.h>
+
+/* --- 命令オペコード定義（上位ビットに格納される） ---
+   番号は RTL 側の chapter06/cpu15_isa.vhd（OP_MOV .. OP_SWAP）と同じ。どちらかを変えたら両方直す。 */
+#define MOV      0
+#define ADD      1
+#define SUB      2
+#define AND      3
+#define OR       4
+#define SL       5
+#define SR       6
+#define SRA      7
+#define LDL      8
+#define LDH      9
+#define CMP     10
+#define JE      11
+#define JMP     12
+#define LD      13
+#define ST      14
+#define HLT     15
+#define JCC     16      // 条件分岐（条件は [10:8]、分岐先は [7:0]）
+#define ADDI    17      // regA = regA + 符号拡張(imm8)。フラグは結果を 0 と比べた値になる
+#define CALL    18      // 戻り番地を積んで [7:0] へ分岐
+#define RET     19      // スタックから戻り番地を取り出して分岐
+#define PUSH    20      // regA を積む
+#define POP     21      // 取り出して regA へ
+#define LDR     22      // regA = ram[regB]     （[0]=1 なら続けて regB++）
+#define STR     23      // ram[regB] = regA     （[0]=1 なら続けて regB++）
+#define MUL     24      // regA = regA * regB の下位16bit
+#define MULHU   25      // regA = regA * regB の上位16bit（符号なし）
+#define DIVU    26      // regA = regA / regB  （符号なし。regB = 0 なら 0xffff）
+#define MODU    27      // regA = regA % regB  （符号なし。regB = 0 なら regA のまま）
+#define MCPY    28      // ram[regA..] = ram[regB..] を regC 語（regC の下位8bit）
+#define MSET    29      // ram[regA..] = regB        を regC 語
+#define SWAP    30      // regA と ram[regB] を入れ替える（不可分。regB の下位8bit が番地）
+#define NUM_OPS 31      // 定義済みの命令数（5bit のうち 31 は空き）
+
+/* --- JCC の条件コード（直前の CMP regA, regB の結果で判定する） --- */
+#define CC_EQ    0      // regA == regB            （Z）
+#define CC_NE    1      // regA != regB            （!Z）
+#define CC_LT    2      // regA <  regB  符号付き   （S != V）
+#define CC_GE    3      // regA >= regB  符号付き   （S == V）
+#define CC_LE    4      // regA <= regB  符号付き   （Z || S != V）
+#define CC_GT    5      // regA >  regB  符号付き   （!Z && S == V）
+#define CC_B     6      // regA <  regB  符号なし   （C：借り）
+#define CC_AE    7      // regA >= regB  符号なし   （!C）
+
+/* --- レジスタ番号（0〜7） --- */
+#define REG0 0
+#define REG1 1
+#define REG2 2
+#define REG3 3
+#define REG4 4
+#define REG5 5
+#define REG6 6
+#define REG7 7
+
+/* --- CPU状態 ---
+   - pc     : Program Counter（8bit。RTL の P_COUNT と同じく 0..255 で折り返す）
+   - ir     : 直前に取り出した命令語
+   - flag_a, flag_b : 直前の CMP の被演算子（regA, regB の値）。
+              フラグ（Z/C/S/V）はここには持たず、JE/JCC が読むときに
+              regA と regB を比べ直して求める（遅延評価。下の cpu15_cond()）。
+   - sp     : スタックポインタ。積むときは先に sp-1、取り出すときは読んでから sp+1
+              （RTL の exec.vhd の SP と同じ。リセット値 STACK_TOP なので最初に積むのは 63 番地）
+   - reg    : 汎用レジスタ8本（16bit）
+   - ram    : データメモリ（RAM_WORDS 語。64番地は出力ポート相当）
+   - rom    : 命令メモリ（256語）
+   - dirty  : ST で書き込まれた RAM ワードのビットマップ（1bit/ワード）。
+              cpu15_restore() はここに立っているワードだけをスナップショットから書き戻す。
+   - io65   : 65番地（RTL の IO65_IN）から読む入力列。
+              LD で65番地を読むたびに次の値を返し、使い切ったら 0 を返す。NULL なら常に 0（IO65_IN = 0）。
+              65番地は読み出し専用の入力で、ST で書いても LD では見えない（RTL の data_ram と同じ）。
+   - shared, shared_mark : mcore.c のようにコアごとに RAM の私有コピー（ram[]）を持つときだけ設定する。
+              SWAP は ram[] ではなく共有 RAM shared[] をホストの不可分命令（__atomic_exchange_n）で入れ替え、
+              入れ替えた語を shared_mark（ビットマップ）に印を付ける（他のコアの私有コピーへの反映用）。
+              その語に自分の未反映の書き込み（dirty）があれば、それを読んだことにして shared[] へ書く。
+              NULL なら ram[] で入れ替える。
+   - core_info : マルチコア（mcore.c / chapter09 の cpu15_multi）のときだけ設定する。
+              LD/LDR で 66 番地を読むと core_info[0]（自分のコア番号）、67 番地を読むと
+              core_info[1]（コア数）を返す。NULL なら 66/67 番地も普通の RAM として読む。
+*/
+#define IO65_ADDR 65
+#define CORE_ID_ADDR 66             // コア番号（読み出し専用。書いた値は RAM に入るが LD では見えない）
+#define NCORES_ADDR  67             // コア数（同上）
+#define RAM_WORDS 256               // 64 の倍数であること（dirty を 64bit 単位で持つため）
+#define STACK_TOP 64                // chapter09 と同じく 63 番地から下へ（64/65 は I/O）
+
+struct cpu15 {
+    short pc;
+    short ir;
+    short flag_a, flag_b;
+    short sp;
+    short reg[8];
+    short ram[RAM_WORDS];
+    short rom[256];
+    const short *io65;
+    int io65_len, io65_pos;
+    const short *core_info;
+    short *shared;
+    uint64_t *shared_mark;
+    uint64_t dirty[RAM_WORDS / 64];
+};
+
+/* --- デコーダ（命令語からフィールドを取り出す） --- */
+static inline short op_code(short ir) { return (ir >> 11) & 0x001f; }   // 上位5bit
+static inline short op_regA(short ir) { return (ir >> 8) & 0x0007; }    // [10:8]
+static inline short op_regB(short ir) { return (ir >> 5) & 0x0007; }    // [7:5]
+static inline short op_regC(short ir) { return (ir >> 2) & 0x0007; }    // [4:2]
+static inline short op_data(short ir) { return ir & 0x00ff; }           // 下位8bit（即値）
+static inline short op_addr(short ir) { return ir & 0x00ff; }           // 下位8bit（アドレス）
+
+/* --- エンコーダ（アセンブラのコア：ニーモニック → 16bit 命令語） --- */
+static inline short mov(short ra, short rb) { return ((MOV << 11) | (ra << 8) | (rb << 5)); }
+static inline short add(short ra, short rb) { return ((ADD << 11) | (ra << 8) | (rb << 5)); }
+static inline short sub(short ra, short rb) { return ((SUB << 11) | (ra << 8) | (rb << 5)); }
+static inline short and(short ra, short rb) { return ((AND << 11) | (ra << 8) | (rb << 5)); }
+static inline short or (short ra, short rb) { return ((OR  << 11) | (ra << 8) | (rb << 5)); }
+static inline short sl(short ra)            { return ((SL  << 11) | (ra << 8)); }
+static inline short sr(short ra)            { return ((SR  << 11) | (ra << 8)); }
+static inline short sra(short ra)           { return ((SRA << 11) | (ra << 8)); }
+static inline short ldl(short ra, short ival) { return ((LDL << 11) | (ra << 8) | (ival & 0x00ff)); }
+static inline short ldh(short ra, short ival) { return ((LDH << 11) | (ra << 8) | (ival & 0x00ff)); }
+static inline short cmp(short ra, short rb) { return ((CMP << 11) | (ra << 8) | (rb << 5)); }
+static inline short je(short addr)          { return ((JE  << 11) | (addr & 0x00ff)); }
+static inline short jmp(short addr)         { return ((JMP << 11) | (addr & 0x00ff)); }
+static inline short ld(short ra, short addr){ return ((LD  << 11) | (ra << 8) | (addr & 0x00ff)); }
+static inline short st(short ra, short addr){ return ((ST  << 11) | (ra << 8) | (addr & 0x00ff)); }
+static inline short hlt(void)               { return (HLT << 11); }
+static inline short jcc(short cc, short addr){ return ((JCC << 11) | ((cc & 7) << 8) | (addr & 0x00ff)); }
+static inline short addi(short ra, short imm){ return ((ADDI << 11) | (ra << 8) | (imm & 0x00ff)); }
+static inline short call(short addr)        { return ((CALL << 11) | (addr & 0x00ff)); }
+static inline short ret(void)               { return (RET << 11); }
+static inline short push(short ra)          { return ((PUSH << 11) | (ra << 8)); }
+static inline short pop(short ra)           { return ((POP  << 11) | (ra << 8)); }
+static inline short ldr(short ra, short rb) { return ((LDR << 11) | (ra << 8) | (rb << 5)); }      // ld ra, [rb]
+static inline short str(short ra, short rb) { return ((STR << 11) | (ra << 8) | (rb << 5)); }      // st ra, [rb]
+static inline short ldr_inc(short ra, short rb) { return ldr(ra, rb) | 1; }                          // ld ra, [rb]+
+static inline short str_inc(short ra, short rb) { return str(ra, rb) | 1; }                          // st ra, [rb]+
+static inline short mul(short ra, short rb)   { return ((MUL   << 11) | (ra << 8) | (rb << 5)); }
+static inline short mulhu(short ra, short rb) { return ((MULHU << 11) | (ra << 8) | (rb << 5)); }
+static inline short divu(short ra, short rb)  { return ((DIVU  << 11) | (ra << 8) | (rb << 5)); }
+static inline short modu(short ra, short rb)  { return ((MODU  << 11) | (ra << 8) | (rb << 5)); }
+static inline short mcpy(short rd, short rs, short rn) { return ((MCPY << 11) | (rd << 8) | (rs << 5) | (rn << 2)); }
+static inline short mset(short rd, short rv, short rn) { return ((MSET << 11) | (rd << 8) | (rv << 5) | (rn << 2)); }
+static inline short swap(short ra, short rb)  { return ((SWAP  << 11) | (ra << 8) | (rb << 5)); }      // swap ra, [rb]
+
+/* 別名（専用のオペコードは持たない） */
+static inline short inc(short ra)           { return addi(ra, 1); }
+static inline short dec(short ra)           { return addi(ra, -1); }
+static inline short jne(short addr)         { return jcc(CC_NE, addr); }
+static inline short bne(short addr)         { return jcc(CC_NE, addr); }
+
+/*
+  --- フラグ（遅延評価） ---
+  CMP は被演算子を2つ保存するだけで、フラグを1つも計算しない。
+  分岐命令が条件を調べるときに、regA と regB を比べ直して求める
+  （ループの大半を占める ADD/SUB/CMP の実行コストを増やさないため）。
+  RTL（exec.vhd）の Z/C/S/V との対応は次のとおりで、どれも被演算子どうしの比較 1回で済む。
+    Z          : regA == regB
+    C          : regA < regB（符号なし。減算で借りが出る）
+    S xor V    : regA < regB（符号付き。S は差の最上位ビット、V は符号付きの減算のあふれ）
+*/
+static inline int cpu15_flag_z(const struct cpu15 *c) { return c->flag_a == c->flag_b; }
+
+/* 条件コードの判定（EQ/NE は Z、LT..GT は S xor V と Z、B/AE は C を比較に置き換えたもの） */
+static inline int cpu15_cond(const struct cpu15 *c, int cc) {
+    switch (cc & 7) {
+        case CC_EQ: return c->flag_a == c->flag_b;
+        case CC_NE: return c->flag_a != c->flag_b;
+        case CC_LT: return c->flag_a <  c->flag_b;
+        case CC_GE: return c->flag_a >= c->flag_b;
+        case CC_LE: return c->flag_a <= c->flag_b;
+        case CC_GT: return c->flag_a >  c->flag_b;
+        case CC_B:  return (uint16_t)c->flag_a <  (uint16_t)c->flag_b;
+        default:    return (uint16_t)c->flag_a >= (uint16_t)c->flag_b;
+    }
+}
+
+/*
+  リセット：ROM 以外をすべて 0 にする（PC=0 から実行開始）
+  ただしフラグは「1 と 0 を比べた」状態にしておく。
+  RTL（exec.vhd）はリセットで Z/C/S/V をすべて 0 にするので、最初の CMP より前の
+  JE/JCC は EQ/LT/LE/B が不成立、NE/GE/GT/AE が成立になる。1 - 0 はちょうどこの組（Z=C=S=V=0）。
+  0 と 0 だと Z=1、0 と 1 だと C=S=1 になり、RTL と分岐が食い違う。
+*/
+static inline void cpu15_reset(struct cpu15 *c) {
+    c->pc = 0;
+    c->ir = 0;
+    c->flag_a = 1;
+    c->flag_b = 0;
+    c->sp = STACK_TOP;
+    c->io65_pos = 0;
+    for (int i = 0; i < 8; i++) c->reg[i] = 0;
+    for (int i = 0; i < RAM_WORDS; i++) c->ram[i] = 0;
+    for (int i = 0; i < RAM_WORDS / 64; i++) c->dirty[i] = 0;
+}
+
+/* RAM を ST 以外（テストベンチ・故障注入など）で書き換えたときに呼ぶ */
+static inline void cpu15_mark_dirty(struct cpu15 *c, int addr) {
+    c->dirty[addr >> 6] |= 1ull << (addr & 63);
+}
+
+/*
+  スナップショット snap の状態に戻す（ROM と io65 の入力列そのものは触らない）。
+  - レジスタ・PC・フラグは数ワードなのでそのままコピーする。
+  - RAM は dirty の立っているワードだけを書き戻す。
+    RAM_WORDS を大きくしても、コストは「前回から書かれたワード数」にしか比例しない。
+  - c->ram は snap->ram から dirty の分だけずれている、という前提で使うこと
+    （最初に c を snap から丸ごとコピーし、以後は同じ snap に戻すだけにする）。
+*/
+static inline void cpu15_restore(struct cpu15 *c, const struct cpu15 *snap) {
+    for (int i = 0; i < RAM_WORDS / 64; i++) {
+        uint64_t m = c->dirty[i];
+        while (m) {
+            int a = i * 64 + __builtin_ctzll(m);
+            c->ram[a] = snap->ram[a];
+            m &= m - 1;
+        }
+        c->dirty[i] = 0;
+    }
+    c->pc = snap->pc;
+    c->ir = snap->ir;
+    c->flag_a = snap->flag_a;
+    c->flag_b = snap->flag_b;
+    c->sp = snap->sp;
+    c->io65_pos = snap->io65_pos;
+    for (int i = 0; i < 8; i++) c->reg[i] = snap->reg[i];
+}
+
+/* LD/LDR の読み出し：65番地は io65 の入力列（なければ 0）、66/67 番地は core_info（設定されていれば）、それ以外は RAM */
+static inline short cpu15_load(struct cpu15 *c, int addr) {
+    if (addr == IO65_ADDR)
+        return c->io65 != NULL && c->io65_pos < c->io65_len ? c->io65[c->io65_pos++] : 0;
+    if ((addr == CORE_ID_ADDR || addr == NCORES_ADDR) && c->core_info != NULL)
+        return c->core_info[addr - CORE_ID_ADDR];
+    return c->ram[addr];
+}
+
+/*
+  MCPY/MSET の本体：n 語を dst へ（fill なら v で埋め、そうでなければ src から）。
+  - 番地は 8bit で折り返す。RTL と同じく前から1語ずつ動かした結果になるようにする。
+  - 重ならない・折り返さないコピーと MSET は1回の memcpy/ループで済ませる（ここが速い経路）。
+    dst が src より後ろで重なっているときだけ、1語ずつ（先頭の語が繰り返される）にする。
+  - dirty は書いた範囲にまとめて立てる。
+*/
+static inline void cpu15_block(struct cpu15 *c, int dst, int src, short v, int n, int fill) {
+    int i;
+
+    if (n == 0) return;
+    if (fill) {
+        if (dst + n <= 256) {
+            short *p = &c->ram[dst];
+            for (i = 0; i < n; i++) p[i] = v;
+        } else {
+            for (i = 0; i < n; i++) c->ram[(dst + i) & 0xff] = v;
+        }
+    } else if (dst + n <= 256 && src + n <= 256 && (dst <= src || dst >= src + n)) {
+        __builtin_memmove(&c->ram[dst], &c->ram[src], (size_t)n * sizeof(short));
+    } else {
+        for (i = 0; i < n; i++) c->ram[(dst + i) & 0xff] = c->ram[(src + i) & 0xff];
+    }
+    for (i = 0; i < n; i++) cpu15_mark_dirty(c, (dst + i) & 0xff);
+}
+
+/*
+  1命令を実行し、実行した命令の opcode を返す（HLT なら呼び出し側で止める）。
+  - Fetch : ir = rom[pc]
+  - PC++  : 分岐命令が成立したら後で上書きする
+  - Decode + Execute : switch で命令ディスパッチ
+  - 未定義命令は NOP として扱う。
+*/
+static inline int cpu15_step(struct cpu15 *c) {
+    short ir = c->rom[c->pc];
+    short *reg = c->reg;
+
+    c->ir = ir;
+    c->pc = (c->pc + 1) & 0x00ff;
+
+    switch (op_code(ir)) {
+        /* MOV: regA = regB（レジスタ間転送） */
+        case MOV: reg[op_regA(ir)] = reg[op_regB(ir)]; break;
+
+        /* ADD/SUB/AND/OR: regA = regA op regB（ALU） */
+        case ADD: reg[op_regA(ir)] = reg[op_regA(ir)] + reg[op_regB(ir)]; break;
+        case SUB: reg[op_regA(ir)] = reg[op_regA(ir)] - reg[op_regB(ir)]; break;
+        case AND: reg[op_regA(ir)] = reg[op_regA(ir)] & reg[op_regB(ir)]; break;
+        case OR:  reg[op_regA(ir)] = reg[op_regA(ir)] | reg[op_regB(ir)]; break;
+
+        /* SL/SR/SRA: 1bitシフト
+           - SR は short の >> なので、処理系によっては算術右シフトになる点に注意。
+           - SRA は元の最上位ビットを OR で残す教材向けの実装。 */
+        case SL:  reg[op_regA(ir)] = reg[op_regA(ir)] << 1; break;
+        case SR:  reg[op_regA(ir)] = reg[op_regA(ir)] >> 1; break;
+        case SRA: reg[op_regA(ir)] = (reg[op_regA(ir)] & 0x8000) | (reg[op_regA(ir)] >> 1); break;
+
+        /* LDL/LDH: 下位/上位8bitに即値をロード（2命令で16bit定数を作る） */
+        case LDL: reg[op_regA(ir)] = (reg[op_regA(ir)] & 0xff00) | (op_data(ir) & 0x00ff); break;
+        case LDH: reg[op_regA(ir)] = (op_data(ir) << 8) | (reg[op_regA(ir)] & 0x00ff); break;
+
+        /* CMP: 被演算子を保存するだけ（フラグは分岐が読むときに計算する） */
+        case CMP: c->flag_a = reg[op_regA(ir)]; c->flag_b = reg[op_regB(ir)]; break;
+
+        /* JE/JMP/JCC: 分岐。pc++ 済みの PC を分岐先で上書きする（JE は JCC の CC_EQ と同じ） */
+        case JE:  if (cpu15_flag_z(c)) c->pc = op_addr(ir); break;
+        case JMP: c->pc = op_addr(ir); break;
+        case JCC: if (cpu15_cond(c, op_regA(ir))) c->pc = op_addr(ir); break;
+
+        /* ADDI: 即値は符号付き8bit（INC/DEC は ±1）。
+           フラグは「結果と 0 を CMP した」状態にする（DEC → BNE でループを閉じられる）。 */
+        case ADDI:
+            reg[op_regA(ir)] = reg[op_regA(ir)] + (signed char)op_data(ir);
+            c->flag_a = reg[op_regA(ir)];
+            c->flag_b = 0;
+            break;
+
+        /* LD/ST: データメモリとの転送（64番地は I/O ポート相当） */
+        case LD:
+            reg[op_regA(ir)] = cpu15_load(c, op_addr(ir));
+            break;
+        case ST:
+            c->ram[op_addr(ir)] = reg[op_regA(ir)];
+            cpu15_mark_dirty(c, op_addr(ir));
+            break;
+
+        /* LDR/STR: アドレスは regB の下位8bit。
+           ポストインクリメントは先に regB++ しておき、LDR で regA == regB のときは
+           ロードした値が残るようにする（RTL の cpu15.vhd の書き込みポート選択と同じ優先順位）。 */
+        case LDR: {
+            int a = reg[op_regB(ir)] & 0x00ff;
+            if (ir & 1) reg[op_regB(ir)]++;
+            reg[op_regA(ir)] = cpu15_load(c, a);
+            break;
+        }
+        case STR: {
+            int a = reg[op_regB(ir)] & 0x00ff;
+            c->ram[a] = reg[op_regA(ir)];
+            cpu15_mark_dirty(c, a);
+            if (ir & 1) reg[op_regB(ir)]++;
+            break;
+        }
+
+        /* CALL/PUSH: 先に sp-1 してから書く。CALL が積むのは pc++ 済みの PC（= 戻り番地） */
+        case CALL:
+            c->sp = (c->sp - 1) & 0x00ff;
+            c->ram[c->sp] = c->pc;
+            cpu15_mark_dirty(c, c->sp);
+            c->pc = op_addr(ir);
+            break;
+        case PUSH:
+            c->sp = (c->sp - 1) & 0x00ff;
+            c->ram[c->sp] = reg[op_regA(ir)];
+            cpu15_mark_dirty(c, c->sp);
+            break;
+
+        /* RET/POP: 読んでから sp+1。RET は RTL と同じく下位8bitだけを PC にする */
+        case RET:
+            c->pc = c->ram[c->sp] & 0x00ff;
+            c->sp = (c->sp + 1) & 0x00ff;
+            break;
+        case POP:
+            reg[op_regA(ir)] = c->ram[c->sp];
+            c->sp = (c->sp + 1) & 0x00ff;
+            break;
+
+        /* MUL/MULHU/DIVU/MODU: 16bit を符号なしとして扱う。
+           0 除算は例外にせず、RTL の引き戻し法と同じ値（商 0xffff、余り = 被除数）にする。 */
+        case MUL:
+            reg[op_regA(ir)] = (short)((uint32_t)(uint16_t)reg[op_regA(ir)] * (uint16_t)reg[op_regB(ir)]);
+            break;
+        case MULHU:
+            reg[op_regA(ir)] = (short)(((uint32_t)(uint16_t)reg[op_regA(ir)] * (uint16_t)reg[op_regB(ir)]) >> 16);
+            break;
+        case DIVU:
+            if (reg[op_regB(ir)] == 0) reg[op_regA(ir)] = (short)0xffff;
+            else reg[op_regA(ir)] = (short)((uint16_t)reg[op_regA(ir)] / (uint16_t)reg[op_regB(ir)]);
+            break;
+        case MODU:
+            if (reg[op_regB(ir)] != 0)
+                reg[op_regA(ir)] = (short)((uint16_t)reg[op_regA(ir)] % (uint16_t)reg[op_regB(ir)]);
+            break;
+
+        /* MCPY/MSET: 語数は regC の下位8bit。レジスタは変えない */
+        case MCPY:
+        case MSET:
+            cpu15_block(c, reg[op_regA(ir)] & 0x00ff, reg[op_regB(ir)] & 0x00ff, reg[op_regB(ir)],
+                        reg[op_regC(ir)] & 0x00ff, op_code(ir) == MSET);
+            break;
+
+        /* SWAP: ra = ram[rb] と ram[rb] = ra を1命令で（RTL は DC で読み WB で書く）。
+           64〜67 番地も I/O としては扱わず、RAM の語として入れ替える。
+           共有 RAM があれば、他のスレッドのコアと取り合ってもどちらか一方が先になるように
+           ホストの不可分な交換で行う（mcore.c）。 */
+        case SWAP: {
+            int a = reg[op_regB(ir)] & 0x00ff;
+            short v = reg[op_regA(ir)];
+            if (c->shared == NULL) {
+                reg[op_regA(ir)] = c->ram[a];
+                cpu15_mark_dirty(c, a);
+            } else if ((c->dirty[a >> 6] >> (a & 63)) & 1) {
+                /* 自分の書き込みがまだ shared[] にない：それを読んだことにして上書きする */
+                reg[op_regA(ir)] = c->ram[a];
+                __atomic_store_n(&c->shared[a], v, __ATOMIC_SEQ_CST);
+                c->dirty[a >> 6] &= ~(1ull << (a & 63));
+                __atomic_fetch_or(&c->shared_mark[a >> 6], 1ull << (a & 63), __ATOMIC_RELAXED);
+            } else {
+                reg[op_regA(ir)] = __atomic_exchange_n(&c->shared[a], v, __ATOMIC_SEQ_CST);
+                __atomic_fetch_or(&c->shared_mark[a >> 6], 1ull << (a & 63), __ATOMIC_RELAXED);
+            }
+            c->ram[a] = v;
+            break;
+        }
+
+        /* 未定義命令（HLT を含む）は何もしない */
+        default:  break;
+    }
+    return op_code(ir);
+}
+
+/*
+  サンプルプログラム：1+2+...+10 = 55 を計算して ram[64] に書く。
+    REG0 = 0, REG1 = 1, REG2 = 0, REG3 = 10
+  ループ(PC=8):
+    REG2 = REG2 + REG1     // 1ずつ増える → 1..10
+    REG0 = REG0 + REG2     // 総和を蓄積
+    ram[64] = REG0         // “I/O”へ書き込み
+    if (REG2 == REG3) goto 14
+    goto 8
+  14: HLT
+*/
+static inline void cpu15_load_sum(short *rom) {
+    rom[0]  = ldh(REG0, 0);
+    rom[1]  = ldl(REG0, 0);
+    rom[2]  = ldh(REG1, 0);
+    rom[3]  = ldl(REG1, 1);
+    rom[4]  = ldh(REG2, 0);
+    rom[5]  = ldl(REG2, 0);
+    rom[6]  = ldh(REG3, 0);
+    rom[7]  = ldl(REG3, 10);
+    rom[8]  = add(REG2, REG1);
+    rom[9]  = add(REG0, REG2);
+    rom[10] = st(REG0, 64);
+    rom[11] = cmp(REG2, REG3);
+    rom[12] = je(14);
+    rom[13] = jmp(8);
+    rom[14] = hlt();
+}
+
+/*
+  同じ総和を ADDI/BNE で書いたもの：ループ1周が 6命令 → 3命令になる。
+    REG0 = 0, REG3 = 10
+  ループ(PC=4):
+    REG0 = REG0 + REG3     // 10, 9, ..., 1 を足す
+    REG3 = REG3 - 1        // DEC（結果が 0 になると Z=1）
+    if (REG3 != 0) goto 4  // BNE
+  ram[64] = REG0; HLT
+*/
+static inline void cpu15_load_sum_addi(short *rom) {
+    rom[0] = ldh(REG0, 0);
+    rom[1] = ldl(REG0, 0);
+    rom[2] = ldh(REG3, 0);
+    rom[3] = ldl(REG3, 10);
+    rom[4] = add(REG0, REG3);
+    rom[5] = dec(REG3);
+    rom[6] = bne(4);
+    rom[7] = st(REG0, 64);
+    rom[8] = hlt();
+}
+
+/*
+  同じ総和をサブルーチンで書いたもの（CALL/RET/PUSH/POP の例）。
+    REG0 = 0, REG3 = 10
+  ループ(PC=4):
+    CALL 9                 // REG0 += REG3（REG3 は PUSH/POP で退避する）
+    DEC REG3
+    BNE 4
+  ram[64] = REG0; HLT
+  9: PUSH REG3; ADD REG0, REG3; LDL REG3, 0; POP REG3; RET
+     （LDL REG3, 0 は REG3 を壊して、POP で戻ることを確かめるためのもの）
+*/
+static inline void cpu15_load_sum_call(short *rom) {
+    rom[0]  = ldh(REG0, 0);
+    rom[1]  = ldl(REG0, 0);
+    rom[2]  = ldh(REG3, 0);
+    rom[3]  = ldl(REG3, 10);
+    rom[4]  = call(9);
+    rom[5]  = dec(REG3);
+    rom[6]  = bne(4);
+    rom[7]  = st(REG0, 64);
+    rom[8]  = hlt();
+    rom[9]  = push(REG3);
+    rom[10] = add(REG0, REG3);
+    rom[11] = ldl(REG3, 0);
+    rom[12] = pop(REG3);
+    rom[13] = ret();
+}
+
+/*
+  レジスタ間接（LDR/STR）の例：ram[0..9] に 1..10 を並べてから、配列を先頭から足す。
+    REG1 = 0（書き込みポインタ）, REG2 = 1（値）, REG3 = 10（残り個数）
+  ループ1(PC=6): st REG2, [REG1]+; inc REG2; dec REG3; bne 6
+    REG1 = 0（読み出しポインタ）, REG3 = 10
+  ループ2(PC=12): ld REG2, [REG1]+; add REG0, REG2; dec REG3; bne 12
+  ram[64] = REG0; HLT
+  どちらのループも命令の書き換えや展開をせずに、ポインタを1命令で進められる。
+*/
+static inline void cpu15_load_sum_ind(short *rom) {
+    rom[0]  = ldh(REG0, 0);
+    rom[1]  = ldl(REG0, 0);
+    rom[2]  = ldl(REG1, 0);
+    rom[3]  = ldl(REG2, 1);
+    rom[4]  = ldh(REG3, 0);
+    rom[5]  = ldl(REG3, 10);
+    rom[6]  = str_inc(REG2, REG1);
+    rom[7]  = inc(REG2);
+    rom[8]  = dec(REG3);
+    rom[9]  = bne(6);
+    rom[10] = ldl(REG1, 0);
+    rom[11] = ldl(REG3, 10);
+    rom[12] = ldr_inc(REG2, REG1);
+    rom[13] = add(REG0, REG2);
+    rom[14] = dec(REG3);
+    rom[15] = bne(12);
+    rom[16] = st(REG0, 64);
+    rom[17] = hlt();
+}
+
+/*
+  乗除算の例：1^2 + 2^2 + ... + 10^2 = 385 を MUL で求め、DIVU で 7 で割って 55 にする。
+    REG0 = 0, REG2 = 7, REG3 = 10
+  ループ(PC=6): REG1 = REG3; REG1 = REG1 * REG3; REG0 += REG1; dec REG3; bne 6
+  REG0 = REG0 / REG2; ram[64] = REG0; HLT
+  SL/ADD/CMP/JE で掛け算をすると1回の積に数十命令かかるところが、1命令で済む。
+*/
+static inline void cpu15_load_sum_mul(short *rom) {
+    rom[0]  = ldh(REG0, 0);
+    rom[1]  = ldl(REG0, 0);
+    rom[2]  = ldh(REG2, 0);
+    rom[3]  = ldl(REG2, 7);
+    rom[4]  = ldh(REG3, 0);
+    rom[5]  = ldl(REG3, 10);
+    rom[6]  = mov(REG1, REG3);
+    rom[7]  = mul(REG1, REG3);
+    rom[8]  = add(REG0, REG1);
+    rom[9]  = dec(REG3);
+    rom[10] = bne(6);
+    rom[11] = divu(REG0, REG2);
+    rom[12] = st(REG0, 64);
+    rom[13] = hlt();
+}
+
+/*
+  ブロック転送の例：ram[0..9] を MSET で 0 にし、1..10 を並べてから MCPY で ram[16..25] へ写し、
+  写した側を LDR で足す（LD/ST のループで初期化・コピーするより命令数が大きく減る）。
+    REG1 = 0, REG4 = 0, REG5 = 10
+    MSET [REG1], REG4, REG5           // ram[0..9] = 0
+  ループ1(PC=6): st REG2, [REG1]+; inc REG2; dec REG3; bne 6    （REG2 = 1..10, REG3 = 10）
+    REG1 = 0, REG6 = 16
+    MCPY [REG6], [REG1], REG5          // ram[16..25] = ram[0..9]
+  ループ2(PC=13): ld REG2, [REG6]+; add REG0, REG2; dec REG5; bne 13
+  ram[64] = REG0; HLT
+*/
+static inline void cpu15_load_sum_blk(short *rom) {
+    rom[0]  = ldl(REG5, 10);
+    rom[1]  = mset(REG1, REG4, REG5);
+    rom[2]  = ldl(REG2, 1);
+    rom[3]  = ldl(REG3, 10);
+    rom[4]  = ldh(REG0, 0);
+    rom[5]  = ldl(REG0, 0);
+    rom[6]  = str_inc(REG2, REG1);
+    rom[7]  = inc(REG2);
+    rom[8]  = dec(REG3);
+    rom[9]  = bne(6);
+    rom[10] = ldl(REG1, 0);
+    rom[11] = ldl(REG6, 16);
+    rom[12] = mcpy(REG6, REG1, REG5);
+    rom[13] = ldr_inc(REG2, REG6);
+    rom[14] = add(REG0, REG2);
+    rom[15] = dec(REG5);
+    rom[16] = bne(13);
+    rom[17] = st(REG0, 64);
+    rom[18] = hlt();
+}
+
+/*
+  65番地（IO65）の読み出しの例：65番地に ST してから LD し直しても、書いた値ではなく入力が読める。
+  パイプライン版（chapter06 の cpu15_pipe）の RAM のフォワーディングが 65番地を回さないことを、
+  直後（距離1）と1命令あけたとき（距離2）の両方で確かめる。
+    st 5 → 65; REG1 = [65]; st 5 → 65; nop; REG2 = [65]; ram[64] = REG1 + REG2; HLT
+  ram[64] は IO65 の入力の2倍になる（入力がなければ 0。書いた 5 が回ると 10 や 5 + 入力になる）。
+*/
+static inline void cpu15_load_io65(short *rom) {
+    rom[0]  = ldl(REG0, 5);
+    rom[1]  = st(REG0, IO65_ADDR);
+    rom[2]  = ld(REG1, IO65_ADDR);
+    rom[3]  = st(REG0, IO65_ADDR);
+    rom[4]  = mov(REG2, REG2);
+    rom[5]  = ld(REG2, IO65_ADDR);
+    rom[6]  = add(REG1, REG2);
+    rom[7]  = st(REG1, 64);
+    rom[8]  = hlt();
+}
+
+/*
+  マルチコアの並列総和（全コアが同じ ROM を実行する。コア番号とコア数は 66/67 番地から読む）。
+    len = 128 / n, base = 128 + id * len
+    1) 自分の区間 ram[base .. base+len-1] に base-127 .. （全体で 1..128）を並べる
+    2) 区間の和を rep 回求める（REG0。rep は負荷を変えるためだけのもの）
+    3) 部分和を ram[PSUM_PART + id] に書き、ram[PSUM_FLAG + id] = 1 にする
+    4) コア 0 だけが、コア 1..n-1 のフラグを順に待って部分和を足し、
+       合計 1 + 2 + ... + 128 = 8256 を ram[64] に書く。他のコアはそのまま HLT
+  ループ1(PC=13): st REG3, [REG0]+; inc REG3; dec REG7; bne 13
+  ループ2(PC=22): ld REG5, [REG3]+; add REG0, REG5; dec REG4; bne 22（外側は PC=19 から REG7 回）
+  待ち(PC=45)   : ld REG5, [REG3]; cmp REG5, REG4; jne 45（REG3 = フラグの番地, REG4 = 1）
+  core_info がない（1コアの CPU_emulator）と n = 0 で割ることになるので、
+  CPU_emulator は -p psum のときだけ core_info = {0, 1} にする。
+*/
+#define PSUM_PART 96
+#define PSUM_FLAG 112
+
+static inline void cpu15_load_psum(short *rom, int rep) {
+    rom[0]  = ld(REG5, CORE_ID_ADDR);
+    rom[1]  = ld(REG6, NCORES_ADDR);
+    rom[2]  = ldl(REG1, 128);
+    rom[3]  = mov(REG2, REG1);
+    rom[4]  = divu(REG2, REG6);             // REG2 = len
+    rom[5]  = mov(REG3, REG2);
+    rom[6]  = mul(REG3, REG5);
+    rom[7]  = add(REG1, REG3);              // REG1 = base
+    rom[8]  = mov(REG3, REG1);
+    rom[9]  = ldl(REG4, 127);
+    rom[10] = sub(REG3, REG4);              // 最初の値 base - 127
+    rom[11] = mov(REG0, REG1);
+    rom[12] = mov(REG7, REG2);
+    rom[13] = str_inc(REG3, REG0);
+    rom[14] = inc(REG3);
+    rom[15] = dec(REG7);
+    rom[16] = bne(13);
+    rom[17] = ldl(REG7, rep & 0xff);
+    rom[18] = ldh(REG7, (rep >> 8) & 0xff);
+    rom[19] = sub(REG0, REG0);
+    rom[20] = mov(REG3, REG1);
+    rom[21] = mov(REG4, REG2);
+    rom[22] = ldr_inc(REG5, REG3);
+    rom[23] = add(REG0, REG5);
+    rom[24] = dec(REG4);
+    rom[25] = bne(22);
+    rom[26] = dec(REG7);
+    rom[27] = bne(19);
+    rom[28] = ld(REG5, CORE_ID_ADDR);
+    rom[29] = ldl(REG6, PSUM_PART);         // REG6 = n（8bit 以下）なので下位だけ入れ替えればよい
+    rom[30] = add(REG6, REG5);
+    rom[31] = str(REG0, REG6);              // 部分和
+    rom[32] = ldl(REG4, PSUM_FLAG - PSUM_PART);
+    rom[33] = add(REG6, REG4);
+    rom[34] = ldl(REG4, 1);
+    rom[35] = str(REG4, REG6);              // フラグ
+    rom[36] = addi(REG5, 0);                // コア 0 以外は HLT へ
+    rom[37] = jne(55);
+    rom[38] = ld(REG7, NCORES_ADDR);
+    rom[39] = dec(REG7);
+    rom[40] = je(54);                       // 1コアなら待つものがない
+    rom[41] = sub(REG3, REG3);
+    rom[42] = ldl(REG3, PSUM_FLAG + 1);
+    rom[43] = sub(REG6, REG6);
+    rom[44] = ldl(REG6, PSUM_PART + 1);
+    rom[45] = ldr(REG5, REG3);
+    rom[46] = cmp(REG5, REG4);
+    rom[47] = jne(45);
+    rom[48] = ldr(REG5, REG6);
+    rom[49] = add(REG0, REG5);
+    rom[50] = inc(REG3);
+    rom[51] = inc(REG6);
+    rom[52] = dec(REG7);
+    rom[53] = bne(45);
+    rom[54] = st(REG0, 64);
+    rom[55] = hlt();
+}
+
+/*
+  マルチコアのロック（SWAP のスピンロック）：全コアが共有のカウンタ ram[LOCK_ADDR + 1] を
+  ロック ram[LOCK_ADDR] の中で rep 回ずつ +1 する。
+    ロックを取る(PC=6): mov REG3, REG4(=1); swap REG3, [REG1]; addi REG3, 0; jne 6
+                       （入れ替える前が 0 なら取れた。1 なら他のコアが持っているのでやり直す）
+    中身(PC=10)       : ld REG6, [REG2]; inc REG6; st REG6, [REG2]
+    外す(PC=13)       : REG3 = 0; st REG3, [REG1]
+  LD/ADD/ST は別々の命令なので、ロックがないと2つのコアが同じ値を読んで +1 し、1回分が消える。
+  終わったらフラグ ram[PSUM_FLAG + id] = 1 にし、コア 0 が全コアのフラグを待って
+  カウンタ（= コア数 × rep）を ram[64] に書く。
+*/
+#define LOCK_ADDR 80
+
+static inline void cpu15_load_lock(short *rom, int rep) {
+    rom[0]  = ld(REG5, CORE_ID_ADDR);
+    rom[1]  = ldl(REG1, LOCK_ADDR);
+    rom[2]  = ldl(REG2, LOCK_ADDR + 1);
+    rom[3]  = ldl(REG7, rep & 0xff);
+    rom[4]  = ldh(REG7, (rep >> 8) & 0xff);
+    rom[5]  = ldl(REG4, 1);
+    rom[6]  = mov(REG3, REG4);
+    rom[7]  = swap(REG3, REG1);
+    rom[8]  = addi(REG3, 0);
+    rom[9]  = jne(6);
+    rom[10] = ldr(REG6, REG2);
+    rom[11] = inc(REG6);
+    rom[12] = str(REG6, REG2);
+    rom[13] = sub(REG3, REG3);
+    rom[14] = str(REG3, REG1);
+    rom[15] = dec(REG7);
+    rom[16] = bne(6);
+    rom[17] = sub(REG6, REG6);
+    rom[18] = ldl(REG6, PSUM_FLAG);
+    rom[19] = add(REG6, REG5);
+    rom[20] = str(REG4, REG6);              // フラグ
+    rom[21] = addi(REG5, 0);                // コア 0 以外は HLT へ
+    rom[22] = jne(34);
+    rom[23] = ld(REG7, NCORES_ADDR);
+    rom[24] = dec(REG7);
+    rom[25] = je(32);
+    rom[26] = inc(REG6);                    // コア 0 なら REG6 = PSUM_FLAG。次のコアのフラグへ
+    rom[27] = ldr(REG3, REG6);
+    rom[28] = cmp(REG3, REG4);
+    rom[29] = jne(27);
+    rom[30] = dec(REG7);
+    rom[31] = bne(26);
+    rom[32] = ld(REG0, LOCK_ADDR + 1);
+    rom[33] = st(REG0, 64);
+    rom[34] = hlt();
+}
+
+/*
+  --- サイクルモデル（リターンアドレス予測つき） ---
+  cpu15_step() は 1命令 = 1ステップで時間を持たない。ここでは命令ごとのサイクル数を
+  次の単純なパイプラインを想定して数える（分岐のペナルティだけを見るためのモデル）。
+    - どの命令も 1 サイクル
+    - JMP/CALL    : 分岐先は命令語に入っているので、DC で分かる → +CYC_REDIRECT_DC
+    - JE/JCC 成立 : 条件はフラグを見る EX まで分からない     → +CYC_REDIRECT_EX
+    - RET         : 戻り番地は RAM を読む EX まで分からない   → +CYC_REDIRECT_EX
+    - MUL/MULHU   : DSP ブロックの乗算器で 1 サイクル
+    - DIVU/MODU   : 1ビット/サイクルの除算器。初期化 + 16 ビット分 → +CYC_DIV
+    - MCPY/MSET   : 要求 + 完了待ち。1サイクル（= ベースクロック4周期）に4語動く。
+                    RAM の読み出しに1周期かかる分（読んで次の周期に書く）だけ遅れるので、
+                    n 語なら +max(1, ceil((n+3)/4))（exec.vhd / ram_dc_wb.vhd と同じ）
+    - LDR [rb]+   : レジスタファイルの書き込みポートが1本なので、rb+1 と読んだ値を
+                    2回に分けて書く → +CYC_LDR_INC（STR [rb]+ は rb だけなので +0）
+  RET だけは、CALL のたびに戻り番地を積む小さなスタック（RAS: return address stack）で
+  FT の時点に予測できる。予測が当たれば JMP と同じく +CYC_REDIRECT_DC で済む。
+  - RAS は ras_depth 段の循環バッファで、あふれたら一番古いものを上書きする
+    （深い再帰では外側の RET が外れるが、内側は当たり続ける）。
+  - ras_depth = 0 は予測なし（RET は毎回 +CYC_REDIRECT_EX）。
+  btfn を 1 にすると、FT で命令語をプリデコードする静的分岐予測（chapter06/fetch_pq.vhd と同じ規則）を使う。
+  - JMP / CALL は常に成立と予測し、分岐先も命令語にあるので FT で読み替えられる → +0
+  - JE / JCC は分岐先が自分の番地以下（後ろ向き）なら成立、前向きなら不成立と予測する。
+    予測と実際が食い違ったときだけ EX で読み直す → +CYC_REDIRECT_EX
+  btfn = 0 は従来どおり「常に次の番地を読む」（JE/JCC は成立のたびに外れ、JMP は DC で読み替える）。
+  どちらでも、分岐ペナルティを払った JMP/JE/JCC を mispredicts に数える。
+  （fetch_pq の先読みキューは後段が止まったときに ROM を読み進めるだけで、
+    このモデルでは命令の並びもサイクル数も変えないので数えていない）
+*/
+#define CYC_REDIRECT_DC 1
+#define CYC_REDIRECT_EX 2
+#define CYC_DIV         16
+#define CYC_LDR_INC     1
+#define RAS_MAX         16
+
+struct cpu15_timing {
+    unsigned long long cycles;      // 累計サイクル
+    unsigned long long insns;       // 実行した命令数
+    unsigned long long rets;        // 実行した RET の数
+    unsigned long long ras_hits;    // RAS の予測が当たった RET の数
+    unsigned long long branches;    // 実行した JMP/JE/JCC の数
+    unsigned long long mispredicts; // そのうち分岐ペナルティを払った数
+    int btfn;                       // 1 なら BTFN 静的予測
+    int ras_depth;                  // RAS の段数（0..RAS_MAX）
+    int ras_top;                    // 次に積む位置
+    int ras_count;                  // 有効なエントリ数（ras_depth で頭打ち）
+    short ras[RAS_MAX];
+};
+
+static inline void cpu15_timing_init(struct cpu15_timing *t, int depth) {
+    t->cycles = t->insns = t->rets = t->ras_hits = 0;
+    t->branches = t->mispredicts = 0;
+    t->btfn = 0;
+    t->ras_depth = depth < 0 ? 0 : depth > RAS_MAX ? RAS_MAX : depth;
+    t->ras_top = 0;
+    t->ras_count = 0;
+}
+
+/* cpu15_step() を1回実行し、その命令のサイクル数を t に足す。戻り値は cpu15_step() と同じ */
+static inline int cpu15_step_timed(struct cpu15 *c, struct cpu15_timing *t) {
+    short pc0 = c->pc;
+    int op = cpu15_step(c);
+    int cyc = 1;
+
+    switch (op) {
+        case JMP:
+            t->branches++;
+            if (!t->btfn) {
+                t->mispredicts++;
+                cyc += CYC_REDIRECT_DC;
+            }
+            break;
+        case JE:
+        case JCC: {
+            int taken = c->pc != ((pc0 + 1) & 0x00ff);
+            int pred = t->btfn && op_addr(c->ir) <= (pc0 & 0x00ff);   // 後ろ向きなら成立と予測
+            t->branches++;
+            if (taken != pred) {
+                t->mispredicts++;
+                cyc += CYC_REDIRECT_EX;
+            }
+            break;
+        }
+        case DIVU:
+        case MODU:
+            cyc += CYC_DIV;
+            break;
+        case LDR:
+            if (c->ir & 1) cyc += CYC_LDR_INC;
+            break;
+        case MCPY:
+        case MSET: {
+            int n = c->reg[op_regC(c->ir)] & 0x00ff;
+            cyc += n + 3 <= 4 ? 1 : (n + 3 + 3) / 4;
+            break;
+        }
+        case CALL:
+            if (!t->btfn) cyc += CYC_REDIRECT_DC;
+            if (t->ras_depth > 0) {
+                t->ras[t->ras_top] = (pc0 + 1) & 0x00ff;
+                t->ras_top = (t->ras_top + 1) % t->ras_depth;
+                if (t->ras_count < t->ras_depth) t->ras_count++;
+            }
+            break;
+        case RET:
+            t->rets++;
+            if (t->ras_count > 0) {
+                t->ras_top = (t->ras_top + t->ras_depth - 1) % t->ras_depth;
+                t->ras_count--;
+                if (t->ras[t->ras_top] == c->pc) {
+                    t->ras_hits++;
+                    cyc += CYC_REDIRECT_DC;
+                    break;
+                }
+            }
+            cyc += CYC_REDIRECT_EX;
+            break;
+        default:
+            break;
+    }
+    t->cycles += cyc;
+    t->insns++;
+    return op;
+}
+
+#endif
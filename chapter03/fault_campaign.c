@@ -0,0 +1,303 @@
+/*
+  fault_campaign.c（フォールト注入キャンペーン / cpu15.h のコアを使う）
+
+  【目的（信頼性評価）】
+  - 放射線などによるソフトエラー（1bit 反転）が CPU の状態に起きたとき、
+    プログラムの結果がどうなるかを統計的に調べる。
+  - 反転させる場所：reg[] / ram[] / pc / フラグ（CMP の被演算子 flag_a, flag_b）
+    反転させる時刻：ゴールデン実行（故障なし）の何命令目か（一様乱数）
+  - 1回の注入ごとに結果を次の4つに分類する。
+      masked    : 正しい結果で HLT した（故障が結果に現れなかった）
+      wrong_out : ゴールデンと同じかそれ以降に HLT したが ram[64] が違う
+      hang      : 命令数の上限までに HLT しなかった（無限ループ等）
+      early_hlt : ゴールデンより早く HLT した（PC 化けで HLT に飛んだ等）
+
+  【速くするための工夫】
+  1) ゴールデン・スナップショット
+     - 故障なしの実行を1回だけ行い、CKPT_INTERVAL 命令ごとに CPU 状態を保存しておく。
+     - t 命令目に注入するときは、t 以下の直近のスナップショットから再開すればよい
+       （毎回リセットから t 命令ぶん実行し直さない）。
+  2) 再収束による早期終了
+     - ゴールデン実行の HASH_INTERVAL 命令ごとの状態ハッシュを記録しておく。
+     - 故障ありの実行でも同じ命令数のところでハッシュを計算し、一致すれば
+       「状態がゴールデンに戻った＝以後もまったく同じ実行になる」ので masked で打ち切る。
+       （例：上書きされるレジスタへの反転、直後に CMP で作り直されるフラグなど）
+     - 64bit ハッシュの衝突で誤判定する確率は無視できる大きさ（2^-64 程度）。
+  3) 全コアで並列実行
+     - ゴールデン実行のあと fork() でワーカを CPU コア数だけ作る。
+       ゴールデンのデータは copy-on-write で共有されるのでコピーは発生しない。
+     - 各ワーカは担当分の注入を実行し、集計結果だけを pipe で親へ返す。
+     - i 番目の注入の乱数は (seed, i) だけで決まるので、
+       ワーカ数を変えても結果（集計）は同じになる。
+
+  【使い方】
+    ./fault_campaign [注入回数] [seed] [ワーカ数]
+      既定：1000000 回 / seed=1 / ワーカ数 = オンラインの CPU 数
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "cpu15.h"
+
+#define CKPT_INTERVAL   64          // スナップショットを取る間隔（命令数）
+#define HASH_INTERVAL   8           // 状態ハッシュを比べる間隔（命令数）
+#define GOLDEN_MAX      (1L << 24)  // ゴールデン実行がこれを超えたら HLT しないプログラムとみなす
+#define HANG_FACTOR     2           // ゴールデンの命令数の何倍で hang と判定するか
+#define MAX_WORKERS     256
+
+/* 反転させる場所 */
+enum { T_REG, T_RAM, T_PC, T_FLAG, N_TARGET };
+static const char *target_name[N_TARGET] = { "reg", "ram", "pc", "flags" };
+
+/* 結果の分類 */
+enum { R_MASKED, R_WRONG_OUT, R_HANG, R_EARLY_HLT, N_RESULT };
+static const char *result_name[N_RESULT] = { "masked", "wrong_out", "hang", "early_hlt" };
+
+/* ゴールデン実行の記録（fork 後は各ワーカから読むだけ） */
+struct golden {
+    long steps;                 // HLT までの命令数（HLT 自身を含む）
+    short out;                  // 最終的な ram[64]
+    long nckpt, nhash;
+    struct cpu15 *ckpt;         // ckpt[k] = k*CKPT_INTERVAL 命令実行後の状態
+    uint64_t *hash;             // hash[k] = k*HASH_INTERVAL 命令実行後の状態ハッシュ
+};
+
+/* ワーカから親へ返す集計 */
+struct tally {
+    long count[N_TARGET][N_RESULT];
+    long reconverged;           // masked のうち、ハッシュ一致で早期終了したもの
+    long steps;                 // 実行した命令数の合計
+};
+
+/* --- 乱数：splitmix64（注入番号 i から独立した乱数列を作る） --- */
+static uint64_t splitmix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+/* --- 状態ハッシュ：pc / flag_a / flag_b / sp / io65_pos / reg / ram（ir は次の Fetch で上書きされるので含めない）
+   sp と io65_pos も入れる。どちらかだけがずれた状態を「合流した」と数えると、
+   あとの POP/RET や LD 65 で食い違っても masked のままになる --- */
+static inline uint64_t mix(uint64_t h, uint64_t w) {
+    h = (h ^ w) * 0xff51afd7ed558ccdull;
+    return h ^ (h >> 32);
+}
+
+static uint64_t state_hash(const struct cpu15 *c) {
+    uint64_t h = mix(0x9e3779b97f4a7c15ull ^ (uint32_t)c->io65_pos,
+                     (uint16_t)c->pc | ((uint64_t)(uint16_t)c->flag_a << 16) |
+                     ((uint64_t)(uint16_t)c->flag_b << 32) | ((uint64_t)(uint16_t)c->sp << 48));
+    uint64_t w;
+    int i;
+    for (i = 0; i < 8; i += 4) {
+        memcpy(&w, &c->reg[i], sizeof(w));
+        h = mix(h, w);
+    }
+    for (i = 0; i < RAM_WORDS; i += 4) {
+        memcpy(&w, &c->ram[i], sizeof(w));
+        h = mix(h, w);
+    }
+    return h;
+}
+
+/* --- ゴールデン実行：スナップショットとハッシュを記録する --- */
+static void golden_run(const struct cpu15 *init, struct golden *g) {
+    struct cpu15 c = *init;
+    long s = 0, cap_ckpt = 64, cap_hash = 512;
+    int op;
+
+    g->ckpt = malloc(sizeof(*g->ckpt) * cap_ckpt);
+    g->hash = malloc(sizeof(*g->hash) * cap_hash);
+    g->nckpt = g->nhash = 0;
+    for (;;) {
+        if (s % CKPT_INTERVAL == 0) {
+            if (g->nckpt == cap_ckpt) g->ckpt = realloc(g->ckpt, sizeof(*g->ckpt) * (cap_ckpt *= 2));
+            g->ckpt[g->nckpt++] = c;
+        }
+        if (s % HASH_INTERVAL == 0) {
+            if (g->nhash == cap_hash) g->hash = realloc(g->hash, sizeof(*g->hash) * (cap_hash *= 2));
+            g->hash[g->nhash++] = state_hash(&c);
+        }
+        op = cpu15_step(&c);
+        s++;
+        if (op == HLT) break;
+        if (s >= GOLDEN_MAX) {
+            fprintf(stderr, "golden run did not reach HLT within %ld instructions\n", GOLDEN_MAX);
+            exit(1);
+        }
+    }
+    g->steps = s;
+    g->out = c.ram[64];
+}
+
+/* --- 1回の注入 --- */
+static int inject_one(const struct golden *g, uint64_t seed, long i, int *target, struct tally *t) {
+    uint64_t x = seed ^ ((uint64_t)i * 0xd1342543de82ef95ull);
+    uint64_t r1 = splitmix64(&x), r2 = splitmix64(&x);
+    long when = (long)(r1 % (uint64_t)g->steps);        // 何命令実行した後に反転させるか
+    long s = when - when % CKPT_INTERVAL;
+    long limit = g->steps * HANG_FACTOR + 256;
+    struct cpu15 c = g->ckpt[s / CKPT_INTERVAL];
+    int op, bit;
+
+    /* 直近のスナップショットから注入時刻までは故障なしで進める */
+    while (s < when) {
+        cpu15_step(&c);
+        s++;
+    }
+
+    /* 1bit 反転 */
+    *target = (int)(r2 % N_TARGET);
+    r2 /= N_TARGET;
+    switch (*target) {
+    case T_REG:  bit = (int)(r2 % (8 * 16));   c.reg[bit >> 4] ^= (short)(1 << (bit & 15)); break;
+    case T_RAM:  bit = (int)(r2 % (256 * 16)); c.ram[bit >> 4] ^= (short)(1 << (bit & 15)); cpu15_mark_dirty(&c, bit >> 4); break;
+    case T_PC:   bit = (int)(r2 % 8);          c.pc ^= (short)(1 << bit); break;
+    default:
+        bit = (int)(r2 % 32);                   // 下位16bit → flag_a、上位16bit → flag_b
+        if (bit < 16) c.flag_a ^= (short)(1 << bit);
+        else c.flag_b ^= (short)(1 << (bit - 16));
+        break;
+    }
+
+    for (;;) {
+        if (s % HASH_INTERVAL == 0 && s / HASH_INTERVAL < g->nhash &&
+            state_hash(&c) == g->hash[s / HASH_INTERVAL]) {
+            t->reconverged++;
+            t->steps += s - when;
+            return R_MASKED;
+        }
+        op = cpu15_step(&c);
+        s++;
+        if (op == HLT) break;
+        if (s >= limit) {
+            t->steps += s - when;
+            return R_HANG;
+        }
+    }
+    t->steps += s - when;
+    if (s < g->steps) return R_EARLY_HLT;
+    if (c.ram[64] != g->out) return R_WRONG_OUT;
+    return R_MASKED;
+}
+
+/* --- ワーカ：注入番号 w, w+nw, w+2nw, ... を担当する --- */
+static void worker(const struct golden *g, uint64_t seed, long n, int w, int nw, struct tally *t) {
+    long i;
+    int target, res;
+    memset(t, 0, sizeof(*t));
+    for (i = w; i < n; i += nw) {
+        res = inject_one(g, seed, i, &target, t);
+        t->count[target][res]++;
+    }
+}
+
+static void write_all(int fd, const void *p, size_t n) {
+    const char *q = p;
+    ssize_t k;
+    while (n > 0) {
+        if ((k = write(fd, q, n)) <= 0) _exit(1);
+        q += k;
+        n -= (size_t)k;
+    }
+}
+
+static int read_all(int fd, void *p, size_t n) {
+    char *q = p;
+    ssize_t k;
+    while (n > 0) {
+        if ((k = read(fd, q, n)) <= 0) return -1;
+        q += k;
+        n -= (size_t)k;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    static struct cpu15 init;
+    struct golden g;
+    struct tally sum, part;
+    long n = argc > 1 ? strtol(argv[1], NULL, 0) : 1000000;
+    uint64_t seed = argc > 2 ? strtoull(argv[2], NULL, 0) : 1;
+    int nw = argc > 3 ? atoi(argv[3]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int fd[MAX_WORKERS], pfd[2], w, i, j;
+    pid_t pid[MAX_WORKERS];
+    struct timespec t0, t1;
+    double sec;
+
+    if (nw < 1) nw = 1;
+    if (nw > MAX_WORKERS) nw = MAX_WORKERS;
+
+    cpu15_load_sum(init.rom);
+    cpu15_reset(&init);
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    golden_run(&init, &g);
+
+    /* ゴールデン実行の結果を共有したまま fork する */
+    for (w = 0; w < nw; w++) {
+        if (pipe(pfd) < 0) { perror("pipe"); return 1; }
+        pid[w] = fork();
+        if (pid[w] < 0) { perror("fork"); return 1; }
+        if (pid[w] == 0) {
+            close(pfd[0]);
+            worker(&g, seed, n, w, nw, &part);
+            write_all(pfd[1], &part, sizeof(part));
+            _exit(0);
+        }
+        close(pfd[1]);
+        fd[w] = pfd[0];
+    }
+
+    memset(&sum, 0, sizeof(sum));
+    for (w = 0; w < nw; w++) {
+        if (read_all(fd[w], &part, sizeof(part)) < 0) {
+            fprintf(stderr, "worker %d failed\n", w);
+            return 1;
+        }
+        close(fd[w]);
+        waitpid(pid[w], NULL, 0);
+        for (i = 0; i < N_TARGET; i++)
+            for (j = 0; j < N_RESULT; j++) sum.count[i][j] += part.count[i][j];
+        sum.reconverged += part.reconverged;
+        sum.steps += part.steps;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    sec = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9;
+
+    printf("golden run : %ld instructions, ram[64] = %d\n", g.steps, g.out);
+    printf("injections : %ld (%d workers, seed %llu)\n\n", n, nw, (unsigned long long)seed);
+    printf("  %-8s", "target");
+    for (j = 0; j < N_RESULT; j++) printf("  %10s", result_name[j]);
+    printf("\n");
+    for (i = 0; i <= N_TARGET; i++) {
+        printf("  %-8s", i < N_TARGET ? target_name[i] : "total");
+        for (j = 0; j < N_RESULT; j++) {
+            long v = 0;
+            if (i < N_TARGET) v = sum.count[i][j];
+            else for (w = 0; w < N_TARGET; w++) v += sum.count[w][j];
+            printf("  %10ld", v);
+        }
+        printf("\n");
+    }
+    printf("\n  reconverged early : %ld\n", sum.reconverged);
+    printf("  instructions      : %ld (%.1f per injection)\n", sum.steps, n ? (double)sum.steps / n : 0.0);
+    printf("  %.3f sec, %.0f injections/s (%.1f M/hour)\n",
+           sec, sec > 0 ? n / sec : 0.0, sec > 0 ? n / sec * 3600 / 1e6 : 0.0);
+    return 0;
+}
+
+/*
+  【GNUでのコンパイル例（Ubuntu / gcc）】
+    gcc -O2 fault_campaign.c -o fault_campaign
+
+  【実行例】
+    ./fault_campaign 10000000
+*/
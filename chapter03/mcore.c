@@ -0,0 +1,267 @@
+/*
+  mcore.c（マルチコア cpu15 エミュレータ / 共有 RAM と決定的なクォンタム同期）
+
+  【目的】
+  - cpu15 のコアを複数並べ、データ RAM（64/65 番地の I/O を含む 256 語）を共有させる。
+    各コアは自分の ROM を持ち、ホストの1スレッドで動く（ゲスト1コア = ホスト1コア）。
+  - スレッドの実行速度やスケジューリングに関係なく、毎回まったく同じ結果になるようにする。
+
+  【実行モデル（クォンタム）】
+  - 各コアは共有 RAM の「私有コピー」（struct cpu15 の ram[]）を持ち、
+    1クォンタム = Q 命令ぶんを他のコアと無関係に実行する。
+    その間に他のコアが書いた値は見えず、自分の書き込みだけが見える。
+  - 全コアが Q 命令を終えたら（バリア）、書き込みを交換する。
+      1) 1つのスレッドが、コア 0, 1, 2, ... の順に dirty（書いた語のビットマップ）の語を
+         共有イメージへ書く。同じ語を複数のコアが書いていたら番号の大きいコアの値が残る。
+      2) 各スレッドが、どれかのコアが書いた語を共有イメージから自分の ram[] へコピーする。
+      3) 全スレッドがコピーを終えるのを待ってから（バリア）、次のクォンタムに入る。
+         先に入ったコアの SWAP が、まだコピー中のコアの私有コピーに混ざらないようにするため。
+    どのコアが何を読むかはクォンタムの境界だけで決まるので、結果はスレッド数にも
+    スケジューリングにもよらない（-1 で1スレッドに順番に実行させても同じ結果になる）。
+  - HLT したコアはそのまま止まり、全コアが止まるか -m クォンタムで終わる。
+
+  【SWAP（不可分な入れ替え）】
+  - SWAP だけは私有コピーではなく共有 RAM（shared[]）をその場で入れ替える
+    （cpu15.h の shared。ホストの __atomic_exchange_n なので、同時に SWAP したコアのうち
+    必ずどちらか一方が先になる）。入れ替えた語は swapped に印を付け、境界で他のコアの私有コピーへ配る。
+  - 普通の ST は従来どおり境界で共有イメージに入る。ロックを ST 0 で外すと、
+    外したことは境界まで他のコアに見えないが、自分が続けて SWAP すれば取り直せる（cpu15.h 参照）。
+    ロックの中で書いた語は、ロックを外す ST と同じ境界で見えるようになるので、
+    次にロックを取ったコアは必ずそれを読む。
+  - 違うスレッドのコアが同じクォンタムの中で同じ語を SWAP し合うと、どちらが先になるかは
+    ホストのスレッドの進み方で決まる（本物のマルチコアと同じ）。そのときだけは実行ごとに
+    ハッシュが変わりうる。-1 なら常に同じ結果になる。
+  - 状態は cpu15.h の struct cpu15 にすべて入っていてグローバル変数を使わないので、
+    コアごとに1つ持つだけで cpu15_step() をそのまま並列に呼べる。
+    dirty は cpu15_restore() 用のものをそのまま書き込みの記録に使う。
+
+  【注意】
+  - スタック（CALL/PUSH）も共有 RAM の 63 番地から下を使うので、
+    複数のコアがスタックを使うなら、SP が重ならないプログラムにすること。
+  - コア間の待ち合わせは RAM のフラグを読んで回る（書いた値はクォンタムの境界で見える）。
+  - 66/67 番地を LD/LDR で読むと自分のコア番号とコア数が返る（cpu15.h の core_info）。
+    全コアに同じ ROM を渡し、コア番号で仕事を分けるプログラム（SPMD）を書ける。
+
+  【使い方】
+    mcore [-q Q] [-m MAXQ] [-1] [-p psum|lock] [-r REP] [-n CORES] [rom0.hex rom1.hex ...]
+      -q Q      : 1クォンタムの命令数（既定 1000）
+      -m MAXQ   : クォンタム数の上限（既定 1000000）
+      -1        : 全コアを1スレッドで順番に動かす（結果が同じことを確かめる用）
+      -p PROG   : 組み込みのプログラム。psum（並列総和、既定）/ lock（SWAP のロックで共有カウンタを +1）
+      -r REP    : 組み込みのプログラムの繰り返し回数（既定 1000）
+      -n CORES  : コア数（既定 4。組み込みの並列総和では 128 を割り切る 1, 2, 4, 8）
+      rom.hex   : CPU_emulator -o の形式の ROM イメージ（1ファイル = 1コア）。
+                  1ファイルだけなら -n のコア数ぶん同じ ROM を使う。
+                  指定しなければ組み込みのプログラム（cpu15.h の cpu15_load_psum / cpu15_load_lock）を使う。
+*/
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "cpu15.h"
+
+#define MAX_CORES 64
+
+struct core {
+    struct cpu15 cpu;
+    short info[2];              // core_info（コア番号, コア数）
+    int halted;
+    long insns;
+};
+
+static struct core cores[MAX_CORES];
+static int ncores;
+static long quantum = 1000, max_q = 1000000, nq;
+
+static short shared[RAM_WORDS];             // クォンタム境界での共有 RAM
+static uint64_t written[RAM_WORDS / 64];    // このクォンタムでどれかのコアが書いた語
+static uint64_t swapped[RAM_WORDS / 64];    // このクォンタムでどれかのコアが SWAP した語（shared[] は書き換え済み）
+static int done;
+static pthread_barrier_t bar;
+
+/* io64 の変化の記録（クォンタム番号と値） */
+static long io64_q[64];
+static short io64_v[64];
+static int nio64;
+
+/* 1クォンタムぶん実行する */
+static void run_quantum(struct core *c) {
+    long i;
+    if (c->halted) return;
+    for (i = 0; i < quantum; i++) {
+        c->insns++;
+        if (cpu15_step(&c->cpu) == HLT) {
+            c->halted = 1;
+            break;
+        }
+    }
+}
+
+/* 書き込みを共有イメージへまとめる（コア番号の順。1スレッドだけが呼ぶ） */
+static void merge(void) {
+    int k, i, all = 1;
+
+    memset(written, 0, sizeof(written));
+    for (k = 0; k < ncores; k++) {
+        struct cpu15 *c = &cores[k].cpu;
+        for (i = 0; i < RAM_WORDS / 64; i++) {
+            uint64_t m = c->dirty[i];
+            written[i] |= m;
+            while (m) {
+                int a = i * 64 + __builtin_ctzll(m);
+                shared[a] = c->ram[a];
+                m &= m - 1;
+            }
+        }
+        all &= cores[k].halted;
+    }
+    for (i = 0; i < RAM_WORDS / 64; i++) {
+        written[i] |= swapped[i];
+        swapped[i] = 0;
+    }
+    if (((written[64 / 64] >> (64 % 64)) & 1) && nio64 < 64 && (nio64 == 0 || io64_v[nio64 - 1] != shared[64])) {
+        io64_q[nio64] = nq;
+        io64_v[nio64++] = shared[64];
+    }
+    nq++;
+    done = all || nq >= max_q;
+}
+
+/* 他のコアが書いた語を自分の私有コピーへ取り込む */
+static void update(struct core *c) {
+    int i;
+    for (i = 0; i < RAM_WORDS / 64; i++) {
+        uint64_t m = written[i];
+        while (m) {
+            int a = i * 64 + __builtin_ctzll(m);
+            c->cpu.ram[a] = shared[a];
+            m &= m - 1;
+        }
+        c->cpu.dirty[i] = 0;
+    }
+}
+
+static void *worker(void *arg) {
+    struct core *c = arg;
+    for (;;) {
+        run_quantum(c);
+        if (pthread_barrier_wait(&bar) == PTHREAD_BARRIER_SERIAL_THREAD) merge();
+        pthread_barrier_wait(&bar);
+        if (done) return NULL;
+        update(c);
+        pthread_barrier_wait(&bar);         // 全コアが取り込み終わるまで、どのコアも SWAP しない
+    }
+}
+
+/* CPU_emulator -o の形式（-- で始まる行は読み飛ばし、1行に1語の16進）を読む */
+static void load_hex(short *rom, const char *path) {
+    char line[256];
+    FILE *fp = fopen(path, "r");
+    int n = 0;
+
+    if (fp == NULL) {
+        perror(path);
+        exit(1);
+    }
+    while (fgets(line, sizeof(line), fp) && n < 256) {
+        char *end;
+        unsigned long v;
+        if (!strncmp(line, "--", 2)) continue;
+        v = strtoul(line, &end, 16);
+        if (end == line) continue;
+        rom[n++] = (short)v;
+    }
+    fclose(fp);
+}
+
+static void usage(void) {
+    fprintf(stderr, "usage: mcore [-q Q] [-m MAXQ] [-1] [-p psum|lock] [-r REP] [-n CORES] [rom0.hex rom1.hex ...]\n");
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    pthread_t th[MAX_CORES];
+    int serial = 0, rep = 1000, builtin, i, k;
+    const char *prog = "psum";
+    long total = 0;
+    uint64_t h = 0xcbf29ce484222325ull;
+    struct timespec t0, t1;
+    double sec;
+
+    ncores = 4;
+    for (i = 1; i < argc && argv[i][0] == '-'; i++) {
+        if (!strcmp(argv[i], "-q") && i + 1 < argc) quantum = strtol(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-m") && i + 1 < argc) max_q = strtol(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-p") && i + 1 < argc) prog = argv[++i];
+        else if (!strcmp(argv[i], "-r") && i + 1 < argc) rep = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-n") && i + 1 < argc) ncores = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-1")) serial = 1;
+        else usage();
+    }
+    builtin = i == argc;
+    if (argc - i > 1) ncores = argc - i;
+    if (strcmp(prog, "psum") && strcmp(prog, "lock")) usage();
+    if (ncores < 1 || ncores > MAX_CORES || quantum < 1 || (builtin && (ncores > 8 || rep < 1 || rep > 0xffff)) ||
+        (builtin && !strcmp(prog, "psum") && 128 % ncores))
+        usage();
+
+    for (k = 0; k < ncores; k++) {
+        struct cpu15 *c = &cores[k].cpu;
+        if (builtin && !strcmp(prog, "lock")) cpu15_load_lock(c->rom, rep);
+        else if (builtin) cpu15_load_psum(c->rom, rep);
+        else load_hex(c->rom, argv[argc - i > 1 ? i + k : i]);
+        cpu15_reset(c);
+        cores[k].info[0] = (short)k;
+        cores[k].info[1] = (short)ncores;
+        c->core_info = cores[k].info;
+        c->shared = shared;
+        c->shared_mark = swapped;
+        memcpy(c->ram, shared, sizeof(shared));
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    if (serial) {
+        do {
+            for (k = 0; k < ncores; k++) run_quantum(&cores[k]);
+            merge();
+            if (!done)
+                for (k = 0; k < ncores; k++) update(&cores[k]);
+        } while (!done);
+    } else {
+        pthread_barrier_init(&bar, NULL, (unsigned)ncores);
+        for (k = 0; k < ncores; k++) pthread_create(&th[k], NULL, worker, &cores[k]);
+        for (k = 0; k < ncores; k++) pthread_join(th[k], NULL);
+        pthread_barrier_destroy(&bar);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    sec = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) / 1e9;
+
+    /* 共有 RAM のハッシュ（FNV-1a）：実行ごとに同じになることを確かめる */
+    for (i = 0; i < RAM_WORDS; i++) h = (h ^ (uint16_t)shared[i]) * 0x100000001b3ull;
+
+    printf("%d cores, quantum %ld, %ld quanta (%s)\n", ncores, quantum, nq, serial ? "1 thread" : "1 thread per core");
+    for (k = 0; k < ncores; k++) {
+        printf("  core %d: %ld insns%s\n", k, cores[k].insns, cores[k].halted ? ", halted" : "");
+        total += cores[k].insns;
+    }
+    for (i = 0; i < nio64; i++) printf("  io64 = %d at quantum %ld\n", io64_v[i], io64_q[i]);
+    printf("  ram[64] = %d, shared ram hash %016llx\n", shared[64], (unsigned long long)h);
+    printf("  %.3f sec, %.1f M insns/s\n", sec, sec > 0 ? total / sec / 1e6 : 0.0);
+    return 0;
+}
+
+/*
+  【GNUでのコンパイル例（Ubuntu / gcc）】
+    gcc -O2 -pthread mcore.c -o mcore
+
+  【実行例】
+    ./mcore -n 4 -r 10000           （4コアで並列総和。ram[64] = 8256）
+    ./mcore -n 4 -r 10000 -1        （1スレッドで同じ結果・同じハッシュになる）
+    ./CPU_emulator -p blk -o blk.hex && ./mcore blk.hex blk.hex
+    ./mcore -p lock -n 4 -r 1000 -q 7   （SWAP のロックで 4コア × 1000 回。ram[64] = 4000）
+    ./CPU_emulator -p psum -o psum.hex && ./mcore -n 8 psum.hex
+                                    （組み込みと同じ SPMD の並列総和を ROM イメージから。REP = 1）
+*/
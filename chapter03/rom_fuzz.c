@@ -0,0 +1,363 @@
+/*
+  rom_fuzz.c（カバレッジ誘導型ファザ / ROM イメージと IO65 入力列を変異させる）
+
+  【目的】
+  - 手書きのテストでは、デコーダや分岐処理の“角”のケース
+    （PC の折り返し、未定義オペコード、CMP なしの JE、IO65 の値で変わるループ回数など）
+    を網羅するのに時間がかかる。
+  - そこで ROM の命令列と IO65 から読まれる入力列をランダムに変異させて大量に実行し、
+    「今まで通ったことのない分岐（エッジ）」を通った入力だけをコーパスに残して育てていく
+    （AFL と同じ考え方）。
+
+  【カバレッジ：エッジ pc → 次の pc】
+  - 1命令実行するたびに (実行前の pc, 実行後の pc) の組を 256×256 = 65536 個のマップに記録する。
+    分岐命令の「成立/不成立」はそれぞれ別のエッジになる。
+  - 全ワーカ共有のマップ（mmap の共有メモリ）に対して新しいエッジを1つでも立てた入力を
+    コーパスに追加する。
+
+  【プロセスを作り直さないリセット】
+  - 1回の実行ごとに CPU を電源投入直後の状態に戻す必要がある。
+  - レジスタ・PC・フラグは数ワードなので全部 0 に戻すが、RAM は
+    「前回の実行で ST が書いたワード」だけをスナップショットから書き戻す。
+    書き込まれたワードは cpu15.h の ST がビットマップ（dirty）に記録しているので、
+    cpu15_restore() で電源投入直後のスナップショットに戻す。
+  - ROM はコーパスの入力をそのまま CPU にコピーする。
+  - ランダムな ROM は大半が HLT に届かないので、実行時間の大部分は timeout の実行が占める。
+    自分自身への分岐（実行後の pc が実行前と同じ）は無限ループが確定するので、
+    上限まで回さずにその場で timeout と判定する。
+
+  【並列化】
+  - fork() でワーカを CPU コア数だけ作る。エッジマップと統計カウンタは共有メモリに置き、
+    各ワーカは自分のコーパスを持って独立に変異・実行する。
+  - 新しいエッジの判定は共有マップへの原子的な書き込みで行うので、
+    同じエッジを2つのワーカが同時に見つけても、コーパスに入るのは片方だけになる。
+
+  【使い方】
+    ./rom_fuzz [-t 秒] [-j ワーカ数] [-s seed] [-o 出力ディレクトリ]
+      既定：10秒 / ワーカ数 = オンラインの CPU 数 / seed=1
+      -o を付けると、新しいエッジを見つけた入力を <dir>/w<ワーカ>_<番号>.bin に保存する
+      （ROM 256語 → IO65 の語数 → IO65 の値、すべて16bit リトルエンディアン）
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "cpu15.h"
+
+#define STEP_LIMIT   256            // 1回の実行の命令数の上限（超えたら timeout）
+#define IO_MAX       32             // IO65 入力列の最大語数
+#define CORPUS_MAX   4096           // ワーカごとのコーパスの最大数
+#define EDGE_MAP     (256 * 256)    // エッジマップの大きさ（pc 8bit × 次の pc 8bit）
+#define MAX_WORKERS  256
+
+/* ファザの入力：ROM イメージ + IO65 入力列 */
+struct input {
+    short rom[256];
+    int rom_len;                    // 変異させる範囲（プログラムとして意味のある長さ）
+    short io[IO_MAX];
+    int io_len;
+};
+
+/* 全ワーカで共有する状態（mmap の共有メモリ） */
+struct shared {
+    volatile int stop;
+    long execs, halts, timeouts, corpus;
+    uint8_t edge[EDGE_MAP];
+};
+
+/* ワーカごとの状態 */
+struct fuzzer {
+    struct cpu15 cpu;
+    struct cpu15 snap;              // リセット時に戻す状態（電源投入直後＝全0）
+    uint8_t local[EDGE_MAP];        // この実行で通ったエッジ
+    uint16_t touched[STEP_LIMIT];   // local を 0 に戻すための記録
+    struct input *corpus;
+    int ncorpus;
+    uint64_t rng;
+    struct shared *sh;
+    const char *outdir;
+    int id, saved;
+};
+
+static uint64_t next_rand(struct fuzzer *f) {
+    /* xorshift64* */
+    f->rng ^= f->rng >> 12;
+    f->rng ^= f->rng << 25;
+    f->rng ^= f->rng >> 27;
+    return f->rng * 0x2545f4914f6cdd1dull;
+}
+
+static unsigned rnd(struct fuzzer *f, unsigned n) {
+    return (unsigned)((next_rand(f) >> 32) % n);
+}
+
+/* --- 1回実行し、共有マップに新しく立てたエッジの数を返す --- */
+static int run_one(struct fuzzer *f, const struct input *in) {
+    struct cpu15 *c = &f->cpu;
+    int steps, ntouched = 0, fresh = 0, op, i;
+    unsigned edge, pc;
+
+    cpu15_restore(c, &f->snap);
+    memcpy(c->rom, in->rom, sizeof(c->rom));
+    c->io65 = in->io;
+    c->io65_len = in->io_len;
+
+    for (steps = 0; steps < STEP_LIMIT; steps++) {
+        pc = (unsigned)c->pc;
+        op = cpu15_step(c);
+        edge = (pc << 8) | (unsigned)c->pc;
+        if (!f->local[edge]) {
+            f->local[edge] = 1;
+            f->touched[ntouched++] = (uint16_t)edge;
+        }
+        if (op == HLT) break;
+        /* 自分自身への JMP / 成立した JE・JCC は状態が二度と変わらないので、その場で timeout にする。
+           RET は PC が同じでも毎回 sp を進めて別の語を取り出すので、止まっているとは限らない */
+        if ((unsigned)c->pc == pc && (op == JMP || op == JE || op == JCC)) {
+            steps = STEP_LIMIT;
+            break;
+        }
+    }
+    if (steps < STEP_LIMIT) __atomic_fetch_add(&f->sh->halts, 1, __ATOMIC_RELAXED);
+    else __atomic_fetch_add(&f->sh->timeouts, 1, __ATOMIC_RELAXED);
+
+    for (i = 0; i < ntouched; i++) {
+        edge = f->touched[i];
+        f->local[edge] = 0;
+        if (!f->sh->edge[edge] && !__atomic_exchange_n(&f->sh->edge[edge], 1, __ATOMIC_RELAXED)) fresh++;
+    }
+    return fresh;
+}
+
+/* --- 変異 --- */
+static short random_insn(struct fuzzer *f, int rom_len) {
+    short op = (short)rnd(f, NUM_OPS), ra = (short)rnd(f, 8), rb = (short)rnd(f, 8);
+    short addr;
+    switch (op) {
+    case JE: case JMP: case JCC: case CALL:
+        addr = (short)rnd(f, (unsigned)rom_len + 1);      // 分岐先はプログラムの中に寄せる
+        return (short)((op << 11) | (op == JCC ? ra << 8 : 0) | addr);
+    case LD: case ST:
+        addr = rnd(f, 4) == 0 ? IO65_ADDR : rnd(f, 2) ? 64 : (short)rnd(f, 256);
+        return (short)((op << 11) | (ra << 8) | addr);
+    case LDL: case LDH: case ADDI:
+        return (short)((op << 11) | (ra << 8) | rnd(f, 256));
+    default:
+        return (short)((op << 11) | (ra << 8) | (rb << 5));
+    }
+}
+
+static void mutate(struct fuzzer *f, struct input *in) {
+    static const short interesting[] = { 0, 1, -1, 2, 10, 55, 64, 65, 127, 128, 255, 256, 0x7fff, -0x8000 };
+    int n = 1 + (int)rnd(f, 4), k, i, j;
+    const struct input *other;
+
+    while (n-- > 0) {
+        i = (int)rnd(f, (unsigned)in->rom_len);
+        switch (rnd(f, 9)) {
+        case 0:     /* ROM のビット反転 */
+            in->rom[i] ^= (short)(1 << rnd(f, 16));
+            break;
+        case 1:     /* ROM の1語をランダムな命令に置き換える */
+            in->rom[i] = random_insn(f, in->rom_len);
+            break;
+        case 2:     /* 即値・アドレス部を少しだけ動かす */
+            in->rom[i] = (short)((in->rom[i] & 0xff00) | ((in->rom[i] + (int)rnd(f, 17) - 8) & 0x00ff));
+            break;
+        case 3:     /* オペコードだけ入れ替える */
+            in->rom[i] = (short)((in->rom[i] & 0x07ff) | (rnd(f, 32) << 11));
+            break;
+        case 4:     /* 2語を入れ替える */
+            j = (int)rnd(f, (unsigned)in->rom_len);
+            k = in->rom[i];
+            in->rom[i] = in->rom[j];
+            in->rom[j] = (short)k;
+            break;
+        case 5:     /* プログラムを1語伸ばす */
+            if (in->rom_len < 256) {
+                in->rom[in->rom_len] = random_insn(f, in->rom_len);
+                in->rom_len++;
+            }
+            break;
+        case 6:     /* IO65 入力列に値を追加する */
+            if (in->io_len < IO_MAX)
+                in->io[in->io_len++] = rnd(f, 2) ? interesting[rnd(f, sizeof(interesting) / sizeof(interesting[0]))]
+                                                 : (short)next_rand(f);
+            break;
+        case 7:     /* IO65 入力列の1語を変える / 末尾を切る */
+            if (in->io_len == 0) break;
+            j = (int)rnd(f, (unsigned)in->io_len);
+            if (rnd(f, 4) == 0) in->io_len = j;
+            else in->io[j] = (short)(in->io[j] + (int)rnd(f, 33) - 16);
+            break;
+        default:    /* 別のコーパス入力の一部を貼り付ける（スプライス） */
+            other = &f->corpus[rnd(f, (unsigned)f->ncorpus)];
+            j = (int)rnd(f, (unsigned)other->rom_len);
+            k = 1 + (int)rnd(f, 8);
+            while (k-- > 0 && i < in->rom_len && j < other->rom_len) in->rom[i++] = other->rom[j++];
+            break;
+        }
+    }
+}
+
+static void save_input(struct fuzzer *f, const struct input *in) {
+    char path[4096];
+    FILE *fp;
+    uint16_t w;
+    int i;
+
+    if (f->outdir == NULL) return;
+    snprintf(path, sizeof(path), "%s/w%d_%06d.bin", f->outdir, f->id, f->saved++);
+    if ((fp = fopen(path, "wb")) == NULL) return;
+    for (i = 0; i < 256; i++) {
+        w = (uint16_t)in->rom[i];
+        fputc(w & 0xff, fp);
+        fputc(w >> 8, fp);
+    }
+    fputc(in->io_len & 0xff, fp);
+    fputc(0, fp);
+    for (i = 0; i < in->io_len; i++) {
+        w = (uint16_t)in->io[i];
+        fputc(w & 0xff, fp);
+        fputc(w >> 8, fp);
+    }
+    fclose(fp);
+}
+
+static void add_corpus(struct fuzzer *f, const struct input *in) {
+    if (f->ncorpus < CORPUS_MAX) {
+        f->corpus[f->ncorpus++] = *in;
+        __atomic_fetch_add(&f->sh->corpus, 1, __ATOMIC_RELAXED);
+    } else {
+        f->corpus[rnd(f, CORPUS_MAX)] = *in;     // 満杯なら古いものを置き換える
+    }
+    save_input(f, in);
+}
+
+/* --- 種（シード）入力 --- */
+static void seed_inputs(struct fuzzer *f) {
+    struct input in;
+
+    /* 1) サンプルプログラム（1+...+10） */
+    memset(&in, 0, sizeof(in));
+    cpu15_load_sum(in.rom);
+    in.rom_len = 15;
+    run_one(f, &in);
+    add_corpus(f, &in);
+
+    /* 2) ループ回数を IO65 から読む版（1+...+n、n は入力列の先頭） */
+    in.rom[6] = ld(REG3, IO65_ADDR);
+    in.rom[7] = mov(REG3, REG3);
+    in.io[0] = 5;
+    in.io_len = 1;
+    run_one(f, &in);
+    add_corpus(f, &in);
+}
+
+static void fuzz_loop(struct fuzzer *f) {
+    struct input in;
+    long local_execs = 0;
+
+    seed_inputs(f);
+    while (!f->sh->stop) {
+        in = f->corpus[rnd(f, (unsigned)f->ncorpus)];
+        mutate(f, &in);
+        if (run_one(f, &in) > 0) add_corpus(f, &in);
+        if (++local_execs == 4096) {
+            __atomic_fetch_add(&f->sh->execs, local_execs, __ATOMIC_RELAXED);
+            local_execs = 0;
+        }
+    }
+    __atomic_fetch_add(&f->sh->execs, local_execs, __ATOMIC_RELAXED);
+}
+
+static long count_edges(const struct shared *sh) {
+    long n = 0;
+    int i;
+    for (i = 0; i < EDGE_MAP; i++) n += sh->edge[i];
+    return n;
+}
+
+int main(int argc, char **argv) {
+    double duration = 10;
+    int nw = (int)sysconf(_SC_NPROCESSORS_ONLN), w, i;
+    uint64_t seed = 1;
+    const char *outdir = NULL;
+    struct shared *sh;
+    pid_t pid[MAX_WORKERS];
+    struct timespec t0, t1;
+    double sec = 0;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-t") && i + 1 < argc) duration = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-j") && i + 1 < argc) nw = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-s") && i + 1 < argc) seed = strtoull(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-o") && i + 1 < argc) outdir = argv[++i];
+        else {
+            fprintf(stderr, "usage: rom_fuzz [-t sec] [-j workers] [-s seed] [-o dir]\n");
+            return 2;
+        }
+    }
+    if (nw < 1) nw = 1;
+    if (nw > MAX_WORKERS) nw = MAX_WORKERS;
+
+    sh = mmap(NULL, sizeof(*sh), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (sh == MAP_FAILED) { perror("mmap"); return 1; }
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (w = 0; w < nw; w++) {
+        pid[w] = fork();
+        if (pid[w] < 0) { perror("fork"); return 1; }
+        if (pid[w] == 0) {
+            struct fuzzer *f = calloc(1, sizeof(*f));
+            f->corpus = malloc(sizeof(*f->corpus) * CORPUS_MAX);
+            cpu15_reset(&f->snap);
+            f->cpu = f->snap;
+            f->rng = (seed + 1) * 0x9e3779b97f4a7c15ull ^ (uint64_t)(w + 1) * 0xd1342543de82ef95ull;
+            if (f->rng == 0) f->rng = 1;
+            f->sh = sh;
+            f->id = w;
+            f->outdir = outdir;
+            fuzz_loop(f);
+            _exit(0);
+        }
+    }
+
+    /* 1秒ごとに途中経過を表示し、時間が来たら全ワーカを止める */
+    printf("     sec        execs     execs/s  corpus  edges  halts%%\n");
+    while (sec < duration) {
+        usleep(duration - sec < 1 ? (useconds_t)((duration - sec) * 1e6) : 1000000);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        sec = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9;
+        {
+            long ex = __atomic_load_n(&sh->execs, __ATOMIC_RELAXED);
+            long h = __atomic_load_n(&sh->halts, __ATOMIC_RELAXED);
+            long to = __atomic_load_n(&sh->timeouts, __ATOMIC_RELAXED);
+            printf("  %6.1f  %11ld  %10.0f  %6ld  %5ld  %5.1f\n", sec, ex, ex / sec,
+                   __atomic_load_n(&sh->corpus, __ATOMIC_RELAXED), count_edges(sh),
+                   h + to ? 100.0 * h / (h + to) : 0.0);
+        }
+    }
+    sh->stop = 1;
+    for (w = 0; w < nw; w++) waitpid(pid[w], NULL, 0);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    sec = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9;
+
+    printf("\n%d workers, %ld execs in %.2f sec (%.2f M execs/s)\n", nw, sh->execs, sec, sh->execs / sec / 1e6);
+    printf("corpus %ld, edges %ld / %d, halted %ld, timeout %ld\n",
+           sh->corpus, count_edges(sh), EDGE_MAP, sh->halts, sh->timeouts);
+    return 0;
+}
+
+/*
+  【GNUでのコンパイル例（Ubuntu / gcc）】
+    gcc -O2 rom_fuzz.c -o rom_fuzz
+
+  【実行例】
+    ./rom_fuzz -t 30 -o corpus
+*/
@@ -0,0 +1,404 @@
+-- adder_nbit.vhd（詳細コメント版：任意ビット幅の加算器ライブラリ
+--                  ripple / carry-lookahead / Kogge-Stone / Brent-Kung）
+--
+-- 【このモジュールの目的（自作CPU観点）】
+-- - full_adder.vhd の冒頭で触れたとおり、全加算器を直列につないだリップルキャリー加算器は
+--   キャリーがビット幅分だけ順に伝わるので、16bit/32bit になると ALU の加算がクリティカルパスになる。
+-- - 本ファイルは、同じ entity（adder_nbit）のまま generic ARCH で内部構造を選べる加算器を提供する。
+--   exec.vhd の ADD はこの entity を使い、構造の違いによる速度・面積を generic 1つで比べられる。
+--
+--     ARCH = ADDER_RIPPLE      : full_adder を N 個直列につなぐ（段数 N。面積最小）
+--     ARCH = ADDER_CLA         : 4bit ごとのキャリー先読み（ブロック内は2段、ブロック間は1段ずつ）
+--     ARCH = ADDER_KOGGE_STONE : 並列プレフィックス。段数 log2(N)、配線と面積は最大
+--     ARCH = ADDER_BRENT_KUNG  : 並列プレフィックス。段数 2*log2(N)-1、結合セルは 2N 個未満
+--
+--   それ以外の ARCH の値は ADDER_RIPPLE と同じ扱いにする。
+--
+-- 【生成・伝播（G/P）による見方】
+-- - ビット i ごとに
+--     G(i) = A(i) and B(i)   … このビットだけで桁上がりを“生成”する
+--     P(i) = A(i) xor B(i)   … 下からの桁上がりをそのまま上へ“伝播”する
+--   を作ると、ビット i の上へ出るキャリーは
+--     C(i+1) = G(i) or (P(i) and C(i))
+--   で、和は S(i) = P(i) xor C(i) になる。リップルはこの式をそのまま N 段つなぐ。
+-- - 区間 [j..i] の (G, P) は、上側 (Gh, Ph) と下側 (Gl, Pl) から
+--     (Gh, Ph) ∘ (Gl, Pl) = (Gh or (Ph and Gl), Ph and Pl)
+--   で合成できる。∘ は結合法則を満たすので、全ビットの [0..i] を求める問題は
+--   「プレフィックス和（scan）」になり、木にすれば log2(N) 段で解ける。
+--   CI は最下位ビットの生成に G(0) or (P(0) and CI) として繰り込めば、
+--   [0..i] の生成がそのまま C(i+1) になる。
+--
+-- 【各方式の構造】
+-- - CLA：4bit ブロックの中では C(4k+1..4k+3) と、ブロックの生成 GG・伝播 PG を
+--   ブロックのキャリー入力 C(4k) から2段の AND-OR で直接求める（展開した先読み式）。
+--   ブロック間は C(4k+4) = GG or (PG and C(4k)) の1段ずつ伝わるので、
+--   16bit なら 4 ブロック分の段数で済む。N が 4 の倍数でないときは上を 0 で埋めて計算する。
+-- - Kogge-Stone（prefix_ks）：距離 D = 1, 2, 4, ... の段ごとに、すべての i >= D で
+--   (i) ∘ (i-D) をとる。各段の再帰は prefix_ks 自身を D*2 でインスタンスして表す。
+-- - Brent-Kung（prefix_bk）：上り（D = 1, 2, 4, ... で i+1 が 2D の倍数の位置だけ合成）で
+--   2 のべき乗の位置を完成させ、下り（i+1 ≡ D (mod 2D) の位置を、すぐ下の完成済みの位置と合成）で
+--   残りを埋める。こちらも1段ずつ prefix_bk 自身をインスタンスする。
+--
+-- 【使い方】
+-- - 解析順：half_adder.vhd → full_adder.vhd → 本ファイル（package と entity をまとめて含む）。
+-- - 使う側は `use work.adder_nbit_pkg.all;` で ADDER_xxx の名前を参照できる。
+-- - 全方式の一致は chapter05/adder_nbit_sim.vhd で確かめる（小さい幅は全入力、16/32bit は乱数）。
+
+
+library IEEE;
+use IEEE.std_logic_1164.all;
+
+-- ============================================================
+-- package: 方式の番号（adder_nbit の generic ARCH に渡す）
+-- ============================================================
+package adder_nbit_pkg is
+
+    constant ADDER_RIPPLE      : integer := 0;
+    constant ADDER_CLA         : integer := 1;
+    constant ADDER_KOGGE_STONE : integer := 2;
+    constant ADDER_BRENT_KUNG  : integer := 3;
+
+end adder_nbit_pkg;
+
+
+library IEEE;
+use IEEE.std_logic_1164.all;
+
+-- ============================================================
+-- prefix_ks: Kogge-Stone の距離 D の段（と、それより上の段）
+-- ============================================================
+-- - GI/PI はビット i について区間 [i-D+1 .. i]（下端は 0 で打ち切り）の (G, P)。
+-- - GO は区間 [0 .. i] の生成、すなわちビット i の上へ出るキャリー。
+entity prefix_ks is
+    generic(
+        N : integer := 16;
+        D : integer := 1
+    );
+    port(
+        GI : in  std_logic_vector(N - 1 downto 0);
+        PI : in  std_logic_vector(N - 1 downto 0);
+        GO : out std_logic_vector(N - 1 downto 0)
+    );
+end prefix_ks;
+
+architecture RTL of prefix_ks is
+
+    component prefix_ks
+        generic(
+            N : integer := 16;
+            D : integer := 1
+        );
+        port(
+            GI : in  std_logic_vector(N - 1 downto 0);
+            PI : in  std_logic_vector(N - 1 downto 0);
+            GO : out std_logic_vector(N - 1 downto 0)
+        );
+    end component;
+
+    -- この段の合成結果（区間が 2D に伸びる）
+    signal GN : std_logic_vector(N - 1 downto 0);
+    signal PN : std_logic_vector(N - 1 downto 0);
+
+begin
+
+    -- 距離 D の位置がない（D >= N）なら、もう区間は [0 .. i] になっている
+    DONE : if D >= N generate
+        GO <= GI;
+    end generate;
+
+    STAGE : if D < N generate
+
+        -- i < D は下にもう合成する相手がない
+        LO : for I in 0 to D - 1 generate
+            GN(I) <= GI(I);
+            PN(I) <= PI(I);
+        end generate;
+
+        -- (i) ∘ (i-D)
+        HI : for I in D to N - 1 generate
+            GN(I) <= GI(I) or (PI(I) and GI(I - D));
+            PN(I) <= PI(I) and PI(I - D);
+        end generate;
+
+        -- 次の段（距離 2D）。最後の段の出力がそのまま GO になる
+        NXT : if 2 * D < N generate
+            U : prefix_ks
+                generic map(N => N, D => 2 * D)
+                port map(GI => GN, PI => PN, GO => GO);
+        end generate;
+
+        LAST : if 2 * D >= N generate
+            GO <= GN;
+        end generate;
+
+    end generate;
+
+end RTL;
+
+
+library IEEE;
+use IEEE.std_logic_1164.all;
+
+-- ============================================================
+-- prefix_bk: Brent-Kung の距離 D の上り段・下り段（と、その間の上位の段）
+-- ============================================================
+-- - GI/PI は i+1 が D の倍数の位置で区間 [i-D+1 .. i] の (G, P)。それ以外の位置は素通しする。
+-- - GO は i+1 が D の倍数の位置で区間 [0 .. i] の生成（＝キャリー）。
+--   それ以外の位置は GI のまま（より D の小さい段の下り段が埋める）。
+entity prefix_bk is
+    generic(
+        N : integer := 16;
+        D : integer := 1
+    );
+    port(
+        GI : in  std_logic_vector(N - 1 downto 0);
+        PI : in  std_logic_vector(N - 1 downto 0);
+        GO : out std_logic_vector(N - 1 downto 0)
+    );
+end prefix_bk;
+
+architecture RTL of prefix_bk is
+
+    component prefix_bk
+        generic(
+            N : integer := 16;
+            D : integer := 1
+        );
+        port(
+            GI : in  std_logic_vector(N - 1 downto 0);
+            PI : in  std_logic_vector(N - 1 downto 0);
+            GO : out std_logic_vector(N - 1 downto 0)
+        );
+    end component;
+
+    -- 上り段の結果（i+1 が 2D の倍数の位置の区間が 2D に伸びる）
+    signal GU : std_logic_vector(N - 1 downto 0);
+    signal PU : std_logic_vector(N - 1 downto 0);
+
+    -- 上位の段から戻ってきた結果（i+1 が 2D の倍数の位置が [0 .. i] になっている）
+    signal GV : std_logic_vector(N - 1 downto 0);
+
+begin
+
+    -- 合成する組がない（2D > N）なら、i+1 が D の倍数の位置は i = D-1 だけで、すでに [0 .. D-1]
+    DONE : if 2 * D > N generate
+        GO <= GI;
+    end generate;
+
+    STAGE : if 2 * D <= N generate
+
+        -- 上り段：i+1 が 2D の倍数の位置だけ (i) ∘ (i-D)
+        UP : for I in 0 to N - 1 generate
+            UC : if (I + 1) mod (2 * D) = 0 generate
+                GU(I) <= GI(I) or (PI(I) and GI(I - D));
+                PU(I) <= PI(I) and PI(I - D);
+            end generate;
+            UT : if (I + 1) mod (2 * D) /= 0 generate
+                GU(I) <= GI(I);
+                PU(I) <= PI(I);
+            end generate;
+        end generate;
+
+        -- 距離 2D の段（上り段で合成する位置 4D-1 が範囲にあるときだけ）
+        NXT : if 4 * D <= N generate
+            U : prefix_bk
+                generic map(N => N, D => 2 * D)
+                port map(GI => GU, PI => PU, GO => GV);
+        end generate;
+
+        LAST : if 4 * D > N generate
+            GV <= GU;
+        end generate;
+
+        -- 下り段：i+1 ≡ D (mod 2D) の位置は、区間 [i-D+1 .. i] と完成済みの [0 .. i-D] を合成する。
+        -- i = D-1 は最初から [0 .. D-1] なので合成しない（i >= 3D-1 だけ）
+        DOWN : for I in 0 to N - 1 generate
+            DF : if (I + 1) mod (2 * D) = 0 generate
+                GO(I) <= GV(I);
+            end generate;
+            DC : if (I + 1) mod (2 * D) = D and I >= 3 * D - 1 generate
+                GO(I) <= GI(I) or (PI(I) and GV(I - D));
+            end generate;
+            DT : if (I + 1) mod (2 * D) /= 0 and not ((I + 1) mod (2 * D) = D and I >= 3 * D - 1) generate
+                GO(I) <= GI(I);
+            end generate;
+        end generate;
+
+    end generate;
+
+end RTL;
+
+
+library IEEE;
+use IEEE.std_logic_1164.all;
+use work.adder_nbit_pkg.all;
+
+-- ============================================================
+-- adder_nbit: N bit 加算器（S = A + B + CI、CO は最上位のキャリー）
+-- ============================================================
+entity adder_nbit is
+    generic(
+        -- N: ビット幅（1 以上）
+        N    : integer := 16;
+
+        -- ARCH: 内部構造（adder_nbit_pkg の ADDER_xxx）
+        ARCH : integer := ADDER_RIPPLE
+    );
+    port(
+        A  : in  std_logic_vector(N - 1 downto 0);
+        B  : in  std_logic_vector(N - 1 downto 0);
+        CI : in  std_logic;
+        S  : out std_logic_vector(N - 1 downto 0);
+        CO : out std_logic
+    );
+end adder_nbit;
+
+architecture RTL of adder_nbit is
+
+    component full_adder
+        port(
+            A  : in  std_logic;
+            B  : in  std_logic;
+            CI : in  std_logic;
+            S  : out std_logic;
+            CO : out std_logic
+        );
+    end component;
+
+    component prefix_ks
+        generic(
+            N : integer := 16;
+            D : integer := 1
+        );
+        port(
+            GI : in  std_logic_vector(N - 1 downto 0);
+            PI : in  std_logic_vector(N - 1 downto 0);
+            GO : out std_logic_vector(N - 1 downto 0)
+        );
+    end component;
+
+    component prefix_bk
+        generic(
+            N : integer := 16;
+            D : integer := 1
+        );
+        port(
+            GI : in  std_logic_vector(N - 1 downto 0);
+            PI : in  std_logic_vector(N - 1 downto 0);
+            GO : out std_logic_vector(N - 1 downto 0)
+        );
+    end component;
+
+    -- 方式の判定（ARCH が未知の値ならリップル）
+    constant IS_CLA : boolean := ARCH = ADDER_CLA;
+    constant IS_PFX : boolean := ARCH = ADDER_KOGGE_STONE or ARCH = ADDER_BRENT_KUNG;
+    constant IS_RIP : boolean := not IS_CLA and not IS_PFX;
+
+    -- CLA のブロック数（4bit ごと。端数は上を 0 で埋める）
+    constant NG : integer := (N + 3) / 4;
+
+    -- ビットごとの生成・伝播と、各ビットへ入るキャリー C(i)（C(N) が CO）
+    signal G  : std_logic_vector(N - 1 downto 0);
+    signal P  : std_logic_vector(N - 1 downto 0);
+    signal C  : std_logic_vector(N downto 0);
+
+    -- プレフィックス方式：CI を G(0) に繰り込んだ生成
+    signal GC : std_logic_vector(N - 1 downto 0);
+
+    -- CLA：4*NG bit に広げた生成・伝播、各ビットのキャリー、ブロックの生成・伝播
+    signal GX : std_logic_vector(4 * NG - 1 downto 0);
+    signal PX : std_logic_vector(4 * NG - 1 downto 0);
+    signal CX : std_logic_vector(4 * NG downto 0);
+    signal GG : std_logic_vector(NG - 1 downto 0);
+    signal PG : std_logic_vector(NG - 1 downto 0);
+
+begin
+
+    G    <= A and B;
+    P    <= A xor B;
+    C(0) <= CI;
+    CO   <= C(N);
+
+    -- ========================================================
+    -- リップル：full_adder を N 個直列に（chapter05 の基本セルそのもの）
+    -- ========================================================
+    RIP : if IS_RIP generate
+        BIT_I : for I in 0 to N - 1 generate
+            FA : full_adder
+                port map(
+                    A  => A(I),
+                    B  => B(I),
+                    CI => C(I),
+                    S  => S(I),
+                    CO => C(I + 1)
+                );
+        end generate;
+    end generate;
+
+    -- リップル以外は、キャリーがそろってから和を一度に作る
+    SUM : if not IS_RIP generate
+        S <= P xor C(N - 1 downto 0);
+    end generate;
+
+    -- ========================================================
+    -- CLA：4bit ブロックごとの先読み
+    -- ========================================================
+    CLA : if IS_CLA generate
+        GX(N - 1 downto 0) <= G;
+        PX(N - 1 downto 0) <= P;
+        PAD : if 4 * NG > N generate
+            GX(4 * NG - 1 downto N) <= (others => '0');
+            PX(4 * NG - 1 downto N) <= (others => '0');
+        end generate;
+        CX(0) <= CI;
+
+        BLK : for K in 0 to NG - 1 generate
+            -- ブロック内のキャリーは、ブロックのキャリー入力 CX(4K) から直接（2段の AND-OR）
+            CX(4 * K + 1) <= GX(4 * K) or (PX(4 * K) and CX(4 * K));
+            CX(4 * K + 2) <= GX(4 * K + 1) or (PX(4 * K + 1) and GX(4 * K)) or
+                             (PX(4 * K + 1) and PX(4 * K) and CX(4 * K));
+            CX(4 * K + 3) <= GX(4 * K + 2) or (PX(4 * K + 2) and GX(4 * K + 1)) or
+                             (PX(4 * K + 2) and PX(4 * K + 1) and GX(4 * K)) or
+                             (PX(4 * K + 2) and PX(4 * K + 1) and PX(4 * K) and CX(4 * K));
+
+            -- ブロックの生成・伝播と、次のブロックへのキャリー
+            GG(K) <= GX(4 * K + 3) or (PX(4 * K + 3) and GX(4 * K + 2)) or
+                     (PX(4 * K + 3) and PX(4 * K + 2) and GX(4 * K + 1)) or
+                     (PX(4 * K + 3) and PX(4 * K + 2) and PX(4 * K + 1) and GX(4 * K));
+            PG(K) <= PX(4 * K + 3) and PX(4 * K + 2) and PX(4 * K + 1) and PX(4 * K);
+            CX(4 * K + 4) <= GG(K) or (PG(K) and CX(4 * K));
+        end generate;
+
+        C(N downto 1) <= CX(N downto 1);
+    end generate;
+
+    -- ========================================================
+    -- 並列プレフィックス：CI を G(0) に繰り込み、[0 .. i] の生成を C(i+1) にする
+    -- ========================================================
+    PFX : if IS_PFX generate
+        GC(0) <= G(0) or (P(0) and CI);
+        GHI : for I in 1 to N - 1 generate
+            GC(I) <= G(I);
+        end generate;
+
+        KS : if ARCH = ADDER_KOGGE_STONE generate
+            U : prefix_ks
+                generic map(N => N, D => 1)
+                port map(GI => GC, PI => P, GO => C(N downto 1));
+        end generate;
+
+        BK : if ARCH = ADDER_BRENT_KUNG generate
+            U : prefix_bk
+                generic map(N => N, D => 1)
+                port map(GI => GC, PI => P, GO => C(N downto 1));
+        end generate;
+    end generate;
+
+end RTL;
+
+-- 【段数の目安（N = 16、AND-OR を1段と数える）】
+-- - ripple       : 16 段（full_adder の CO が順に伝わる）
+-- - CLA          : ブロック内 2 段 + ブロック間 4 段
+-- - Kogge-Stone  : 4 段（結合セル 49 個）
+-- - Brent-Kung   : 7 段（結合セル 26 個）
+-- FPGA では専用キャリーチェーンがリップルを速くするので、合成結果のタイミングで比べること。
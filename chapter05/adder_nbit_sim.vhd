@@ -0,0 +1,260 @@
+-- adder_nbit_sim.vhd（詳細コメント版：adder_nbit の4方式を振る舞いの + と突き合わせるテストベンチ）
+--
+-- 【このファイルの目的】
+-- - adder_nbit の ripple / CLA / Kogge-Stone / Brent-Kung が、どの幅でも
+--   ('0' & A) + ('0' & B) + CI（std_logic_unsigned の +）と同じ S・CO を出すことを assert で確かめる。
+-- - 幅ごとの検査は adder_nbit_chk にまとめ、トップ adder_nbit_sim がいくつかの幅で並べて動かす。
+--     N <= N_EXH  : A・B・CI の全組み合わせ（2^(2N+1) 通り）
+--     N >  N_EXH  : uniform（ieee.math_real）で作った乱数 N_RAND 組
+-- - 4方式は同じ A・B・CI を受けるので、1つの入力で4つを同時に検査する。
+--
+-- 【使い方】
+-- - 解析順：half_adder.vhd → full_adder.vhd → adder_nbit.vhd → 本ファイル。トップは adder_nbit_sim。
+-- - 既定では 1/4/5/8bit を全入力、16/32bit を 20000 組ずつ検査する（1組 1ns）。
+
+
+library IEEE;
+use IEEE.std_logic_1164.all;
+use IEEE.std_logic_arith.all;
+use IEEE.std_logic_unsigned.all;
+use IEEE.math_real.all;
+use work.adder_nbit_pkg.all;
+
+-- ============================================================
+-- adder_nbit_chk: N bit の4方式を1組ずつ検査する
+-- ============================================================
+entity adder_nbit_chk is
+    generic(
+        N      : integer := 4;
+        N_EXH  : integer := 8;          -- この幅までは全入力
+        N_RAND : integer := 20000;      -- それより広いときの乱数の組数
+        SEED   : integer := 1
+    );
+    port(
+        FINISHED : out boolean;
+        N_ERR    : out integer
+    );
+end adder_nbit_chk;
+
+architecture SIM of adder_nbit_chk is
+
+    component adder_nbit
+        generic(
+            N    : integer := 16;
+            ARCH : integer := ADDER_RIPPLE
+        );
+        port(
+            A  : in  std_logic_vector(N - 1 downto 0);
+            B  : in  std_logic_vector(N - 1 downto 0);
+            CI : in  std_logic;
+            S  : out std_logic_vector(N - 1 downto 0);
+            CO : out std_logic
+        );
+    end component;
+
+    -- 方式番号（ADDER_xxx）ごとの出力。CO を上に付けて N+1 bit で持つ
+    type RESULTS is array (0 to 3) of std_logic_vector(N downto 0);
+
+    constant NAMES : string := "RIP CLA KS  BK  ";
+
+    signal A   : std_logic_vector(N - 1 downto 0) := (others => '0');
+    signal B   : std_logic_vector(N - 1 downto 0) := (others => '0');
+    signal CI  : std_logic := '0';
+    signal RES : RESULTS;
+
+begin
+
+    DUT : for K in 0 to 3 generate
+        U : adder_nbit
+            generic map(N => N, ARCH => K)
+            port map(
+                A  => A,
+                B  => B,
+                CI => CI,
+                S  => RES(K)(N - 1 downto 0),
+                CO => RES(K)(N)
+            );
+    end generate;
+
+    process
+        variable s1, s2  : positive := SEED;
+        variable r       : real;
+        variable exp_v   : std_logic_vector(N downto 0);
+        variable n_vec   : integer;
+        variable err     : integer := 0;
+        variable av, bv  : std_logic_vector(N - 1 downto 0);
+
+        -- 0 .. 2^k-1 の乱数（k <= 16）
+        impure function rand_bits(k : integer) return std_logic_vector is
+        begin
+            uniform(s1, s2, r);
+            return conv_std_logic_vector(integer(trunc(r * real(2 ** k))), k);
+        end function;
+
+        -- N bit の乱数（16bit ずつ詰める）
+        impure function rand_vec return std_logic_vector is
+            variable v : std_logic_vector(N - 1 downto 0);
+            variable i : integer := 0;
+        begin
+            while (i < N) loop
+                if (N - i >= 16) then
+                    v(i + 15 downto i) := rand_bits(16);
+                    i := i + 16;
+                else
+                    v(N - 1 downto i) := rand_bits(N - i);
+                    i := N;
+                end if;
+            end loop;
+            return v;
+        end function;
+
+        -- 2進の文字列（32bit は integer に入らないので conv_integer で表示できない）
+        function bits(v : std_logic_vector) return string is
+            variable t : string(1 to v'length);
+            variable j : integer := 1;
+        begin
+            for i in v'range loop
+                t(j) := std_logic'image(v(i))(2);
+                j := j + 1;
+            end loop;
+            return t;
+        end function;
+
+        -- いまの A・B・CI で4方式を期待値と比べる
+        procedure check is
+        begin
+            exp_v := ('0' & A) + ('0' & B) + CI;
+            for k in 0 to 3 loop
+                if (RES(k) /= exp_v) then
+                    err := err + 1;
+                    assert err > 10                 -- 最初の 10 個だけ表示する
+                        report "N=" & integer'image(N) & " " & NAMES(4 * k + 1 to 4 * k + 3) &
+                               ": A=" & bits(A) & " B=" & bits(B) & " CI=" & std_logic'image(CI) &
+                               " の結果が違う（CO&S=" & bits(RES(k)) & "、期待値 " & bits(exp_v) & "）"
+                        severity error;
+                end if;
+            end loop;
+        end procedure;
+
+    begin
+        FINISHED <= false;
+        N_ERR    <= 0;
+
+        if (N <= N_EXH) then
+            -- 全入力：CI・B・A の順に回す
+            n_vec := 0;
+            for c in 0 to 1 loop
+                for bi in 0 to 2 ** N - 1 loop
+                    for ai in 0 to 2 ** N - 1 loop
+                        A  <= conv_std_logic_vector(ai, N);
+                        B  <= conv_std_logic_vector(bi, N);
+                        if (c = 0) then CI <= '0'; else CI <= '1'; end if;
+                        wait for 1 ns;
+                        check;
+                        n_vec := n_vec + 1;
+                    end loop;
+                end loop;
+            end loop;
+        else
+            -- 乱数。最初の数組はキャリーが全桁を通る端の値にする
+            n_vec := 0;
+            for i in 0 to N_RAND - 1 loop
+                if (i = 0) then
+                    av := (others => '1'); bv := (others => '0'); CI <= '1';
+                elsif (i = 1) then
+                    av := (others => '1'); bv := (others => '1'); CI <= '1';
+                elsif (i = 2) then
+                    av := (others => '0'); bv := (others => '0'); CI <= '0';
+                else
+                    av := rand_vec;
+                    bv := rand_vec;
+                    uniform(s1, s2, r);
+                    if (r < 0.5) then CI <= '0'; else CI <= '1'; end if;
+                end if;
+                A <= av;
+                B <= bv;
+                wait for 1 ns;
+                check;
+                n_vec := n_vec + 1;
+            end loop;
+        end if;
+
+        assert err = 0
+            report "N=" & integer'image(N) & ": " & integer'image(err) & " 個の結果が違う"
+            severity error;
+        if (err = 0) then
+            report "N=" & integer'image(N) & ": 4方式とも一致（" & integer'image(n_vec) & " 組）"
+                severity note;
+        end if;
+
+        N_ERR    <= err;
+        FINISHED <= true;
+        wait;
+    end process;
+
+end SIM;
+
+
+library IEEE;
+use IEEE.std_logic_1164.all;
+
+-- ============================================================
+-- adder_nbit_sim: いくつかの幅で adder_nbit_chk を並べる
+-- ============================================================
+entity adder_nbit_sim is
+end adder_nbit_sim;
+
+architecture SIM of adder_nbit_sim is
+
+    component adder_nbit_chk
+        generic(
+            N      : integer := 4;
+            N_EXH  : integer := 8;
+            N_RAND : integer := 20000;
+            SEED   : integer := 1
+        );
+        port(
+            FINISHED : out boolean;
+            N_ERR    : out integer
+        );
+    end component;
+
+    -- 検査する幅（8 までは全入力、それより上は乱数）
+    type WIDTHS is array (0 to 5) of integer;
+    constant W : WIDTHS := (1, 4, 5, 8, 16, 32);
+
+    type FLAGS is array (0 to 5) of boolean;
+    type COUNTS is array (0 to 5) of integer;
+    constant ALL_DONE : FLAGS := (others => true);
+    signal FIN : FLAGS;
+    signal ERR : COUNTS;
+
+begin
+
+    CHK : for I in 0 to 5 generate
+        U : adder_nbit_chk
+            generic map(N => W(I), SEED => I + 1)
+            port map(FINISHED => FIN(I), N_ERR => ERR(I));
+    end generate;
+
+    process
+        variable total : integer := 0;
+    begin
+        wait until FIN = ALL_DONE;
+        for i in 0 to 5 loop
+            total := total + ERR(i);
+        end loop;
+        assert total = 0
+            report "adder_nbit: 合計 " & integer'image(total) & " 個の不一致"
+            severity error;
+        if (total = 0) then
+            report "adder_nbit: すべての幅・方式で + と一致" severity note;
+        end if;
+        wait;
+    end process;
+
+end SIM;
+
+-- 【期待される結果】
+-- - 幅ごとに「4方式とも一致」の note が出て、最後に「すべての幅・方式で + と一致」が出る。
+-- - 8bit の全入力は 2^17 組なので約 131us、他の幅はそれより短い。
@@ -0,0 +1,859 @@
+/*
+  bitsim.c（ビット並列ゲートレベルシミュレータ / chapter05 のネットリストの全入力検査）
+
+  【このプログラムの位置づけ】
+  - half_adder / full_adder / adder_4bit_lib / and_or / count_nbit のような小さなブロックを
+    GHDL の波形で全入力確かめると、1ブロックに何分もかかる。
+  - 本プログラムは vhdl2c と同じフロントエンド（vhdl_front.c）で port map の構造を読んで
+    フラットな回路にし、64 本のテストベクタを 64bit ワード1つに詰めて同時に評価する
+    （ビット並列の論理シミュレーション）。adder_4bit_lib の全 256 通りはワード 4 個分で終わる。
+  - 出力はブロックごとの参照関数（C の算術で書いた期待値）とレーンごとに突き合わせ、
+    食い違いを報告する。
+  - -f を付けると、cpu15 のような大きな回路で 64 レーンを 64 台の別々の回路として使い、
+    レーンごとに違う縮退故障を入れて、故障が出力に現れるかを一度に調べる。
+
+  【値の持ち方（ビットスライス）】
+  - 信号の各ビットを uint64_t 1語で持ち、その語のビット l を「レーン l（l 本目のベクタ）の値」とする。
+      v[i] のビット l = レーン l における信号のビット i
+  - AND/OR/XOR/NOT は語どうしの演算1回で 64 レーン分になる。
+    + / - はビット 0 から順にキャリー語を伝える（リップル）。比較は借りの連鎖で求める。
+  - if / case は「どのレーンがこの枝を通るか」のマスク語を持って両方の枝を実行し、
+    代入はマスクの立っているレーンだけに書く。
+  - クロックのエッジもレーンごと（CLK の語と前回値から求めたマスク）に扱う。
+
+  【実行モデル】
+  - vhdl2c が生成するモデルと同じ2相のデルタ（全プロセスを現在値で評価 → 一括コミット）を、
+    変化がなくなるまで繰り返す。std_logic は 2値で 'U' は 0 とみなす（同じ前提）。
+
+  【検査のしかた】
+  - 組合せ回路（-c の名前のクロック入力がないもの）：
+      入力ポートのビットを宣言順に並べた合計 n ビットが -x 以下なら 2^n 通りをすべて、
+      それより多ければ乱数で -n 本を評価する。
+  - 順序回路（クロック入力があるもの）：
+      64 レーンに -t サイクルぶん乱数の入力を与え、毎サイクル立ち上がりの後の出力を比べる。
+      1bit の入力（RST など）は、レーン 8g..8g+7 で 1 になる確率を 1/2^(g+1) にする
+      （リセットがほとんど来ないレーンでもカウンタが一周する）。
+  - 参照関数は refs[]（entity 名・入出力ポート名・関数）に並べてある。
+
+  【故障シミュレーション（-f）】
+  - 64 レーンを「64 台の同じ回路」とみなし、レーン l にだけ縮退故障（stuck-at-0/1）を1つ入れる。
+    故障箇所は信号（配列なら要素）の1ビットで、プロセスが書いた次値にレーンごとのマスクで
+      v = (v & ~sa0) | sa1
+    をかけて固定する。1バッチ（ワード1つ分の実行）で 64 箇所の故障を同時に調べられる。
+  - 刺激は全レーン共通：-r の入力（既定 RESET_N）を最初の 8 サイクルだけ '0'、
+    -i NAME=VALUE の入力はその値、それ以外の入力は 0 にして、-t サイクル CLK を回す。
+  - 先に故障なしで1回流してトップの出力ポートの値を毎サイクル記録しておき（ゴールデン）、
+    各バッチではそれとレーンごとに比べる。
+      detected : どこかのサイクルで出力ポートがゴールデンと違った
+      latent   : 出力は最後まで同じだが、終了時にクロック同期プロセスの信号（レジスタ・RAM）が違う
+      silent   : どちらも同じ
+  - 故障を入れる信号は -p のインスタンス名（例：C6 → C6__ で始まる信号）で絞る。
+    指定がなければプロセスが駆動する全信号が対象になる。
+
+  【使い方】
+    bitsim [-x BITS] [-n N] [-t CYCLES] [-s SEED] [-c CLK] TOP file.vhd...
+      -x BITS   : 全入力を試す入力ビット数の上限（既定 24）
+      -n N      : 全入力にしないときの乱数ベクタ数（既定 1048576）
+      -t CYCLES : 順序回路のサイクル数（既定 4096）
+      -s SEED   : 乱数の種（既定 1）
+      -c CLK    : クロック入力の名前（既定 CLK）
+    bitsim -f [-p INST]... [-t CYCLES] [-r RST] [-i NAME=VALUE]... [-v] TOP file.vhd...
+      -f        : 故障シミュレーション（参照関数は使わない）
+      -p INST   : 故障を入れるインスタンス（繰り返し指定できる）
+      -r RST    : 負論理のリセット入力の名前（既定 RESET_N。なければ使わない）
+      -i N=V    : 入力ポート N に与える値
+      -v        : 検出できなかった故障を1つずつ表示する
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include "vhdl_front.h"
+
+#define MAXW 64                 // 信号の最大ビット幅（vhdl_front の制限と同じ）
+
+typedef uint64_t word;          // 64 レーン分の1ビット
+
+static struct vf_design *d;
+static word **cur;              // 信号ごとの現在値（ビットスライス。配列は要素 e のビット i が [e * w + i]）
+static word **nxt;              // デルタ中の次値（デルタの始めでは常に cur と同じ）
+static int *nw;                 // 信号ごとの語数（w × 要素数）
+static word *store;             // cur の実体（全信号を宣言順に並べたもの）
+static size_t nstore;
+static char *dirty;             // このデルタで代入された信号
+static word *prev_clk;          // クロック信号の前回値（ビット 0）
+static word *edge;              // このデルタで立ち上がったレーン
+
+/* レーンごとの縮退故障：信号 sig の語 k を sa0 のレーンで 0、sa1 のレーンで 1 に固定する */
+struct fault {
+    int sig, k;
+    word sa0, sa1;
+};
+
+static struct fault flt[64];
+static int nflt;
+
+/* ============================================================
+   式の評価
+   ============================================================ */
+static void ev(const struct vf_rx *r, word *o);
+
+/* r を評価して w ビットに合わせる（std_logic_unsigned と同じくゼロ拡張・上位切り捨て） */
+static void ev_w(const struct vf_rx *r, int w, word *o) {
+    word t[MAXW];
+    int i;
+    ev(r, t);
+    for (i = 0; i < w; i++) o[i] = i < r->w ? t[i] : 0;
+}
+
+/* i と等しい値を持つレーン（動的な添字 a(i) の選択に使う） */
+static word eq_const(const word *v, int w, uint64_t c) {
+    word m = ~(word)0;
+    int i;
+    for (i = 0; i < w; i++) m &= (c >> i) & 1 ? v[i] : ~v[i];
+    if (w < 64 && (c >> w)) m = 0;
+    return m;
+}
+
+/* 符号なしで a < b のレーン（a - b の借り） */
+static word lt(const word *a, const word *b, int w) {
+    word br = 0;
+    int i;
+    for (i = 0; i < w; i++) br = (~a[i] & b[i]) | (~(a[i] ^ b[i]) & br);
+    return br;
+}
+
+static void add(const word *a, const word *b, word c, int w, word *o) {
+    int i;
+    for (i = 0; i < w; i++) {
+        word p = a[i] ^ b[i];
+        o[i] = p ^ c;
+        c = (a[i] & b[i]) | (p & c);
+    }
+}
+
+static void ev(const struct vf_rx *r, word *o) {
+    word a[MAXW], b[MAXW];
+    int i, j, w = r->w;
+
+    switch (r->k) {
+    case RX_CONST:
+        for (i = 0; i < w; i++) o[i] = (r->val >> i) & 1 ? ~(word)0 : 0;
+        return;
+    case RX_SIG:
+        memcpy(o, cur[r->sig], sizeof(word) * (size_t)w);
+        return;
+    case RX_SLICE:
+        ev(r->a, a);
+        for (i = 0; i < w; i++) o[i] = r->lo + i < r->a->w ? a[r->lo + i] : 0;
+        return;
+    case RX_BIT:
+        ev(r->a, a);
+        ev(r->b, b);
+        o[0] = 0;
+        for (i = 0; i < r->a->w; i++) o[0] |= a[i] & eq_const(b, r->b->w, (uint64_t)i);
+        return;
+    case RX_CAT:
+        ev(r->b, o);
+        ev(r->a, o + r->b->w);
+        return;
+    case RX_NOT:
+        ev(r->a, a);
+        for (i = 0; i < w; i++) o[i] = ~a[i];
+        return;
+    case RX_MUX: {
+        word c;
+        ev(r->c, a);
+        c = a[0];
+        ev_w(r->a, w, a);
+        ev_w(r->b, w, b);
+        for (i = 0; i < w; i++) o[i] = (a[i] & c) | (b[i] & ~c);
+        return;
+    }
+    case RX_ELEM: {
+        /* 添字が e のレーンだけ要素 e を取り出す（範囲外の添字は 0） */
+        const struct vf_sig *s = &d->sigs[r->sig];
+        ev(r->a, a);
+        memset(o, 0, sizeof(word) * (size_t)w);
+        for (j = 0; j < s->len; j++) {
+            word m = eq_const(a, r->a->w, (uint64_t)(j + s->alo));
+            if (!m) continue;
+            for (i = 0; i < w; i++) o[i] |= cur[r->sig][j * s->w + i] & m;
+        }
+        return;
+    }
+    case RX_CARR: {
+        const struct vf_carr *c = &d->carrs[r->sig];
+        ev(r->a, a);
+        memset(o, 0, sizeof(word) * (size_t)w);
+        for (j = 0; j < c->len; j++) {
+            word m;
+            if (!c->v[j]) continue;
+            m = eq_const(a, r->a->w, (uint64_t)(j + c->alo));
+            for (i = 0; i < w; i++)
+                if ((c->v[j] >> i) & 1) o[i] |= m;
+        }
+        return;
+    }
+    }
+
+    /* RX_BIN */
+    switch (r->op) {
+    case OP_AND: case OP_OR: case OP_XOR: case OP_NAND: case OP_NOR: case OP_XNOR:
+        ev(r->a, a);
+        ev(r->b, b);
+        for (i = 0; i < w; i++) {
+            word x = r->op == OP_AND || r->op == OP_NAND ? a[i] & b[i] :
+                     r->op == OP_OR || r->op == OP_NOR ? a[i] | b[i] : a[i] ^ b[i];
+            o[i] = r->op >= OP_NAND ? ~x : x;
+        }
+        return;
+    case OP_EQ: case OP_NE: case OP_LT: case OP_LE: case OP_GT: case OP_GE: {
+        int cw = r->a->w > r->b->w ? r->a->w : r->b->w;
+        ev_w(r->a, cw, a);
+        ev_w(r->b, cw, b);
+        switch (r->op) {
+        case OP_EQ: o[0] = ~(word)0; for (i = 0; i < cw; i++) o[0] &= ~(a[i] ^ b[i]); break;
+        case OP_NE: o[0] = 0; for (i = 0; i < cw; i++) o[0] |= a[i] ^ b[i]; break;
+        case OP_LT: o[0] = lt(a, b, cw); break;
+        case OP_GE: o[0] = ~lt(a, b, cw); break;
+        case OP_GT: o[0] = lt(b, a, cw); break;
+        default:    o[0] = ~lt(b, a, cw); break;
+        }
+        return;
+    }
+    case OP_ADD: case OP_SUB:
+        ev_w(r->a, w, a);
+        ev_w(r->b, w, b);
+        if (r->op == OP_SUB) {
+            for (i = 0; i < w; i++) b[i] = ~b[i];
+            add(a, b, ~(word)0, w, o);
+        } else {
+            add(a, b, 0, w, o);
+        }
+        return;
+    case OP_MUL: {
+        /* シフト加算：b のビット j が立っているレーンだけ a << j を足す */
+        word p[MAXW], t[MAXW];
+        ev_w(r->a, w, a);
+        ev_w(r->b, w, b);
+        memset(p, 0, sizeof(word) * (size_t)w);
+        for (j = 0; j < w; j++) {
+            for (i = 0; i < w; i++) t[i] = i >= j ? a[i - j] & b[j] : 0;
+            add(p, t, 0, w, p);
+        }
+        memcpy(o, p, sizeof(word) * (size_t)w);
+        return;
+    }
+    }
+    vf_fatal("bitsim: operator %d is unsupported", r->op);
+}
+
+/* ============================================================
+   文の実行（m: この文を通るレーン）
+   ============================================================ */
+static void exec(const struct vf_rs *rs, word m);
+
+static void assign(const struct vf_rs *rs, word m) {
+    const struct vf_sig *s = &d->sigs[rs->sig];
+    word v[MAXW], *n = nxt[rs->sig];
+    int i;
+
+    dirty[rs->sig] = 1;
+    if (s->len) {
+        word x[MAXW];
+        int e;
+        ev(rs->idx, x);
+        ev_w(rs->val, s->w, v);
+        for (e = 0; e < s->len; e++) {
+            word me = m & eq_const(x, rs->idx->w, (uint64_t)(e + s->alo));
+            if (!me) continue;
+            for (i = 0; i < s->w; i++) n[e * s->w + i] = (n[e * s->w + i] & ~me) | (v[i] & me);
+        }
+    } else if (rs->w == 0) {
+        ev_w(rs->val, s->w, v);
+        for (i = 0; i < s->w; i++) n[i] = (n[i] & ~m) | (v[i] & m);
+    } else if (rs->idx == NULL) {
+        ev_w(rs->val, rs->w, v);
+        for (i = 0; i < rs->w; i++) n[rs->lo + i] = (n[rs->lo + i] & ~m) | (v[i] & m);
+    } else {
+        word x[MAXW];
+        ev(rs->idx, x);
+        ev_w(rs->val, 1, v);
+        for (i = 0; i < s->w; i++) {
+            word mi = m & eq_const(x, rs->idx->w, (uint64_t)i);
+            n[i] = (n[i] & ~mi) | (v[0] & mi);
+        }
+    }
+}
+
+static void exec(const struct vf_rs *rs, word m) {
+    const struct vf_arm *a;
+    word v[MAXW], left, am;
+    int i;
+
+    for (; rs && m; rs = rs->next) {
+        switch (rs->k) {
+        case RS_ASSIGN:
+            assign(rs, m);
+            break;
+        case RS_IF:
+            ev(rs->cond, v);
+            exec(rs->then_s, m & v[0]);
+            exec(rs->else_s, m & ~v[0]);
+            break;
+        default:
+            ev(rs->sel, v);
+            left = m;
+            for (a = rs->arms; a && left; a = a->next) {
+                if (a->others) {
+                    am = left;
+                } else {
+                    am = 0;
+                    for (i = 0; i < a->nch; i++) am |= eq_const(v, rs->sel->w, a->ch[i]);
+                    am &= left;
+                }
+                exec(a->body, am);
+                left &= ~am;
+            }
+            break;
+        }
+    }
+}
+
+/* ============================================================
+   デルタサイクル
+   ============================================================ */
+
+/* 故障のある語を固定する（all=0 ならこのデルタで代入された信号だけ） */
+static void force(word **v, int all) {
+    int i;
+    for (i = 0; i < nflt; i++) {
+        const struct fault *f = &flt[i];
+        if (all || dirty[f->sig]) v[f->sig][f->k] = (v[f->sig][f->k] & ~f->sa0) | f->sa1;
+    }
+}
+
+static int delta(void) {
+    int i, ch = 0;
+
+    for (i = 0; i < d->nsig; i++)
+        if (d->sigs[i].is_clock) {
+            edge[i] = cur[i][0] & ~prev_clk[i];
+            prev_clk[i] = cur[i][0];
+        }
+    memset(dirty, 0, (size_t)d->nsig);
+    for (i = 0; i < d->nproc; i++) {
+        const struct vf_proc *p = &d->procs[i];
+        exec(p->body, p->clk >= 0 ? edge[p->clk] : ~(word)0);
+    }
+    force(nxt, 0);
+    for (i = 0; i < d->nsig; i++)
+        if (dirty[i] && memcmp(nxt[i], cur[i], sizeof(word) * (size_t)nw[i])) {
+            memcpy(cur[i], nxt[i], sizeof(word) * (size_t)nw[i]);
+            ch = 1;
+        }
+    return ch;
+}
+
+static void settle(void) {
+    int n = 0;
+    while (delta())
+        if (++n > 1000) vf_fatal("bitsim: combinational loop does not settle");
+}
+
+static void init_state(void) {
+    int i, j;
+    for (i = 0; i < d->nsig; i++) {
+        const struct vf_sig *s = &d->sigs[i];
+        for (j = 0; j < nw[i]; j++) {
+            uint64_t v = !s->len ? s->init : s->inits ? s->inits[j / s->w] : 0;
+            cur[i][j] = (v >> (j % s->w)) & 1 ? ~(word)0 : 0;
+        }
+        prev_clk[i] = cur[i][0];
+    }
+    force(cur, 1);
+    for (i = 0; i < d->nsig; i++) memcpy(nxt[i], cur[i], sizeof(word) * (size_t)nw[i]);
+    settle();
+}
+
+/* CLK を 0 → 1 にしてそれぞれ落ち着かせる（1サイクル） */
+static void step(int clk) {
+    cur[clk][0] = 0;
+    settle();
+    cur[clk][0] = ~(word)0;
+    settle();
+}
+
+/* 信号 sig のレーン l の値 */
+static uint64_t lane(int sig, int l) {
+    uint64_t v = 0;
+    int i;
+    for (i = 0; i < d->sigs[sig].w; i++) v |= ((cur[sig][i] >> l) & 1) << i;
+    return v;
+}
+
+/* ============================================================
+   参照関数（ブロックごとの期待値）
+   in / out はポートの宣言順（順序回路ではクロックを除く）、w は in, out の順の幅。
+   st はレーンごとの状態（順序回路だけ使う。最初は 0）
+   ============================================================ */
+static uint64_t mask(int w) { return vf_mask(w); }
+
+static void ref_half_adder(const uint64_t *in, uint64_t *out, uint64_t *st, const int *w) {
+    (void)st; (void)w;
+    out[0] = in[0] ^ in[1];
+    out[1] = in[0] & in[1];
+}
+
+static void ref_full_adder(const uint64_t *in, uint64_t *out, uint64_t *st, const int *w) {
+    uint64_t s = in[0] + in[1] + in[2];
+    (void)st; (void)w;
+    out[0] = s & 1;
+    out[1] = s >> 1;
+}
+
+static void ref_adder_4bit(const uint64_t *in, uint64_t *out, uint64_t *st, const int *w) {
+    (void)st; (void)w;
+    out[0] = in[0] + in[1];
+}
+
+/* adder_nbit の N は 63 以下（内部のキャリー C(N downto 0) が 64bit に収まる幅） */
+static void ref_adder_nbit(const uint64_t *in, uint64_t *out, uint64_t *st, const int *w) {
+    uint64_t s = in[0] + in[1] + in[2];
+    (void)st;
+    out[0] = s & mask(w[0]);
+    out[1] = (s >> w[0]) & 1;
+}
+
+static void ref_and_or(const uint64_t *in, uint64_t *out, uint64_t *st, const int *w) {
+    (void)st; (void)w;
+    out[0] = in[0] & in[1];
+    out[1] = in[0] | in[1];
+}
+
+static void ref_dec_7seg(const uint64_t *in, uint64_t *out, uint64_t *st, const int *w) {
+    static const uint8_t seg[10] = { 0x40, 0x79, 0x24, 0x30, 0x19, 0x12, 0x02, 0x78, 0x00, 0x10 };
+    (void)st; (void)w;
+    out[0] = in[0] < 10 ? seg[in[0]] : 0x7f;
+}
+
+/* 同期リセット付きの 2^N 進カウンタ（count_nbit / count_16） */
+static void ref_count_nbit(const uint64_t *in, uint64_t *out, uint64_t *st, const int *w) {
+    *st = in[0] ? 0 : (*st + 1) & mask(w[1]);
+    out[0] = *st;
+}
+
+static void ref_count10(const uint64_t *in, uint64_t *out, uint64_t *st, const int *w) {
+    (void)w;
+    *st = in[0] || *st == 9 ? 0 : *st + 1;
+    out[0] = *st;
+}
+
+/* count10_2 は RST を使わない */
+static void ref_count10_2(const uint64_t *in, uint64_t *out, uint64_t *st, const int *w) {
+    (void)in; (void)w;
+    *st = *st == 9 ? 0 : *st + 1;
+    out[0] = *st;
+}
+
+static void ref_d_ff(const uint64_t *in, uint64_t *out, uint64_t *st, const int *w) {
+    (void)w;
+    *st = in[0];
+    out[0] = *st;
+}
+
+typedef void ref_fn(const uint64_t *in, uint64_t *out, uint64_t *st, const int *w);
+
+static const struct ref {
+    const char *top;
+    const char *ins, *outs;     // ポート名（宣言順、カンマ区切り。順序回路はクロックを除く）
+    int seq;                    // 順序回路か
+    ref_fn *fn;
+} refs[] = {
+    { "half_adder",     "A,B",      "S,CO",         0, ref_half_adder },
+    { "full_adder",     "A,B,CI",   "S,CO",         0, ref_full_adder },
+    { "adder_4bit_lib", "AIN,BIN",  "SOUT",         0, ref_adder_4bit },
+    { "adder_nbit",     "A,B,CI",   "S,CO",         0, ref_adder_nbit },
+    { "and_or",         "A,B",      "Z_AND,Z_OR",   0, ref_and_or },
+    { "dec_7seg",       "DIN",      "SEG7",         0, ref_dec_7seg },
+    { "count_nbit",     "RST",      "COUNT_N",      1, ref_count_nbit },
+    { "count_16",       "RST",      "COUNT_16",     1, ref_count_nbit },
+    { "count10",        "RST",      "COUNT",        1, ref_count10 },
+    { "count10_2",      "RST",      "COUNT",        1, ref_count10_2 },
+    { "d_ff",           "D",        "Q",            1, ref_d_ff },
+    { NULL, NULL, NULL, 0, NULL }
+};
+
+/* ============================================================
+   刺激と突き合わせ
+   ============================================================ */
+#define MAXP 16
+
+static int nin, nout, in_sig[MAXP], out_sig[MAXP], pw[2 * MAXP];
+static const struct ref *R;
+static long n_err;
+
+static uint64_t rng;
+static word rnd(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    return rng;
+}
+
+/* "A,B,CI" の各名前を信号番号にする。ポートの向きも確かめる */
+static int ports(const char *list, int dir, int *sig) {
+    char buf[128], *p, *save;
+    int n = 0;
+    snprintf(buf, sizeof(buf), "%s", list);
+    for (p = strtok_r(buf, ",", &save); p; p = strtok_r(NULL, ",", &save)) {
+        int s = vf_lookup(d, p);
+        if (s < 0 || d->sigs[s].dir != dir)
+            vf_fatal("bitsim: %s has no %s port '%s'", R->top, dir == VF_IN ? "input" : "output", p);
+        if (n == MAXP) vf_fatal("bitsim: too many ports");
+        sig[n++] = s;
+    }
+    return n;
+}
+
+/* valid のレーンについて、入力ポートの値から期待値を求めて出力と比べる */
+static void check(word valid, uint64_t *state) {
+    uint64_t in[MAXP], exp[MAXP], got;
+    int l, i;
+
+    for (l = 0; l < 64; l++) {
+        if (!((valid >> l) & 1)) continue;
+        for (i = 0; i < nin; i++) in[i] = lane(in_sig[i], l);
+        R->fn(in, exp, state ? &state[l] : NULL, pw);
+        for (i = 0; i < nout; i++) {
+            got = lane(out_sig[i], l);
+            exp[i] &= mask(d->sigs[out_sig[i]].w);
+            if (got == exp[i]) continue;
+            if (n_err++ < 10) {
+                int k;
+                printf("  mismatch:");
+                for (k = 0; k < nin; k++) printf(" %s=0x%llx", d->sigs[in_sig[k]].name, (unsigned long long)in[k]);
+                printf(" -> %s=0x%llx (expected 0x%llx)\n", d->sigs[out_sig[i]].name,
+                       (unsigned long long)got, (unsigned long long)exp[i]);
+            }
+        }
+    }
+}
+
+/* 組合せ回路：入力ビットを宣言順に並べて v = base + レーン番号 を与える */
+static long run_comb(long nvec, int exhaustive) {
+    static const word pat[6] = {
+        0xaaaaaaaaaaaaaaaaull, 0xccccccccccccccccull, 0xf0f0f0f0f0f0f0f0ull,
+        0xff00ff00ff00ff00ull, 0xffff0000ffff0000ull, 0xffffffff00000000ull
+    };
+    long base, batches = 0;
+    int i, j, k;
+
+    init_state();
+    for (base = 0; base < nvec; base += 64) {
+        word valid = nvec - base >= 64 ? ~(word)0 : (((word)1 << (nvec - base)) - 1);
+        k = 0;
+        for (i = 0; i < nin; i++)
+            for (j = 0; j < d->sigs[in_sig[i]].w; j++, k++)
+                cur[in_sig[i]][j] = !exhaustive ? rnd() :
+                                    k < 6 ? pat[k] : ((uint64_t)base >> k) & 1 ? ~(word)0 : 0;
+        settle();
+        check(valid, NULL);
+        batches++;
+    }
+    return batches;
+}
+
+/* 順序回路：64 レーンに cycles サイクル分の乱数入力を与える */
+static void run_seq(int clk, long cycles) {
+    static uint64_t state[64];
+    long t;
+    int i, j, g, k;
+
+    init_state();
+    for (t = 0; t < cycles; t++) {
+        for (i = 0; i < nin; i++) {
+            const struct vf_sig *s = &d->sigs[in_sig[i]];
+            if (s->w > 1) {
+                for (j = 0; j < s->w; j++) cur[in_sig[i]][j] = rnd();
+                continue;
+            }
+            cur[in_sig[i]][0] = 0;
+            for (g = 0; g < 8; g++) {
+                word r = ~(word)0;
+                for (k = 0; k <= g; k++) r &= rnd();
+                cur[in_sig[i]][0] |= r & ((word)0xff << (8 * g));
+            }
+        }
+        step(clk);
+        check(~(word)0, state);
+    }
+}
+
+/* ============================================================
+   故障シミュレーション
+   ============================================================ */
+struct site {
+    int sig, k, val;            // 信号 sig の語 k を val に固定する
+};
+
+static struct site *sites;
+static int nsites;
+static int nobs, obs[MAXP];     // 比べる出力ポート
+static word *gold_state;        // 故障なしで終わったときの全信号（全レーン同じ値）
+static uint64_t *gold_out;      // 故障なしの出力ポートの値（サイクル × ポート）
+
+/* -p で指定したインスタンスの信号か（inst__ で始まる） */
+static int in_inst(const char *name, char **inst, int ninst) {
+    int i;
+    if (ninst == 0) return 1;
+    for (i = 0; i < ninst; i++) {
+        size_t n = strlen(inst[i]);
+        if (!strncmp(name, inst[i], n) && !strncmp(name + n, "__", 2)) return 1;
+    }
+    return 0;
+}
+
+static void site_name(const struct site *st, char *buf, size_t n) {
+    const struct vf_sig *s = &d->sigs[st->sig];
+    if (s->len) snprintf(buf, n, "%s(%d)(%d)", s->name, st->k / s->w + s->alo, st->k % s->w);
+    else if (s->w > 1) snprintf(buf, n, "%s(%d)", s->name, st->k);
+    else snprintf(buf, n, "%s", s->name);
+}
+
+/* 全レーン共通の刺激を与えて cycles サイクル回す。
+   gold_out が NULL なら故障なしの実行として出力を記録し、そうでなければ比べて
+   出力が違ったレーンを返す（全レーンが違った時点で打ち切る）。*lat には検出までのサイクル数の和を足す */
+static word run_cycles(int clk, int rst, uint64_t *iv, long cycles, word valid, uint64_t *rec, double *lat) {
+    word det = 0;
+    long t;
+    int i, j;
+
+    init_state();
+    for (t = 0; t < cycles; t++) {
+        for (i = 0; i < d->nsig; i++)
+            if (d->sigs[i].dir == VF_IN && i != clk)
+                for (j = 0; j < d->sigs[i].w; j++) cur[i][j] = (iv[i] >> j) & 1 ? ~(word)0 : 0;
+        if (rst >= 0) cur[rst][0] = t < 8 ? 0 : ~(word)0;
+        step(clk);
+        for (i = 0; i < nobs; i++) {
+            if (rec) {
+                rec[t * nobs + i] = lane(obs[i], 0);
+            } else {
+                word x = 0, nd;
+                for (j = 0; j < d->sigs[obs[i]].w; j++)
+                    x |= cur[obs[i]][j] ^ ((gold_out[t * nobs + i] >> j) & 1 ? ~(word)0 : 0);
+                nd = x & valid & ~det;
+                *lat += (double)(t + 1) * __builtin_popcountll(nd);
+                det |= nd;
+            }
+        }
+        if (!rec && det == valid) break;
+    }
+    return det;
+}
+
+/* クロック同期プロセスが駆動する信号がゴールデンと違うレーン */
+static word state_diff(void) {
+    word x = 0;
+    int i, j;
+    for (i = 0; i < d->nsig; i++) {
+        if (d->sigs[i].driver < 0 || d->procs[d->sigs[i].driver].clk < 0) continue;
+        for (j = 0; j < nw[i]; j++) x |= cur[i][j] ^ gold_state[cur[i] - store + j];
+    }
+    return x;
+}
+
+static void run_faults(int clk, int rst, uint64_t *iv, long cycles, char **inst, int ninst, int verbose) {
+    long n_det = 0, n_lat = 0, n_sil = 0;
+    double lat = 0;
+    int i, k, b, l, nbatch;
+    char name[256];
+
+    for (i = 0; i < d->nsig; i++)
+        if (d->sigs[i].dir == VF_OUT) {
+            if (nobs == MAXP) vf_fatal("bitsim: too many output ports");
+            obs[nobs++] = i;
+        }
+    if (nobs == 0) vf_fatal("bitsim: %s has no output ports to observe", d->top);
+
+    /* 故障箇所：指定インスタンス内でプロセスが駆動する信号の全ビット × {0, 1} */
+    for (i = 0; i < d->nsig; i++)
+        if (d->sigs[i].driver >= 0 && in_inst(d->sigs[i].name, inst, ninst)) nsites += 2 * nw[i];
+    if (nsites == 0) vf_fatal("bitsim: no fault sites");
+    sites = vf_alloc(sizeof(*sites) * (size_t)nsites);
+    nsites = 0;
+    for (i = 0; i < d->nsig; i++)
+        if (d->sigs[i].driver >= 0 && in_inst(d->sigs[i].name, inst, ninst))
+            for (k = 0; k < nw[i]; k++) {
+                sites[nsites++] = (struct site){ i, k, 0 };
+                sites[nsites++] = (struct site){ i, k, 1 };
+            }
+
+    /* ゴールデン */
+    gold_out = NULL;
+    {
+        uint64_t *rec = vf_alloc(sizeof(uint64_t) * (size_t)cycles * (size_t)nobs);
+        nflt = 0;
+        run_cycles(clk, rst, iv, cycles, ~(word)0, rec, &lat);
+        gold_out = rec;
+        gold_state = vf_alloc(sizeof(word) * nstore);
+        memcpy(gold_state, store, sizeof(word) * nstore);
+    }
+
+    nbatch = (nsites + 63) / 64;
+    for (b = 0; b < nbatch; b++) {
+        int n = nsites - 64 * b < 64 ? nsites - 64 * b : 64;
+        word valid = n == 64 ? ~(word)0 : (((word)1 << n) - 1), det, latent;
+
+        nflt = n;
+        for (l = 0; l < n; l++) {
+            const struct site *st = &sites[64 * b + l];
+            flt[l] = (struct fault){ st->sig, st->k, st->val ? 0 : (word)1 << l, st->val ? (word)1 << l : 0 };
+        }
+        det = run_cycles(clk, rst, iv, cycles, valid, NULL, &lat);
+        latent = state_diff() & valid & ~det;
+        n_det += __builtin_popcountll(det);
+        n_lat += __builtin_popcountll(latent);
+        n_sil += n - __builtin_popcountll(det | latent);
+        if (!verbose) continue;
+        for (l = 0; l < n; l++) {
+            if ((det >> l) & 1) continue;
+            site_name(&sites[64 * b + l], name, sizeof(name));
+            printf("  %-7s %s stuck-at-%d\n", (latent >> l) & 1 ? "latent" : "silent", name, sites[64 * b + l].val);
+        }
+    }
+
+    printf("%s: %d fault sites in %d batches, %ld cycles\n", d->top, nsites, nbatch, cycles);
+    printf("  detected %ld (%.1f%%, mean latency %.1f cycles), latent %ld, silent %ld\n",
+           n_det, 100.0 * (double)n_det / nsites, n_det ? lat / (double)n_det : 0.0, n_lat, n_sil);
+}
+
+static void usage(void) {
+    fprintf(stderr, "usage: bitsim [-x BITS] [-n N] [-t CYCLES] [-s SEED] [-c CLK] TOP file.vhd...\n"
+                    "       bitsim -f [-p INST]... [-t CYCLES] [-r RST] [-i NAME=VALUE]... [-v] TOP file.vhd...\n");
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    const char *clk = "CLK", *rst = "RESET_N", *top;
+    int xbits = 24, i, bits = 0, ck, fault = 0, verbose = 0, ninst = 0, nset = 0;
+    long nvec = 1L << 20, cycles = 4096;
+    char *inst[MAXP], *set[MAXP];
+    struct timespec t0, t1;
+    double us;
+    word *nbuf;
+
+    rng = 1;
+    for (i = 1; i < argc && argv[i][0] == '-'; i++) {
+        if (!strcmp(argv[i], "-f")) fault = 1;
+        else if (!strcmp(argv[i], "-v")) verbose = 1;
+        else if (!strcmp(argv[i], "-p") && i + 1 < argc && ninst < MAXP) inst[ninst++] = argv[++i];
+        else if (!strcmp(argv[i], "-i") && i + 1 < argc && nset < MAXP) set[nset++] = argv[++i];
+        else if (!strcmp(argv[i], "-r") && i + 1 < argc) rst = argv[++i];
+        else if (!strcmp(argv[i], "-x") && i + 1 < argc) xbits = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-n") && i + 1 < argc) nvec = strtol(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc) cycles = strtol(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-s") && i + 1 < argc) rng = strtoull(argv[++i], NULL, 0) | 1;
+        else if (!strcmp(argv[i], "-c") && i + 1 < argc) clk = argv[++i];
+        else usage();
+    }
+    if (argc - i < 2) usage();
+    top = argv[i++];
+    for (; i < argc; i++) vf_parse_file(argv[i]);
+    d = vf_elaborate(top);
+
+    cur = vf_alloc(sizeof(word *) * (size_t)d->nsig);
+    nxt = vf_alloc(sizeof(word *) * (size_t)d->nsig);
+    nw = vf_alloc(sizeof(int) * (size_t)d->nsig);
+    dirty = vf_alloc((size_t)d->nsig);
+    prev_clk = vf_alloc(sizeof(word) * (size_t)d->nsig);
+    edge = vf_alloc(sizeof(word) * (size_t)d->nsig);
+    for (i = 0; i < d->nsig; i++) {
+        nw[i] = d->sigs[i].w * (d->sigs[i].len ? d->sigs[i].len : 1);
+        nstore += (size_t)nw[i];
+    }
+    store = vf_alloc(sizeof(word) * nstore);
+    nbuf = vf_alloc(sizeof(word) * nstore);
+    for (i = 0; i < d->nsig; i++) {
+        cur[i] = i ? cur[i - 1] + nw[i - 1] : store;
+        nxt[i] = i ? nxt[i - 1] + nw[i - 1] : nbuf;
+    }
+    ck = vf_lookup(d, clk);
+
+    if (fault) {
+        uint64_t *iv = vf_alloc(sizeof(uint64_t) * (size_t)d->nsig);
+        int r = vf_lookup(d, rst);
+        if (ck < 0 || d->sigs[ck].dir != VF_IN) vf_fatal("bitsim: clock input '%s' not found", clk);
+        if (r >= 0 && d->sigs[r].dir != VF_IN) r = -1;
+        for (i = 0; i < nset; i++) {
+            char *eq = strchr(set[i], '=');
+            int s;
+            if (eq == NULL) usage();
+            *eq = 0;
+            s = vf_lookup(d, set[i]);
+            if (s < 0 || d->sigs[s].dir != VF_IN) vf_fatal("bitsim: %s has no input port '%s'", d->top, set[i]);
+            iv[s] = strtoull(eq + 1, NULL, 0);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        run_faults(ck, r, iv, cycles, inst, ninst, verbose);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        us = (double)(t1.tv_sec - t0.tv_sec) * 1e6 + (double)(t1.tv_nsec - t0.tv_nsec) / 1e3;
+        printf("  %.1f ms\n", us / 1e3);
+        return 0;
+    }
+
+    for (R = refs; R->top; R++)
+        if (!strcasecmp(R->top, d->top)) break;
+    if (R->top == NULL) vf_fatal("bitsim: no reference function for '%s'", d->top);
+    nin = ports(R->ins, VF_IN, in_sig);
+    nout = ports(R->outs, VF_OUT, out_sig);
+    for (i = 0; i < nin; i++) pw[i] = d->sigs[in_sig[i]].w;
+    for (i = 0; i < nout; i++) pw[nin + i] = d->sigs[out_sig[i]].w;
+    for (i = 0; i < nin; i++) bits += d->sigs[in_sig[i]].w;
+
+    if (R->seq && (ck < 0 || d->sigs[ck].dir != VF_IN)) vf_fatal("bitsim: clock input '%s' not found", clk);
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    if (R->seq) {
+        run_seq(ck, cycles);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        us = (double)(t1.tv_sec - t0.tv_sec) * 1e6 + (double)(t1.tv_nsec - t0.tv_nsec) / 1e3;
+        printf("%s: 64 lanes x %ld cycles, %ld mismatches, %.1f us\n", d->top, cycles, n_err, us);
+    } else {
+        int exhaustive = bits <= xbits && bits < 63;
+        long batches;
+        if (exhaustive) nvec = 1L << bits;
+        batches = run_comb(nvec, exhaustive);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        us = (double)(t1.tv_sec - t0.tv_sec) * 1e6 + (double)(t1.tv_nsec - t0.tv_nsec) / 1e3;
+        printf("%s: %ld vectors (%s, %d input bits) in %ld words, %ld mismatches, %.1f us\n",
+               d->top, nvec, exhaustive ? "exhaustive" : "random", bits, batches, n_err, us);
+    }
+    return n_err != 0;
+}
+
+/*
+  【GNUでのコンパイル例（Ubuntu / gcc）】
+    gcc -O2 bitsim.c vhdl_front.c -o bitsim
+
+  【chapter05 のブロックを検査する例】
+    ./bitsim half_adder ../chapter05/half_adder.vhd
+    ./bitsim full_adder ../chapter05/half_adder.vhd ../chapter05/full_adder.vhd
+    ./bitsim adder_4bit_lib ../chapter05/adder_4bit_lib.vhd
+    ./bitsim and_or ../chapter05/and_or.vhd
+    ./bitsim count_16 ../chapter05/count_nbit.vhd ../chapter05/count_16.vhd
+    ./bitsim adder_nbit ../chapter05/half_adder.vhd ../chapter05/full_adder.vhd ../chapter05/adder_nbit.vhd
+      （adder_nbit は既定の 16bit で入力 33bit なので乱数 -n 本）
+
+  【cpu15 の exec / reg_file / ram_dc_wb に故障を入れる例（chapter09 の構成、fetch_rom.hex はカレント）】
+    ./bitsim -f -t 600 -p C4 -p C6 -p C8 cpu15_rom_ram cpu15_isa.vhd clk_gen.vhd fetch.vhd \
+        ../chapter09/fetch_rom_sim.vhd decode.vhd reg_file.vhd \
+        ../chapter05/half_adder.vhd ../chapter05/full_adder.vhd ../chapter05/adder_nbit.vhd \
+        exec.vhd data_ram.vhd ../chapter09/ram_dc_wb.vhd ../chapter09/cpu15_rom_ram.vhd
+      （C4 = reg_file、C6 = exec、C8 = ram_dc_wb。RAM 256 語の各セルも故障箇所になる）
+*/
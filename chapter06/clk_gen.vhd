@@ -1,12 +1,12 @@
--- clk_gen.vhd（詳細コメント版：ステージクロック生成 / 段階実行のタイミング制御）
+-- clk_gen.vhd（詳細コメント版：ステージイネーブル生成 / 段階実行のタイミング制御）
 --
 -- 【このモジュールの目的（CPU設計観点）】
 -- - ベースクロック `CLK` を入力として、
 --   CPUの各ステージ（Fetch / Decode / Execute / WriteBack）を順番に動かすための
---   “ワンホット（one-hot）なステージクロック” を生成する。
+--   “ワンホット（one-hot）なステージイネーブル” を生成する。
 --
 -- - 具体的には、ベースクロックの立ち上がりごとに
---   CLK_FT → CLK_DC → CLK_EX → CLK_WB →（再び）CLK_FT …
+--   CE_FT → CE_DC → CE_EX → CE_WB →（再び）CE_FT …
 --   の順で「どれか1本だけが '1' になる」ように出力を切り替える。
 --
 -- 【この方式の意味（段階実行のアルゴリズム）】
@@ -23,35 +23,59 @@
 -- - 自作CPUでは、まずこのように“逐次で確実に動く”設計にすると
 --   タイミングの難易度を下げられ、デバッグもしやすい。
 --
--- 【重要：これは「クロックゲーティング」に近い】
--- - 出力は “CLKの分周クロック” ではなく、「ステージイネーブル（enable）」として使うのが本質。
--- - FPGA/ASIC設計の一般論では、クロックを論理で直接ON/OFFするのは注意が必要で、
---   可能なら “同一クロック + enable” にするのが安全である。
--- - ただし教材/小規模CPUでは、段のトリガとして擬似クロックを配る設計が採られることがある。
-v--   この場合、配線遅延やグリッチが起きないように
---   「完全に同期的に '0'/'1' を切り替えているか」が重要になる。
+-- 【段クロックではなく段イネーブル（単一クロックドメイン）】
+-- - もとは CLK_FT/CLK_DC/CLK_EX/CLK_WB を論理で作ったレジスタ出力として配り、
+--   各段がそれを process(CLK_xx) の 'event でクロックとして使っていた。
+--   これは CLK から派生した4つのクロックドメインを作ることになり、
+--     - 段クロックの配線はクロック網に乗らないのでスキューが大きい
+--     - 段から段へ渡る信号はすべてクロックドメインをまたぐ経路としてタイミング解析される
+--   ため、ベースクロックの Fmax を押さえていた。
+-- - 現在は出力を「段イネーブル」CE_FT/CE_DC/CE_EX/CE_WB とし、
+--   全段が同じ CLK の立ち上がりで動いて、自分の CE_xx が '1' のエッジだけ状態を更新する：
+--       process(CLK)
+--       begin
+--           if (CLK'event and CLK = '1') then
+--               if (CE_EX = '1') then ... end if;
+--           end if;
+--       end process;
+--   設計全体が CLK だけの1つのクロックドメインになり、CE はふつうの同期信号として解析される。
+--
+-- 【エッジ単位で従来と同じタイミングになる理由】
+-- - 従来：CLK_xx は CLK の立ち上がりで '1' になり、そのデルタで段のプロセスが動く。
+--   つまり段 xx は「CLK_xx を '1' にした CLK エッジ」で動いていた。
+-- - 現在：CE_xx が '1' の間に来た CLK エッジで段 xx が動く。
+--   そこで CE_xx は従来の CLK_xx より1エッジ早く '1' にする（下の PH は「このエッジで動く段」）。
+--   これで各段が動く CLK エッジの番号は従来とまったく同じになる。
+-- - 段どうしは必ず別のエッジで動くので、ある段が読む他段の出力は従来と同じ値になる
+--   （cpu15_sim.vhd で IO64_OUT が書かれるエッジが従来と一致することを確かめている）。
 --
 -- 【この回路の生成アルゴリズム（実装の中身）】
--- - 2bitカウンタ COUNT を持ち、CLK立ち上がりごとに +1 する。
--- - COUNT の値で case 分岐し、対応する出力だけ '1'、残りを '0' にする。
+-- - 4bit のワンホットのリングレジスタ PH を持ち、CLK 立ち上がりごとに1bit回す。
+--
+--   PH="0001" → このエッジで FT
+--   PH="0010" → このエッジで DC
+--   PH="0100" → このエッジで EX
+--   PH="1000" → このエッジで WB
 --
---   COUNT="00" → FT=1
---   COUNT="01" → DC=1
---   COUNT="10" → EX=1
---   COUNT="11" → WB=1
+-- - CE_xx は PH の各ビットと入力 CE の AND を出す。CE='1'（既定）なら PH そのもの。
 --
--- - これにより、4段のワンホットシーケンスが完成する。
+-- 【遅く動かす（CE 入力）】
+-- - CE='0' のエッジでは PH を回さず、CE_xx もすべて '0' にする（どの段も動かない）。
+-- - ボードで目視するときは chapter08 の clk_down の CE_OUT（2^21 クロックに1回の '1'）をつなぐ。
+--   クロックは CLK のままで、段が1つ進むのが CE_OUT のエッジだけになり、CPU 全体が 2^21 倍遅く進む
+--   （chapter08 の cpu_dec.vhd がこの形）。
+-- - CE_xx を PH だけにすると、PH が止まっている間ずっと同じ段のイネーブルが '1' のままになり、
+--   その段が毎エッジ動いてしまう。だから CE との AND をとって出す。
 --
 -- 【観測上の注意（波形としてどう見えるか）】
--- - 各出力は “1ベースクロック周期だけ '1' になるパルス” のように見える。
--- - つまり、FT/DC/EX/WB はそれぞれベースクロックの1/4周期で“有効化”される。
--- - CPU全体では、1命令を完了するのにベースクロック4サイクル相当がかかる設計になる。
+-- - 各出力は “1ベースクロック周期だけ '1' になるパルス” に見え、FT→DC→EX→WB の順に巡回する。
+-- - CPU全体では、1命令を完了するのにベースクロック4サイクル相当がかかる設計になる（従来と同じ）。
 --
 -- 【リセットが無い点の注意】
--- - COUNT の初期値は "00" に初期化されているため、シミュレーション上は
---   最初の立ち上がりで FT が '1' から始まる。
--- - 実機（FPGA）では初期値が確実に入るかはデバイス/合成設定に依存する場合がある。
---   堅牢にするなら RESET_N などで COUNT と出力を既知状態へ初期化するのが定石である。
+-- - PH の初期値は "0001" なので、シミュレーション上は最初の立ち上がりで FT が動く
+--   （従来の COUNT="00" から始めたときと同じ）。
+-- - 実機（FPGA）では初期値がビットストリームで入る。入らないデバイスでは RESET_N で
+--   PH を "0001" に戻すこと（ワンホットが崩れると段が動かなくなる）。
 
 
 library IEEE;
@@ -59,91 +83,54 @@ use IEEE.std_logic_1164.all;
 use IEEE.std_logic_unsigned.all;
 
 -- ============================================================
--- entity: ベースクロック → ステージクロック（ワンホット）生成
+-- entity: ベースクロック → ステージイネーブル（ワンホット）生成
 -- ============================================================
 entity clk_gen is
     port
     (
         CLK     : in  std_logic;  -- ベースクロック
-        CLK_FT  : out std_logic;  -- Fetch段を動かすトリガ
-        CLK_DC  : out std_logic;  -- Decode段を動かすトリガ
-        CLK_EX  : out std_logic;  -- Execute段を動かすトリガ
-        CLK_WB  : out std_logic   -- WriteBack段を動かすトリガ
+        CE      : in  std_logic := '1';  -- '1' のエッジだけ段を進める（遅く動かすとき clk_down の CE_OUT）
+        CE_FT   : out std_logic;  -- このCLKエッジで Fetch段が動く
+        CE_DC   : out std_logic;  -- このCLKエッジで Decode段が動く
+        CE_EX   : out std_logic;  -- このCLKエッジで Execute段が動く
+        CE_WB   : out std_logic   -- このCLKエッジで WriteBack段が動く
     );
 end clk_gen;
 
 -- ============================================================
--- architecture RTL: 2bitカウンタで4段を順番に有効化
+-- architecture RTL: 4bitのワンホットリングで4段を順番に有効化
 -- ============================================================
 architecture RTL of clk_gen is
 
     -- --------------------------------------------------------
-    -- COUNT: 2bitの段カウンタ
+    -- PH: 段のワンホットリング（bit0=FT, bit1=DC, bit2=EX, bit3=WB）
     -- --------------------------------------------------------
-    -- "00"→"01"→"10"→"11"→"00"... と循環し、
-    -- その値に応じて出力のワンホットパターンを切り替える。
-    signal COUNT : std_logic_vector(1 downto 0) := "00";
+    -- "0001"→"0010"→"0100"→"1000"→"0001"... と循環する。
+    signal PH : std_logic_vector(3 downto 0) := "0001";
 
 begin
 
     -- ========================================================
-    -- CLK立ち上がりで段を進める順序回路
+    -- CLK立ち上がりで段を進める（リングを1bit回す）
     -- ========================================================
     process(CLK)
     begin
-        -- 立ち上がりエッジ検出（同期回路の基本形）
         if (CLK'event and CLK = '1') then
-
-            -- ------------------------------------------------
-            -- 現在のCOUNTに応じて、どの段を有効化するかを決定
-            -- ------------------------------------------------
-            -- ここでは “必ず1本だけ '1'” になるようにしている。
-            case COUNT is
-
-                -- Fetch段だけ有効
-                when "00" =>
-                    CLK_FT <= '1';
-                    CLK_DC <= '0';
-                    CLK_EX <= '0';
-                    CLK_WB <= '0';
-
-                -- Decode段だけ有効
-                when "01" =>
-                    CLK_FT <= '0';
-                    CLK_DC <= '1';
-                    CLK_EX <= '0';
-                    CLK_WB <= '0';
-
-                -- Execute段だけ有効
-                when "10" =>
-                    CLK_FT <= '0';
-                    CLK_DC <= '0';
-                    CLK_EX <= '1';
-                    CLK_WB <= '0';
-
-                -- WriteBack段だけ有効
-                when "11" =>
-                    CLK_FT <= '0';
-                    CLK_DC <= '0';
-                    CLK_EX <= '0';
-                    CLK_WB <= '1';
-
-                -- 想定外の値（基本的に起きないが保険）
-                when others =>
-                    null;
-            end case;
-
-            -- ------------------------------------------------
-            -- 次の段へ進める（2bitなので4周期で一周する）
-            -- ------------------------------------------------
-            COUNT <= COUNT + 1;
-
+            if (CE = '1') then
+                PH <= PH(2 downto 0) & PH(3);
+            end if;
         end if;
     end process;
 
+    -- ========================================================
+    -- 段イネーブル：PH のビット（CE='0' のエッジではどれも '0'）
+    -- ========================================================
+    CE_FT <= PH(0) and CE;
+    CE_DC <= PH(1) and CE;
+    CE_EX <= PH(2) and CE;
+    CE_WB <= PH(3) and CE;
+
 end RTL;
 
 -- 【CPU設計としての次の検討ポイント】
--- - RESET_N を追加して、COUNTと出力を確実に既知状態へ初期化する（実機で強い）。
--- - 出力を “クロック” として扱うより “enable” として扱う設計に寄せると安全性が上がる。
---   （同一CLKで全段を駆動し、段ごとに enable で更新する方式）
+-- - RESET_N を追加して、PH を確実に既知状態へ初期化する（実機で強い）。
@@ -15,9 +15,14 @@
 --   4) Exec   : ALU演算/分岐/ロードストア制御などを行い、次PCや書き込みデータを生成する
 --   5) WB     : レジスタ/RAMへ結果を書き戻す
 --
--- - これらを別々のクロック（CLK_FT/CLK_DC/CLK_EX/CLK_WB）で進める点が特徴である。
---   一般的なCPUの“単一クロックでのパイプライン”とは異なり、
---   clk_gen がベースクロック CLK を加工して各段用のタイミングを作り出す構造になっている。
+-- - 全段が同じベースクロック CLK で動き、clk_gen が出す段イネーブル
+--   （CE_FT/CE_DC/CE_EX/CE_WB、どれか1本だけが '1'）で「このエッジで動く段」を選ぶ。
+--   一般的なCPUの“全段が毎サイクル動くパイプライン”とは異なり、1命令を4エッジで逐次に進める。
+-- - もとは clk_gen が CLK_FT/CLK_DC/CLK_EX/CLK_WB を論理で作って各段のクロックにしていた
+--   （CLK から派生した4つのクロックドメイン）。今は CLK だけの1つのクロックドメインで、
+--   各段が動く CLK エッジの番号は従来と同じ（clk_gen.vhd、cpu15_sim.vhd を参照）。
+-- - CE 入力（既定 '1'）は clk_gen に渡す。'0' のエッジではどの段も動かないので、
+--   ボードで目視するときは chapter08 の clk_down の CE_OUT をつないで遅く動かす（cpu_dec.vhd）。
 --
 -- 【重要：トップ階層の責務】
 -- - トップ階層の責務は「各部品の接続（インタフェース整合）」と
@@ -26,7 +31,7 @@
 --   - 命令ビットフィールドの取り違え（PROM_OUTのビット切り出し）
 --   - レジスタ番号と書き込み先のズレ
 --   - RAMアドレス/データのタイミングずれ
---   - ステージクロックの位相/更新順の破綻
+--   - 段イネーブルの位相/更新順の破綻
 --   であり、このファイルはそれらの “配線設計” を担う。
 --
 -- 【I/O（メモリマップドI/O風）】
@@ -48,22 +53,31 @@ use IEEE.std_logic_unsigned.all;
 -- entity: CPUトップの外部インタフェース
 -- ============================================================
 entity cpu15 is
+    generic
+    (
+        -- 命令ROM の初期化ファイル（"" なら fetch.vhd の SUM_PROG）。
+        -- cpu15_pipe と同じプログラムを流して比べるときに使う（cpu15_pipe_sim.vhd）
+        ROM_FILE  : string := ""
+    );
     port
     (
         -- ベースクロック入力
         -- clk_gen により Fetch/Decode/Exec/WB 用のクロックへ分配される。
         CLK       : in  std_logic;
 
+        -- 段を進めるエッジ（'1' のエッジだけ CPU が進む）。つながなければ毎エッジ進む。
+        CE        : in  std_logic := '1';
+
         -- リセット（アクティブ Low っぽい命名：RESET_N）
-        -- exec / reg_wb など主要な状態を持つブロックへ渡される。
+        -- exec / reg_file など主要な状態を持つブロックへ渡される。
         RESET_N   : in  std_logic;
 
         -- 外部入力（I/Oポート相当）
-        -- ram_dc へ入り、特定アドレス参照時のRAM値として供給される想定。
+        -- data_ram へ入り、65番地を読んだときの値として供給される。
         IO65_IN   : in  std_logic_vector(15 downto 0);
 
         -- 外部出力（I/Oポート相当）
-        -- ram_wb から出力され、特定アドレスへの store 結果を外部へ見せる想定。
+        -- data_ram から出力され、64番地への store 結果を外部へ見せる。
         IO64_OUT  : out std_logic_vector(15 downto 0)
     );
 end cpu15;
@@ -80,93 +94,113 @@ architecture RTL of cpu15 is
     -- 後段でインスタンス化して配線する。
 
     -- --------------------------------------------------------
-    -- clk_gen: ステージクロック生成
+    -- clk_gen: ステージイネーブル生成
     -- --------------------------------------------------------
-    -- ベースクロック CLK を、各段用のクロックに分割/整形するブロック。
-    -- このCPUは段ごとに別クロックを使うため、タイミング設計の要。
+    -- ベースクロック CLK の各エッジで、どの段を動かすかを決めるブロック。
+    -- 段の順序（FT→DC→EX→WB）を決めるので、タイミング設計の要。
     component clk_gen
         port
         (
             CLK     : in  std_logic;
-            CLK_FT  : out std_logic;  -- Fetch用
-            CLK_DC  : out std_logic;  -- Decode用
-            CLK_EX  : out std_logic;  -- Execute用
-            CLK_WB  : out std_logic   -- WriteBack用
+            CE      : in  std_logic;  -- '1' のエッジだけ段を進める
+            CE_FT   : out std_logic;  -- Fetch用
+            CE_DC   : out std_logic;  -- Decode用
+            CE_EX   : out std_logic;  -- Execute用
+            CE_WB   : out std_logic   -- WriteBack用
         );
     end component;
 
     -- --------------------------------------------------------
     -- fetch: 命令フェッチ（PROM参照）
     -- --------------------------------------------------------
-    -- P_COUNT（8bit PC）で命令ROM（PROM）を参照し、15bit命令を出力する。
+    -- P_COUNT（8bit PC）で命令ROM（PROM）を参照し、16bit命令を出力する。
     component fetch
+        generic
+        (
+            A_BITS   : integer;
+            ROM_FILE : string
+        );
         port
         (
-            CLK_FT   : in  std_logic;
+            CLK      : in  std_logic;
+            CE_FT    : in  std_logic;
             P_COUNT  : in  std_logic_vector(7 downto 0);
-            PROM_OUT : out std_logic_vector(14 downto 0)
+            PROM_OUT : out std_logic_vector(15 downto 0)
         );
     end component;
 
     -- --------------------------------------------------------
     -- decode: 命令デコード（OP_CODE/OP_DATA抽出）
     -- --------------------------------------------------------
-    -- PROM_OUT（15bit命令）を分解してオペコードと即値/データを取り出す。
+    -- PROM_OUT（16bit命令）を分解してオペコード・条件コードと即値/データを取り出す。
     component decode
         port
         (
-            CLK_DC   : in  std_logic;
-            PROM_OUT : in  std_logic_vector(14 downto 0);
-            OP_CODE  : out std_logic_vector(3 downto 0);
+            CLK      : in  std_logic;
+            CE_DC    : in  std_logic;
+            PROM_OUT : in  std_logic_vector(15 downto 0);
+            OP_CODE  : out std_logic_vector(4 downto 0);
+            OP_CC    : out std_logic_vector(2 downto 0);
             OP_DATA  : out std_logic_vector(7 downto 0)
         );
     end component;
 
     -- --------------------------------------------------------
-    -- reg_dc: レジスタ読み出し（デコード段）
+    -- reg_file: レジスタファイル（読み出し2ポート＋書き込み1ポート）
     -- --------------------------------------------------------
-    -- N_REG_IN で指定されたレジスタ番号の値を REG_OUT に出す。
-    -- 同時に N_REG_OUT を出しており、後段（WB等）で “どのレジスタ番号か” を保持する用途がある。
-    component reg_dc
+    -- レジスタを配列に持ち、番号で添字して読み書きする（合成では RAM になる）。
+    -- 読み出しA/Bは DC のエッジでラッチし、番号も N_REG_A/N_REG_B として出す（旧 reg_dc と同じ）。
+    -- 書き込みは WB のエッジ（旧 reg_wb と同じ）。読み出しCは chapter09 の間接アドレス用でここでは使わない。
+    component reg_file
+        generic
+        (
+            N_BITS     : integer
+        );
         port
         (
-            CLK_DC    : in  std_logic;
-            N_REG_IN  : in  std_logic_vector(2 downto 0);
-            REG_0     : in  std_logic_vector(15 downto 0);
-            REG_1     : in  std_logic_vector(15 downto 0);
-            REG_2     : in  std_logic_vector(15 downto 0);
-            REG_3     : in  std_logic_vector(15 downto 0);
-            REG_4     : in  std_logic_vector(15 downto 0);
-            REG_5     : in  std_logic_vector(15 downto 0);
-            REG_6     : in  std_logic_vector(15 downto 0);
-            REG_7     : in  std_logic_vector(15 downto 0);
-            N_REG_OUT : out std_logic_vector(2 downto 0);
-            REG_OUT   : out std_logic_vector(15 downto 0)
+            CLK        : in  std_logic;
+            CE_DC      : in  std_logic;
+            CE_WB      : in  std_logic;
+            RESET_N    : in  std_logic;
+            N_REG_A_IN : in  std_logic_vector(N_BITS - 1 downto 0);
+            N_REG_B_IN : in  std_logic_vector(N_BITS - 1 downto 0);
+            N_REG_A    : out std_logic_vector(N_BITS - 1 downto 0);
+            N_REG_B    : out std_logic_vector(N_BITS - 1 downto 0);
+            REG_A      : out std_logic_vector(15 downto 0);
+            REG_B      : out std_logic_vector(15 downto 0);
+            N_REG_C    : in  std_logic_vector(N_BITS - 1 downto 0);
+            REG_C      : out std_logic_vector(15 downto 0);
+            N_REG_W    : in  std_logic_vector(N_BITS - 1 downto 0);
+            REG_IN     : in  std_logic_vector(15 downto 0);
+            REG_WEN    : in  std_logic
         );
     end component;
 
     -- --------------------------------------------------------
-    -- ram_dc: RAM読み出し（デコード段）
+    -- data_ram: データメモリ（256語、2ポート、読み出しは出力レジスタ付き）
     -- --------------------------------------------------------
-    -- 命令中のアドレス等から RAM_AD_IN を受け取り、
-    -- RAM_0〜RAM_7（小容量RAMの“バンク/分割”表現）から該当値を出力する。
-    -- IO65_IN も入力に含まれており、特定アドレスで外部入力に切り替える設計が想定される。
-    component ram_dc
+    -- 命令下位8bitの番地を DC で読み（1サイクルレイテンシ）、WB で RAM_IN を書く。
+    -- 64/65 番地はメモリマップドI/O（IO64_OUT / IO65_IN）として data_ram の中で処理する。
+    component data_ram
+        generic
+        (
+            A_BITS   : integer := 8
+        );
         port
         (
-            CLK_DC     : in  std_logic;
-            RAM_AD_IN  : in  std_logic_vector(7 downto 0);
-            RAM_0      : in  std_logic_vector(15 downto 0);
-            RAM_1      : in  std_logic_vector(15 downto 0);
-            RAM_2      : in  std_logic_vector(15 downto 0);
-            RAM_3      : in  std_logic_vector(15 downto 0);
-            RAM_4      : in  std_logic_vector(15 downto 0);
-            RAM_5      : in  std_logic_vector(15 downto 0);
-            RAM_6      : in  std_logic_vector(15 downto 0);
-            RAM_7      : in  std_logic_vector(15 downto 0);
-            IO65_IN    : in  std_logic_vector(15 downto 0);
-            RAM_AD_OUT : out std_logic_vector(7 downto 0);
-            RAM_OUT    : out std_logic_vector(15 downto 0)
+            CLK      : in  std_logic;
+            EN_A     : in  std_logic;
+            ADDR_A   : in  std_logic_vector(7 downto 0);
+            DIN_A    : in  std_logic_vector(15 downto 0);
+            WE_A     : in  std_logic;
+            DOUT_A   : out std_logic_vector(15 downto 0);
+            EN_B     : in  std_logic;
+            ADDR_B   : in  std_logic_vector(7 downto 0);
+            DIN_B    : in  std_logic_vector(15 downto 0);
+            WE_B     : in  std_logic;
+            DOUT_B   : out std_logic_vector(15 downto 0);
+            IO65_IN  : in  std_logic_vector(15 downto 0);
+            IO64_OUT : out std_logic_vector(15 downto 0)
         );
     end component;
 
@@ -181,9 +215,11 @@ architecture RTL of cpu15 is
     component exec
         port
         (
-            CLK_EX   : in  std_logic;
+            CLK      : in  std_logic;
+            CE_EX    : in  std_logic;
             RESET_N  : in  std_logic;
-            OP_CODE  : in  std_logic_vector(3 downto 0);
+            OP_CODE  : in  std_logic_vector(4 downto 0);
+            OP_CC    : in  std_logic_vector(2 downto 0);
             REG_A    : in  std_logic_vector(15 downto 0);
             REG_B    : in  std_logic_vector(15 downto 0);
             OP_DATA  : in  std_logic_vector(7 downto 0);
@@ -192,75 +228,33 @@ architecture RTL of cpu15 is
             REG_IN   : out std_logic_vector(15 downto 0);
             RAM_IN   : out std_logic_vector(15 downto 0);
             REG_WEN  : out std_logic;
-            RAM_WEN  : out std_logic
-        );
-    end component;
-
-    -- --------------------------------------------------------
-    -- reg_wb: レジスタ書き戻し（WB段）
-    -- --------------------------------------------------------
-    -- exec で生成された REG_IN を、指定レジスタ番号 N_REG へ書き戻す。
-    -- 出力として REG_0〜REG_7 を持ち、トップ内の“レジスタファイル状態”を保持する役割もある。
-    component reg_wb
-        port
-        (
-            CLK_WB  : in  std_logic;
-            RESET_N : in  std_logic;
-            N_REG   : in  std_logic_vector(2 downto 0);
-            REG_IN  : in  std_logic_vector(15 downto 0);
-            REG_WEN : in  std_logic;
-            REG_0   : out std_logic_vector(15 downto 0);
-            REG_1   : out std_logic_vector(15 downto 0);
-            REG_2   : out std_logic_vector(15 downto 0);
-            REG_3   : out std_logic_vector(15 downto 0);
-            REG_4   : out std_logic_vector(15 downto 0);
-            REG_5   : out std_logic_vector(15 downto 0);
-            REG_6   : out std_logic_vector(15 downto 0);
-            REG_7   : out std_logic_vector(15 downto 0)
-        );
-    end component;
-
-    -- --------------------------------------------------------
-    -- ram_wb: RAM書き戻し（WB段）+ 外部出力ポート生成
-    -- --------------------------------------------------------
-    -- exec で生成された RAM_IN を RAM_ADDR に store する。
-    -- IO64_OUT を出しているので、特定アドレスへの store を外部出力へ反映する設計が想定される。
-    component ram_wb
-        port
-        (
-            CLK_WB   : in  std_logic;
-            RAM_ADDR : in  std_logic_vector(7 downto 0);
-            RAM_IN   : in  std_logic_vector(15 downto 0);
-            RAM_WEN  : in  std_logic;
-            RAM_0    : out std_logic_vector(15 downto 0);
-            RAM_1    : out std_logic_vector(15 downto 0);
-            RAM_2    : out std_logic_vector(15 downto 0);
-            RAM_3    : out std_logic_vector(15 downto 0);
-            RAM_4    : out std_logic_vector(15 downto 0);
-            RAM_5    : out std_logic_vector(15 downto 0);
-            RAM_6    : out std_logic_vector(15 downto 0);
-            RAM_7    : out std_logic_vector(15 downto 0);
-            IO64_OUT : out std_logic_vector(15 downto 0)
+            RAM_WEN  : out std_logic;
+            SP_OUT   : out std_logic_vector(7 downto 0);
+            REG_IN_B : out std_logic_vector(15 downto 0);
+            REG_WEN_B : out std_logic;
+            BLK_REQ   : out std_logic;
+            BLK_BUSY  : in  std_logic
         );
     end component;
 
     -- ========================================================
     -- 内部信号（配線）
     -- ========================================================
-    -- ステージクロック
-    signal CLK_FT   : std_logic;
-    signal CLK_DC   : std_logic;
-    signal CLK_EX   : std_logic;
-    signal CLK_WB   : std_logic;
+    -- 段イネーブル
+    signal CE_FT    : std_logic;
+    signal CE_DC    : std_logic;
+    signal CE_EX    : std_logic;
+    signal CE_WB    : std_logic;
 
     -- プログラムカウンタ（PC）
     signal P_COUNT  : std_logic_vector(7 downto 0);
 
     -- 命令（PROM出力）
-    signal PROM_OUT : std_logic_vector(14 downto 0);
+    signal PROM_OUT : std_logic_vector(15 downto 0);
 
     -- デコード結果
-    signal OP_CODE  : std_logic_vector(3 downto 0);
+    signal OP_CODE  : std_logic_vector(4 downto 0);
+    signal OP_CC    : std_logic_vector(2 downto 0);
     signal OP_DATA  : std_logic_vector(7 downto 0);
 
     -- レジスタ番号（命令から抽出した参照先）
@@ -277,46 +271,34 @@ architecture RTL of cpu15 is
 
     -- 書き込み許可
     signal REG_WEN  : std_logic;
+    signal REG_IN_B : std_logic_vector(15 downto 0);
+    signal REG_WEN_B : std_logic;
     signal RAM_WEN  : std_logic;
 
-    -- レジスタファイルの状態（reg_wbが保持し、reg_dcが参照する）
-    signal REG_0    : std_logic_vector(15 downto 0);
-    signal REG_1    : std_logic_vector(15 downto 0);
-    signal REG_2    : std_logic_vector(15 downto 0);
-    signal REG_3    : std_logic_vector(15 downto 0);
-    signal REG_4    : std_logic_vector(15 downto 0);
-    signal REG_5    : std_logic_vector(15 downto 0);
-    signal REG_6    : std_logic_vector(15 downto 0);
-    signal REG_7    : std_logic_vector(15 downto 0);
-
-    -- RAMアドレスとRAMデータ（ram_dc/ram_wb間の受け渡し）
-    signal RAM_ADDR : std_logic_vector(7 downto 0);
-    signal RAM_OUT  : std_logic_vector(15 downto 0);
+    -- レジスタファイルの書き込みポート（REG_WEN_B のときは B 側の番号と値を選ぶ）
+    signal N_REG_W  : std_logic_vector(2 downto 0);
+    signal REG_W    : std_logic_vector(15 downto 0);
+    signal REG_WE   : std_logic;
 
-    -- RAMの状態（ram_wbが保持し、ram_dcが参照する）
-    signal RAM_0    : std_logic_vector(15 downto 0);
-    signal RAM_1    : std_logic_vector(15 downto 0);
-    signal RAM_2    : std_logic_vector(15 downto 0);
-    signal RAM_3    : std_logic_vector(15 downto 0);
-    signal RAM_4    : std_logic_vector(15 downto 0);
-    signal RAM_5    : std_logic_vector(15 downto 0);
-    signal RAM_6    : std_logic_vector(15 downto 0);
-    signal RAM_7    : std_logic_vector(15 downto 0);
+    -- RAMの読み出しデータと書き込み許可（WB のエッジだけ '1'）
+    signal RAM_OUT  : std_logic_vector(15 downto 0);
+    signal RAM_WE   : std_logic;
 
 begin
 
     -- ========================================================
-    -- (1) ステージクロック生成
+    -- (1) ステージイネーブル生成
     -- ========================================================
-    -- ベースCLKから、各段のクロックを生成する。
+    -- ベースCLKのエッジごとに、動かす段を1つ選ぶ。
     -- 段ごとの更新順序・位相はCPUの正しさに直結するため、clk_genが要になる。
     C1 : clk_gen
         port map(
             CLK     => CLK,
-            CLK_FT  => CLK_FT,
-            CLK_DC  => CLK_DC,
-            CLK_EX  => CLK_EX,
-            CLK_WB  => CLK_WB
+            CE      => CE,
+            CE_FT   => CE_FT,
+            CE_DC   => CE_DC,
+            CE_EX   => CE_EX,
+            CE_WB   => CE_WB
         );
 
     -- ========================================================
@@ -324,8 +306,13 @@ begin
     -- ========================================================
     -- exec が更新する PC（P_COUNT）を使って命令を取り出す。
     C2 : fetch
+        generic map(
+            A_BITS   => 8,
+            ROM_FILE => ROM_FILE
+        )
         port map(
-            CLK_FT   => CLK_FT,
+            CLK      => CLK,
+            CE_FT    => CE_FT,
             P_COUNT  => P_COUNT,
             PROM_OUT => PROM_OUT
         );
@@ -335,14 +322,16 @@ begin
     -- ========================================================
     C3 : decode
         port map(
-            CLK_DC   => CLK_DC,
+            CLK      => CLK,
+            CE_DC    => CE_DC,
             PROM_OUT => PROM_OUT,
             OP_CODE  => OP_CODE,
+            OP_CC    => OP_CC,
             OP_DATA  => OP_DATA
         );
 
     -- ========================================================
-    -- (4) レジスタ読み出し（デコード段）
+    -- (4) レジスタファイル：読み出し（デコード段）と書き戻し（WB段）
     -- ========================================================
     -- PROM_OUTのビットフィールドからレジスタ番号を取り出し、
     -- 対応するREG値を REG_A / REG_B としてexecへ渡す。
@@ -351,59 +340,65 @@ begin
     -- - (10 downto 8) を Aオペランドのレジスタ番号
     -- - (7 downto 5)  を Bオペランドのレジスタ番号
     -- として使っている。
-    C4 : reg_dc
-        port map(
-            CLK_DC    => CLK_DC,
-            N_REG_IN  => PROM_OUT(10 downto 8),
-            REG_0     => REG_0,
-            REG_1     => REG_1,
-            REG_2     => REG_2,
-            REG_3     => REG_3,
-            REG_4     => REG_4,
-            REG_5     => REG_5,
-            REG_6     => REG_6,
-            REG_7     => REG_7,
-            N_REG_OUT => N_REG_A,
-            REG_OUT   => REG_A
-        );
-
-    C5 : reg_dc
+    --
+    -- 書き戻し宛先は通常 N_REG_A。LDR/STR のポストインクリメント（REG_WEN_B='1'）のときだけ
+    -- N_REG_B へ REG_IN_B を書く。exec は REG_WEN と REG_WEN_B を同時に立てないので、
+    -- 書き込みポートは1本で足りる。
+    N_REG_W <= N_REG_B  when REG_WEN_B = '1' else N_REG_A;
+    REG_W   <= REG_IN_B when REG_WEN_B = '1' else REG_IN;
+    REG_WE  <= REG_WEN or REG_WEN_B;
+
+    C4 : reg_file
+        generic map(
+            N_BITS     => 3
+        )
         port map(
-            CLK_DC    => CLK_DC,
-            N_REG_IN  => PROM_OUT(7 downto 5),
-            REG_0     => REG_0,
-            REG_1     => REG_1,
-            REG_2     => REG_2,
-            REG_3     => REG_3,
-            REG_4     => REG_4,
-            REG_5     => REG_5,
-            REG_6     => REG_6,
-            REG_7     => REG_7,
-            N_REG_OUT => N_REG_B,
-            REG_OUT   => REG_B
+            CLK        => CLK,
+            CE_DC      => CE_DC,
+            CE_WB      => CE_WB,
+            RESET_N    => RESET_N,
+            N_REG_A_IN => PROM_OUT(10 downto 8),
+            N_REG_B_IN => PROM_OUT(7 downto 5),
+            N_REG_A    => N_REG_A,
+            N_REG_B    => N_REG_B,
+            REG_A      => REG_A,
+            REG_B      => REG_B,
+            N_REG_C    => "000",
+            REG_C      => open,
+            N_REG_W    => N_REG_W,
+            REG_IN     => REG_W,
+            REG_WEN    => REG_WE
         );
 
     -- ========================================================
-    -- (5) RAM読み出し（デコード段）
+    -- (5) データメモリ：DC で読み出し、WB で書き込み
     -- ========================================================
-    -- PROM_OUT(7 downto 0) をアドレス入力として渡しているため、
-    -- 命令下位8bitがRAMアドレス（またはI/Oアドレス）として扱われる設計が想定される。
-    -- IO65_IN を入力に持つので、特定アドレスで外部入力へ切替える実装がram_dc内にあるはず。
-    C6 : ram_dc
+    -- PROM_OUT(7 downto 0)（命令下位8bit）が番地。PROM_OUT は次の FT まで変わらないので、
+    -- DC の読みと WB の書きは同じ番地を指す（アドレスを段を跨いでラッチし直す必要がない）。
+    -- data_ram も他の段と同じ CLK で動くので、段イネーブルをそのまま使う：
+    --   EN_A = CE_DC（DC のエッジで読み出し）
+    --   WE_A = CE_WB and RAM_WEN（WB のエッジで書き込み）
+    -- 読み出し値は exec がラッチする EX までに DOUT_A に出ている（1サイクルレイテンシ）。
+    RAM_WE <= CE_WB and RAM_WEN;
+
+    C6 : data_ram
+        generic map(
+            A_BITS   => 8
+        )
         port map(
-            CLK_DC     => CLK_DC,
-            RAM_AD_IN  => PROM_OUT(7 downto 0),
-            RAM_0      => RAM_0,
-            RAM_1      => RAM_1,
-            RAM_2      => RAM_2,
-            RAM_3      => RAM_3,
-            RAM_4      => RAM_4,
-            RAM_5      => RAM_5,
-            RAM_6      => RAM_6,
-            RAM_7      => RAM_7,
-            IO65_IN    => IO65_IN,
-            RAM_AD_OUT => RAM_ADDR,
-            RAM_OUT    => RAM_OUT
+            CLK      => CLK,
+            EN_A     => CE_DC,
+            ADDR_A   => PROM_OUT(7 downto 0),
+            DIN_A    => RAM_IN,
+            WE_A     => RAM_WE,
+            DOUT_A   => RAM_OUT,
+            EN_B     => '0',         -- ポートBはこの構成では使わない
+            ADDR_B   => "00000000",
+            DIN_B    => "0000000000000000",
+            WE_B     => '0',
+            DOUT_B   => open,
+            IO65_IN  => IO65_IN,
+            IO64_OUT => IO64_OUT
         );
 
     -- ========================================================
@@ -413,9 +408,11 @@ begin
     -- 次PC、レジスタ書き込みデータ、RAM書き込みデータ、各WENを生成する。
     C7 : exec
         port map(
-            CLK_EX   => CLK_EX,
+            CLK      => CLK,
+            CE_EX    => CE_EX,
             RESET_N  => RESET_N,
             OP_CODE  => OP_CODE,
+            OP_CC    => OP_CC,
             REG_A    => REG_A,
             REG_B    => REG_B,
             OP_DATA  => OP_DATA,
@@ -424,53 +421,12 @@ begin
             REG_IN   => REG_IN,
             RAM_IN   => RAM_IN,
             REG_WEN  => REG_WEN,
-            RAM_WEN  => RAM_WEN
-        );
-
-    -- ========================================================
-    -- (7) WriteBack段：レジスタへ書き戻し
-    -- ========================================================
-    -- N_REG（ここではN_REG_A）を宛先として REG_IN を書く想定。
-    -- この “宛先レジスタ番号” の扱いは命令仕様の核心なので、
-    -- 実際のISAで「書き込み先がAなのかBなのか/別フィールドなのか」を再確認すべきポイント。
-    C8 : reg_wb
-        port map(
-            CLK_WB  => CLK_WB,
-            RESET_N => RESET_N,
-            N_REG   => N_REG_A,
-            REG_IN  => REG_IN,
-            REG_WEN => REG_WEN,
-            REG_0   => REG_0,
-            REG_1   => REG_1,
-            REG_2   => REG_2,
-            REG_3   => REG_3,
-            REG_4   => REG_4,
-            REG_5   => REG_5,
-            REG_6   => REG_6,
-            REG_7   => REG_7
-        );
-
-    -- ========================================================
-    -- (8) WriteBack段：RAMへ書き戻し + 外部出力
-    -- ========================================================
-    -- RAM_ADDR は ram_dc で確定したアドレスを使う。
-    -- RAM_WEN が1のとき RAM_IN を該当アドレスへ書く。
-    -- IO64_OUT は ram_wb 側で “特定アドレスへの書き込み” を外部出力へ反映する想定。
-    C9 : ram_wb
-        port map(
-            CLK_WB   => CLK_WB,
-            RAM_ADDR => RAM_ADDR,
-            RAM_IN   => RAM_IN,
             RAM_WEN  => RAM_WEN,
-            RAM_0    => RAM_0,
-            RAM_1    => RAM_1,
-            RAM_2    => RAM_2,
-            RAM_3    => RAM_3,
-            RAM_4    => RAM_4,
-            RAM_5    => RAM_5,
-            RAM_6    => RAM_6,
-            RAM_7    => RAM_7,
-            IO64_OUT => IO64_OUT
+            SP_OUT   => open,       -- スタックと LDR/STR のアドレスは chapter09（ram_dc_wb）の構成で使う
+            REG_IN_B => REG_IN_B,
+            REG_WEN_B => REG_WEN_B,
+            BLK_REQ   => open,
+            BLK_BUSY  => '0'          -- ブロック転送も chapter09 の構成で使う（ここでは何も動かさずに終わる）
         );
 
 end RTL;
@@ -479,8 +435,8 @@ end RTL;
 -- - 命令フォーマット：
 --   PROM_OUT(10 downto 8) / (7 downto 5) / (7 downto 0) の意味が一貫しているか
 -- - 書き戻し宛先：
---   reg_wb の N_REG に N_REG_A を渡しているが、命令仕様上正しい宛先か
+--   reg_file の N_REG_W は N_REG_A（ポストインクリメントのときだけ N_REG_B）で、命令仕様上正しい宛先か
 -- - RAMアドレスのタイミング：
---   ram_dc が出す RAM_ADDR を WB段で使うため、段跨ぎの保持/整合が崩れていないか
--- - ステージクロック：
+--   data_ram の読み出し（CE_DC のエッジ）と書き込み（CE_WB のエッジ）が同じ PROM_OUT を見ているか
+-- - 段イネーブル：
 --   clk_gen の位相関係が “データが準備されてから次段がサンプルする” になっているか
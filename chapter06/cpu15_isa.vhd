@@ -0,0 +1,77 @@
+-- cpu15_isa.vhd（命令セット定義パッケージ：オペコード／条件コードの一元定義）
+--
+-- 【このパッケージの目的】
+-- - cpu15 の命令語（16bit、オペコード5bit＝最大32命令）のエンコーディングを 1か所にまとめる。
+-- - これまでは exec.vhd の case 選択肢、トップ階層のスタック／間接アドレス判定、
+--   fetch の命令ROM などに "10010" のようなビット列が直接書かれていた。
+--   同じ値が複数ファイルに散らばると、命令を追加・変更したときに 1か所だけ直し忘れる
+--   （= ブロック間でISAの解釈がずれる）という典型的なバグを生む。
+-- - そこで「命令番号の正本」をこのパッケージに置き、RTL 側は名前（OP_ADD 等）で参照する。
+--
+-- 【C 側（chapter03/cpu15.h）との対応】
+-- - 番号は cpu15.h の enum（MOV=0 … SWAP=30）と 1対1 に対応させている。
+--   エミュレータ・エンコーダ・RTL・命令ROM がすべて同じ番号体系を使うので、
+--   片方だけ変更した場合は必ずもう片方も合わせること。
+-- - 条件コード（JCC の [10:8]）も cpu15.h の CC_EQ … CC_AE と同じ番号である。
+--
+-- 【命令フォーマット（再掲）】
+--     [15:11] OP_CODE（本パッケージの OP_xxx）
+--     [10: 8] REG_A 番号（JCC では条件コード CC_xxx）
+--     [ 7: 5] REG_B 番号
+--     [ 4: 2] REG_C 番号（MCPY/MSET の長さレジスタ）
+--     [ 7: 0] OP_DATA（即値/アドレス。LDR/STR では bit0 がポストインクリメント指定）
+--
+-- 【使い方】
+-- - 参照する側の entity の前に `use work.cpu15_isa.all;` を書く。
+-- - 解析（コンパイル）順は、このパッケージを最初にすること。
+-- - 空き番号は "11111" の 1つ。
+
+library IEEE;
+use IEEE.std_logic_1164.all;
+
+package cpu15_isa is
+
+	-- オペコード（PROM_OUT(15 downto 11)）
+	constant OP_MOV   : std_logic_vector(4 downto 0) := "00000";
+	constant OP_ADD   : std_logic_vector(4 downto 0) := "00001";
+	constant OP_SUB   : std_logic_vector(4 downto 0) := "00010";
+	constant OP_AND   : std_logic_vector(4 downto 0) := "00011";
+	constant OP_OR    : std_logic_vector(4 downto 0) := "00100";
+	constant OP_SL    : std_logic_vector(4 downto 0) := "00101";
+	constant OP_SR    : std_logic_vector(4 downto 0) := "00110";
+	constant OP_SRA   : std_logic_vector(4 downto 0) := "00111";
+	constant OP_LDL   : std_logic_vector(4 downto 0) := "01000";
+	constant OP_LDH   : std_logic_vector(4 downto 0) := "01001";
+	constant OP_CMP   : std_logic_vector(4 downto 0) := "01010";
+	constant OP_JE    : std_logic_vector(4 downto 0) := "01011";
+	constant OP_JMP   : std_logic_vector(4 downto 0) := "01100";
+	constant OP_LD    : std_logic_vector(4 downto 0) := "01101";
+	constant OP_ST    : std_logic_vector(4 downto 0) := "01110";
+	constant OP_HLT   : std_logic_vector(4 downto 0) := "01111";
+	constant OP_JCC   : std_logic_vector(4 downto 0) := "10000";
+	constant OP_ADDI  : std_logic_vector(4 downto 0) := "10001";
+	constant OP_CALL  : std_logic_vector(4 downto 0) := "10010";
+	constant OP_RET   : std_logic_vector(4 downto 0) := "10011";
+	constant OP_PUSH  : std_logic_vector(4 downto 0) := "10100";
+	constant OP_POP   : std_logic_vector(4 downto 0) := "10101";
+	constant OP_LDR   : std_logic_vector(4 downto 0) := "10110";
+	constant OP_STR   : std_logic_vector(4 downto 0) := "10111";
+	constant OP_MUL   : std_logic_vector(4 downto 0) := "11000";
+	constant OP_MULHU : std_logic_vector(4 downto 0) := "11001";
+	constant OP_DIVU  : std_logic_vector(4 downto 0) := "11010";
+	constant OP_MODU  : std_logic_vector(4 downto 0) := "11011";
+	constant OP_MCPY  : std_logic_vector(4 downto 0) := "11100";
+	constant OP_MSET  : std_logic_vector(4 downto 0) := "11101";
+	constant OP_SWAP  : std_logic_vector(4 downto 0) := "11110";
+
+	-- 条件コード（JCC の PROM_OUT(10 downto 8)）
+	constant CC_EQ    : std_logic_vector(2 downto 0) := "000";
+	constant CC_NE    : std_logic_vector(2 downto 0) := "001";
+	constant CC_LT    : std_logic_vector(2 downto 0) := "010";
+	constant CC_GE    : std_logic_vector(2 downto 0) := "011";
+	constant CC_LE    : std_logic_vector(2 downto 0) := "100";
+	constant CC_GT    : std_logic_vector(2 downto 0) := "101";
+	constant CC_B     : std_logic_vector(2 downto 0) := "110";
+	constant CC_AE    : std_logic_vector(2 downto 0) := "111";
+
+end cpu15_isa;
@@ -0,0 +1,539 @@
+/*
+  cpu15_model.c（サイクルベースCモデル / chapter06 の cpu15 RTL をビット精度で再現する）
+
+  【このプログラムの位置づけ】
+  - chapter03/CPU_emulator.c は「ISA（命令セット）レベル」のエミュレータで、
+    1命令 = 1ループとして振る舞いだけを再現する。
+  - GHDL 等のイベント駆動シミュレータは RTL を正確に動かせるが、
+    デルタサイクルやイベントキューの処理が重く、長いプログラムの検証には遅い。
+  - 本ファイルはその中間を埋める「サイクルベース・モデル」である。
+    Verilator と同じ考え方で、各エンティティの“クロック同期プロセス”を
+    ベースクロック CLK の立ち上がり1回につき1回だけ評価する。
+
+  【モデル化したエンティティ（chapter06）】
+    clk_gen / fetch / decode / reg_file / data_ram / exec / cpu15(トップ配線)
+
+  【ビット精度の前提（CLKエッジごとに RTL と一致させるための規則）】
+  - 全エンティティが同じ CLK の立ち上がりで動く（単一クロックドメイン）。
+    clk_gen の PH（ワンホット）から出る段イネーブル CE_FT/CE_DC/CE_EX/CE_WB は、
+    「このエッジで動く段」を選ぶ条件にすぎない。
+  - したがって1回の CLK 立ち上がりは、全プロセスを同じデルタで1回ずつ評価すれば再現できる：
+      - clk_gen は PH を1bit回す
+      - 各段は、エッジ前の PH で自分の段イネーブルが '1' のときだけ評価する
+      - data_ram は CE_DC（= PH(1)）で読み、CE_WB（= PH(3)）and RAM_WEN で書く
+  - VHDL のシグナル代入規則（読み出しは旧値・書き込みは次値）に合わせて、
+    全プロセスを「現在値 s から次値 n を作る」2相方式で評価し、最後に一括コミットする。
+  - 段イネーブルは必ず1本だけが立つので、同一エッジで複数段が動くことはない。
+    それでも DC 段（decode/reg_file の読み出し/data_ram の読み出し）のように
+    同じエッジで動くプロセス同士の順序依存を消すため、2相評価は省略しない。
+
+  【std_logic の 'U'/'X' について】
+  - C モデルは2値（0/1）だけを扱う。RTL で未初期化の 'U' になる信号
+    （リセット前の REG_WEN/RAM_WEN など）は 0 として扱う。
+  - 'U' の立ち上がり（'U'→'1'）は VHDL でも CLK'event and CLK='1' を満たすので、
+    t=0 の CLK も立ち上がり #0 として数える（PH の初期値 "0001" により FT が動く）。
+  - リセット解除後、全信号が 0/1 に確定してからは RTL と完全に一致する。
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* --- fetch.vhd の PROM（256語 × 16bit） ---
+   fetch.vhd の既定の中身（ROM_FILE = "" のときの SUM_PROG）と同じ。1+2+...+10=55 を計算して 64番地へ store する。
+   fetch は P_COUNT(7 downto 0) 全体で参照するので 256語。15番地以降は 0（nop）。
+*/
+static const unsigned short prom[256] = {
+    0x4800,  /*  0: ldh Reg0, 0   "0100100000000000" */
+    0x4000,  /*  1: ldl Reg0, 0   "0100000000000000" */
+    0x4900,  /*  2: ldh Reg1, 0   "0100100100000000" */
+    0x4101,  /*  3: ldl Reg1, 1   "0100000100000001" */
+    0x4a00,  /*  4: ldh Reg2, 0   "0100101000000000" */
+    0x4200,  /*  5: ldl Reg2, 0   "0100001000000000" */
+    0x4b00,  /*  6: ldh Reg3, 0   "0100101100000000" */
+    0x430a,  /*  7: ldl Reg3, 10  "0100001100001010" */
+    0x0a20,  /*  8: add Reg2, Reg1 "0000101000100000" */
+    0x0840,  /*  9: add Reg0, Reg2 "0000100001000000" */
+    0x7040,  /* 10: st  Reg0, 64  "0111000001000000" */
+    0x5260,  /* 11: cmp Reg2, Reg3 "0101001001100000" */
+    0x580e,  /* 12: je  14        "0101100000001110" */
+    0x6008,  /* 13: jmp 8         "0110000000001000" */
+    0x7800,  /* 14: hlt           "0111100000000000" */
+    0x0000   /* 15: nop           "0000000000000000" */
+};
+
+/* --- 全エンティティのレジスタ（= 信号の現在値） ---
+   RTL の各 signal / out ポートのうち「クロック同期プロセスが駆動するもの」を1つの構造体にまとめる。
+   組合せ代入（exec の P_COUNT、data_ram の DOUT_A の選択）は他のレジスタから毎回導出する。
+*/
+struct cpu15_sig {
+    /* clk_gen */
+    unsigned char  ph;          // PH(3 downto 0)：bit0=CE_FT, bit1=CE_DC, bit2=CE_EX, bit3=CE_WB
+
+    /* fetch */
+    unsigned short prom_out;    // PROM_OUT(15 downto 0)
+
+    /* decode */
+    unsigned char  op_code;     // OP_CODE(4 downto 0)
+    unsigned char  op_cc;       // OP_CC(2 downto 0)
+    unsigned char  op_data;     // OP_DATA(7 downto 0)
+
+    /* reg_file の読み出しA/B（C4） */
+    unsigned char  n_reg_a;     // N_REG_A
+    unsigned char  n_reg_b;     // N_REG_B
+    unsigned short reg_a;       // REG_A
+    unsigned short reg_b;       // REG_B
+
+    /* data_ram の出力レジスタ（I/O の選択を済ませた DOUT_A の値） */
+    unsigned short ram_out;     // RAM_OUT
+
+    /* exec */
+    unsigned char  pc;          // PC（= P_COUNT）
+    unsigned char  flag_z;      // FLAG_Z
+    unsigned char  flag_c;      // FLAG_C
+    unsigned char  flag_s;      // FLAG_S
+    unsigned char  flag_v;      // FLAG_V
+    unsigned short reg_in;      // REG_IN
+    unsigned short ram_in;      // RAM_IN
+    unsigned char  reg_wen;     // REG_WEN
+    unsigned char  ram_wen;     // RAM_WEN
+    unsigned char  sp;          // SP（= SP_OUT。chapter06 の構成では RAM アドレスに使われない）
+    unsigned short reg_in_b;    // REG_IN_B（ポストインクリメント値）
+    unsigned char  reg_wen_b;   // REG_WEN_B
+    unsigned char  div_busy;    // DIV_BUSY
+    unsigned char  div_cnt;     // DIV_CNT(4 downto 0)
+    unsigned short div_q;       // DIV_Q
+    unsigned short div_r;       // DIV_R
+    unsigned char  blk_phase;   // BLK_PHASE
+    unsigned char  blk_req;     // BLK_REQ（chapter06 のトップでは open）
+    unsigned char  ldr_phase;   // LDR_PHASE
+    unsigned short ld_save;     // LD_SAVE
+
+    /* reg_file の中身 */
+    unsigned short reg[8];      // RF(0) .. RF(7)
+    unsigned char  valid;       // VALID(7 downto 0)
+
+    /* data_ram の中身 */
+    unsigned short ram[256];    // RAM(0) .. RAM(255)（64/65 は使わない）
+    unsigned short io64_out;    // IO64_OUT
+};
+
+/* --- モデル全体（信号 + 外部入力） --- */
+struct cpu15_model {
+    struct cpu15_sig s;         // 現在値
+    unsigned char    reset_n;   // RESET_N（外部入力）
+    unsigned short   io65_in;   // IO65_IN（外部入力）
+    unsigned long    edges;     // これまでに評価した CLK 立ち上がりの数
+};
+
+/* ============================================================
+   各エンティティの同期プロセス
+   - s: 現在値（読み出し専用）
+   - n: 次値（このエッジでの代入先）
+   VHDL の process(CLK) / if (CE_xx = '1') の中身をそのまま書き写している。
+   ============================================================ */
+
+/* clk_gen.vhd：PH <= PH(2 downto 0) & PH(3)（段イネーブルのリングを1bit回す） */
+static void clk_gen_eval(const struct cpu15_sig *s, struct cpu15_sig *n) {
+    n->ph = ((s->ph << 1) | (s->ph >> 3)) & 0xf;
+}
+
+/* fetch.vhd：PROM_OUT <= MEM(conv_integer(P_COUNT(A_BITS - 1 downto 0)))（A_BITS = 8） */
+static void fetch_eval(const struct cpu15_sig *s, struct cpu15_sig *n) {
+    n->prom_out = prom[s->pc & 0xff];
+}
+
+/* decode.vhd：OP_CODE <= PROM_OUT(15 downto 11); OP_CC <= PROM_OUT(10 downto 8); OP_DATA <= PROM_OUT(7 downto 0) */
+static void decode_eval(const struct cpu15_sig *s, struct cpu15_sig *n) {
+    n->op_code = (s->prom_out >> 11) & 0x1f;
+    n->op_cc   = (s->prom_out >> 8) & 0x7;
+    n->op_data = s->prom_out & 0xff;
+}
+
+/* reg_file.vhd の読み出しA/B（CE_DC）：番号で読んだ RF の値と番号そのものをラッチする。
+   VALID が '0' の番号（リセット後まだ書いていない）は 0 を返す */
+static void reg_file_rd_eval(const struct cpu15_sig *s, struct cpu15_sig *n) {
+    unsigned char na = (s->prom_out >> 8) & 0x7;   // PROM_OUT(10 downto 8)
+    unsigned char nb = (s->prom_out >> 5) & 0x7;   // PROM_OUT(7 downto 5)
+
+    n->reg_a   = (s->valid >> na) & 1 ? s->reg[na] : 0;
+    n->n_reg_a = na;
+    n->reg_b   = (s->valid >> nb) & 1 ? s->reg[nb] : 0;
+    n->n_reg_b = nb;
+}
+
+/* data_ram.vhd（ポートAだけ）：CE_DC='1' の CLK で PROM_OUT(7:0) を読み、
+   CE_WB='1' の CLK で RAM_WEN なら書く。0x40 は IO64_OUT（読むと IO64_OUT）、0x41 は IO65_IN。
+   読み出しは書き込み前の値（read-first）。 */
+static void data_ram_eval(const struct cpu15_sig *s, struct cpu15_sig *n,
+                          unsigned char dc, unsigned char wb, unsigned short io65_in) {
+    unsigned char ad = s->prom_out & 0xff;         // ADDR_A = PROM_OUT(7 downto 0)
+
+    if (dc) {
+        if (ad == 0x41) {
+            n->ram_out = io65_in;
+        } else if (ad == 0x40) {
+            n->ram_out = s->io64_out;
+        } else {
+            n->ram_out = s->ram[ad];
+        }
+    }
+    if (wb && s->ram_wen) {                        // WE_A = CE_WB and RAM_WEN
+        if (ad == 0x40) {
+            n->io64_out = s->ram_in;
+        } else if (ad != 0x41) {
+            n->ram[ad] = s->ram_in;
+        }
+    }
+}
+
+/* exec.vhd の COND_OK：OP_CC の条件がフラグで成立しているか */
+static int exec_cond(const struct cpu15_sig *s) {
+    int lt = s->flag_s ^ s->flag_v;
+
+    switch (s->op_cc) {
+        case 0:  return s->flag_z;                 // EQ
+        case 1:  return !s->flag_z;                // NE
+        case 2:  return lt;                        // LT
+        case 3:  return !lt;                       // GE
+        case 4:  return s->flag_z || lt;           // LE
+        case 5:  return !(s->flag_z || lt);        // GT
+        case 6:  return s->flag_c;                 // B
+        default: return !s->flag_c;                // AE
+    }
+}
+
+/* exec.vhd：OP_CODE に応じて REG_IN/RAM_IN/WEN/PC/フラグを決める */
+static void exec_eval(const struct cpu15_sig *s, struct cpu15_sig *n,
+                      unsigned char reset_n) {
+    unsigned char pc1 = (s->pc + 1) & 0xff;
+    unsigned short r;
+
+    if (reset_n == 0) {
+        n->pc     = 0;
+        n->flag_z = 0;
+        n->flag_c = 0;
+        n->flag_s = 0;
+        n->flag_v = 0;
+        n->sp     = 64;
+        n->reg_wen_b = 0;
+        n->div_busy  = 0;
+        n->blk_phase = 0;
+        n->ldr_phase = 0;
+        n->blk_req   = 0;
+        return;
+    }
+    n->reg_wen_b = 0;                              // 2本目の書き戻しは LDR/STR だけが使う
+    n->blk_req   = 0;                              // ブロック転送の要求は1回の EX だけ
+
+    switch (s->op_code) {
+        case 0x0: n->reg_in = s->reg_b;                               goto reg_write;  // MOV
+        case 0x1: n->reg_in = s->reg_a + s->reg_b;                    goto reg_write;  // ADD
+        case 0x2: n->reg_in = s->reg_a - s->reg_b;                    goto reg_write;  // SUB
+        case 0x3: n->reg_in = s->reg_a & s->reg_b;                    goto reg_write;  // AND
+        case 0x4: n->reg_in = s->reg_a | s->reg_b;                    goto reg_write;  // OR
+        case 0x5: n->reg_in = s->reg_a << 1;                          goto reg_write;  // SL
+        case 0x6: n->reg_in = s->reg_a >> 1;                          goto reg_write;  // SR
+        case 0x7: n->reg_in = (s->reg_a & 0x8000) | (s->reg_a >> 1);  goto reg_write;  // SRA
+        case 0x8: n->reg_in = (s->reg_a & 0xff00) | s->op_data;       goto reg_write;  // LDL
+        case 0x9: n->reg_in = (s->op_data << 8) | (s->reg_a & 0x00ff); goto reg_write; // LDH
+        case 0xd: n->reg_in = s->ram_out;                             goto reg_write;  // LD
+
+        case 0xa:                                                     // CMP
+            r = s->reg_a - s->reg_b;
+            n->flag_z  = (r == 0);
+            n->flag_c  = (s->reg_a < s->reg_b);
+            n->flag_s  = r >> 15;
+            n->flag_v  = ((s->reg_a ^ s->reg_b) & (s->reg_a ^ r)) >> 15;
+            n->reg_wen = 0;
+            n->ram_wen = 0;
+            n->pc      = pc1;
+            return;
+
+        case 0xb:                                                     // JE
+            n->pc      = s->flag_z ? s->op_data : pc1;
+            n->reg_wen = 0;
+            n->ram_wen = 0;
+            return;
+
+        case 0xc:                                                     // JMP
+            n->reg_wen = 0;
+            n->ram_wen = 0;
+            n->pc      = s->op_data;
+            return;
+
+        case 0xe:                                                     // ST
+            n->ram_in  = s->reg_a;
+            n->reg_wen = 0;
+            n->ram_wen = 1;
+            n->pc      = pc1;
+            return;
+
+        case 0x10:                                                    // JCC
+            n->pc      = exec_cond(s) ? s->op_data : pc1;
+            n->reg_wen = 0;
+            n->ram_wen = 0;
+            return;
+
+        case 0x11:                                                    // ADDI（フラグは結果と 0 の比較）
+            r = s->reg_a + (unsigned short)(signed char)s->op_data;
+            n->reg_in  = r;
+            n->flag_z  = (r == 0);
+            n->flag_c  = 0;
+            n->flag_s  = r >> 15;
+            n->flag_v  = 0;
+            goto reg_write;
+
+        /* スタック命令：chapter06 の data_ram の番地は SP を使わないので、
+           RTL と同じく exec 側の SP/PC/WEN だけを再現する */
+        case 0x12:                                                    // CALL
+            n->ram_in  = pc1;
+            n->reg_wen = 0;
+            n->ram_wen = 1;
+            n->sp      = (s->sp - 1) & 0xff;
+            n->pc      = s->op_data;
+            return;
+
+        case 0x13:                                                    // RET
+            n->reg_wen = 0;
+            n->ram_wen = 0;
+            n->sp      = (s->sp + 1) & 0xff;
+            n->pc      = s->ram_out & 0xff;
+            return;
+
+        case 0x14:                                                    // PUSH
+            n->ram_in  = s->reg_a;
+            n->reg_wen = 0;
+            n->ram_wen = 1;
+            n->sp      = (s->sp - 1) & 0xff;
+            n->pc      = pc1;
+            return;
+
+        case 0x15:                                                    // POP
+            n->reg_in  = s->ram_out;
+            n->sp      = (s->sp + 1) & 0xff;
+            goto reg_write;
+
+        /* LDR/STR：chapter06 では RAM アドレスは命令の下位8bitのまま（間接アドレスは chapter09）。
+           書き込みポートが1本なので、LDR のポストインクリメントは2回の EX に分ける */
+        case 0x16:                                                    // LDR
+            if (!(s->op_data & 1)) {
+                n->reg_in = s->ram_out;
+                goto reg_write;
+            }
+            n->ram_wen = 0;
+            if (!s->ldr_phase) {
+                n->ld_save   = s->ram_out;
+                n->reg_wen   = 0;
+                n->reg_in_b  = s->reg_b + 1;
+                n->reg_wen_b = 1;
+                n->ldr_phase = 1;
+                return;
+            }
+            n->reg_in    = s->ld_save;
+            n->ldr_phase = 0;
+            goto reg_write;
+
+        case 0x17:                                                    // STR
+            n->ram_in    = s->reg_a;
+            n->reg_in_b  = s->reg_b + 1;
+            n->reg_wen_b = s->op_data & 1;
+            n->reg_wen   = 0;
+            n->ram_wen   = 1;
+            n->pc        = pc1;
+            return;
+
+        case 0x18:                                                    // MUL
+            n->reg_in = (unsigned short)((unsigned long)s->reg_a * s->reg_b);
+            goto reg_write;
+
+        case 0x19:                                                    // MULHU
+            n->reg_in = (unsigned short)(((unsigned long)s->reg_a * s->reg_b) >> 16);
+            goto reg_write;
+
+        case 0x1a:                                                    // DIVU
+        case 0x1b: {                                                  // MODU
+            /* 引き戻し法の1ステップ（DIV_SH/DIV_SUB/DIV_QN/DIV_RN） */
+            unsigned long sh  = ((unsigned long)s->div_r << 1) | (s->div_q >> 15);
+            int           ok  = sh >= s->reg_b;    // DIV_SUB(17) = '0'
+            unsigned short qn = (unsigned short)((s->div_q << 1) | ok);
+            unsigned short rn = (unsigned short)(ok ? sh - s->reg_b : sh);
+
+            n->ram_wen = 0;
+            if (!s->div_busy) {
+                n->div_q    = s->reg_a;
+                n->div_r    = 0;
+                n->div_cnt  = 16;
+                n->div_busy = 1;
+                n->reg_wen  = 0;
+            } else {
+                n->div_q   = qn;
+                n->div_r   = rn;
+                n->div_cnt = (s->div_cnt - 1) & 0x1f;
+                if (s->div_cnt == 1) {
+                    n->reg_in   = (s->op_code & 1) ? rn : qn;
+                    n->reg_wen  = 1;
+                    n->div_busy = 0;
+                    n->pc       = pc1;
+                } else {
+                    n->reg_wen  = 0;
+                }
+            }
+            return;
+        }
+
+        case 0x1c:                                                    // MCPY
+        case 0x1d:                                                    // MSET
+            /* chapter06 のトップは BLK_BUSY='0' に固定なので、要求を出した次の EX で終わる */
+            n->reg_wen = 0;
+            n->ram_wen = 0;
+            if (!s->blk_phase) {
+                n->blk_req   = 1;
+                n->blk_phase = 1;
+            } else {
+                n->blk_phase = 0;
+                n->pc        = pc1;
+            }
+            return;
+
+        case 0x1e:                                                    // SWAP（LDR と STR を1命令で）
+            n->reg_in  = s->ram_out;
+            n->ram_in  = s->reg_a;
+            n->reg_wen = 1;
+            n->ram_wen = 1;
+            n->pc      = pc1;
+            return;
+
+        case 0xf:                                                     // HLT（PCを止める）
+            n->reg_wen = 0;
+            n->ram_wen = 0;
+            return;
+
+        default:                                                      // 未定義（others => NOP。PC+1 のみ）
+            n->reg_wen = 0;
+            n->ram_wen = 0;
+            n->pc      = pc1;
+            return;
+    }
+
+reg_write:
+    /* レジスタへ書き戻す命令に共通の後半（REG_WEN=1, RAM_WEN=0, PC+1） */
+    n->reg_wen = 1;
+    n->ram_wen = 0;
+    n->pc      = pc1;
+}
+
+/* reg_file.vhd の書き込み（CE_WB）：RESET_N='0' で VALID を全クリア。
+   書き込みポートは1本で、トップが REG_WEN_B='1' なら N_REG_B / REG_IN_B、それ以外は N_REG_A / REG_IN を選ぶ */
+static void reg_file_wr_eval(const struct cpu15_sig *s, struct cpu15_sig *n,
+                             unsigned char reset_n) {
+    unsigned char nw = s->reg_wen_b ? s->n_reg_b : s->n_reg_a;     // N_REG_W
+
+    if (reset_n == 0) {
+        n->valid = 0;
+    } else if (s->reg_wen || s->reg_wen_b) {                        // REG_WE
+        n->reg[nw] = s->reg_wen_b ? s->reg_in_b : s->reg_in;        // REG_W
+        n->valid  |= (unsigned char)(1 << nw);
+    }
+}
+
+/* ============================================================
+   cpu15（トップ）：CLK の立ち上がり1回分を評価する
+   ============================================================ */
+static void cpu15_clock(struct cpu15_model *m) {
+    struct cpu15_sig n;
+    unsigned char ph = m->s.ph;                    // エッジ前の PH ＝ このエッジで動く段
+
+    /* 全プロセスが同じ CLK で動く。段のプロセスは自分の段イネーブルが '1' のときだけ評価する */
+    n = m->s;
+    clk_gen_eval(&m->s, &n);
+    data_ram_eval(&m->s, &n, ph & 2, ph & 8, m->io65_in);
+    if (ph & 1) fetch_eval(&m->s, &n);
+    if (ph & 2) {
+        decode_eval(&m->s, &n);
+        reg_file_rd_eval(&m->s, &n);
+    }
+    if (ph & 4) exec_eval(&m->s, &n, m->reset_n);
+    if (ph & 8) reg_file_wr_eval(&m->s, &n, m->reset_n);
+    m->s = n;
+
+    m->edges++;
+}
+
+/* 電源投入直後の状態（信号の初期値は SP := "01000000"、PH := "0001" 以外すべて 0） */
+static void cpu15_init(struct cpu15_model *m) {
+    struct cpu15_model z = { 0 };
+    *m = z;
+    m->s.sp = 64;
+    m->s.ph = 1;
+}
+
+/*
+  cpu15_sim.vhd と同じ刺激を与える：
+  - CLK は 20ns 周期で t=0 から立ち上がる
+  - RESET_N は最初の 100ns だけ '0'
+  よって CLK の立ち上がり #0〜#4 は RESET_N='0'、#5 以降は '1' として評価する。
+*/
+static void cpu15_stimulus(struct cpu15_model *m) {
+    m->reset_n = (m->edges >= 5);
+}
+
+/* HLT を実行して停止したか（exec が HLT を EX 段で処理し、PC が動かなくなった）
+   EX 段が動いた直後は PH が WB（"1000"）に回っている */
+static int cpu15_halted(const struct cpu15_model *m) {
+    return m->s.ph == 8 && m->s.op_code == 0xf;
+}
+
+/*
+  メイン：
+  - 引数なし：CLK エッジごとのトレースを表示しながら HLT まで実行する
+  - 引数 N  ：トレースを出さずに N エッジ分を繰り返し実行し、速度（エッジ/秒）を表示する
+*/
+int main(int argc, char **argv) {
+    struct cpu15_model m;
+    static const char *stage[9] = { "", "FT", "DC", "", "EX", "", "", "", "WB" };   // PH で引く
+    unsigned char ph;
+
+    cpu15_init(&m);
+
+    if (argc > 1) {
+        unsigned long n = strtoul(argv[1], NULL, 0);
+        unsigned long i;
+        clock_t t0 = clock();
+        double sec;
+
+        for (i = 0; i < n; i++) {
+            cpu15_stimulus(&m);
+            cpu15_clock(&m);
+            if (cpu15_halted(&m)) cpu15_init(&m);   // HLT に達したら電源投入からやり直す
+        }
+        sec = (double)(clock() - t0) / CLOCKS_PER_SEC;
+        printf("%lu edges, %.3f sec, %.1f Medges/s, IO64_OUT = %d\n",
+               n, sec, sec > 0 ? n / sec / 1e6 : 0.0, m.s.io64_out);
+        return 0;
+    }
+
+    /* トレース：CLK立ち上がり番号 / 動いた段 / P_COUNT / PROM_OUT / REG0..3 / IO64_OUT */
+    printf("  edge  stg  P_COUNT  PROM_OUT   REG0   REG1   REG2   REG3  IO64_OUT\n");
+    do {
+        cpu15_stimulus(&m);
+        ph = m.s.ph;
+        cpu15_clock(&m);
+        printf(" %5lu  %s  %7d  %8x  %5d  %5d  %5d  %5d  %8d\n",
+               m.edges - 1, stage[ph], m.s.pc, m.s.prom_out,
+               m.s.reg[0], m.s.reg[1], m.s.reg[2], m.s.reg[3], m.s.io64_out);
+    } while (!cpu15_halted(&m));
+
+    printf("IO64_OUT = %d \n", m.s.io64_out);
+
+    return 0;
+}
+
+/*
+  【GNUでのコンパイル例（Ubuntu / gcc）】
+    gcc -O2 cpu15_model.c -o cpu15_model
+
+  【実行例】
+    ./cpu15_model              # CLKエッジごとのトレース（最後に IO64_OUT = 55）
+    ./cpu15_model 100000000    # 1億エッジ分の速度計測
+*/
@@ -0,0 +1,568 @@
+-- cpu15_pipe.vhd（詳細コメント版：4段を重ねて動かすパイプライン版 cpu15 トップ）
+--
+-- 【このファイルの位置づけ】
+-- - cpu15.vhd は clk_gen の4相クロックで FT→DC→EX→WB を「1段ずつ順番に」動かす。
+--   ある瞬間に働いているのは4段のうち1段だけなので、ベースクロック4回で1命令（CPI=4）になる。
+-- - 本ファイルは同じ命令セット・同じ I/O（IO64_OUT / IO65_IN）のまま、
+--   4段すべてを同じ CLK で毎サイクル動かすパイプライン版である。
+--   命令が途切れなければベースクロック1回で1命令が完了する（CPI≒1）。
+--
+-- 【段構成（すべて CLK の立ち上がりで進む）】
+--
+--     IF  : fetch_pq.vhd（fetch.vhd ＋ 分岐予測 ＋ 先読みキュー）。命令語を INSN に出す
+--     ID  : INSN を分解し、レジスタファイル／RAM を読んで ID/EX レジスタ（EX_xxx）へ
+--     EX  : ALU・分岐判定・フラグ更新。結果を EX/WB レジスタ（WB_xxx）へ
+--     WB  : reg_file.vhd / data_ram.vhd（ポートB）に WB_xxx を書き込む
+--
+-- - fetch（fetch_pq の中）/ reg_file は段イネーブル（CE_FT / CE_WB）を '1' に固定するだけで、
+--   「毎サイクル動く段」としてそのまま再利用できる（中身は変えていない）。
+-- - ID のレジスタ読み出しは reg_file の非同期読み出しポート C / D を使う。
+--   同期読み出し A / B（CE_DC でラッチ）は4相版用なので、ここでは CE_DC='0' にして使わない。
+-- - データメモリは data_ram（256語、真の2ポート）。ID が INSN を取り込むエッジで
+--   ポートA に番地を出すと、出力レジスタ（1サイクルレイテンシ）の値がちょうど EX 段で DOUT_A に出る。
+--   ID/EX レジスタの EX_RAM の役目を data_ram の出力レジスタが受け持つ形になる。
+--   WB の書き込みはポートB なので、ID の読み出しと同じエッジに重なってもかまわない。
+-- - decode / exec は使わない。
+--   exec は PC を自分で持っていて「1命令実行したら PC+1」という逐次実行前提なので、
+--   先読みする IF 段の PC とは役割が合わない。ID と EX はこのファイルの中に直接書く。
+--
+-- 【データハザードとフォワーディング】
+-- - 書き込みは WB 段（EX の次のサイクル）でしか起きないので、直前の命令の結果を
+--   読みたい命令は、レジスタファイルがまだ古い値のうちに読んでしまう。
+--   4段構成では次の2通りしかないので、どちらも WB_xxx（EX/WB レジスタ）から回す。
+--
+--     距離1（i の直後の i+1）：i が WB 段にいるとき i+1 は EX 段にいる。
+--        → EX の入力で WB_REG_IN に差し替える（EX_A → A_F、EX_B → B_F）。
+--     距離2（i+2）：i が WB で書き込むのと同じエッジで i+2 が ID でレジスタを読む。
+--        → ID の読み出しポートで WB_REG_IN に差し替える（書き込みスルー）。
+--
+-- - RAM も同じ形（ST の直後の LD）なので、番地が一致したら WB_RAM_IN を回す。
+--   ただし data_ram は同じエッジの読みと書きが重なると書く前の値を出す（read-first）ので、
+--   距離2は ID で差し替えられない。代わりにそのエッジで WB_RAM_IN を EX_RAM にラッチし、
+--   EX_RAM_FWD='1' で DOUT_A の代わりに使う。
+-- - 65番地（IO65）は読み出し専用の入力で、data_ram は書き込みを捨てて常に IO65_IN を返す。
+--   だから WB の番地が 65 のときはどちらの距離でも回さない（ST 65 の直後の LD 65 も IO65_IN を読む）。
+-- - この2か所のフォワーディングだけで、レジスタ・RAM の依存でストールすることはない。
+--
+-- 【制御ハザード（分岐）：静的予測とフラッシュ】
+-- - IF（fetch_pq）は ROM から出てきた分岐命令をその場でプリデコードし、
+--   JMP と後ろ向きの JE/JCC は成立、前向きの JE/JCC は不成立と予測して次の番地を読む（BTFN）。
+--   予測が当たれば分岐による損失は無い。
+-- - JE/JMP/JCC は EX 段で成否が決まる。予測（EX_PRED）と違ったときは
+--     ・そのエッジで正しい番地（成立なら EX_DATA、不成立なら EX_PC+1）を直接フェッチさせ（REDIRECT）、
+--     ・ID 段にいた誤った命令を捨てる（EX_V <= '0'）。fetch_pq の先読みキューも捨てる。
+--   INSN の次はもう EX なので、先読みしてしまうのは ID の1命令だけで、
+--   予測を外した分岐1回につき1サイクルを失う。
+-- - HLT が EX に来たら HALT を立て、以後の命令はすべて無効にする（PC は HLT の次で止まる）。
+--
+-- 【構造ハザード：DIVU/MODU のストール】
+-- - 除算は exec.vhd と同じ1ビット/サイクルの引き戻し法で、EX 段に17サイクルとどまる。
+-- - その間 ID は止め（fetch_pq に TAKE='0' を返す。IF は先読みキューが埋まるまで読み進める）、
+--   WB には何も書かない泡（バブル）を流す。
+-- - ストール中も EX_A/EX_B はフォワーディング後の値で取り直すので、
+--   除算の直前の命令の結果が WB から抜けたあとも正しい除数を使い続けられる。
+--
+-- 【対応している命令】
+-- - chapter06 の構成（命令の下位8bitで RAM/IO64/IO65 を指す）で意味を持つ命令：
+--   MOV〜HLT の16命令、JCC、ADDI、MUL/MULHU、DIVU/MODU。
+-- - スタック（CALL/RET/PUSH/POP）、間接アドレス（LDR/STR/SWAP）、ブロック転送（MCPY/MSET）は
+--   chapter09 の ram_dc_wb を前提にした命令で、cpu15.vhd でも正しく動かないため、
+--   ここでは何も書かずに次へ進む（NOP 扱い）。
+--
+-- 【検証】
+-- - cpu15_pipe_sim.vhd が cpu15（4相版）と本パイプライン版を同じ CLK で並べて動かし、
+--   IO64_OUT に出る値の列が一致すること、完了までのサイクル数を比べる。
+
+
+library IEEE;
+use IEEE.std_logic_1164.all;
+use IEEE.std_logic_unsigned.all;
+use work.cpu15_isa.all;
+
+-- ============================================================
+-- entity: cpu15 と同じ外部インタフェース（差し替えできるように）
+-- ============================================================
+entity cpu15_pipe is
+    generic
+    (
+        -- 命令ROM の初期化ファイル（"" なら fetch.vhd の SUM_PROG。fetch_pq → fetch に渡す）
+        ROM_FILE  : string := ""
+    );
+    port
+    (
+        -- ベースクロック（4段すべてがこの立ち上がりで進む）
+        CLK       : in  std_logic;
+
+        -- アクティブLowリセット（CLK に同期）
+        RESET_N   : in  std_logic;
+
+        -- 外部入力（65番地として LD で読む）
+        IO65_IN   : in  std_logic_vector(15 downto 0);
+
+        -- 外部出力（64番地への ST で更新される）
+        IO64_OUT  : out std_logic_vector(15 downto 0)
+    );
+end cpu15_pipe;
+
+architecture RTL of cpu15_pipe is
+
+    -- --------------------------------------------------------
+    -- 再利用する段部品（段イネーブルを '1' に固定する）
+    -- --------------------------------------------------------
+    component fetch_pq
+        generic
+        (
+            ROM_FILE    : string
+        );
+        port
+        (
+            CLK         : in  std_logic;
+            RESET_N     : in  std_logic;
+            TAKE        : in  std_logic;
+            REDIRECT    : in  std_logic;
+            REDIRECT_PC : in  std_logic_vector(7 downto 0);
+            INSN        : out std_logic_vector(15 downto 0);
+            INSN_PC     : out std_logic_vector(7 downto 0);
+            INSN_V      : out std_logic;
+            INSN_PRED   : out std_logic
+        );
+    end component;
+
+    component reg_file
+        generic
+        (
+            N_BITS     : integer
+        );
+        port
+        (
+            CLK        : in  std_logic;
+            CE_DC      : in  std_logic;
+            CE_WB      : in  std_logic;
+            RESET_N    : in  std_logic;
+            N_REG_A_IN : in  std_logic_vector(N_BITS - 1 downto 0);
+            N_REG_B_IN : in  std_logic_vector(N_BITS - 1 downto 0);
+            N_REG_A    : out std_logic_vector(N_BITS - 1 downto 0);
+            N_REG_B    : out std_logic_vector(N_BITS - 1 downto 0);
+            REG_A      : out std_logic_vector(15 downto 0);
+            REG_B      : out std_logic_vector(15 downto 0);
+            N_REG_C    : in  std_logic_vector(N_BITS - 1 downto 0);
+            REG_C      : out std_logic_vector(15 downto 0);
+            N_REG_D    : in  std_logic_vector(N_BITS - 1 downto 0);
+            REG_D      : out std_logic_vector(15 downto 0);
+            N_REG_W    : in  std_logic_vector(N_BITS - 1 downto 0);
+            REG_IN     : in  std_logic_vector(15 downto 0);
+            REG_WEN    : in  std_logic
+        );
+    end component;
+
+    -- データメモリ：ポートA で ID の読み出し、ポートB で WB の書き込み
+    component data_ram
+        generic
+        (
+            A_BITS   : integer := 8
+        );
+        port
+        (
+            CLK      : in  std_logic;
+            EN_A     : in  std_logic;
+            ADDR_A   : in  std_logic_vector(7 downto 0);
+            DIN_A    : in  std_logic_vector(15 downto 0);
+            WE_A     : in  std_logic;
+            DOUT_A   : out std_logic_vector(15 downto 0);
+            EN_B     : in  std_logic;
+            ADDR_B   : in  std_logic_vector(7 downto 0);
+            DIN_B    : in  std_logic_vector(15 downto 0);
+            WE_B     : in  std_logic;
+            DOUT_B   : out std_logic_vector(15 downto 0);
+            IO65_IN  : in  std_logic_vector(15 downto 0);
+            IO64_OUT : out std_logic_vector(15 downto 0)
+        );
+    end component;
+
+    -- --------------------------------------------------------
+    -- IF 段
+    -- --------------------------------------------------------
+    signal INSN     : std_logic_vector(15 downto 0);   -- ID 段の命令語
+    signal INSN_PC  : std_logic_vector(7 downto 0);    -- その番地
+    signal INSN_V   : std_logic;                       -- 有効な命令か
+    signal INSN_PRED: std_logic;                       -- IF が成立と予測したか
+    signal TAKE     : std_logic;                       -- ID/EX がこのエッジで INSN を取り込む
+
+    -- --------------------------------------------------------
+    -- ID 段（組合せ）
+    -- --------------------------------------------------------
+    signal RF_A     : std_logic_vector(15 downto 0);   -- レジスタファイルの読み出し（[10:8] 番）
+    signal RF_B     : std_logic_vector(15 downto 0);   -- レジスタファイルの読み出し（[7:5] 番）
+    signal ID_A     : std_logic_vector(15 downto 0);   -- 書き込みスルー後
+    signal ID_B     : std_logic_vector(15 downto 0);
+
+    -- --------------------------------------------------------
+    -- ID/EX レジスタ
+    -- --------------------------------------------------------
+    signal EX_V     : std_logic := '0';
+    signal EX_OP    : std_logic_vector(4 downto 0);
+    signal EX_CC    : std_logic_vector(2 downto 0);
+    signal EX_NA    : std_logic_vector(2 downto 0);
+    signal EX_NB    : std_logic_vector(2 downto 0);
+    signal EX_DATA  : std_logic_vector(7 downto 0);
+    signal EX_PC    : std_logic_vector(7 downto 0);
+    signal EX_PRED  : std_logic;
+    signal EX_A     : std_logic_vector(15 downto 0);
+    signal EX_B     : std_logic_vector(15 downto 0);
+    signal EX_RAM   : std_logic_vector(15 downto 0);   -- 距離2で回した値（EX_RAM_FWD='1' のとき使う）
+    signal EX_RAM_FWD : std_logic := '0';
+    signal RAM_DOUT : std_logic_vector(15 downto 0);   -- data_ram の出力レジスタ（EX 段の命令が読んだ語）
+
+    -- --------------------------------------------------------
+    -- EX 段（組合せ）
+    -- --------------------------------------------------------
+    signal A_F      : std_logic_vector(15 downto 0);   -- フォワーディング後のオペランド
+    signal B_F      : std_logic_vector(15 downto 0);
+    signal EX_MEM   : std_logic_vector(15 downto 0);   -- EX 段の命令が読んだ語（距離2 の差し替え後）
+    signal RAM_F    : std_logic_vector(15 downto 0);
+    signal CMP_R    : std_logic_vector(15 downto 0);
+    signal IMM_SX   : std_logic_vector(15 downto 0);
+    signal ADDI_R   : std_logic_vector(15 downto 0);
+    signal MUL_R    : std_logic_vector(31 downto 0);
+    signal COND_OK  : std_logic;
+    signal EX_TAKEN : std_logic;                       -- EX の分岐が成立
+    signal EX_MISS  : std_logic;                       -- 予測外れ（ID をフラッシュし IF を読み直させる）
+    signal FIX_PC   : std_logic_vector(7 downto 0);    -- 予測外れのときの正しい番地
+    signal EX_STALL : std_logic;                       -- EX が次のサイクルも同じ命令を続ける（除算）
+    signal EX_HLT   : std_logic;
+    signal HALT     : std_logic := '0';
+
+    -- フラグ（exec.vhd と同じ意味）
+    signal FLAG_Z   : std_logic := '0';
+    signal FLAG_C   : std_logic := '0';
+    signal FLAG_S   : std_logic := '0';
+    signal FLAG_V   : std_logic := '0';
+
+    -- 除算器（exec.vhd と同じ引き戻し法）
+    signal DIV_BUSY : std_logic := '0';
+    signal DIV_CNT  : std_logic_vector(4 downto 0);
+    signal DIV_Q    : std_logic_vector(15 downto 0);
+    signal DIV_R    : std_logic_vector(15 downto 0);
+    signal DIV_SH   : std_logic_vector(16 downto 0);
+    signal DIV_SUB  : std_logic_vector(17 downto 0);
+    signal DIV_QN   : std_logic_vector(15 downto 0);
+    signal DIV_RN   : std_logic_vector(15 downto 0);
+
+    -- --------------------------------------------------------
+    -- EX/WB レジスタ（reg_file / data_ram の書き込みポートの入力）
+    -- --------------------------------------------------------
+    signal WB_N       : std_logic_vector(2 downto 0);
+    signal WB_REG_IN  : std_logic_vector(15 downto 0);
+    signal WB_REG_WEN : std_logic := '0';
+    signal WB_ADDR    : std_logic_vector(7 downto 0);
+    signal WB_RAM_IN  : std_logic_vector(15 downto 0);
+    signal WB_RAM_WEN : std_logic := '0';
+
+begin
+
+    -- ========================================================
+    -- IF 段：fetch_pq（予測と先読みキューつき）
+    -- ========================================================
+    -- 除算ストール中と停止後は ID が受け取らない。予測外れなら EX が正しい番地を渡す。
+    TAKE <= not (EX_STALL or HALT);
+
+    P1 : fetch_pq generic map(
+        ROM_FILE    => ROM_FILE
+    ) port map(
+        CLK         => CLK,
+        RESET_N     => RESET_N,
+        TAKE        => TAKE,
+        REDIRECT    => EX_MISS,
+        REDIRECT_PC => FIX_PC,
+        INSN        => INSN,
+        INSN_PC     => INSN_PC,
+        INSN_V      => INSN_V,
+        INSN_PRED   => INSN_PRED
+    );
+
+    -- ========================================================
+    -- ID 段：レジスタファイルの読み出し（組合せ）
+    -- ========================================================
+    -- reg_file の非同期読み出し C / D（RF_A / RF_B）。実体は下の WB 段の P2。
+
+    -- 距離2のフォワーディング（書き込みスルー）：
+    -- WB がこのエッジで書く値を、同じエッジで ID/EX に取り込む
+    ID_A   <= WB_REG_IN when (WB_REG_WEN = '1' and WB_N = INSN(10 downto 8)) else RF_A;
+    ID_B   <= WB_REG_IN when (WB_REG_WEN = '1' and WB_N = INSN(7 downto 5))  else RF_B;
+
+    -- ========================================================
+    -- EX 段：オペランドの選択と演算（組合せ）
+    -- ========================================================
+    -- 距離1のフォワーディング：直前の命令は WB 段にいて、まだ書き込まれていない
+    A_F    <= WB_REG_IN when (WB_REG_WEN = '1' and WB_N = EX_NA) else EX_A;
+    B_F    <= WB_REG_IN when (WB_REG_WEN = '1' and WB_N = EX_NB) else EX_B;
+    EX_MEM <= EX_RAM when EX_RAM_FWD = '1' else RAM_DOUT;
+    RAM_F  <= WB_RAM_IN when (WB_RAM_WEN = '1' and WB_ADDR = EX_DATA and WB_ADDR /= "01000001") else EX_MEM;
+
+    CMP_R   <= A_F - B_F;
+    IMM_SX  <= X"FF" & EX_DATA when EX_DATA(7) = '1' else X"00" & EX_DATA;
+    ADDI_R  <= A_F + IMM_SX;
+    MUL_R   <= A_F * B_F;
+
+    DIV_SH  <= DIV_R & DIV_Q(15);
+    DIV_SUB <= ('0' & DIV_SH) - ("00" & B_F);
+    DIV_QN  <= DIV_Q(14 downto 0) & not DIV_SUB(17);
+    DIV_RN  <= DIV_SUB(15 downto 0) when DIV_SUB(17) = '0' else DIV_SH(15 downto 0);
+
+    COND_OK <= FLAG_Z                                  when EX_CC = CC_EQ else
+               not FLAG_Z                              when EX_CC = CC_NE else
+               FLAG_S xor FLAG_V                       when EX_CC = CC_LT else
+               not (FLAG_S xor FLAG_V)                 when EX_CC = CC_GE else
+               FLAG_Z or (FLAG_S xor FLAG_V)           when EX_CC = CC_LE else
+               not (FLAG_Z or (FLAG_S xor FLAG_V))     when EX_CC = CC_GT else
+               FLAG_C                                  when EX_CC = CC_B  else
+               not FLAG_C;
+
+    -- 分岐の成否（EX で確定）。IF の予測と違えば ID にいる1命令を捨てて読み直させる
+    EX_TAKEN <= '1' when EX_OP = OP_JMP or
+                         (EX_OP = OP_JE  and FLAG_Z  = '1') or
+                         (EX_OP = OP_JCC and COND_OK = '1') else '0';
+    EX_MISS  <= '1' when EX_V = '1' and HALT = '0' and
+                         (EX_OP = OP_JMP or EX_OP = OP_JE or EX_OP = OP_JCC) and
+                         EX_TAKEN /= EX_PRED else '0';
+    FIX_PC   <= EX_DATA when EX_TAKEN = '1' else EX_PC + 1;
+
+    -- 除算は最後のビット（DIV_BUSY='1' かつ DIV_CNT=1）以外のサイクルで EX にとどまる
+    EX_STALL <= '1' when EX_V = '1' and HALT = '0' and
+                         (EX_OP = OP_DIVU or EX_OP = OP_MODU) and
+                         not (DIV_BUSY = '1' and DIV_CNT = "00001") else '0';
+
+    EX_HLT   <= '1' when EX_V = '1' and EX_OP = OP_HLT else '0';
+
+    -- ========================================================
+    -- パイプラインレジスタの更新（ID/EX）
+    -- ========================================================
+    process(CLK)
+    begin
+        if (CLK'event and CLK = '1') then
+            if (RESET_N = '0') then
+                EX_V  <= '0';
+                HALT  <= '0';
+
+            elsif (HALT = '1') then
+                -- 停止中：何も流さない
+                EX_V <= '0';
+
+            elsif (EX_HLT = '1') then
+                -- HLT が EX に来た：後ろの命令は捨てて止まる
+                HALT <= '1';
+                EX_V <= '0';
+
+            elsif (EX_MISS = '1') then
+                -- 予測外れ：このエッジで fetch_pq は正しい番地を読んでいる
+                EX_V  <= '0';          -- ID にいた命令（予測した側の命令）を捨てる
+
+            elsif (EX_STALL = '1') then
+                -- 除算中：ID は INSN を受け取らない（TAKE='0'）。
+                -- EX のオペランドは WB から回した値で取り直しておく
+                -- （RAM の語も RAM_F を EX_RAM に移し、以後は data_ram の出力ではなくこちらを使う）
+                EX_A   <= A_F;
+                EX_B   <= B_F;
+                EX_RAM <= RAM_F;
+                EX_RAM_FWD <= '1';
+
+            else
+                EX_V    <= INSN_V;
+                EX_OP   <= INSN(15 downto 11);
+                EX_CC   <= INSN(10 downto 8);
+                EX_NA   <= INSN(10 downto 8);
+                EX_NB   <= INSN(7 downto 5);
+                EX_DATA <= INSN(7 downto 0);
+                EX_PC   <= INSN_PC;
+                EX_PRED <= INSN_PRED;
+                EX_A    <= ID_A;
+                EX_B    <= ID_B;
+                -- RAM の語は data_ram の出力レジスタに入る。距離2（このエッジの WB 書き込み）だけ回す
+                EX_RAM  <= WB_RAM_IN;
+                if (WB_RAM_WEN = '1' and WB_ADDR = INSN(7 downto 0) and INSN(7 downto 0) /= "01000001") then
+                    EX_RAM_FWD <= '1';
+                else
+                    EX_RAM_FWD <= '0';
+                end if;
+            end if;
+        end if;
+    end process;
+
+    -- ========================================================
+    -- EX 段の実行（EX/WB レジスタとフラグ・除算器の更新）
+    -- ========================================================
+    process(CLK)
+    begin
+        if (CLK'event and CLK = '1') then
+            -- 既定は泡（何も書かない）
+            WB_REG_WEN <= '0';
+            WB_RAM_WEN <= '0';
+            WB_N       <= EX_NA;
+            WB_ADDR    <= EX_DATA;
+
+            if (RESET_N = '0') then
+                FLAG_Z   <= '0';
+                FLAG_C   <= '0';
+                FLAG_S   <= '0';
+                FLAG_V   <= '0';
+                DIV_BUSY <= '0';
+
+            elsif (EX_V = '1' and HALT = '0') then
+                case EX_OP is
+                    when OP_MOV =>
+                        WB_REG_IN  <= B_F;
+                        WB_REG_WEN <= '1';
+                    when OP_ADD =>
+                        WB_REG_IN  <= A_F + B_F;
+                        WB_REG_WEN <= '1';
+                    when OP_SUB =>
+                        WB_REG_IN  <= A_F - B_F;
+                        WB_REG_WEN <= '1';
+                    when OP_AND =>
+                        WB_REG_IN  <= A_F and B_F;
+                        WB_REG_WEN <= '1';
+                    when OP_OR =>
+                        WB_REG_IN  <= A_F or B_F;
+                        WB_REG_WEN <= '1';
+                    when OP_SL =>
+                        WB_REG_IN  <= A_F(14 downto 0) & '0';
+                        WB_REG_WEN <= '1';
+                    when OP_SR =>
+                        WB_REG_IN  <= '0' & A_F(15 downto 1);
+                        WB_REG_WEN <= '1';
+                    when OP_SRA =>
+                        WB_REG_IN  <= A_F(15) & A_F(15 downto 1);
+                        WB_REG_WEN <= '1';
+                    when OP_LDL =>
+                        WB_REG_IN  <= A_F(15 downto 8) & EX_DATA;
+                        WB_REG_WEN <= '1';
+                    when OP_LDH =>
+                        WB_REG_IN  <= EX_DATA & A_F(7 downto 0);
+                        WB_REG_WEN <= '1';
+
+                    when OP_CMP =>
+                        if (CMP_R = X"0000") then
+                            FLAG_Z <= '1';
+                        else
+                            FLAG_Z <= '0';
+                        end if;
+                        if (A_F < B_F) then
+                            FLAG_C <= '1';
+                        else
+                            FLAG_C <= '0';
+                        end if;
+                        FLAG_S <= CMP_R(15);
+                        FLAG_V <= (A_F(15) xor B_F(15)) and (A_F(15) xor CMP_R(15));
+
+                    when OP_LD =>
+                        WB_REG_IN  <= RAM_F;
+                        WB_REG_WEN <= '1';
+                    when OP_ST =>
+                        WB_RAM_IN  <= A_F;
+                        WB_RAM_WEN <= '1';
+
+                    when OP_ADDI =>
+                        WB_REG_IN  <= ADDI_R;
+                        WB_REG_WEN <= '1';
+                        if (ADDI_R = X"0000") then
+                            FLAG_Z <= '1';
+                        else
+                            FLAG_Z <= '0';
+                        end if;
+                        FLAG_C <= '0';
+                        FLAG_S <= ADDI_R(15);
+                        FLAG_V <= '0';
+
+                    when OP_MUL =>
+                        WB_REG_IN  <= MUL_R(15 downto 0);
+                        WB_REG_WEN <= '1';
+                    when OP_MULHU =>
+                        WB_REG_IN  <= MUL_R(31 downto 16);
+                        WB_REG_WEN <= '1';
+
+                    when OP_DIVU | OP_MODU =>
+                        if (DIV_BUSY = '0') then
+                            DIV_Q    <= A_F;
+                            DIV_R    <= "0000000000000000";
+                            DIV_CNT  <= "10000";
+                            DIV_BUSY <= '1';
+                        else
+                            DIV_Q   <= DIV_QN;
+                            DIV_R   <= DIV_RN;
+                            DIV_CNT <= DIV_CNT - 1;
+                            if (DIV_CNT = "00001") then
+                                if (EX_OP(0) = '0') then
+                                    WB_REG_IN <= DIV_QN;
+                                else
+                                    WB_REG_IN <= DIV_RN;
+                                end if;
+                                WB_REG_WEN <= '1';
+                                DIV_BUSY   <= '0';
+                            end if;
+                        end if;
+
+                    -- JE/JMP/JCC は EX_MISS で、HLT は EX_HLT で処理済み。
+                    -- スタック・間接・ブロック転送は chapter09 の構成用（ここでは NOP）
+                    when others =>
+                        null;
+                end case;
+            end if;
+        end if;
+    end process;
+
+    -- ========================================================
+    -- WB 段：reg_file.vhd を毎サイクル書き、data_ram のポートB に書く
+    -- ========================================================
+    -- 読み出しは ID 段が非同期ポート C / D で行う（同期ポート A / B は使わない）。
+    P2 : reg_file
+        generic map(
+            N_BITS     => 3
+        )
+        port map(
+            CLK        => CLK,
+            CE_DC      => '0',
+            CE_WB      => '1',            -- 毎サイクル書く
+            RESET_N    => RESET_N,
+            N_REG_A_IN => "000",
+            N_REG_B_IN => "000",
+            N_REG_A    => open,
+            N_REG_B    => open,
+            REG_A      => open,
+            REG_B      => open,
+            N_REG_C    => INSN(10 downto 8),
+            REG_C      => RF_A,
+            N_REG_D    => INSN(7 downto 5),
+            REG_D      => RF_B,
+            N_REG_W    => WB_N,
+            REG_IN     => WB_REG_IN,
+            REG_WEN    => WB_REG_WEN
+        );
+
+    -- ID の読み出し（ポートA）は TAKE のエッジで番地を取り込み、EX 段で RAM_DOUT に出る
+    P3 : data_ram generic map(
+        A_BITS   => 8
+    ) port map(
+        CLK      => CLK,
+        EN_A     => TAKE,
+        ADDR_A   => INSN(7 downto 0),
+        DIN_A    => "0000000000000000",
+        WE_A     => '0',
+        DOUT_A   => RAM_DOUT,
+        EN_B     => '0',
+        ADDR_B   => WB_ADDR,
+        DIN_B    => WB_RAM_IN,
+        WE_B     => WB_RAM_WEN,
+        DOUT_B   => open,
+        IO65_IN  => IO65_IN,
+        IO64_OUT => IO64_OUT
+    );
+
+end RTL;
+
+-- 【波形での観察ポイント】
+-- - INSN_PC が毎サイクル進み、JMP（後ろ向き）は予測どおりそのまま 8 番地へ続く。
+--   ループ出口の前向き JE だけが予測外れで、直後の EX_V が '0' になる
+-- - ADD Reg2, Reg1 → ADD Reg0, Reg2 のような連続依存で A_F/B_F が WB_REG_IN に切り替わる
+-- - サンプルプログラム（1+2+…+10）の IO64_OUT 最終値は cpu15.vhd と同じ 55。
+--   ループ1周（8〜13番地の6命令）は 6 サイクルで、4相版の 24 サイクルに対して4倍。
+--   （予測なしで毎回 JMP をフラッシュしていたときは 7 サイクルだった）
@@ -0,0 +1,238 @@
+-- cpu15_pipe_sim.vhd（詳細コメント版：4相版 cpu15 とパイプライン版 cpu15_pipe を並べて比べるテストベンチ）
+--
+-- 【このファイルの目的】
+-- - cpu15.vhd（clk_gen の4相で1段ずつ動く版）と cpu15_pipe.vhd（4段を毎サイクル重ねて動かす版）に
+--   同じ CLK・同じ RESET_N・同じ IO65_IN を与え、IO64_OUT に出てくる値の列が一致することを確かめる。
+-- - 命令ROM はどちらも generic ROM_FILE で同じものを選ぶ。既定（""）は fetch.vhd の SUM_PROG
+--   （1+2+…+10 の総和プログラム）で、ループ1周ごとに 1, 3, 6, …, 55 の10個が IO64_OUT に出る。
+--   chapter03 のエミュレータ（アセンブラ）が書き出したイメージを渡せば、そのプログラムで両方を比べる。
+-- - パイプライン版はフォワーディングと分岐フラッシュで同じ結果を出しつつ、
+--   最後の書き込み（55）までの時間が短くなる。その時間も報告する。
+--
+-- - もう1組、65番地（IO65）の読み出しのプログラム（chapter03 cpu15.h の cpu15_load_io65）を
+--   両方に流す。65番地に ST した直後（距離1）と1命令あけて（距離2）LD し、足して 64番地に書く。
+--   65番地は読み出し専用の入力なので、IO65_IN を 7 にしておけば答えは 14。
+--   パイプライン版が書いた 5 を RAM のフォワーディングで回してしまうと 10 や 12 になる。
+--
+-- 【比較のしかた】
+-- - IO64_OUT が変化するたびに、その値を REF_LOG / PIPE_LOG に順番に記録する。
+--   （サンプルプログラムは毎回ちがう値を書くので「変化」＝「書き込み」とみなせる。
+--   同じ値を続けて書くプログラムでは、続けて書いた分は1回に数えられる）
+-- - 十分な時間（RUN_TIME）が経ったら、個数と各値を突き合わせて assert する。
+--   一致すれば note、ずれていれば error を出す。
+--
+-- 【使い方】
+-- - ROM イメージを作る：CPU_emulator -p io65 -o io65.hex（chapter03）
+-- - 解析順：cpu15_isa.vhd → clk_gen / fetch / decode / reg_file / data_ram
+--   → chapter05 の half_adder / full_adder / adder_nbit（exec が使う）→ exec
+--   → fetch_pq.vhd → cpu15.vhd → cpu15_pipe.vhd → 本ファイル。トップは cpu15_pipe_sim。
+-- - 別のプログラムで比べるとき（chapter06 の構成で動く命令だけを使うもの。sum / addi / mul）：
+--     CPU_emulator -p mul -o mul.hex（chapter03）
+--     シミュレータの generic 上書きで ROM_FILE=mul.hex（GHDL なら -gROM_FILE=mul.hex）。
+--     ループの長いプログラムは RUN_TIME も延ばす。
+
+
+library IEEE;
+use IEEE.std_logic_1164.all;
+use IEEE.std_logic_unsigned.all;
+
+entity cpu15_pipe_sim is
+    generic
+    (
+        ROM_FILE : string := "";          -- 両方の命令ROM（"" なら SUM_PROG）
+        RUN_TIME : time   := 8000 ns      -- 20ns 周期で 400 サイクル。4相版でも総和プログラムが終わる長さ
+    );
+end cpu15_pipe_sim;
+
+architecture SIM of cpu15_pipe_sim is
+
+    -- 4相版（基準）
+    component cpu15
+        generic
+        (
+            ROM_FILE  : string
+        );
+        port
+        (
+            CLK       : in  std_logic;
+            RESET_N   : in  std_logic;
+            IO65_IN   : in  std_logic_vector(15 downto 0);
+            IO64_OUT  : out std_logic_vector(15 downto 0)
+        );
+    end component;
+
+    -- パイプライン版（検証対象）
+    component cpu15_pipe
+        generic
+        (
+            ROM_FILE  : string
+        );
+        port
+        (
+            CLK       : in  std_logic;
+            RESET_N   : in  std_logic;
+            IO65_IN   : in  std_logic_vector(15 downto 0);
+            IO64_OUT  : out std_logic_vector(15 downto 0)
+        );
+    end component;
+
+    -- IO64_OUT に出た値の記録
+    type LOG is array (0 to 15) of std_logic_vector(15 downto 0);
+
+    signal CLK       : std_logic;
+    signal RESET_N   : std_logic;
+    signal IO65_IN   : std_logic_vector(15 downto 0) := (others => '0');
+
+    signal IO64_REF  : std_logic_vector(15 downto 0);
+    signal IO64_PIPE : std_logic_vector(15 downto 0);
+
+    -- 65番地の読み出し（io65.hex）の組
+    constant IO65_ROM : string := "io65.hex";
+    constant IO65_V   : std_logic_vector(15 downto 0) := X"0007";
+    constant IO65_EXP : std_logic_vector(15 downto 0) := X"000E";     -- 入力の2倍
+    signal IO64_REF65  : std_logic_vector(15 downto 0);
+    signal IO64_PIPE65 : std_logic_vector(15 downto 0);
+
+    signal REF_LOG   : LOG;
+    signal PIPE_LOG  : LOG;
+    signal REF_N     : integer := 0;        -- 記録した個数
+    signal PIPE_N    : integer := 0;
+    signal REF_T     : time := 0 ns;        -- 最後に書かれた時刻
+    signal PIPE_T    : time := 0 ns;
+
+begin
+
+    -- ========================================================
+    -- DUT：同じ入力を2つのCPUに配る
+    -- ========================================================
+    U_REF : cpu15 generic map(
+        ROM_FILE => ROM_FILE
+    ) port map(
+        CLK      => CLK,
+        RESET_N  => RESET_N,
+        IO65_IN  => IO65_IN,
+        IO64_OUT => IO64_REF
+    );
+
+    U_PIPE : cpu15_pipe generic map(
+        ROM_FILE => ROM_FILE
+    ) port map(
+        CLK      => CLK,
+        RESET_N  => RESET_N,
+        IO65_IN  => IO65_IN,
+        IO64_OUT => IO64_PIPE
+    );
+
+    U_REF65 : cpu15 generic map(
+        ROM_FILE => IO65_ROM
+    ) port map(
+        CLK      => CLK,
+        RESET_N  => RESET_N,
+        IO65_IN  => IO65_V,
+        IO64_OUT => IO64_REF65
+    );
+
+    U_PIPE65 : cpu15_pipe generic map(
+        ROM_FILE => IO65_ROM
+    ) port map(
+        CLK      => CLK,
+        RESET_N  => RESET_N,
+        IO65_IN  => IO65_V,
+        IO64_OUT => IO64_PIPE65
+    );
+
+    -- ========================================================
+    -- テスト刺激（cpu15_sim.vhd と同じ）
+    -- ========================================================
+    process
+    begin
+        CLK <= '1';
+        wait for 10 ns;
+        CLK <= '0';
+        wait for 10 ns;
+    end process;
+
+    process
+    begin
+        RESET_N <= '0';
+        wait for 100 ns;
+        RESET_N <= '1';
+        wait;
+    end process;
+
+    -- ========================================================
+    -- IO64_OUT の記録
+    -- ========================================================
+    process(IO64_REF)
+    begin
+        if (RESET_N = '1' and REF_N < 16) then
+            REF_LOG(REF_N) <= IO64_REF;
+            REF_N <= REF_N + 1;
+            REF_T <= now;
+        end if;
+    end process;
+
+    process(IO64_PIPE)
+    begin
+        if (RESET_N = '1' and PIPE_N < 16) then
+            PIPE_LOG(PIPE_N) <= IO64_PIPE;
+            PIPE_N <= PIPE_N + 1;
+            PIPE_T <= now;
+        end if;
+    end process;
+
+    -- ========================================================
+    -- 判定
+    -- ========================================================
+    process
+        variable ok : boolean;
+    begin
+        wait for RUN_TIME;
+
+        ok := (REF_N = PIPE_N) and (REF_N > 0);
+        assert REF_N = PIPE_N
+            report "IO64_OUT の書き込み回数が違う: cpu15=" & integer'image(REF_N) &
+                   " cpu15_pipe=" & integer'image(PIPE_N)
+            severity error;
+
+        for i in 0 to 15 loop
+            if (i < REF_N and i < PIPE_N) then
+                if (REF_LOG(i) /= PIPE_LOG(i)) then
+                    ok := false;
+                    report "IO64_OUT の " & integer'image(i) & " 回目が違う: cpu15=" &
+                           integer'image(conv_integer(REF_LOG(i))) & " cpu15_pipe=" &
+                           integer'image(conv_integer(PIPE_LOG(i)))
+                        severity error;
+                end if;
+            end if;
+        end loop;
+
+        if (ok) then
+            report "一致: " & integer'image(REF_N) & " 回の書き込み、最終値 " &
+                   integer'image(conv_integer(REF_LOG(REF_N - 1))) &
+                   "。最後の書き込み時刻 cpu15=" & time'image(REF_T) &
+                   " cpu15_pipe=" & time'image(PIPE_T)
+                severity note;
+        end if;
+
+        -- 65番地：書いた値ではなく IO65_IN が読めていること
+        assert IO64_REF65 = IO65_EXP
+            report "io65: cpu15 の IO64_OUT が " & integer'image(conv_integer(IO64_REF65)) &
+                   "（期待値 " & integer'image(conv_integer(IO65_EXP)) & "）"
+            severity error;
+        assert IO64_PIPE65 = IO65_EXP
+            report "io65: cpu15_pipe の IO64_OUT が " & integer'image(conv_integer(IO64_PIPE65)) &
+                   "（期待値 " & integer'image(conv_integer(IO65_EXP)) & "。65番地への ST を回している）"
+            severity error;
+
+        wait;
+    end process;
+
+end SIM;
+
+-- 【期待される結果】
+-- - 10 回の書き込み（1, 3, 6, …, 55）が両方で一致する。
+-- - io65 の組は両方とも 14（IO65_IN = 7 の2倍）。error は出ない。
+-- - ループ1周は 4相版で 6命令×4 = 24 ベースクロック、パイプライン版で 6 ベースクロック
+--   （後ろ向きの JMP は fetch_pq が成立と予測するのでフラッシュしない）。
+--   最後の書き込み時刻はおよそ 4 分の1 になる（先頭の充填とリセット分だけ差は小さく見える）。
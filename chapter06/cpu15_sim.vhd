@@ -14,9 +14,10 @@
 --   3) EX（Execute）: 命令実行（ALU/分岐/Load/Store）し、次PCと書き戻し制御を生成する
 --   4) WB（WriteBack）: レジスタやRAM/I/Oへ書き込みを確定し、CPU状態を更新する
 --
---  重要なのは、FT/DC/EX/WBが同一クロックで同時に動くのではなく、
---  clk_gen が 4相クロック（CLK_FT/CLK_DC/CLK_EX/CLK_WB）を順番に立てることで、
+--  重要なのは、FT/DC/EX/WBが同一エッジで同時に動くのではなく、
+--  clk_gen が 4相の段イネーブル（CE_FT/CE_DC/CE_EX/CE_WB）を順番に立てることで、
 --  1命令の処理が「段ごとに時間的に分離」されて進む点である。
+--  全段が同じ CLK で動く（クロックは CLK の1本だけ）。
 --
 -- 【このテストベンチで確認したい典型シナリオ】
 -- - fetch.vhd 内の定数MEMに格納されたサンプルプログラム（1+2+…+10=55）を実行し、
@@ -24,15 +25,20 @@
 -- - 観測の軸：
 --   - P_COUNT（PC）が分岐で 8 に戻る／最終的に HLT で止まる
 --   - PROM_OUT が PCに応じた命令列になっている
---   - REG_0 等が ADD で更新される
+--   - reg_file の RF(0) 等が ADD で更新される
 --   - RAM_WEN と IO64_OUT が ST 命令タイミングで更新される
+-- - 段クロック版との一致（判定プロセスで自動確認する）：
+--   もとの clk_gen は CLK_FT/CLK_DC/CLK_EX/CLK_WB を段のクロックとして配っていた。
+--   段イネーブル版に変えても各段が動く CLK エッジは同じはずなので、
+--   段クロック版で測った「IO64_OUT が書かれるエッジ」（47, 71, 95, …, 263。ループ1周 24 エッジ）と
+--   値（1, 3, 6, …, 55）に一致することを assert で確かめる。
 --
 -- 【注意点（テストベンチの落とし穴）】
 -- - このTBでは IO65_IN を初期化していないため、未定義(X)のままになる可能性がある。
 --   本サンプルプログラムは IO65_IN を読まない（LDしない）なら問題になりにくいが、
 --   波形上のX汚染を避けるなら IO65_IN <= (others => '0'); のように初期化すると良い。
--- - RESET_N は “同期リセット” として exec/reg_wb で扱われているため、
---   いつ解除するか（CLK_EX/CLK_WBのタイミング）を意識するとデバッグが楽になる。
+-- - RESET_N は “同期リセット” として exec/reg_file で扱われているため、
+--   いつ解除するか（EX/WB のエッジ）を意識するとデバッグが楽になる。
 
 
 library IEEE;
@@ -59,10 +65,10 @@ architecture SIM of cpu15_sim is
         port
         (
             CLK     : in  std_logic;  -- ベースクロック（TBが作る）
-            CLK_FT  : out std_logic;  -- Fetch相
-            CLK_DC  : out std_logic;  -- Decode相
-            CLK_EX  : out std_logic;  -- Execute相
-            CLK_WB  : out std_logic   -- WriteBack相
+            CE_FT   : out std_logic;  -- Fetch相
+            CE_DC   : out std_logic;  -- Decode相
+            CE_EX   : out std_logic;  -- Execute相
+            CE_WB   : out std_logic   -- WriteBack相
         );
     end component;
 
@@ -70,9 +76,10 @@ architecture SIM of cpu15_sim is
     component fetch
         port
         (
-            CLK_FT   : in  std_logic;
+            CLK      : in  std_logic;
+            CE_FT    : in  std_logic;
             P_COUNT  : in  std_logic_vector(7 downto 0);
-            PROM_OUT : out std_logic_vector(14 downto 0)
+            PROM_OUT : out std_logic_vector(15 downto 0)
         );
     end component;
 
@@ -80,49 +87,62 @@ architecture SIM of cpu15_sim is
     component decode
         port
         (
-            CLK_DC   : in  std_logic;
-            PROM_OUT : in  std_logic_vector(14 downto 0);
-            OP_CODE  : out std_logic_vector(3 downto 0);
+            CLK      : in  std_logic;
+            CE_DC    : in  std_logic;
+            PROM_OUT : in  std_logic_vector(15 downto 0);
+            OP_CODE  : out std_logic_vector(4 downto 0);
+            OP_CC    : out std_logic_vector(2 downto 0);
             OP_DATA  : out std_logic_vector(7 downto 0)
         );
     end component;
 
-    -- レジスタ読み出し（番号→値）を行うデコード段のMUX
-    component reg_dc
+    -- レジスタファイル（読み出し2ポートは DC 相、書き込み1ポートは WB 相）
+    component reg_file
+        generic
+        (
+            N_BITS     : integer
+        );
         port
         (
-            CLK_DC    : in  std_logic;
-            N_REG_IN  : in  std_logic_vector(2 downto 0);
-            REG_0     : in  std_logic_vector(15 downto 0);
-            REG_1     : in  std_logic_vector(15 downto 0);
-            REG_2     : in  std_logic_vector(15 downto 0);
-            REG_3     : in  std_logic_vector(15 downto 0);
-            REG_4     : in  std_logic_vector(15 downto 0);
-            REG_5     : in  std_logic_vector(15 downto 0);
-            REG_6     : in  std_logic_vector(15 downto 0);
-            REG_7     : in  std_logic_vector(15 downto 0);
-            N_REG_OUT : out std_logic_vector(2 downto 0);
-            REG_OUT   : out std_logic_vector(15 downto 0)
+            CLK        : in  std_logic;
+            CE_DC      : in  std_logic;
+            CE_WB      : in  std_logic;
+            RESET_N    : in  std_logic;
+            N_REG_A_IN : in  std_logic_vector(N_BITS - 1 downto 0);
+            N_REG_B_IN : in  std_logic_vector(N_BITS - 1 downto 0);
+            N_REG_A    : out std_logic_vector(N_BITS - 1 downto 0);
+            N_REG_B    : out std_logic_vector(N_BITS - 1 downto 0);
+            REG_A      : out std_logic_vector(15 downto 0);
+            REG_B      : out std_logic_vector(15 downto 0);
+            N_REG_C    : in  std_logic_vector(N_BITS - 1 downto 0);
+            REG_C      : out std_logic_vector(15 downto 0);
+            N_REG_W    : in  std_logic_vector(N_BITS - 1 downto 0);
+            REG_IN     : in  std_logic_vector(15 downto 0);
+            REG_WEN    : in  std_logic
         );
     end component;
 
-    -- メモリ読み出し（番地→値）を行うデコード段のMUX（＋IO65_INマップ）
-    component ram_dc
+    -- データメモリ（256語、2ポート、出力レジスタ付き＝1サイクルレイテンシ、64/65番地はI/O）
+    component data_ram
+        generic
+        (
+            A_BITS   : integer := 8
+        );
         port
         (
-            CLK_DC    : in  std_logic;
-            RAM_0     : in  std_logic_vector(15 downto 0);
-            RAM_1     : in  std_logic_vector(15 downto 0);
-            RAM_2     : in  std_logic_vector(15 downto 0);
-            RAM_3     : in  std_logic_vector(15 downto 0);
-            RAM_4     : in  std_logic_vector(15 downto 0);
-            RAM_5     : in  std_logic_vector(15 downto 0);
-            RAM_6     : in  std_logic_vector(15 downto 0);
-            RAM_7     : in  std_logic_vector(15 downto 0);
-            IO65_IN   : in  std_logic_vector(15 downto 0);   -- メモリマップド入力（0x41）
-            RAM_AD_IN : in  std_logic_vector(7 downto 0);    -- 命令下位8bitを番地として扱う設計
-            RAM_AD_OUT: out std_logic_vector(7 downto 0);    -- WB段へアドレス伝搬
-            RAM_OUT   : out std_logic_vector(15 downto 0)    -- 読み出し値（LDで使う）
+            CLK      : in  std_logic;
+            EN_A     : in  std_logic;                        -- '1' の CLK で ADDR_A を読む
+            ADDR_A   : in  std_logic_vector(7 downto 0);
+            DIN_A    : in  std_logic_vector(15 downto 0);
+            WE_A     : in  std_logic;                        -- '1' の CLK で DIN_A を書く
+            DOUT_A   : out std_logic_vector(15 downto 0);
+            EN_B     : in  std_logic;
+            ADDR_B   : in  std_logic_vector(7 downto 0);
+            DIN_B    : in  std_logic_vector(15 downto 0);
+            WE_B     : in  std_logic;
+            DOUT_B   : out std_logic_vector(15 downto 0);
+            IO65_IN  : in  std_logic_vector(15 downto 0);    -- 0x41 を読むと見える入力
+            IO64_OUT : out std_logic_vector(15 downto 0)     -- 0x40 書き込みで更新される出力
         );
     end component;
 
@@ -130,9 +150,11 @@ architecture SIM of cpu15_sim is
     component exec
         port
         (
-            CLK_EX  : in  std_logic;
+            CLK     : in  std_logic;
+            CE_EX   : in  std_logic;
             RESET_N : in  std_logic;
-            OP_CODE : in  std_logic_vector(3 downto 0);
+            OP_CODE : in  std_logic_vector(4 downto 0);
+            OP_CC   : in  std_logic_vector(2 downto 0);
             REG_A   : in  std_logic_vector(15 downto 0);
             REG_B   : in  std_logic_vector(15 downto 0);
             OP_DATA : in  std_logic_vector(7 downto 0);
@@ -142,50 +164,12 @@ architecture SIM of cpu15_sim is
             REG_IN  : out std_logic_vector(15 downto 0);     -- レジスタ書き戻し値（WBへ）
             RAM_IN  : out std_logic_vector(15 downto 0);     -- メモリ書き込み値（WBへ）
             REG_WEN : out std_logic;                         -- レジスタ書き込み許可
-            RAM_WEN : out std_logic                          -- メモリ書き込み許可
-        );
-    end component;
-
-    -- レジスタファイル書き込み（WB段で状態確定）
-    component reg_wb
-        port
-        (
-            CLK_WB  : in  std_logic;
-            RESET_N : in  std_logic;
-            N_REG   : in  std_logic_vector(2 downto 0);
-            REG_IN  : in  std_logic_vector(15 downto 0);
-            REG_WEN : in  std_logic;
-
-            REG_0   : out std_logic_vector(15 downto 0);
-            REG_1   : out std_logic_vector(15 downto 0);
-            REG_2   : out std_logic_vector(15 downto 0);
-            REG_3   : out std_logic_vector(15 downto 0);
-            REG_4   : out std_logic_vector(15 downto 0);
-            REG_5   : out std_logic_vector(15 downto 0);
-            REG_6   : out std_logic_vector(15 downto 0);
-            REG_7   : out std_logic_vector(15 downto 0)
-        );
-    end component;
-
-    -- RAM/I/O書き込み（WB段で副作用確定）
-    component ram_wb
-        port
-        (
-            CLK_WB   : in  std_logic;
-            RAM_ADDR : in  std_logic_vector(7 downto 0);
-            RAM_IN   : in  std_logic_vector(15 downto 0);
-            RAM_WEN  : in  std_logic;
-
-            RAM_0    : out std_logic_vector(15 downto 0);
-            RAM_1    : out std_logic_vector(15 downto 0);
-            RAM_2    : out std_logic_vector(15 downto 0);
-            RAM_3    : out std_logic_vector(15 downto 0);
-            RAM_4    : out std_logic_vector(15 downto 0);
-            RAM_5    : out std_logic_vector(15 downto 0);
-            RAM_6    : out std_logic_vector(15 downto 0);
-            RAM_7    : out std_logic_vector(15 downto 0);
-
-            IO64_OUT : out std_logic_vector(15 downto 0)     -- 0x40書き込みで更新される出力
+            RAM_WEN : out std_logic;                         -- メモリ書き込み許可
+            SP_OUT  : out std_logic_vector(7 downto 0);
+            REG_IN_B  : out std_logic_vector(15 downto 0);   -- ポストインクリメント値（REG_B+1）
+            REG_WEN_B : out std_logic;                       -- その書き込み許可
+            BLK_REQ   : out std_logic;                       -- ブロック転送の要求
+            BLK_BUSY  : in  std_logic                        -- ブロック転送中
         );
     end component;
 
@@ -199,18 +183,19 @@ architecture SIM of cpu15_sim is
     signal IO65_IN  : std_logic_vector(15 downto 0);
     signal IO64_OUT : std_logic_vector(15 downto 0);
 
-    -- 4相クロック
-    signal CLK_FT : std_logic;
-    signal CLK_DC : std_logic;
-    signal CLK_EX : std_logic;
-    signal CLK_WB : std_logic;
+    -- 4相の段イネーブル
+    signal CE_FT : std_logic;
+    signal CE_DC : std_logic;
+    signal CE_EX : std_logic;
+    signal CE_WB : std_logic;
 
     -- PCと命令語
     signal P_COUNT  : std_logic_vector(7 downto 0);
-    signal PROM_OUT : std_logic_vector(14 downto 0);
+    signal PROM_OUT : std_logic_vector(15 downto 0);
 
     -- デコード結果
-    signal OP_CODE : std_logic_vector(3 downto 0);
+    signal OP_CODE : std_logic_vector(4 downto 0);
+    signal OP_CC   : std_logic_vector(2 downto 0);
     signal OP_DATA : std_logic_vector(7 downto 0);
 
     -- レジスタ番号とオペランド
@@ -222,30 +207,26 @@ architecture SIM of cpu15_sim is
     -- 書き戻し・制御
     signal REG_IN  : std_logic_vector(15 downto 0);
     signal REG_WEN : std_logic;
+    signal REG_IN_B : std_logic_vector(15 downto 0);
+    signal REG_WEN_B : std_logic;
 
-    -- レジスタファイルの実体（reg_wbが保持し、reg_dcが読む）
-    signal REG_0 : std_logic_vector(15 downto 0);
-    signal REG_1 : std_logic_vector(15 downto 0);
-    signal REG_2 : std_logic_vector(15 downto 0);
-    signal REG_3 : std_logic_vector(15 downto 0);
-    signal REG_4 : std_logic_vector(15 downto 0);
-    signal REG_5 : std_logic_vector(15 downto 0);
-    signal REG_6 : std_logic_vector(15 downto 0);
-    signal REG_7 : std_logic_vector(15 downto 0);
-
-    -- RAM（小規模）の実体（ram_wbが保持し、ram_dcが読む）
+    -- レジスタファイルの書き込みポート（ポストインクリメントのときだけ B 側を選ぶ）
+    -- レジスタの中身は reg_file の中の配列 RF（波形では C4/RF を見る）
+    signal N_REG_W : std_logic_vector(2 downto 0);
+    signal REG_W   : std_logic_vector(15 downto 0);
+    signal REG_WE  : std_logic;
+
+    -- データメモリの読み出し・書き込み（RAM の中身は data_ram の中の配列 RAM：波形では C6/RAM を見る）
     signal RAM_IN   : std_logic_vector(15 downto 0);
-    signal RAM_ADDR : std_logic_vector(7 downto 0);
     signal RAM_OUT  : std_logic_vector(15 downto 0);
     signal RAM_WEN  : std_logic;
-    signal RAM_0    : std_logic_vector(15 downto 0);
-    signal RAM_1    : std_logic_vector(15 downto 0);
-    signal RAM_2    : std_logic_vector(15 downto 0);
-    signal RAM_3    : std_logic_vector(15 downto 0);
-    signal RAM_4    : std_logic_vector(15 downto 0);
-    signal RAM_5    : std_logic_vector(15 downto 0);
-    signal RAM_6    : std_logic_vector(15 downto 0);
-    signal RAM_7    : std_logic_vector(15 downto 0);
+    signal RAM_WE   : std_logic;
+
+    -- 段クロック版との一致の判定
+    constant CLK_PERIOD : time    := 20 ns;
+    constant RUN_TIME   : time    := 6000 ns;   -- 300 エッジ。最後の書き込み（263 エッジ目）より後
+    constant N_EXP      : integer := 10;        -- 1, 3, 6, …, 55 の10回
+    signal   N_WR       : integer := 0;         -- これまでに IO64_OUT が書かれた回数
 
 begin
 
@@ -253,85 +234,87 @@ begin
     -- DUT相当の結線（cpu15トップでやる配線をTB側で再現）
     -- ========================================================
 
-    -- 4相クロック生成：TBのCLKを元にFT/DC/EX/WB相を作る
+    -- 4相の段イネーブル生成：TBのCLKの各エッジに FT/DC/EX/WB 相を割り当てる
     C1 : clk_gen port map(
-        CLK    => CLK,
-        CLK_FT => CLK_FT,
-        CLK_DC => CLK_DC,
-        CLK_EX => CLK_EX,
-        CLK_WB => CLK_WB
+        CLK   => CLK,
+        CE_FT => CE_FT,
+        CE_DC => CE_DC,
+        CE_EX => CE_EX,
+        CE_WB => CE_WB
     );
 
     -- Fetch相：PC→PROM→命令語
     C2 : fetch port map(
-        CLK_FT   => CLK_FT,
+        CLK      => CLK,
+        CE_FT    => CE_FT,
         P_COUNT  => P_COUNT,
         PROM_OUT => PROM_OUT
     );
 
     -- Decode相：命令語→OP_CODE/OP_DATA
     C3 : decode port map(
-        CLK_DC   => CLK_DC,
+        CLK      => CLK,
+        CE_DC    => CE_DC,
         PROM_OUT => PROM_OUT,
         OP_CODE  => OP_CODE,
+        OP_CC    => OP_CC,
         OP_DATA  => OP_DATA
     );
 
-    -- Decode相：レジスタA読み出し（命令のraフィールド相当）
-    C4 : reg_dc port map(
-        CLK_DC    => CLK_DC,
-        N_REG_IN  => PROM_OUT(10 downto 8),
-        REG_0     => REG_0,
-        REG_1     => REG_1,
-        REG_2     => REG_2,
-        REG_3     => REG_3,
-        REG_4     => REG_4,
-        REG_5     => REG_5,
-        REG_6     => REG_6,
-        REG_7     => REG_7,
-        N_REG_OUT => N_REG_A,     -- 宛先番号（WBへ伝えるため保持）
-        REG_OUT   => REG_A        -- オペランドA（EXで使用）
-    );
-
-    -- Decode相：レジスタB読み出し（命令のrbフィールド相当）
-    C5 : reg_dc port map(
-        CLK_DC    => CLK_DC,
-        N_REG_IN  => PROM_OUT(7 downto 5),
-        REG_0     => REG_0,
-        REG_1     => REG_1,
-        REG_2     => REG_2,
-        REG_3     => REG_3,
-        REG_4     => REG_4,
-        REG_5     => REG_5,
-        REG_6     => REG_6,
-        REG_7     => REG_7,
-        N_REG_OUT => N_REG_B,
-        REG_OUT   => REG_B
+    -- Decode相：レジスタA/B読み出し（命令のra/rbフィールド）、WriteBack相：レジスタファイル更新
+    N_REG_W <= N_REG_B  when REG_WEN_B = '1' else N_REG_A;   -- raフィールドが宛先になる設計
+    REG_W   <= REG_IN_B when REG_WEN_B = '1' else REG_IN;
+    REG_WE  <= REG_WEN or REG_WEN_B;
+
+    C4 : reg_file generic map(
+        N_BITS     => 3
+    ) port map(
+        CLK        => CLK,
+        CE_DC      => CE_DC,
+        CE_WB      => CE_WB,
+        RESET_N    => RESET_N,
+        N_REG_A_IN => PROM_OUT(10 downto 8),
+        N_REG_B_IN => PROM_OUT(7 downto 5),
+        N_REG_A    => N_REG_A,    -- 宛先番号（WBへ伝えるため保持）
+        N_REG_B    => N_REG_B,
+        REG_A      => REG_A,      -- オペランドA（EXで使用）
+        REG_B      => REG_B,
+        N_REG_C    => "000",
+        REG_C      => open,
+        N_REG_W    => N_REG_W,
+        REG_IN     => REG_W,
+        REG_WEN    => REG_WE
     );
 
-    -- Decode相：RAM/IO読み出し（アドレス=命令下位8bit）
-    -- ここでRAM_ADDR（=RAM_AD_OUT）をWB段へ“アドレス伝搬”しているのが設計のキモ。
-    C6 : ram_dc port map(
-        CLK_DC     => CLK_DC,
-        RAM_AD_IN  => PROM_OUT(7 downto 0),
-        RAM_0      => RAM_0,
-        RAM_1      => RAM_1,
-        RAM_2      => RAM_2,
-        RAM_3      => RAM_3,
-        RAM_4      => RAM_4,
-        RAM_5      => RAM_5,
-        RAM_6      => RAM_6,
-        RAM_7      => RAM_7,
-        IO65_IN    => IO65_IN,
-        RAM_AD_OUT => RAM_ADDR,   -- ST時の書き込み先にもなるため保持してWBへ渡す
-        RAM_OUT    => RAM_OUT     -- LD時にEXが参照する値
+    -- データメモリ（アドレス=命令下位8bit。PROM_OUT は次の FT まで変わらないので読みと書きで同じ番地）
+    -- CE_DC のエッジで読み、CE_WB のエッジで書く。
+    RAM_WE <= CE_WB and RAM_WEN;
+
+    C6 : data_ram generic map(
+        A_BITS   => 8
+    ) port map(
+        CLK      => CLK,
+        EN_A     => CE_DC,
+        ADDR_A   => PROM_OUT(7 downto 0),
+        DIN_A    => RAM_IN,       -- ST時の書き込み値
+        WE_A     => RAM_WE,
+        DOUT_A   => RAM_OUT,      -- LD時にEXが参照する値
+        EN_B     => '0',
+        ADDR_B   => "00000000",
+        DIN_B    => "0000000000000000",
+        WE_B     => '0',
+        DOUT_B   => open,
+        IO65_IN  => IO65_IN,
+        IO64_OUT => IO64_OUT
     );
 
     -- Execute相：命令実行（次PC/書き戻し値/書き込み制御を生成）
     C7 : exec port map(
-        CLK_EX  => CLK_EX,
+        CLK     => CLK,
+        CE_EX   => CE_EX,
         RESET_N => RESET_N,
         OP_CODE => OP_CODE,
+        OP_CC   => OP_CC,
         REG_A   => REG_A,
         REG_B   => REG_B,
         OP_DATA => OP_DATA,
@@ -340,41 +323,12 @@ begin
         REG_IN  => REG_IN,
         RAM_IN  => RAM_IN,
         REG_WEN => REG_WEN,
-        RAM_WEN => RAM_WEN
-    );
-
-    -- WriteBack相：レジスタファイル更新（命令結果をCPU状態として確定）
-    C8 : reg_wb port map(
-        CLK_WB  => CLK_WB,
-        RESET_N => RESET_N,
-        N_REG   => N_REG_A,       -- raフィールドが宛先になる設計
-        REG_IN  => REG_IN,
-        REG_WEN => REG_WEN,
-        REG_0   => REG_0,
-        REG_1   => REG_1,
-        REG_2   => REG_2,
-        REG_3   => REG_3,
-        REG_4   => REG_4,
-        REG_5   => REG_5,
-        REG_6   => REG_6,
-        REG_7   => REG_7
-    );
-
-    -- WriteBack相：RAM/I/O更新（ST命令の副作用を確定）
-    C9 : ram_wb port map(
-        CLK_WB   => CLK_WB,
-        RAM_ADDR => RAM_ADDR,     -- DC段で確定した番地がWBまで保持されている前提
-        RAM_IN   => RAM_IN,
-        RAM_WEN  => RAM_WEN,
-        RAM_0    => RAM_0,
-        RAM_1    => RAM_1,
-        RAM_2    => RAM_2,
-        RAM_3    => RAM_3,
-        RAM_4    => RAM_4,
-        RAM_5    => RAM_5,
-        RAM_6    => RAM_6,
-        RAM_7    => RAM_7,
-        IO64_OUT => IO64_OUT
+        RAM_WEN => RAM_WEN,
+        SP_OUT  => open,       -- スタックと LDR/STR のアドレスは chapter09（ram_dc_wb）の構成で使う
+        REG_IN_B => REG_IN_B,
+        REG_WEN_B => REG_WEN_B,
+        BLK_REQ   => open,
+        BLK_BUSY  => '0'          -- ブロック転送も chapter09 の構成で使う（ここでは何も動かさずに終わる）
     );
 
     -- ========================================================
@@ -382,7 +336,8 @@ begin
     -- ========================================================
 
     -- ベースクロック生成：20ns周期（10ns High, 10ns Low）
-    -- clk_gen がこれを受けて 4相クロックを順番に立てる。
+    -- clk_gen がこれを受けて 4相の段イネーブルを順番に立てる。
+    -- CLK は t=0 から '1' なので、n 番目（0 始まり）の立ち上がりは n × CLK_PERIOD。
     process
     begin
         CLK <= '1';
@@ -412,12 +367,47 @@ begin
     --     wait;
     -- end process;
 
+    -- ========================================================
+    -- 判定：段クロック版と同じエッジで同じ値が IO64_OUT に書かれるか
+    -- ========================================================
+    -- k 回目（0 始まり）の書き込みは、段クロック版では 47 + 24k 番目のエッジで値 (k+1)(k+2)/2。
+    process(IO64_OUT)
+    begin
+        if (RESET_N = '1') then
+            if (N_WR < N_EXP) then
+                assert now = (47 + 24 * N_WR) * CLK_PERIOD and
+                       conv_integer(IO64_OUT) = (N_WR + 1) * (N_WR + 2) / 2
+                    report "IO64_OUT の " & integer'image(N_WR) & " 回目が段クロック版と違う: " &
+                           integer'image(conv_integer(IO64_OUT)) & " at " & time'image(now) &
+                           "（期待値 " & integer'image((N_WR + 1) * (N_WR + 2) / 2) & " at " &
+                           time'image((47 + 24 * N_WR) * CLK_PERIOD) & "）"
+                    severity error;
+            end if;
+            N_WR <= N_WR + 1;
+        end if;
+    end process;
+
+    process
+    begin
+        wait for RUN_TIME;
+        assert N_WR = N_EXP
+            report "IO64_OUT の書き込み回数が違う: " & integer'image(N_WR) &
+                   "（期待値 " & integer'image(N_EXP) & "）"
+            severity error;
+        if (N_WR = N_EXP) then
+            report "段クロック版と一致: " & integer'image(N_EXP) & " 回の書き込み、最後は " &
+                   time'image((47 + 24 * (N_EXP - 1)) * CLK_PERIOD)
+                severity note;
+        end if;
+        wait;
+    end process;
+
 end SIM;
 
 -- 【波形での観察ポイント（実務的チェックリスト）】
 -- - RESET解除後：
 --   - P_COUNT が 0 → 1 → 2 → ... と進み、JMP/JEで 8/14 に飛ぶ
 --   - PROM_OUT が PC に応じた命令語になっている（fetchのMEM）
---   - REG_0 が加算で増え、最終的に 55 になる（プログラム依存）
+--   - レジスタ0（C4/RF(0)）が加算で増え、最終的に 55 になる（プログラム依存）
 --   - ST命令タイミングで RAM_WEN=1 になり、IO64_OUT が 55 に更新される
 --   - HLT命令で REG_WEN/RAM_WEN が 0 になり、PCが更新されなくなる（停止状態）
@@ -0,0 +1,186 @@
+-- data_ram.vhd（詳細コメント版：ブロックRAM 推論型データメモリ / 真の2ポート＋メモリマップドI/O）
+--
+-- 【このモジュールの目的】
+-- - ram_dc / ram_wb（RAM_0〜RAM_7 の8語を case で1語ずつデコード）と、
+--   chapter09 の ram_dc_wb の中の 64語の配列 RAM_ARRAY を置き換えるデータメモリ。
+-- - 語数は generic A_BITS で決まる 2**A_BITS 語（既定 8 → 256語＝8bit アドレス空間全体）。
+--   ただし 64 / 65 番地はメモリマップドI/O（下記）に使うので、RAM としては使えない。
+-- - 配列 RAM を「番地で添字して読む / 書く」だけの形で書き、読み出しに出力レジスタを付けているので、
+--   合成ツールはこれを FPGA のブロックRAM（真の2ポートRAM）として推論する。
+--
+-- 【ポートの構成（A / B は対称）】
+--   EN_x   : '1' の CLK で ADDR_x の語を読み出し、DOUT_x を更新する（'0' なら DOUT_x は前の値を保持）
+--   ADDR_x : 番地（8bit）
+--   DIN_x  : 書き込みデータ
+--   WE_x   : '1' の CLK で DIN_x を ADDR_x へ書く（EN_x とは独立）
+--   DOUT_x : 読み出しデータ（出力レジスタ）
+-- - 2つのポートはそれぞれ独立に読み書きできる。1つのポートで読みながら、もう1つで書くことも、
+--   両方で読むことも、両方で書くこともできる。
+--
+-- 【読み出しレイテンシ：1サイクル】
+-- - EN_x='1' の CLK の立ち上がりで ADDR_x の語を出力レジスタに取り込み、
+--   それが DOUT_x に出る。つまり「番地を出した次の CLK の間」にデータが見える。
+-- - 同じ番地を同じ CLK で読みと書きをしたときは、書く前の値が読める（read-first）。
+--   新しい値が必要な側（chapter09 のブロック転送、cpu15_pipe）は、外でフォワーディングする。
+-- - 非同期読み出しの RAM と違ってアドレス→データの組合せ経路がないので、
+--   パイプライン版（cpu15_pipe）でも1段に収まり、Fmax を押さえない。
+--
+-- 【メモリマップドI/O】
+--   64 番地 : 書くと IO64_OUT（出力レジスタ）を更新する。読むと IO64_OUT の値が読める
+--             （エミュレータ chapter03 の ram[64] と同じふるまい）
+--   65 番地 : 読むと IO65_IN が読める。書き込みは捨てる（読み出し専用の入力ポート）
+-- - I/O の選択は出力レジスタの後ろで行う（読んだときに「I/O だったか」をフラグとして一緒に登録する）。
+--   RAM 本体には I/O のデコードが入らないので、ブロックRAM として推論される形を崩さない。
+--
+-- 【書き込みの衝突】
+-- - 同じ CLK で A と B が同じ番地に書いたときは B が勝つ。
+--   この CPU の使い方（下記）では同じ CLK に両ポートから書くことはない。
+--
+-- 【A_BITS を 8 より小さくしたとき】
+-- - 2**A_BITS 以上の番地（64/65 を除く）は RAM がない。読むと 0、書き込みは捨てる。
+-- - スタックが 63 番地から下へ伸びるので、A_BITS は 6 以上にすること（6 で 0..63 の 64語）。
+--
+-- 【このCPUでの使い方】
+-- - cpu15.vhd（4相版）      : A で読み（DC）と書き（WB）をする。B は使わない
+-- - chapter09 ram_dc_wb     : A は CPU とブロック転送の書き込み、B はブロック転送の読み出し
+-- - cpu15_pipe.vhd          : A で ID 段の読み出し、B で WB 段の書き込み
+
+
+library IEEE;
+use IEEE.std_logic_1164.all;
+use IEEE.std_logic_unsigned.all;
+
+-- ============================================================
+-- entity: データメモリ（2**A_BITS 語 × 16bit、2ポート）
+-- ============================================================
+entity data_ram is
+    generic
+    (
+        A_BITS   : integer := 8      -- RAM のアドレスのビット数（2**A_BITS 語、8 以下）
+    );
+    port
+    (
+        CLK      : in  std_logic;
+
+        -- ポートA
+        EN_A     : in  std_logic;
+        ADDR_A   : in  std_logic_vector(7 downto 0);
+        DIN_A    : in  std_logic_vector(15 downto 0);
+        WE_A     : in  std_logic;
+        DOUT_A   : out std_logic_vector(15 downto 0);
+
+        -- ポートB
+        EN_B     : in  std_logic;
+        ADDR_B   : in  std_logic_vector(7 downto 0);
+        DIN_B    : in  std_logic_vector(15 downto 0);
+        WE_B     : in  std_logic;
+        DOUT_B   : out std_logic_vector(15 downto 0);
+
+        -- メモリマップドI/O
+        IO65_IN  : in  std_logic_vector(15 downto 0);
+        IO64_OUT : out std_logic_vector(15 downto 0)
+    );
+end data_ram;
+
+-- ============================================================
+-- architecture RTL: 配列 RAM を添字で読み書きする（ブロックRAM として推論される形）
+-- ============================================================
+architecture RTL of data_ram is
+
+    type RAM_TYPE is array (0 to 2**A_BITS - 1) of std_logic_vector(15 downto 0);
+
+    -- RAM 本体（リセットしない）
+    signal RAM     : RAM_TYPE := (others => (others => '0'));
+
+    -- I/O 出力レジスタ（IO64_OUT）
+    signal IO64    : std_logic_vector(15 downto 0) := (others => '0');
+
+    -- 番地が RAM を指しているか（I/O でも範囲外でもない）
+    signal RAM_A   : std_logic;
+    signal RAM_B   : std_logic;
+
+    -- RAM でないときに読める値（I/O または 0）
+    signal MM_A    : std_logic_vector(15 downto 0);
+    signal MM_B    : std_logic_vector(15 downto 0);
+
+    -- 出力レジスタ：RAM の読み出し値と、RAM でなかったときの値・その選択
+    signal RD_A    : std_logic_vector(15 downto 0) := (others => '0');
+    signal RD_B    : std_logic_vector(15 downto 0) := (others => '0');
+    signal MQ_A    : std_logic_vector(15 downto 0) := (others => '0');
+    signal MQ_B    : std_logic_vector(15 downto 0) := (others => '0');
+    signal SEL_A   : std_logic := '0';           -- '1' なら MQ_A を出す
+    signal SEL_B   : std_logic := '0';
+
+begin
+
+    -- ========================================================
+    -- 番地のデコード（I/O と範囲外）
+    -- ========================================================
+    RAM_A <= '1' when ADDR_A /= "01000000" and ADDR_A /= "01000001" and ADDR_A < 2**A_BITS else '0';
+    RAM_B <= '1' when ADDR_B /= "01000000" and ADDR_B /= "01000001" and ADDR_B < 2**A_BITS else '0';
+
+    MM_A  <= IO65_IN when ADDR_A = "01000001" else
+             IO64    when ADDR_A = "01000000" else
+             "0000000000000000";
+    MM_B  <= IO65_IN when ADDR_B = "01000001" else
+             IO64    when ADDR_B = "01000000" else
+             "0000000000000000";
+
+    -- ========================================================
+    -- RAM 本体：書き込み2ポート＋出力レジスタ付き読み出し2ポート
+    -- ========================================================
+    -- 読み出しは同じプロセスの中で書き込み前の RAM を見るので read-first になる。
+    process(CLK)
+    begin
+        if (CLK'event and CLK = '1') then
+            if (WE_A = '1' and RAM_A = '1') then
+                RAM(conv_integer(ADDR_A(A_BITS - 1 downto 0))) <= DIN_A;
+            end if;
+            if (WE_B = '1' and RAM_B = '1') then
+                RAM(conv_integer(ADDR_B(A_BITS - 1 downto 0))) <= DIN_B;
+            end if;
+
+            if (EN_A = '1') then
+                RD_A <= RAM(conv_integer(ADDR_A(A_BITS - 1 downto 0)));
+            end if;
+            if (EN_B = '1') then
+                RD_B <= RAM(conv_integer(ADDR_B(A_BITS - 1 downto 0)));
+            end if;
+        end if;
+    end process;
+
+    -- ========================================================
+    -- I/O：出力レジスタの選択と IO64_OUT
+    -- ========================================================
+    process(CLK)
+    begin
+        if (CLK'event and CLK = '1') then
+            if (EN_A = '1') then
+                MQ_A  <= MM_A;
+                SEL_A <= not RAM_A;
+            end if;
+            if (EN_B = '1') then
+                MQ_B  <= MM_B;
+                SEL_B <= not RAM_B;
+            end if;
+
+            if (WE_A = '1' and ADDR_A = "01000000") then
+                IO64 <= DIN_A;
+            end if;
+            if (WE_B = '1' and ADDR_B = "01000000") then
+                IO64 <= DIN_B;
+            end if;
+        end if;
+    end process;
+
+    DOUT_A   <= MQ_A when SEL_A = '1' else RD_A;
+    DOUT_B   <= MQ_B when SEL_B = '1' else RD_B;
+    IO64_OUT <= IO64;
+
+end RTL;
+
+-- 【検証の観点】
+-- - EN_x='1' の CLK の次から DOUT_x に読み出し値が出ること（1サイクルレイテンシ）。
+-- - 同じ番地の読みと書きが同じ CLK に重なったとき、書く前の値が読めること（read-first）。
+-- - 64 番地への書き込みが RAM ではなく IO64_OUT に出ること、65 番地の読み出しが IO65_IN になること。
+-- - 合成レポートで RAM がブロックRAM（真の2ポート）として推論されていること。
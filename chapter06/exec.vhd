@@ -9,39 +9,119 @@
 --
 --   1) ALU演算（ADD/SUB/AND/OR/SHIFT など）
 --   2) 即値合成（LDL/LDH：上位/下位バイトの差し替え）
---   3) 比較とフラグ保持（CMP → CMP_FLAG）
---   4) 分岐（JE/JMP）によるPC更新
+--   3) 比較とフラグ保持（CMP/ADDI → FLAG_Z/FLAG_C/FLAG_S/FLAG_V）
+--   4) 分岐（JE/JMP/JCC）によるPC更新
 --   5) Load/Store（LD/ST）に伴うレジスタ書き戻し/メモリ書き込み制御
+--   6) スタック（CALL/RET/PUSH/POP）と SP の更新
+--   7) レジスタ間接の Load/Store（LDR/STR）とポストインクリメント
+--   8) 乗算（MUL/MULHU：DSP ブロック）と除算（DIVU/MODU：複数サイクル）
+--   9) ブロック転送（MCPY/MSET）の起動と完了待ち
+--  10) 不可分な入れ替え（SWAP）
 --
 -- - つまり「データパス（REG/ALU/RAM）」と「制御（PC/分岐/WriteEnable）」の両方を
 --   命令ごとに切り替える“CPUの心臓部”である。
 --
 -- 【段階実行（FT→DC→EX→WB）との対応】
--- - exec は CLK_EX（Execute段クロック）の立ち上がりで動作し、
+-- - exec は CE_EX（Execute段のイネーブル）が '1' の CLK の立ち上がりで動作し、
 --   “この命令で次にPCをどうするか” と “書き戻し/書き込みをどうするか” を確定させる。
 -- - 出力の役割は以下。
-v--
+--
 --   P_COUNT : 次にFetch段が参照する命令番地（PC）を出す
---   REG_IN  : レジスタ書き戻し値（WriteBack段の reg_wb へ渡すデータ）
---   RAM_IN  : メモリ書き込みデータ（WriteBack段の ram_wb へ渡す storeデータ）
+--   REG_IN  : レジスタ書き戻し値（WriteBack段の reg_file へ渡すデータ）
+--   RAM_IN  : メモリ書き込みデータ（WriteBack段で data_ram へ書く storeデータ）
 --   REG_WEN : レジスタ書き戻し有効（Write Enable）
 --   RAM_WEN : メモリ書き込み有効（Write Enable）
+--   SP_OUT  : スタックポインタ（スタック命令のときの RAM アドレス）
+--   REG_IN_B  : 2本目の書き戻し値（LDR/STR のポストインクリメントで REG_B+1 を N_REG_B 番へ）
+--   REG_WEN_B : 2本目の書き戻し有効
+--   BLK_REQ   : ブロック転送の要求（この命令の WB で chapter09 の ram_dc_wb が転送を始める）
 --
 -- - 注意：この設計では exec 自身が “レジスタファイルやRAMの実体” を更新しない。
 --   exec はあくまで「次段に対する制御信号と書き込みデータを作る」段であり、
---   実際の更新は reg_wb / ram_wb が CLK_WB で行う。
+--   実際の更新は reg_file と data_ram が WB のエッジ（CE_WB='1' の CLK）で行う。
 --   これにより段分割の役割が明確になる。
 --
--- 【内部状態：PC と CMP_FLAG】
+-- 【内部状態：PC とフラグ（Z/C/S/V）】
 -- - PC（プログラムカウンタ）は exec 内で保持される“状態”であり、
 --   命令ごとに PC+1 / 分岐先 へ更新される。
--- - CMP_FLAG は CMP 命令の結果（REG_A==REG_B）を保持する1bit状態で、
---   JE（Jump Equal）命令が参照する。
--- - 自作CPU観点では、これは「フラグレジスタ（最小版）」の実装であり、
---   将来的に Z/N/C/V などを増やす拡張の入口になる。
+-- - フラグは CMP（REG_A - REG_B）と ADDI（結果を 0 と比べる）だけが更新する。
+--     FLAG_Z : 差が 0（REG_A = REG_B）        … JE と JCC EQ/NE が参照
+--     FLAG_C : 符号なしで REG_A < REG_B（借り）… JCC B/AE
+--     FLAG_S : 差の最上位ビット
+--     FLAG_V : 符号付きの減算があふれた        … JCC LT/GE/LE/GT は S xor V で判定
+-- - ADD/SUB などの演算命令はフラグを変えない（CMP の直後に JE を置く従来の書き方のまま動く）。
+-- - chapter03 のエミュレータ（cpu15.h）はフラグを CMP の被演算子から遅延評価するが、
+--   分岐で見える値はこのフラグと同じになる。
+--
+-- 【命令語の拡張（5bit オペコード）】
+-- - 命令語を 16bit にし、OP_CODE を PROM_OUT(15 downto 11) の5bitにした。
+--   従来の16命令は先頭に '0' を付けたのと同じ（"0xxxx"）で、意味は変わらない。
+--     10000: JCC  条件分岐（条件コード OP_CC = PROM_OUT(10 downto 8)、分岐先 OP_DATA）
+--     10001: ADDI 即値加算（REG_A + 符号拡張した OP_DATA。INC/DEC は ±1 の別名）
+--     10010: CALL 戻り番地（PC+1）をスタックに積んで OP_DATA へ分岐
+--     10011: RET  スタックから戻り番地を取り出して分岐
+--     10100: PUSH REG_A をスタックに積む
+--     10101: POP  スタックから取り出して REG_A 番へ書き戻す
+--     10110: LDR  REG_A 番 = RAM(REG_B の下位8bit)。OP_DATA(0)='1' なら REG_B 番も +1 する
+--     10111: STR  RAM(REG_B の下位8bit) = REG_A。   OP_DATA(0)='1' なら REG_B 番も +1 する
+--     11000: MUL   REG_A * REG_B の下位16bit
+--     11001: MULHU REG_A * REG_B の上位16bit（符号なし）
+--     11010: DIVU  REG_A / REG_B（符号なし。REG_B=0 なら X"FFFF"）
+--     11011: MODU  REG_A mod REG_B（符号なし。REG_B=0 なら REG_A）
+--     11100: MCPY  RAM(REG_A..) = RAM(REG_B..) を PROM_OUT(4 downto 2) 番レジスタの語数だけ
+--     11101: MSET  RAM(REG_A..) = REG_B        を PROM_OUT(4 downto 2) 番レジスタの語数だけ
+--     11110: SWAP  REG_A 番 = RAM(REG_B の下位8bit)、同時に RAM(REG_B の下位8bit) = REG_A
+-- - オペコードと条件コードの値は cpu15_isa.vhd（パッケージ）にまとめてあり、
+--   下の case では OP_ADD のような名前で選ぶ。番号は chapter03/cpu15.h と同じ。
+--
+-- 【ADD の加算器（generic ADDER_ARCH）】
+-- - ADD の REG_A + REG_B は EX の中で最も長い組合せ経路なので、chapter05/adder_nbit.vhd の
+--   adder_nbit（16bit）で作り、その内部構造を generic ADDER_ARCH で選ぶ。
+--     ADDER_RIPPLE / ADDER_CLA / ADDER_KOGGE_STONE（既定）/ ADDER_BRENT_KUNG
+-- - どれを選んでも結果は同じ（adder_nbit_sim.vhd で突き合わせ済み）で、変わるのは段数と面積だけ。
+-- - トップ階層は generic map を書かずに exec をインスタンスしているので既定値が使われる。
+--   解析順は adder_nbit.vhd（と、それが使う half_adder / full_adder）を exec.vhd より先にする。
+--
+-- 【スタック（SP）】
+-- - SP は exec が持つ 8bit のレジスタで、RAM の 63 番地から下へ伸びる（リセット値 64）。
+--   積むときは先に SP-1 し、取り出すときは読んでから SP+1 する。
+-- - RAM のアドレスは SP_OUT をそのまま使う（アドレスの選択は chapter09 の ram_dc_wb）。
+--     PUSH/CALL : EX で SP <= SP-1 → WB で RAM(SP) へ書く（WB の時点では SP は更新後）
+--     POP/RET   : DC で RAM(SP) を読む → EX で SP <= SP+1（DC の時点では SP は更新前）
+--   段イネーブルが FT→DC→EX→WB の順に1本ずつ立つので、どちらも「その時点の SP」が正しい番地になる。
+-- - chapter06 の cpu15 は data_ram の番地に命令の下位8bitをそのまま渡すだけなので、
+--   スタック命令は chapter09（ram_dc_wb）の構成で使う。
+--
+-- 【レジスタ間接（LDR/STR）】
+-- - RAM のアドレスは REG_B の下位8bit。DC 段で RAM を読むのと reg_file が REG_B を取り込むのは
+--   同じ DC のエッジなので、アドレスはトップでレジスタファイルから直接選ぶ（chapter09 の IND_ADDR）。
+-- - ポストインクリメント（[rb]+）は REG_B+1 を2本目の書き戻し（REG_IN_B/REG_WEN_B）で
+--   WB 段に書く。レジスタファイル（reg_file）の書き込みポートは1本なので、
+--   REG_WEN と REG_WEN_B を同じ EX で同時に立てることはしない。
+--     STR [rb]+ : RAM へ書くだけでレジスタは REG_B+1 の1本なので、1回の EX で終わる
+--     LDR [rb]+ : 1回目の EX で REG_B+1 を書き、ロード値を LD_SAVE に取っておく（PC は進めない）。
+--                 2回目の EX で LD_SAVE を REG_A 番へ書いて PC+1。ra = rb のときはロード値が後に
+--                 書かれるので、エミュレータ（cpu15.h）と同じくロード値が残る
+--
+-- 【乗算・除算】
+-- - MUL/MULHU は 16x16 → 32bit の積 MUL_R を組合せで作る。std_logic_unsigned の "*" は
+--   FPGA の合成ツールで DSP ブロック（18x18 乗算器）に割り当てられるので、1命令で終わる。
+-- - DIVU/MODU は1ビットずつの引き戻し法（restoring division）で、16 回の EX に分けて計算する。
+--     1回目の EX  : DIV_Q に REG_A、DIV_R に 0 を入れて DIV_BUSY='1'。PC は進めない
+--     2〜17回目   : 1ビットずつ商を決める。PC が同じなので FT/DC は同じ命令を読み直し、
+--                   REG_A/REG_B も変わらない（その間 REG_WEN='0' で何も書かない）
+--     17回目      : 最後のビットを決めると同時に商または余りを書き戻して PC+1
+--   命令としては 17 サイクル（chapter03/cpu15.h の CYC_DIV と同じ）かかる。
+--
+-- 【ブロック転送】
+-- - 実際に RAM を動かすのは chapter09 の ram_dc_wb（ベースクロック1周期に1語）で、
+--   exec は起動と完了待ちだけをする。
+--     1回目の EX  : BLK_REQ='1'、BLK_PHASE='1'。PC は進めない（WB で転送が始まる）
+--     2回目以降   : BLK_REQ='0'。BLK_BUSY='0'（転送済み）になっていれば PC+1
+-- - 語数 n に対して、命令は 1 + max(1, ceil((n+3)/4)) サイクルかかる（cpu15.h の cpu15_step_timed()）。
 --
 -- 【リセット挙動（RESET_N）】
--- - RESET_N='0' のとき PC=0, CMP_FLAG=0 に初期化する。
+-- - RESET_N='0' のとき PC=0、フラグ=0、SP=64 に初期化し、除算や LDR の途中なら打ち切る。
 -- - CPU bring-up では “必ず決まった番地から実行が始まる” ことが重要なので、
 --   PC初期化は最優先の基本仕様である。
 
@@ -49,30 +129,41 @@ v--
 library IEEE;
 use IEEE.std_logic_1164.all;
 use IEEE.std_logic_unsigned.all;
+use work.cpu15_isa.all;
+use work.adder_nbit_pkg.all;
 
 -- ============================================================
 -- entity: Execute段の外部インタフェース
 -- ============================================================
 entity exec is
+    generic
+    (
+        -- ADD の加算器の構造（adder_nbit_pkg の ADDER_xxx）
+        ADDER_ARCH : integer := ADDER_KOGGE_STONE
+    );
     port
     (
-        -- Execute段クロック：命令の実行（結果・制御の確定）を行うタイミング
-        CLK_EX    : in  std_logic;
+        -- ベースクロックと Execute段のイネーブル：CE_EX のエッジで命令の実行（結果・制御の確定）を行う
+        CLK       : in  std_logic;
+        CE_EX     : in  std_logic;
 
         -- アクティブLowリセット（RESET_N=0でリセット）
         RESET_N   : in  std_logic;
 
-        -- 命令種別（OP_CODE）: decode段が PROM_OUT(14:11) から抽出
-        OP_CODE   : in  std_logic_vector(3 downto 0);
+        -- 命令種別（OP_CODE）: decode段が PROM_OUT(15:11) から抽出
+        OP_CODE   : in  std_logic_vector(4 downto 0);
+
+        -- 条件コード（JCC 用）: decode段が PROM_OUT(10:8) から抽出
+        OP_CC     : in  std_logic_vector(2 downto 0);
 
-        -- オペランドA/B（reg_dcが選択して渡すレジスタ値）
+        -- オペランドA/B（reg_file が読み出して渡すレジスタ値）
         REG_A     : in  std_logic_vector(15 downto 0);
         REG_B     : in  std_logic_vector(15 downto 0);
 
         -- 即値/アドレス（decode段が PROM_OUT(7:0) から抽出）
         OP_DATA   : in  std_logic_vector(7 downto 0);
 
-        -- メモリ読み出し値（ram_dcが選択して渡す値）
+        -- メモリ読み出し値（data_ram の出力レジスタ。DC で読んだ値）
         RAM_OUT   : in  std_logic_vector(15 downto 0);
 
         -- 次にFetchが参照するPC（プログラムカウンタ）
@@ -88,7 +179,18 @@ entity exec is
         REG_WEN   : out std_logic;
 
         -- RAM書き込み有効
-        RAM_WEN   : out std_logic
+        RAM_WEN   : out std_logic;
+
+        -- スタックポインタ（スタック命令の RAM アドレス）
+        SP_OUT    : out std_logic_vector(7 downto 0);
+
+        -- 2本目のレジスタ書き戻し（ポストインクリメント：REG_B+1 を N_REG_B 番へ）
+        REG_IN_B  : out std_logic_vector(15 downto 0);
+        REG_WEN_B : out std_logic;
+
+        -- ブロック転送（MCPY/MSET）：要求と、転送中かどうか（ram_dc_wb から）
+        BLK_REQ   : out std_logic;
+        BLK_BUSY  : in  std_logic
     );
 end exec;
 
@@ -97,6 +199,20 @@ end exec;
 -- ============================================================
 architecture RTL of exec is
 
+    component adder_nbit
+        generic(
+            N    : integer := 16;
+            ARCH : integer := ADDER_RIPPLE
+        );
+        port(
+            A  : in  std_logic_vector(N - 1 downto 0);
+            B  : in  std_logic_vector(N - 1 downto 0);
+            CI : in  std_logic;
+            S  : out std_logic_vector(N - 1 downto 0);
+            CO : out std_logic
+        );
+    end component;
+
     -- --------------------------------------------------------
     -- PC: プログラムカウンタ（CPUの内部状態）
     -- --------------------------------------------------------
@@ -104,217 +220,506 @@ architecture RTL of exec is
     signal PC       : std_logic_vector(7 downto 0) := "00000000";
 
     -- --------------------------------------------------------
-    -- CMP_FLAG: 比較結果フラグ（最小版フラグレジスタ）
+    -- SP: スタックポインタ（RAM の 63 番地から下へ伸びる）
+    -- --------------------------------------------------------
+    signal SP       : std_logic_vector(7 downto 0) := "01000000";
+
+    -- --------------------------------------------------------
+    -- フラグレジスタ：CMP/ADDI が設定し、JE/JCC が参照する。
+    -- --------------------------------------------------------
+    signal FLAG_Z   : std_logic := '0';
+    signal FLAG_C   : std_logic := '0';
+    signal FLAG_S   : std_logic := '0';
+    signal FLAG_V   : std_logic := '0';
+
+    -- --------------------------------------------------------
+    -- 組合せで作る中間値
+    -- --------------------------------------------------------
+    signal CMP_R    : std_logic_vector(15 downto 0);   -- REG_A - REG_B（CMP のフラグ計算用）
+    signal IMM_SX   : std_logic_vector(15 downto 0);   -- OP_DATA を符号拡張した即値（ADDI）
+    signal ADDI_R   : std_logic_vector(15 downto 0);   -- REG_A + IMM_SX
+    signal COND_OK  : std_logic;                       -- OP_CC の条件が成立しているか（JCC）
+    signal MUL_R    : std_logic_vector(31 downto 0);   -- REG_A * REG_B（DSP ブロック）
+    signal ADD_R    : std_logic_vector(15 downto 0);   -- REG_A + REG_B（adder_nbit、ADDER_ARCH の構造）
+
+    -- --------------------------------------------------------
+    -- 除算器（DIVU/MODU）：1ビット/EX の引き戻し法
     -- --------------------------------------------------------
-    -- CMP命令が設定し、JE命令が参照する。
-    signal CMP_FLAG : std_logic := '0';
+    signal DIV_BUSY : std_logic := '0';                         -- 除算の途中
+    signal DIV_CNT  : std_logic_vector(4 downto 0);             -- 残りビット数（16→0）
+    signal DIV_Q    : std_logic_vector(15 downto 0);            -- 被除数を左へ送り出しながら商を詰める
+    signal DIV_R    : std_logic_vector(15 downto 0);            -- 部分剰余
+    signal DIV_SH   : std_logic_vector(16 downto 0);            -- DIV_R を1ビット左へ送って被除数の次ビットを入れた値
+    signal DIV_SUB  : std_logic_vector(17 downto 0);            -- DIV_SH - REG_B（最上位が '1' なら引けない）
+    signal DIV_QN   : std_logic_vector(15 downto 0);            -- このステップ後の DIV_Q
+    signal DIV_RN   : std_logic_vector(15 downto 0);            -- このステップ後の DIV_R
+
+    -- ブロック転送：要求を出し終えて完了を待っている
+    signal BLK_PHASE : std_logic := '0';
+
+    -- LDR のポストインクリメント：REG_B+1 を書き終えてロード値の書き戻しを待っている
+    signal LDR_PHASE : std_logic := '0';
+    signal LD_SAVE   : std_logic_vector(15 downto 0);    -- 1回目の EX で読んだ RAM(REG_B)
 
 begin
 
+    CMP_R   <= REG_A - REG_B;
+    IMM_SX  <= X"FF" & OP_DATA when OP_DATA(7) = '1' else X"00" & OP_DATA;
+    ADDI_R  <= REG_A + IMM_SX;
+
+    MUL_R   <= REG_A * REG_B;
+
+    -- ADD の加算器（キャリー出力はフラグに使わないので open）
+    ADD : adder_nbit
+        generic map(N => 16, ARCH => ADDER_ARCH)
+        port map(
+            A  => REG_A,
+            B  => REG_B,
+            CI => '0',
+            S  => ADD_R,
+            CO => open
+        );
+
+    -- 除算の1ステップ（組合せ）。REG_B=0 なら毎回引けるので、商は全ビット '1'、余りは REG_A になる
+    DIV_SH  <= DIV_R & DIV_Q(15);
+    DIV_SUB <= ('0' & DIV_SH) - ("00" & REG_B);
+    DIV_QN  <= DIV_Q(14 downto 0) & not DIV_SUB(17);
+    DIV_RN  <= DIV_SUB(15 downto 0) when DIV_SUB(17) = '0' else DIV_SH(15 downto 0);
+
+    -- 条件コード：chapter03/cpu15.h の CC_EQ..CC_AE と同じ番号
+    COND_OK <= FLAG_Z                                  when OP_CC = CC_EQ else   -- EQ
+               not FLAG_Z                              when OP_CC = CC_NE else   -- NE
+               FLAG_S xor FLAG_V                       when OP_CC = CC_LT else   -- LT（符号付き）
+               not (FLAG_S xor FLAG_V)                 when OP_CC = CC_GE else   -- GE（符号付き）
+               FLAG_Z or (FLAG_S xor FLAG_V)           when OP_CC = CC_LE else   -- LE（符号付き）
+               not (FLAG_Z or (FLAG_S xor FLAG_V))     when OP_CC = CC_GT else   -- GT（符号付き）
+               FLAG_C                                  when OP_CC = CC_B  else   -- B （符号なし）
+               not FLAG_C;                                                       -- AE（符号なし）
+
     -- ========================================================
     -- Execute段メイン：命令実行
     -- ========================================================
-    process(CLK_EX)
+    process(CLK)
     begin
-        if (CLK_EX'event and CLK_EX = '1') then
-
-            -- ------------------------------------------------
-            -- リセット処理（アクティブLow）
-            -- ------------------------------------------------
-            if (RESET_N = '0') then
-                PC       <= "00000000";  -- 実行開始番地へ戻す
-                CMP_FLAG <= '0';         -- 比較フラグも既知値に
+        if (CLK'event and CLK = '1') then
+            if (CE_EX = '1') then
 
-            else
                 -- ------------------------------------------------
-                -- 命令デコード（OP_CODE）に応じた実行
+                -- リセット処理（アクティブLow）
                 -- ------------------------------------------------
-                case OP_CODE is
-
-                    -- ====================================================
-                    -- 0000: MOV（レジスタ間コピー）
-                    --   REG_IN = REG_B を生成し、REG_WEN=1で書き戻しさせる
-                    --   PCは次命令へ（PC+1）
-                    -- ====================================================
-                    when "0000" =>
-                        REG_IN  <= REG_B;  -- 書き戻しデータ
-                        REG_WEN <= '1';    -- レジスタ更新あり
-                        RAM_WEN <= '0';    -- メモリ更新なし
-                        PC      <= PC + 1;
-
-                    -- ====================================================
-                    -- 0001: ADD（加算）
-                    --   REG_IN = REG_A + REG_B（ALU加算）
-                    --   PC+1
-                    -- ====================================================
-                    when "0001" =>
-                        REG_IN  <= REG_A + REG_B;
-                        REG_WEN <= '1';
-                        RAM_WEN <= '0';
-                        PC      <= PC + 1;
-
-                    -- ====================================================
-                    -- 0010: SUB（減算）
-                    -- ====================================================
-                    when "0010" =>
-                        REG_IN  <= REG_A - REG_B;
-                        REG_WEN <= '1';
-                        RAM_WEN <= '0';
-                        PC      <= PC + 1;
-
-                    -- ====================================================
-                    -- 0011: AND（論理積）
-                    -- ====================================================
-                    when "0011" =>
-                        REG_IN  <= REG_A and REG_B;
-                        REG_WEN <= '1';
-                        RAM_WEN <= '0';
-                        PC      <= PC + 1;
-
-                    -- ====================================================
-                    -- 0100: OR（論理和）
-                    -- ====================================================
-                    when "0100" =>
-                        REG_IN  <= REG_A or REG_B;
-                        REG_WEN <= '1';
-                        RAM_WEN <= '0';
-                        PC      <= PC + 1;
-
-                    -- ====================================================
-                    -- 0101: SL（Shift Left Logical：論理左シフト1）
-                    --   REG_Aを1bit左へ、LSBに0を入れる
-                    --   REG_A(14:0) & '0' は (REG_A << 1) に相当
-                    -- ====================================================
-                    when "0101" =>
-                        REG_IN  <= REG_A(14 downto 0) & '0';
-                        REG_WEN <= '1';
-                        RAM_WEN <= '0';
-                        PC      <= PC + 1;
-
-                    -- ====================================================
-                    -- 0110: SR（Shift Right Logical：論理右シフト1）
-                    --   MSBに0を入れる
-                    -- ====================================================
-                    when "0110" =>
-                        REG_IN  <= '0' & REG_A(15 downto 1);
-                        REG_WEN <= '1';
-                        RAM_WEN <= '0';
-                        PC      <= PC + 1;
-
-                    -- ====================================================
-                    -- 0111: SRA（Shift Right Arithmetic：算術右シフト1）
-                    --   MSB（符号ビット相当）を保持して右シフトする
-                    --   REG_A(15) & REG_A(15:1)
-                    -- ====================================================
-                    when "0111" =>
-                        REG_IN  <= REG_A(15) & REG_A(15 downto 1);
-                        REG_WEN <= '1';
-                        RAM_WEN <= '0';
-                        PC      <= PC + 1;
-
-                    -- ====================================================
-                    -- 1000: LDL（Load Immediate Low）
-                    --   下位8bitをOP_DATAで置き換える（上位8bitはREG_Aから保持）
-                    --   REG_IN = REG_A[15:8] & OP_DATA
-                    -- ====================================================
-                    when "1000" =>
-                        REG_IN  <= REG_A(15 downto 8) & OP_DATA;
-                        REG_WEN <= '1';
-                        RAM_WEN <= '0';
-                        PC      <= PC + 1;
-
-                    -- ====================================================
-                    -- 1001: LDH（Load Immediate High）
-                    --   上位8bitをOP_DATAで置き換える（下位8bitはREG_Aから保持）
-                    --   REG_IN = OP_DATA & REG_A[7:0]
-                    -- ====================================================
-                    when "1001" =>
-                        REG_IN  <= OP_DATA & REG_A(7 downto 0);
-                        REG_WEN <= '1';
-                        RAM_WEN <= '0';
-                        PC      <= PC + 1;
-
-                    -- ====================================================
-                    -- 1010: CMP（比較）
-                    --   REG_A == REG_B なら CMP_FLAG=1、それ以外は0
-                    --   レジスタやRAMは更新しない（WEN=0）
-                    --   PC+1
-                    -- ====================================================
-                    when "1010" =>
-                        if (REG_A = REG_B) then
-                            CMP_FLAG <= '1';
-                        else
-                            CMP_FLAG <= '0';
-                        end if;
-
-                        REG_WEN <= '0';
-                        RAM_WEN <= '0';
-                        PC      <= PC + 1;
-
-                    -- ====================================================
-                    -- 1011: JE（Jump if Equal）
-                    --   CMP_FLAG==1 なら PC = OP_DATA（分岐先へ）
-                    --   そうでなければ PC+1
-                    --   データ更新なし
-                    -- ====================================================
-                    when "1011" =>
-                        if (CMP_FLAG = '1') then
-                            PC <= OP_DATA;   -- 分岐（絶対番地）
-                        else
-                            PC <= PC + 1;    -- 不成立なら次命令
-                        end if;
-
-                        REG_WEN <= '0';
-                        RAM_WEN <= '0';
-
-                    -- ====================================================
-                    -- 1100: JMP（無条件ジャンプ）
-                    --   PC = OP_DATA
-                    -- ====================================================
-                    when "1100" =>
-                        REG_WEN <= '0';
-                        RAM_WEN <= '0';
-                        PC      <= OP_DATA;
-
-                    -- ====================================================
-                    -- 1101: LD（ロード）
-                    --   RAM_OUT（Decode段で読んだメモリ/IO値）をREGに書き戻す
-                    --   PC+1
-                    -- ====================================================
-                    when "1101" =>
-                        REG_IN  <= RAM_OUT;
-                        REG_WEN <= '1';
-                        RAM_WEN <= '0';
-                        PC      <= PC + 1;
-
-                    -- ====================================================
-                    -- 1110: ST（ストア）
-                    --   REG_A を RAM_IN に出し、RAM_WEN=1で書き込みを要求する
-                    --   書き込み先アドレスは別経路（ram_dcのRAM_AD_OUT→ram_wb）で伝搬している想定
-                    --   PC+1
-                    -- ====================================================
-                    when "1110" =>
-                        RAM_IN  <= REG_A;  -- 書き込みデータ
-                        REG_WEN <= '0';
-                        RAM_WEN <= '1';    -- メモリ更新あり
-                        PC      <= PC + 1;
-
-                    -- ====================================================
-                    -- 1111: HLT（停止）
-                    --   何も更新しない。PCも更新しないため、以後同じ命令番地に留まる挙動になる。
-                    --   （Fetchが同じ番地を読み続ける＝“停止状態”とみなす）
-                    -- ====================================================
-                    when "1111" =>
-                        REG_WEN <= '0';
-                        RAM_WEN <= '0';
-
-                    -- ====================================================
-                    -- 想定外：何もしない（更新なし）
-                    -- ====================================================
-                    when others =>
-                        null;
-
-                end case;
+                if (RESET_N = '0') then
+                    PC       <= "00000000";  -- 実行開始番地へ戻す
+                    FLAG_Z   <= '0';         -- フラグも既知値に
+                    FLAG_C   <= '0';
+                    FLAG_S   <= '0';
+                    FLAG_V   <= '0';
+                    SP       <= "01000000";  -- スタックは空（次に積むのは 63 番地）
+                    REG_WEN_B <= '0';
+                    DIV_BUSY <= '0';
+                    BLK_PHASE <= '0';
+                    LDR_PHASE <= '0';
+                    BLK_REQ  <= '0';
+
+                else
+                    -- 2本目の書き戻しを使うのは LDR/STR のポストインクリメントだけ
+                    REG_WEN_B <= '0';
+                    -- ブロック転送の要求は1回の EX だけ出す
+                    BLK_REQ   <= '0';
+
+                    -- ------------------------------------------------
+                    -- 命令デコード（OP_CODE）に応じた実行
+                    -- ------------------------------------------------
+                    case OP_CODE is
+
+                        -- ====================================================
+                        -- 00000: MOV（レジスタ間コピー）
+                        --   REG_IN = REG_B を生成し、REG_WEN=1で書き戻しさせる
+                        --   PCは次命令へ（PC+1）
+                        -- ====================================================
+                        when OP_MOV =>
+                            REG_IN  <= REG_B;  -- 書き戻しデータ
+                            REG_WEN <= '1';    -- レジスタ更新あり
+                            RAM_WEN <= '0';    -- メモリ更新なし
+                            PC      <= PC + 1;
+
+                        -- ====================================================
+                        -- 00001: ADD（加算）
+                        --   REG_IN = REG_A + REG_B（ALU加算。adder_nbit の出力 ADD_R）
+                        --   PC+1
+                        -- ====================================================
+                        when OP_ADD =>
+                            REG_IN  <= ADD_R;
+                            REG_WEN <= '1';
+                            RAM_WEN <= '0';
+                            PC      <= PC + 1;
+
+                        -- ====================================================
+                        -- 00010: SUB（減算）
+                        -- ====================================================
+                        when OP_SUB =>
+                            REG_IN  <= REG_A - REG_B;
+                            REG_WEN <= '1';
+                            RAM_WEN <= '0';
+                            PC      <= PC + 1;
+
+                        -- ====================================================
+                        -- 00011: AND（論理積）
+                        -- ====================================================
+                        when OP_AND =>
+                            REG_IN  <= REG_A and REG_B;
+                            REG_WEN <= '1';
+                            RAM_WEN <= '0';
+                            PC      <= PC + 1;
+
+                        -- ====================================================
+                        -- 00100: OR（論理和）
+                        -- ====================================================
+                        when OP_OR =>
+                            REG_IN  <= REG_A or REG_B;
+                            REG_WEN <= '1';
+                            RAM_WEN <= '0';
+                            PC      <= PC + 1;
+
+                        -- ====================================================
+                        -- 00101: SL（Shift Left Logical：論理左シフト1）
+                        --   REG_Aを1bit左へ、LSBに0を入れる
+                        --   REG_A(14:0) & '0' は (REG_A << 1) に相当
+                        -- ====================================================
+                        when OP_SL =>
+                            REG_IN  <= REG_A(14 downto 0) & '0';
+                            REG_WEN <= '1';
+                            RAM_WEN <= '0';
+                            PC      <= PC + 1;
+
+                        -- ====================================================
+                        -- 00110: SR（Shift Right Logical：論理右シフト1）
+                        --   MSBに0を入れる
+                        -- ====================================================
+                        when OP_SR =>
+                            REG_IN  <= '0' & REG_A(15 downto 1);
+                            REG_WEN <= '1';
+                            RAM_WEN <= '0';
+                            PC      <= PC + 1;
+
+                        -- ====================================================
+                        -- 00111: SRA（Shift Right Arithmetic：算術右シフト1）
+                        --   MSB（符号ビット相当）を保持して右シフトする
+                        --   REG_A(15) & REG_A(15:1)
+                        -- ====================================================
+                        when OP_SRA =>
+                            REG_IN  <= REG_A(15) & REG_A(15 downto 1);
+                            REG_WEN <= '1';
+                            RAM_WEN <= '0';
+                            PC      <= PC + 1;
+
+                        -- ====================================================
+                        -- 01000: LDL（Load Immediate Low）
+                        --   下位8bitをOP_DATAで置き換える（上位8bitはREG_Aから保持）
+                        --   REG_IN = REG_A[15:8] & OP_DATA
+                        -- ====================================================
+                        when OP_LDL =>
+                            REG_IN  <= REG_A(15 downto 8) & OP_DATA;
+                            REG_WEN <= '1';
+                            RAM_WEN <= '0';
+                            PC      <= PC + 1;
+
+                        -- ====================================================
+                        -- 01001: LDH（Load Immediate High）
+                        --   上位8bitをOP_DATAで置き換える（下位8bitはREG_Aから保持）
+                        --   REG_IN = OP_DATA & REG_A[7:0]
+                        -- ====================================================
+                        when OP_LDH =>
+                            REG_IN  <= OP_DATA & REG_A(7 downto 0);
+                            REG_WEN <= '1';
+                            RAM_WEN <= '0';
+                            PC      <= PC + 1;
+
+                        -- ====================================================
+                        -- 01010: CMP（比較）
+                        --   REG_A - REG_B からフラグ Z/C/S/V を作る
+                        --   レジスタやRAMは更新しない（WEN=0）
+                        --   PC+1
+                        -- ====================================================
+                        when OP_CMP =>
+                            if (CMP_R = X"0000") then
+                                FLAG_Z <= '1';
+                            else
+                                FLAG_Z <= '0';
+                            end if;
+                            if (REG_A < REG_B) then
+                                FLAG_C <= '1';
+                            else
+                                FLAG_C <= '0';
+                            end if;
+                            FLAG_S <= CMP_R(15);
+                            FLAG_V <= (REG_A(15) xor REG_B(15)) and (REG_A(15) xor CMP_R(15));
+
+                            REG_WEN <= '0';
+                            RAM_WEN <= '0';
+                            PC      <= PC + 1;
+
+                        -- ====================================================
+                        -- 01011: JE（Jump if Equal）
+                        --   FLAG_Z==1 なら PC = OP_DATA（分岐先へ）
+                        --   そうでなければ PC+1
+                        --   データ更新なし
+                        -- ====================================================
+                        when OP_JE =>
+                            if (FLAG_Z = '1') then
+                                PC <= OP_DATA;   -- 分岐（絶対番地）
+                            else
+                                PC <= PC + 1;    -- 不成立なら次命令
+                            end if;
+
+                            REG_WEN <= '0';
+                            RAM_WEN <= '0';
+
+                        -- ====================================================
+                        -- 01100: JMP（無条件ジャンプ）
+                        --   PC = OP_DATA
+                        -- ====================================================
+                        when OP_JMP =>
+                            REG_WEN <= '0';
+                            RAM_WEN <= '0';
+                            PC      <= OP_DATA;
+
+                        -- ====================================================
+                        -- 01101: LD（ロード）
+                        --   RAM_OUT（Decode段で読んだメモリ/IO値）をREGに書き戻す
+                        --   PC+1
+                        -- ====================================================
+                        when OP_LD =>
+                            REG_IN  <= RAM_OUT;
+                            REG_WEN <= '1';
+                            RAM_WEN <= '0';
+                            PC      <= PC + 1;
+
+                        -- ====================================================
+                        -- 01110: ST（ストア）
+                        --   REG_A を RAM_IN に出し、RAM_WEN=1で書き込みを要求する
+                        --   書き込み先アドレスは別経路（PROM_OUT(7:0)→data_ram）で伝搬している想定
+                        --   PC+1
+                        -- ====================================================
+                        when OP_ST =>
+                            RAM_IN  <= REG_A;  -- 書き込みデータ
+                            REG_WEN <= '0';
+                            RAM_WEN <= '1';    -- メモリ更新あり
+                            PC      <= PC + 1;
+
+                        -- ====================================================
+                        -- 01111: HLT（停止）
+                        --   何も更新しない。PCも更新しないため、以後同じ命令番地に留まる挙動になる。
+                        --   （Fetchが同じ番地を読み続ける＝“停止状態”とみなす）
+                        -- ====================================================
+                        when OP_HLT =>
+                            REG_WEN <= '0';
+                            RAM_WEN <= '0';
+
+                        -- ====================================================
+                        -- 10000: JCC（条件分岐）
+                        --   OP_CC の条件（COND_OK）が成立すれば PC = OP_DATA
+                        --   BNE/JNE は OP_CC="001"（NE）の JCC
+                        -- ====================================================
+                        when OP_JCC =>
+                            if (COND_OK = '1') then
+                                PC <= OP_DATA;
+                            else
+                                PC <= PC + 1;
+                            end if;
+
+                            REG_WEN <= '0';
+                            RAM_WEN <= '0';
+
+                        -- ====================================================
+                        -- 10001: ADDI（即値加算）
+                        --   REG_IN = REG_A + 符号拡張(OP_DATA)
+                        --   フラグは結果を 0 と比べた値にする（DEC → BNE でループを組めるように）
+                        --   INC = ADDI +1、DEC = ADDI -1
+                        -- ====================================================
+                        when OP_ADDI =>
+                            REG_IN  <= ADDI_R;
+                            REG_WEN <= '1';
+                            RAM_WEN <= '0';
+                            PC      <= PC + 1;
+
+                            if (ADDI_R = X"0000") then
+                                FLAG_Z <= '1';
+                            else
+                                FLAG_Z <= '0';
+                            end if;
+                            FLAG_C <= '0';
+                            FLAG_S <= ADDI_R(15);
+                            FLAG_V <= '0';
+
+                        -- ====================================================
+                        -- 10010: CALL（サブルーチン呼び出し）
+                        --   RAM(SP-1) に戻り番地 PC+1 を書き、PC = OP_DATA
+                        -- ====================================================
+                        when OP_CALL =>
+                            RAM_IN  <= "00000000" & (PC + 1);
+                            REG_WEN <= '0';
+                            RAM_WEN <= '1';
+                            SP      <= SP - 1;
+                            PC      <= OP_DATA;
+
+                        -- ====================================================
+                        -- 10011: RET（サブルーチンから戻る）
+                        --   DC段で読んだ RAM(SP) の下位8bitへ分岐し、SP+1
+                        -- ====================================================
+                        when OP_RET =>
+                            REG_WEN <= '0';
+                            RAM_WEN <= '0';
+                            SP      <= SP + 1;
+                            PC      <= RAM_OUT(7 downto 0);
+
+                        -- ====================================================
+                        -- 10100: PUSH（REG_A を積む）
+                        -- ====================================================
+                        when OP_PUSH =>
+                            RAM_IN  <= REG_A;
+                            REG_WEN <= '0';
+                            RAM_WEN <= '1';
+                            SP      <= SP - 1;
+                            PC      <= PC + 1;
+
+                        -- ====================================================
+                        -- 10101: POP（取り出して REG_A 番へ）
+                        -- ====================================================
+                        when OP_POP =>
+                            REG_IN  <= RAM_OUT;
+                            REG_WEN <= '1';
+                            RAM_WEN <= '0';
+                            SP      <= SP + 1;
+                            PC      <= PC + 1;
+
+                        -- ====================================================
+                        -- 10110: LDR（レジスタ間接ロード）
+                        --   DC段で読んだ RAM(REG_B) を REG_A 番へ。OP_DATA(0)='1' なら REG_B+1 も書く
+                        --   （書き込みポートが1本なので、ポストインクリメント付きは2回の EX に分ける）
+                        -- ====================================================
+                        when OP_LDR =>
+                            RAM_WEN   <= '0';
+                            if (OP_DATA(0) = '0') then
+                                REG_IN    <= RAM_OUT;
+                                REG_WEN   <= '1';
+                                PC        <= PC + 1;
+                            elsif (LDR_PHASE = '0') then
+                                -- 1回目：REG_B+1 だけ書き、ロード値は LD_SAVE に取っておく（PC は進めない）
+                                LD_SAVE   <= RAM_OUT;
+                                REG_WEN   <= '0';
+                                REG_IN_B  <= REG_B + 1;
+                                REG_WEN_B <= '1';
+                                LDR_PHASE <= '1';
+                            else
+                                -- 2回目：ロード値を REG_A 番へ（ra = rb ならこちらが後に書くので勝つ）
+                                REG_IN    <= LD_SAVE;
+                                REG_WEN   <= '1';
+                                LDR_PHASE <= '0';
+                                PC        <= PC + 1;
+                            end if;
+
+                        -- ====================================================
+                        -- 10111: STR（レジスタ間接ストア）
+                        --   RAM(REG_B) = REG_A。OP_DATA(0)='1' なら REG_B+1 も書く
+                        -- ====================================================
+                        when OP_STR =>
+                            RAM_IN    <= REG_A;
+                            REG_WEN   <= '0';
+                            RAM_WEN   <= '1';
+                            REG_IN_B  <= REG_B + 1;
+                            REG_WEN_B <= OP_DATA(0);
+                            PC        <= PC + 1;
+
+                        -- ====================================================
+                        -- 11000: MUL（積の下位16bit）
+                        -- ====================================================
+                        when OP_MUL =>
+                            REG_IN  <= MUL_R(15 downto 0);
+                            REG_WEN <= '1';
+                            RAM_WEN <= '0';
+                            PC      <= PC + 1;
+
+                        -- ====================================================
+                        -- 11001: MULHU（積の上位16bit、符号なし）
+                        -- ====================================================
+                        when OP_MULHU =>
+                            REG_IN  <= MUL_R(31 downto 16);
+                            REG_WEN <= '1';
+                            RAM_WEN <= '0';
+                            PC      <= PC + 1;
+
+                        -- ====================================================
+                        -- 11010: DIVU / 11011: MODU（複数サイクル）
+                        --   DIV_BUSY='0' なら初期化だけ、'1' なら1ビット進める。
+                        --   最後のビット（DIV_CNT=1）で OP_CODE(0) に応じて商/余りを書き戻す。
+                        -- ====================================================
+                        when OP_DIVU | OP_MODU =>
+                            RAM_WEN <= '0';
+                            if (DIV_BUSY = '0') then
+                                DIV_Q    <= REG_A;
+                                DIV_R    <= "0000000000000000";
+                                DIV_CNT  <= "10000";
+                                DIV_BUSY <= '1';
+                                REG_WEN  <= '0';
+                            else
+                                DIV_Q   <= DIV_QN;
+                                DIV_R   <= DIV_RN;
+                                DIV_CNT <= DIV_CNT - 1;
+                                if (DIV_CNT = "00001") then
+                                    if (OP_CODE(0) = '0') then
+                                        REG_IN <= DIV_QN;
+                                    else
+                                        REG_IN <= DIV_RN;
+                                    end if;
+                                    REG_WEN  <= '1';
+                                    DIV_BUSY <= '0';
+                                    PC       <= PC + 1;
+                                else
+                                    REG_WEN  <= '0';
+                                end if;
+                            end if;
+
+                        -- ====================================================
+                        -- 11100: MCPY / 11101: MSET（ブロック転送）
+                        --   1回目は要求だけ出して PC を止め、2回目以降は転送の完了を待つ
+                        -- ====================================================
+                        when OP_MCPY | OP_MSET =>
+                            REG_WEN <= '0';
+                            RAM_WEN <= '0';
+                            if (BLK_PHASE = '0') then
+                                BLK_REQ   <= '1';
+                                BLK_PHASE <= '1';
+                            elsif (BLK_BUSY = '0') then
+                                BLK_PHASE <= '0';
+                                PC        <= PC + 1;
+                            end if;
+
+                        -- ====================================================
+                        -- 11110: SWAP（不可分な入れ替え）
+                        --   DC段で読んだ RAM(REG_B) を REG_A 番へ書き戻し、同じ命令の WB で
+                        --   RAM(REG_B) = REG_A（入れ替え前の値）を書く。LDR と STR を1命令にしたもの。
+                        --   DC の読みから WB の書きまでを他のコアに割り込ませないのは
+                        --   共有メモリ側（chapter09 の cpu15_multi）の役目
+                        -- ====================================================
+                        when OP_SWAP =>
+                            REG_IN  <= RAM_OUT;
+                            RAM_IN  <= REG_A;
+                            REG_WEN <= '1';
+                            RAM_WEN <= '1';
+                            PC      <= PC + 1;
+
+                        -- ====================================================
+                        -- 未定義（いまは 11111）：NOP として次の命令へ進む
+                        --   null のままだと PC が止まり、前の命令の REG_WEN/RAM_WEN が残って
+                        --   同じ書き込みを繰り返す。エミュレータ（cpu15.h の default）と同じく読み飛ばす
+                        -- ====================================================
+                        when others =>
+                            REG_WEN <= '0';
+                            RAM_WEN <= '0';
+                            PC      <= PC + 1;
+
+                    end case;
+                end if;
             end if;
         end if;
     end process;
@@ -323,12 +728,13 @@ begin
     -- PCを外へ出す：Fetch段が参照する次命令番地
     -- ========================================================
     P_COUNT <= PC;
+    SP_OUT  <= SP;
 
 end RTL;
 
 -- 【CPU設計としての補足（検証ポイント）】
--- - PC更新規則：通常命令はPC+1、JE/JMPは絶対番地OP_DATAへ。これがFetchと一致しているか。
--- - CMP_FLAGの寿命：CMPの次にJEが来る前提の“単純フラグ”であり、割込み/例外等は未考慮。
--- - LD/STのアドレス：データはRAM_OUT/RAM_INだが、アドレスは別線でram_wbへ届く設計。
+-- - PC更新規則：通常命令はPC+1、JE/JMP/JCCは絶対番地OP_DATAへ。これがFetchと一致しているか。
+-- - フラグの寿命：CMP/ADDI が作り、次の CMP/ADDI まで保持する。割込み/例外等は未考慮。
+-- - LD/STのアドレス：データはRAM_OUT/RAM_INだが、アドレスは別線で data_ram へ届く設計。
 --   トップ配線で「どの段のアドレスを使うか」が一致していないと store が壊れる。
 -- - HLTの挙動：PCを止めることで“停止”を表現している。明示的なHALT状態信号を追加するとより明確になる。
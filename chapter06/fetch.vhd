@@ -9,22 +9,33 @@
 --
 -- 【設計上の特徴（この教材CPUの事情）】
 -- - PROMは「配列 + constant 初期化」で実装されており、RAMではなくROM相当である。
--- - 命令語は 15bit 固定（std_logic_vector(14 downto 0)）。
--- - アドレス空間は 0〜15（16語）だけを使う簡易PROMで、
---   PCの下位4bit（P_COUNT(3 downto 0)）で参照している。
---   つまり、このCPUは実験用に “16命令だけ入る小さいプログラム” を実行する構成である。
+-- - 命令語は 16bit 固定（std_logic_vector(15 downto 0)）。
+--   もとは 15bit（オペコード4bit）だったが、ADDI/JCC などを追加するため
+--   オペコードを5bit（[15:11]）に広げた。従来の命令は MSB が '0' になるだけで同じビット列。
+-- - PROM は 2**A_BITS 語（generic A_BITS、既定 8 → 256語）で、
+--   PCの下位 A_BITS ビット（既定では P_COUNT(7 downto 0) 全体）で参照する。
+--   もとは 16語で P_COUNT(3 downto 0) だけを使っていたため、17語以上のプログラムは
+--   16番地で 0番地に折り返して（モジュロ16で）黙って壊れていた。
 --
 -- 【フェッチ段のアルゴリズム（1サイクル動作）】
--- - CLK_FT（Fetch用ステージクロック）の立ち上がりで、
+-- - CE_FT（Fetch段のイネーブル）が '1' の CLK の立ち上がりで、
 --   PROM[ PC ] を読み出し PROM_OUT にラッチする。
--- - これにより、次のDecode段（CLK_DC）では PROM_OUT が安定した入力として扱える。
+-- - これにより、次のDecode段（CE_DC のエッジ）では PROM_OUT が安定した入力として扱える。
+-- - パイプライン版（fetch_pq）や chapter09 の fetch_rom_sim のように毎サイクル読むときは
+--   CE_FT に '1' をつなぐ。
 --
--- 【注意：P_COUNT(3 downto 0) を使う意味】
--- - MEM の配列サイズが 16 (=2^4) なので、アドレスとして 4bit しか使っていない。
--- - 上位ビット P_COUNT(7 downto 4) はこのfetchでは無視される。
---   そのため、PCが16以上になってもアドレスは下位4bitで折り返す（モジュロ16動作）になる。
--- - 自作CPUの拡張では、MEMORY を 256語などに拡張し、
---   P_COUNT(7 downto 0) 全体で参照するのが自然になる。
+-- 【ROM の中身の与え方（generic ROM_FILE）】
+-- - ROM_FILE = ""（既定）   : 下の SUM_PROG（総和プログラム）。残りの番地は nop（全0）
+-- - ROM_FILE = "ファイル名" : エラボレーション時にそのファイルを読み込む（LOAD_ROM）。
+--   chapter03 のエミュレータ（アセンブラ）が書き出すイメージをそのまま使える：
+--       CPU_emulator -p blk -o blk.hex
+--   形式は「1行に1語の16進（例：450a）」。先頭の空白は飛ばし、16進でない文字で止まるので
+--   "450a  -- ldh ..." のように後ろに注釈を書いてよい。16進の数字がない行（空行・-- の行）は読み飛ばす。
+--   書かれていない残りの番地は 0。ROM より長いファイルはエラーにする。
+-- - 読み込みは std.textio の関数なので、シミュレーションと、初期化ファイルを読める合成ツール
+--   （Quartus / Vivado の定数の初期化）のどちらでも同じ中身になる。
+--   chapter09 の fetch_rom（Quartus のメガファンクション）と違ってベンダ固有のものは使わない。
+-- - vhdl2c（vhdl_front.c）は function の本体を解析しないので、LOAD_ROM は同じ規則で自前で評価する。
 --
 -- 【命令ROMの中身（このプログラムが何をするか）】
 -- - コメントにある通り、1+2+...+10 の総和（55）を計算し、メモリ(64番地)へ store して停止する。
@@ -49,25 +60,34 @@
 
 library IEEE;
 use IEEE.std_logic_1164.all;
+use IEEE.std_logic_arith.all;
 use IEEE.std_logic_unsigned.all;
+use std.textio.all;
+use work.cpu15_isa.all;
 
 -- ============================================================
 -- entity: Fetch段の外部インタフェース
 -- ============================================================
 entity fetch is
+    generic
+    (
+        A_BITS   : integer := 8;     -- ROM のアドレスのビット数（2**A_BITS 語、8 以下）
+        ROM_FILE : string  := ""     -- ROM の初期化ファイル（"" なら SUM_PROG）
+    );
     port
     (
-        -- Fetch段用ステージクロック（clk_genが生成）
-        -- この立ち上がりで命令を読み出す。
-        CLK_FT   : in  std_logic;
+        -- ベースクロックと Fetch段のイネーブル（clk_genが生成）
+        -- CE_FT='1' の CLK の立ち上がりで命令を読み出す。
+        CLK      : in  std_logic;
+        CE_FT    : in  std_logic;
 
         -- プログラムカウンタ（PC）
         -- exec段で更新され、ここでPROMのアドレスとして使われる。
         P_COUNT  : in  std_logic_vector(7 downto 0);
 
-        -- 命令ROM（PROM）から読み出した命令ワード（15bit）
+        -- 命令ROM（PROM）から読み出した命令ワード（16bit）
         -- 次段（decode）へ渡す。
-        PROM_OUT : out std_logic_vector(14 downto 0)
+        PROM_OUT : out std_logic_vector(15 downto 0)
     );
 end fetch;
 
@@ -77,68 +97,139 @@ end fetch;
 architecture RTL of fetch is
 
     -- --------------------------------------------------------
-    -- 命令語の型（15bit固定長）
+    -- 命令語の型（16bit固定長）
     -- --------------------------------------------------------
-    subtype WORD is std_logic_vector(14 downto 0);
+    subtype WORD is std_logic_vector(15 downto 0);
 
     -- --------------------------------------------------------
-    -- PROMメモリ型：16語の命令ROM
+    -- PROMメモリ型：2**A_BITS 語の命令ROM
     -- --------------------------------------------------------
-    -- 0〜15 の16エントリだけ持つ超小型PROM。
-    type MEMORY is array (0 to 15) of WORD;
+    type MEMORY is array (0 to 2**A_BITS - 1) of WORD;
 
     -- --------------------------------------------------------
-    -- PROMの中身：固定プログラム
+    -- 既定のプログラム（ROM_FILE = "" のとき）
     -- --------------------------------------------------------
     -- CPU動作確認用のプログラム（1+2+...+10=55 の計算＋store＋halt）。
-    -- 末尾に nop 相当（全0）も入れている。
-    constant MEM : MEMORY :=
+    -- 15番地以降は nop 相当（全0）。
+    -- 各語は「オペコード（cpu15_isa の OP_xxx）& [10:8] & [7:0]」の連結で書く。
+    -- ビット列を直書きするとオペコード表の変更に追従できないため。
+    constant SUM_PROG : MEMORY :=
         (
-            "100100000000000",  -- 0: ldh Reg0, 0   （Reg0の上位8bitへ0をロード）
-            "100000000000000",  -- 1: ldl Reg0, 0   （Reg0の下位8bitへ0をロード）=> Reg0=0
-            "100100100000000",  -- 2: ldh Reg1, 0
-            "100000100000001",  -- 3: ldl Reg1, 1   => Reg1=1
-            "100101000000000",  -- 4: ldh Reg2, 0
-            "100001000000000",  -- 5: ldl Reg2, 0   => Reg2=0
-            "100101100000000",  -- 6: ldh Reg3, 0
-            "100001100001010",  -- 7: ldl Reg3, 10  => Reg3=10
-            "000101000100000",  -- 8: add Reg2, Reg1 （Reg2 = Reg2 + Reg1）
-            "000100001000000",  -- 9: add Reg0, Reg2 （Reg0 = Reg0 + Reg2）=> 総和蓄積
-            "111000001000000",  --10: st  Reg0, 64   （結果をRAM/I/Oの64番地へ保存）
-            "101001001100000",  --11: cmp Reg2, Reg3 （Reg2とReg3を比較してフラグ更新）
-            "101100000001110",  --12: je  14         （一致なら14番地へ）
-            "110000000001000",  --13: jmp 8          （無条件で8番地へ戻る）
-            "111100000000000",  --14: hlt            （停止）
-            "000000000000000"   --15: nop            （何もしない：保険/空き）
+            OP_LDH & "000" & X"00",  -- 0: ldh Reg0, 0   （Reg0の上位8bitへ0をロード）
+            OP_LDL & "000" & X"00",  -- 1: ldl Reg0, 0   （Reg0の下位8bitへ0をロード）=> Reg0=0
+            OP_LDH & "001" & X"00",  -- 2: ldh Reg1, 0
+            OP_LDL & "001" & X"01",  -- 3: ldl Reg1, 1   => Reg1=1
+            OP_LDH & "010" & X"00",  -- 4: ldh Reg2, 0
+            OP_LDL & "010" & X"00",  -- 5: ldl Reg2, 0   => Reg2=0
+            OP_LDH & "011" & X"00",  -- 6: ldh Reg3, 0
+            OP_LDL & "011" & X"0A",  -- 7: ldl Reg3, 10  => Reg3=10
+            OP_ADD & "010" & X"20",  -- 8: add Reg2, Reg1 （Reg2 = Reg2 + Reg1。[7:5]=Reg1）
+            OP_ADD & "000" & X"40",  -- 9: add Reg0, Reg2 （Reg0 = Reg0 + Reg2）=> 総和蓄積
+            OP_ST  & "000" & X"40",  --10: st  Reg0, 64   （結果をRAM/I/Oの64番地へ保存）
+            OP_CMP & "010" & X"60",  --11: cmp Reg2, Reg3 （Reg2とReg3を比較してフラグ更新）
+            OP_JE  & "000" & X"0E",  --12: je  14         （一致なら14番地へ）
+            OP_JMP & "000" & X"08",  --13: jmp 8          （無条件で8番地へ戻る）
+            OP_HLT & "000" & X"00",  --14: hlt            （停止）
+            others => OP_MOV & "000" & X"00"  -- nop（何もしない：空き。MOV Reg0, Reg0 と同じ）
         );
 
+    -- --------------------------------------------------------
+    -- ROM の初期化ファイルを読む（エラボレーション時に1回だけ呼ばれる）
+    -- --------------------------------------------------------
+    -- NAME が "" なら DEF を返す。形式はファイル先頭のコメントを参照。
+    impure function LOAD_ROM(NAME : string; DEF : MEMORY) return MEMORY is
+        file     F    : text;
+        variable STAT : file_open_status;
+        variable L    : line;
+        variable C    : character;
+        variable OK   : boolean;
+        variable D    : integer;
+        variable V    : integer;
+        variable N    : integer;
+        variable I    : integer := 0;
+        variable ROM  : MEMORY := (others => (others => '0'));
+    begin
+        if (NAME = "") then
+            return DEF;
+        end if;
+
+        file_open(STAT, F, NAME, read_mode);
+        assert STAT = open_ok report "fetch: cannot open ROM file " & NAME severity failure;
+
+        while not endfile(F) loop
+            readline(F, L);
+
+            -- 先頭の空白を飛ばす
+            C  := ' ';
+            OK := true;
+            while OK and (C = ' ' or C = HT) loop
+                read(L, C, OK);
+            end loop;
+
+            -- 16進でない文字（行末を含む）まで読んで1語にする
+            V := 0;
+            N := 0;
+            while OK loop
+                if (C >= '0' and C <= '9') then
+                    D := character'pos(C) - character'pos('0');
+                elsif (C >= 'a' and C <= 'f') then
+                    D := character'pos(C) - character'pos('a') + 10;
+                elsif (C >= 'A' and C <= 'F') then
+                    D := character'pos(C) - character'pos('A') + 10;
+                else
+                    exit;
+                end if;
+                V := (V * 16 + D) mod 65536;
+                N := N + 1;
+                read(L, C, OK);
+            end loop;
+
+            -- 16進の数字がなかった行（空行・コメント行）は読み飛ばす
+            if (N > 0) then
+                assert I <= MEMORY'high
+                    report "fetch: " & NAME & " is longer than the ROM" severity failure;
+                ROM(I) := conv_std_logic_vector(V, 16);
+                I := I + 1;
+            end if;
+        end loop;
+
+        file_close(F);
+        return ROM;
+    end LOAD_ROM;
+
+    -- --------------------------------------------------------
+    -- PROMの中身
+    -- --------------------------------------------------------
+    constant MEM : MEMORY := LOAD_ROM(ROM_FILE, SUM_PROG);
+
 begin
 
     -- ========================================================
     -- PROM読み出し（Fetch段）
     -- ========================================================
-    -- CLK_FTの立ち上がりで、PCが指す命令をPROM_OUTへ出す。
+    -- CE_FT='1' の CLK の立ち上がりで、PCが指す命令をPROM_OUTへ出す。
     -- ここで出した命令が次のDecode段で解釈されるため、
     -- フェッチ段は “命令ストリームの正しさ” を保証する根幹になる。
-    process(CLK_FT)
+    process(CLK)
     begin
-        if (CLK_FT'event and CLK_FT = '1') then
+        if (CLK'event and CLK = '1') then
+            if (CE_FT = '1') then
 
-            -- ------------------------------------------------
-            -- アドレス選択：PC下位4bitでPROMを参照
-            -- ------------------------------------------------
-            -- MEMが16語なので 0〜15 の範囲に収めるために (3 downto 0) だけ使う。
-            -- conv_integer で integer に変換して配列インデックスにする。
-            --
-            -- 注意：P_COUNTが 0x10,0x20... などでも下位4bitに折り返す。
-            PROM_OUT <= MEM(conv_integer(P_COUNT(3 downto 0)));
+                -- ------------------------------------------------
+                -- アドレス選択：PC下位 A_BITS ビットでPROMを参照
+                -- ------------------------------------------------
+                -- 既定（A_BITS=8）では P_COUNT 全体を使うので折り返さない。
+                -- A_BITS を小さくしたときだけ 2**A_BITS 語で折り返す。
+                -- conv_integer で integer に変換して配列インデックスにする。
+                PROM_OUT <= MEM(conv_integer(P_COUNT(A_BITS - 1 downto 0)));
 
+            end if;
         end if;
     end process;
 
 end RTL;
 
 -- 【CPU拡張の観点】
--- - 命令数を増やすなら MEMORY のサイズを増やし、P_COUNT全体で参照する。
--- - 分岐やジャンプの正しさを検証するには、PROMに複数パターンのプログラムを入れ替えられる仕組み
---   （別ファイル化/初期化ファイル読み込みなど）があると便利になる。
+-- - PC を 8bit より広げるときは P_COUNT の幅と A_BITS を合わせて広げる。
+-- - 分岐やジャンプの正しさを検証するときは、ROM_FILE でプログラムを入れ替える
+--   （generic map で ROM_FILE => "xxx.hex" を渡すか、シミュレータの -g オプションで上書きする）。
@@ -0,0 +1,221 @@
+-- fetch_pq.vhd（詳細コメント版：先読みキューと静的分岐予測つきのフェッチ段）
+--
+-- 【このモジュールの目的】
+-- - パイプライン版（cpu15_pipe.vhd）の IF 段。fetch.vhd（命令ROM）を中に持ち、
+--   その前後に次の2つを足したもの。
+--     1) 静的分岐予測（BTFN：後ろ向きは成立、前向きは不成立と予測）
+--     2) 2語の先読みキュー（プリフェッチバッファ）
+-- - 4相版の cpu15.vhd は fetch.vhd をそのまま使い続ける（本モジュールは使わない）。
+--
+-- 【なぜ予測がいるのか】
+-- - 命令を重ねて流すと、IF は分岐命令の結果が出る前に次の番地を読まなければならない。
+--   常に「次の番地」を読むと、成立する分岐のたびに EX で取り消し（フラッシュ）が起きる。
+-- - このCPUのプログラムは
+--     ・ループの戻り（JMP / 後ろ向きの JE・JCC）… ほぼ毎回成立
+--     ・ループの出口や if の飛び越し（前向きの JE・JCC）… たいてい不成立
+--   という形がほとんどなので、分岐先が自分より前か後ろかだけで十分当たる。
+-- - 分岐先は命令語の [7:0] に入っているので、ROM から出てきた時点（PROM_OUT）で
+--   プリデコードして次の読み出し番地を決められる。予測が当たれば損失は0サイクル。
+--
+-- 【予測の規則】
+--     JMP              : 常に成立（分岐先へ）
+--     JE / JCC         : 分岐先 <= 自分の番地（後ろ向き）なら成立、前向きなら不成立
+--     それ以外          : 分岐しない（次の番地）
+-- - 予測結果は命令と一緒に INSN_PRED として後段へ渡す。
+--   EX で実際の成否と違えば、EX が REDIRECT / REDIRECT_PC で正しい番地から読み直させる。
+--
+-- 【先読みキュー】
+-- - ROM は1サイクルで1語読めるので、後段が止まらなければキューは空のまま
+--   （PROM_OUT をそのまま INSN に出す＝キューを通らないので段数は増えない）。
+-- - 後段が止まったとき（TAKE='0'：除算のストール中など）も ROM は読み進め、
+--   出てきた語を最大2語までキューにためる。キューが満杯で PROM_OUT も受け取れないときだけ
+--   同じ番地を読み直して PROM_OUT を保持する（ROM は定数なので読み直しても同じ語）。
+-- - キューが空でないときは先頭（Q0）を INSN に出す。REDIRECT が来たらキューは捨てる。
+--
+-- 【ポート】
+--   TAKE        : 後段（ID）がこのエッジで INSN を受け取る
+--   REDIRECT    : 予測が外れた（EX から）。REDIRECT_PC から読み直す
+--   INSN        : 後段に渡す命令語
+--   INSN_PC     : その命令の番地
+--   INSN_V      : INSN が有効か
+--   INSN_PRED   : その命令を「成立」と予測して分岐先を読んだか
+--
+-- 【ROM の中身（generic ROM_FILE）】
+-- - 中の fetch にそのまま渡す（A_BITS=8 の 256語）。"" なら fetch.vhd の SUM_PROG、
+--   ファイル名なら chapter03 のエミュレータ（CPU_emulator -o）が書き出したイメージを読む。
+--
+-- 【chapter09 の fetch_rom について】
+-- - fetch_rom（Quartus のROM）も「クロックの立ち上がりで address の語を q に出す」1サイクルROMなので、
+--   中の fetch を fetch_rom に置き換えれば同じ形で使える。
+
+
+library IEEE;
+use IEEE.std_logic_1164.all;
+use IEEE.std_logic_unsigned.all;
+use work.cpu15_isa.all;
+
+entity fetch_pq is
+    generic
+    (
+        ROM_FILE    : string := ""    -- 命令ROM の初期化ファイル（"" なら SUM_PROG）
+    );
+    port
+    (
+        CLK         : in  std_logic;
+        RESET_N     : in  std_logic;
+
+        TAKE        : in  std_logic;
+        REDIRECT    : in  std_logic;
+        REDIRECT_PC : in  std_logic_vector(7 downto 0);
+
+        INSN        : out std_logic_vector(15 downto 0);
+        INSN_PC     : out std_logic_vector(7 downto 0);
+        INSN_V      : out std_logic;
+        INSN_PRED   : out std_logic
+    );
+end fetch_pq;
+
+architecture RTL of fetch_pq is
+
+    component fetch
+        generic
+        (
+            A_BITS   : integer;
+            ROM_FILE : string
+        );
+        port
+        (
+            CLK      : in  std_logic;
+            CE_FT    : in  std_logic;
+            P_COUNT  : in  std_logic_vector(7 downto 0);
+            PROM_OUT : out std_logic_vector(15 downto 0)
+        );
+    end component;
+
+    -- ROM の読み出し
+    signal RD_PC    : std_logic_vector(7 downto 0);    -- このエッジで読む番地
+    signal PROM_OUT : std_logic_vector(15 downto 0);   -- 読み出した語
+    signal F_PC     : std_logic_vector(7 downto 0) := "00000000";  -- PROM_OUT の番地
+    signal F_V      : std_logic := '0';                            -- PROM_OUT が有効か
+
+    -- プリデコードと予測
+    signal F_OP     : std_logic_vector(4 downto 0);
+    signal F_P      : std_logic;                       -- 成立と予測
+    signal F_NEXT   : std_logic_vector(7 downto 0);    -- 予測した次の番地
+    signal F_ACC    : std_logic;                       -- PROM_OUT がこのエッジで出ていける
+
+    -- 先読みキュー（Q0 が先頭）
+    signal QCNT     : std_logic_vector(1 downto 0) := "00";
+    signal Q0_W     : std_logic_vector(15 downto 0);
+    signal Q0_PC    : std_logic_vector(7 downto 0);
+    signal Q0_P     : std_logic;
+    signal Q1_W     : std_logic_vector(15 downto 0);
+    signal Q1_PC    : std_logic_vector(7 downto 0);
+    signal Q1_P     : std_logic;
+
+begin
+
+    -- ========================================================
+    -- プリデコード：BTFN 予測
+    -- ========================================================
+    F_OP   <= PROM_OUT(15 downto 11);
+    F_P    <= '1' when F_V = '1' and
+                       (F_OP = OP_JMP or
+                        ((F_OP = OP_JE or F_OP = OP_JCC) and PROM_OUT(7 downto 0) <= F_PC)) else '0';
+    F_NEXT <= PROM_OUT(7 downto 0) when F_P = '1' else
+              F_PC                 when F_V = '0' else     -- リセット直後：F_PC（0番地）から読み始める
+              F_PC + 1;
+
+    -- キューが満杯で後段も受け取らないときだけ PROM_OUT を保持する
+    F_ACC  <= '0' when TAKE = '0' and QCNT = "10" and F_V = '1' else '1';
+
+    RD_PC  <= REDIRECT_PC when REDIRECT = '1' else
+              F_NEXT      when F_ACC = '1'    else
+              F_PC;
+
+    F1 : fetch generic map(
+        A_BITS   => 8,
+        ROM_FILE => ROM_FILE
+    ) port map(
+        CLK      => CLK,
+        CE_FT    => '1',             -- 毎サイクル読む
+        P_COUNT  => RD_PC,
+        PROM_OUT => PROM_OUT
+    );
+
+    -- ========================================================
+    -- 後段への出力：キューが空なら PROM_OUT を素通し
+    -- ========================================================
+    INSN      <= Q0_W  when QCNT /= "00" else PROM_OUT;
+    INSN_PC   <= Q0_PC when QCNT /= "00" else F_PC;
+    INSN_V    <= '1'   when QCNT /= "00" else F_V;
+    INSN_PRED <= Q0_P  when QCNT /= "00" else F_P;
+
+    -- ========================================================
+    -- キューと読み出し番地の更新
+    -- ========================================================
+    process(CLK)
+    begin
+        if (CLK'event and CLK = '1') then
+            if (RESET_N = '0') then
+                F_PC <= "00000000";
+                F_V  <= '0';
+                QCNT <= "00";
+
+            elsif (REDIRECT = '1') then
+                -- 予測外れ：先読みした語はすべて捨て、正しい番地から読み直す
+                F_PC <= REDIRECT_PC;
+                F_V  <= '1';
+                QCNT <= "00";
+
+            else
+                if (TAKE = '1') then
+                    -- 先頭が出ていく。PROM_OUT はキューの後ろへ（キューが空なら素通しで出ていった）
+                    case QCNT is
+                        when "01" =>
+                            Q0_W  <= PROM_OUT;
+                            Q0_PC <= F_PC;
+                            Q0_P  <= F_P;
+                            if (F_V = '0') then
+                                QCNT <= "00";
+                            end if;
+                        when "10" =>
+                            Q0_W  <= Q1_W;
+                            Q0_PC <= Q1_PC;
+                            Q0_P  <= Q1_P;
+                            Q1_W  <= PROM_OUT;
+                            Q1_PC <= F_PC;
+                            Q1_P  <= F_P;
+                            if (F_V = '0') then
+                                QCNT <= "01";
+                            end if;
+                        when others =>
+                            null;
+                    end case;
+                elsif (F_V = '1') then
+                    -- 後段が止まっている：空きがあれば PROM_OUT をためる
+                    case QCNT is
+                        when "00" =>
+                            Q0_W  <= PROM_OUT;
+                            Q0_PC <= F_PC;
+                            Q0_P  <= F_P;
+                            QCNT  <= "01";
+                        when "01" =>
+                            Q1_W  <= PROM_OUT;
+                            Q1_PC <= F_PC;
+                            Q1_P  <= F_P;
+                            QCNT  <= "10";
+                        when others =>
+                            null;
+                    end case;
+                end if;
+
+                if (F_ACC = '1') then
+                    F_PC <= F_NEXT;
+                    F_V  <= '1';
+                end if;
+            end if;
+        end if;
+    end process;
+
+end RTL;
@@ -0,0 +1,171 @@
+-- reg_file.vhd（詳細コメント版：RAM 推論型レジスタファイル / 同期読み出し2ポート＋非同期読み出し2ポート＋書き込み1ポート）
+--
+-- 【このモジュールの目的】
+-- - 旧 reg_dc（読み出し）×2 と旧 reg_wb（書き込み）をまとめて置き換えるレジスタファイル。
+-- - 従来の構成は「REG_0〜REG_7 を独立した16bitレジスタで持ち、旧 reg_dc ごとに 16bit の 8:1 MUX で選ぶ」
+--   形だった。8本×16bit がすべて配線としてトップを通り、読み出しポートごとに MUX が並ぶので
+--   LUT を多く使い、MUX の段数が Fmax を押さえる。レジスタを 16本・32本に増やすと入力ポートも増える。
+-- - ここではレジスタを配列 RF に入れ、「番号で添字して読む / 書く」形で書く。
+--   合成ツールはこの形を RAM として推論するので、FPGA の分散RAM（LUTRAM）や
+--   ブロックRAM に割り当てられ、MUX は RAM の中のデコーダに置き換わる。
+--
+-- 【ポートの構成】
+--   読み出しA : N_REG_A_IN 番を CE_DC のエッジで読む（REG_A）。番号も N_REG_A としてラッチして出す
+--   読み出しB : N_REG_B_IN 番を CE_DC のエッジで読む（REG_B）。番号も N_REG_B としてラッチして出す
+--   読み出しC : N_REG_C 番を非同期に読む（REG_C）。chapter09 の間接アドレス（IND_ADDR）と
+--               ブロック転送の語数（BLK_N）用。使わないトップでは open にする
+--   読み出しD : N_REG_D 番を非同期に読む（REG_D）。パイプライン版（cpu15_pipe）が C と組で
+--               ID 段の2つの読み出しに使う。使わないトップではつながなくてよい（番号の既定は 0）
+--   書き込み  : N_REG_W 番へ REG_IN を CE_WB のエッジで書く（REG_WEN='1' のとき）
+-- - どのポートも CLK の立ち上がりで動き、CE_DC / CE_WB が '1' のエッジだけ更新する（単一クロックドメイン）。
+-- - 読み出しA/B は旧 reg_dc と同じく DC のエッジでラッチするので、exec から見たタイミングは変わらない。
+--   出力レジスタ付きの同期読み出しなので、ブロックRAM（2ポート読み＋1ポート書き）に収まる。
+-- - 読み出しC/D は非同期なので、これを使うトップでは RF 全体が分散RAMになる
+--   （8×16bit 程度ならブロックRAMより分散RAMのほうが小さい）。
+-- - cpu15_pipe は毎サイクル ID で読み、同じエッジで WB が書く。非同期読み出しは書く前の値を出すが、
+--   その差し替え（書き込みスルー）はトップの ID_A / ID_B が受け持つので、ここは RAM のままでよい。
+--
+-- 【書き込みポートが1本であること】
+-- - RAM の書き込みポートは1本なので、旧 reg_wb にあった2本目の書き込みポート
+--   （LDR/STR のポストインクリメント用 N_REG_B/REG_IN_B/REG_WEN_B）は持たない。
+--   トップで REG_WEN_B='1' のときだけ N_REG_B / REG_IN_B を選んで書き込みポートへつなぐ。
+-- - exec は REG_WEN と REG_WEN_B を同じ EX で同時に立てない
+--   （LDR のポストインクリメントは2回の EX に分けて書く。exec.vhd の LDR_PHASE）。
+--
+-- 【リセット（全レジスタ 0）】
+-- - 旧 reg_wb は RESET_N='0' で REG_0〜REG_7 を 0 にしていた。RAM は1サイクルで全語を消せないので、
+--   ここでは語ごとの有効ビット VALID（2**N_BITS 本のフリップフロップ）を RESET_N で 0 にし、
+--   書き込んだ番号だけ '1' にする。VALID='0' の番号を読むと 0 を返すので、
+--   プログラムから見えるふるまいは旧 reg_wb の全クリアと同じになる。
+-- - リセット中（RESET_N='0'）は旧 reg_wb と同じく書き込まない。
+--
+-- 【レジスタ数の拡張】
+-- - generic N_BITS がレジスタ番号のビット数で、レジスタは 2**N_BITS 本（既定 3 → 8本）。
+--   N_BITS=4 で16本、5 で32本になる。命令語のレジスタフィールドは3bitなので、
+--   増やすときは命令フォーマット（cpu15_isa.vhd）とトップの番号の切り出しも合わせて広げること。
+
+
+library IEEE;
+use IEEE.std_logic_1164.all;
+use IEEE.std_logic_unsigned.all;
+
+-- ============================================================
+-- entity: レジスタファイル（2**N_BITS 本 × 16bit）
+-- ============================================================
+entity reg_file is
+    generic
+    (
+        N_BITS     : integer := 3      -- レジスタ番号のビット数（2**N_BITS 本）
+    );
+    port
+    (
+        CLK        : in  std_logic;
+        CE_DC      : in  std_logic;    -- 読み出しA/B のイネーブル
+        CE_WB      : in  std_logic;    -- 書き込みのイネーブル
+        RESET_N    : in  std_logic;
+
+        -- 読み出しA/B（CE_DC のエッジでラッチ）
+        N_REG_A_IN : in  std_logic_vector(N_BITS - 1 downto 0);
+        N_REG_B_IN : in  std_logic_vector(N_BITS - 1 downto 0);
+        N_REG_A    : out std_logic_vector(N_BITS - 1 downto 0);
+        N_REG_B    : out std_logic_vector(N_BITS - 1 downto 0);
+        REG_A      : out std_logic_vector(15 downto 0);
+        REG_B      : out std_logic_vector(15 downto 0);
+
+        -- 読み出しC（非同期）
+        N_REG_C    : in  std_logic_vector(N_BITS - 1 downto 0);
+        REG_C      : out std_logic_vector(15 downto 0);
+
+        -- 読み出しD（非同期。cpu15_pipe 用）
+        N_REG_D    : in  std_logic_vector(N_BITS - 1 downto 0) := (others => '0');
+        REG_D      : out std_logic_vector(15 downto 0);
+
+        -- 書き込み（CE_WB のエッジ）
+        N_REG_W    : in  std_logic_vector(N_BITS - 1 downto 0);
+        REG_IN     : in  std_logic_vector(15 downto 0);
+        REG_WEN    : in  std_logic
+    );
+end reg_file;
+
+-- ============================================================
+-- architecture RTL: 配列 RF を添字で読み書きする（RAM として推論される形）
+-- ============================================================
+architecture RTL of reg_file is
+
+    type REGS is array (0 to 2**N_BITS - 1) of std_logic_vector(15 downto 0);
+
+    -- RAM 本体（リセットしない：リセットを付けると RAM ではなくフリップフロップになる）
+    signal RF      : REGS := (others => (others => '0'));
+
+    -- 書き込み済みの番号（RESET_N で 0 に戻す）
+    signal VALID   : std_logic_vector(2**N_BITS - 1 downto 0) := (others => '0');
+
+    -- 同期読み出しの出力レジスタと、そのときの VALID
+    signal RD_A    : std_logic_vector(15 downto 0);
+    signal RD_B    : std_logic_vector(15 downto 0);
+    signal V_A     : std_logic := '0';
+    signal V_B     : std_logic := '0';
+
+begin
+
+    -- ========================================================
+    -- 書き込み（CE_WB）：RAM の書き込みポート
+    -- ========================================================
+    process(CLK)
+    begin
+        if (CLK'event and CLK = '1') then
+            if (CE_WB = '1') then
+                if (RESET_N = '1' and REG_WEN = '1') then
+                    RF(conv_integer(N_REG_W)) <= REG_IN;
+                end if;
+            end if;
+        end if;
+    end process;
+
+    process(CLK)
+    begin
+        if (CLK'event and CLK = '1') then
+            if (CE_WB = '1') then
+                if (RESET_N = '0') then
+                    VALID <= (others => '0');
+                elsif (REG_WEN = '1') then
+                    VALID(conv_integer(N_REG_W)) <= '1';
+                end if;
+            end if;
+        end if;
+    end process;
+
+    -- ========================================================
+    -- 読み出しA/B（CE_DC）：旧 reg_dc と同じタイミングでラッチ
+    -- ========================================================
+    process(CLK)
+    begin
+        if (CLK'event and CLK = '1') then
+            if (CE_DC = '1') then
+                RD_A    <= RF(conv_integer(N_REG_A_IN));
+                RD_B    <= RF(conv_integer(N_REG_B_IN));
+                V_A     <= VALID(conv_integer(N_REG_A_IN));
+                V_B     <= VALID(conv_integer(N_REG_B_IN));
+                N_REG_A <= N_REG_A_IN;
+                N_REG_B <= N_REG_B_IN;
+            end if;
+        end if;
+    end process;
+
+    -- 未書き込みの番号は 0（RAM の出力レジスタの後ろで AND するだけ）
+    REG_A <= RD_A when V_A = '1' else "0000000000000000";
+    REG_B <= RD_B when V_B = '1' else "0000000000000000";
+
+    -- ========================================================
+    -- 読み出しC（非同期）：分散RAM の読み出しポート
+    -- ========================================================
+    REG_C <= RF(conv_integer(N_REG_C)) when VALID(conv_integer(N_REG_C)) = '1' else "0000000000000000";
+    REG_D <= RF(conv_integer(N_REG_D)) when VALID(conv_integer(N_REG_D)) = '1' else "0000000000000000";
+
+end RTL;
+
+-- 【検証の観点】
+-- - リセット直後にどの番号を読んでも 0 になること（VALID のクリア）。
+-- - 同じ番号への書き込みと読み出しが同じ命令の中で重ならないこと
+--   （段イネーブルが FT→DC→EX→WB の順なので、DC で読む値は1つ前の命令の WB が書いた値）。
+-- - 合成レポートで RF が RAM（分散RAM またはブロックRAM）として推論されていること。
@@ -0,0 +1,557 @@
+/*
+  vhdl2c.c（VHDL 合成サブセット → サイクルベース C モデルへの変換器）
+
+  【このプログラムの位置づけ】
+  - cpu15_model.c は chapter06 の cpu15 を“手で”C に書き直したモデルである。
+    速いが、RTL を直すたびに C 側も手で追従させる必要があり、食い違いの元になる。
+  - 本プログラムは RTL（.vhd）を直接読み、同じ考え方の C モデルを自動生成する。
+      vhdl_front.c : 字句解析・構文解析・階層展開（IR を作る）
+      vhdl2c.c     : IR から C ソースを出力する（本ファイル）
+
+  【生成されるコードの実行モデル（VHDL のデルタサイクルの再現）】
+  - 1回の「デルタ」で、
+      (1) 直前のデルタで 0→1 に変化したクロックを検出し、
+      (2) 組合せプロセスすべてと、エッジが立ったクロック同期プロセスを
+          “現在値を読み、次値 n_X に書く”2相方式で評価し、
+      (3) 最後に次値を一括コミットする。
+  - 信号が1本も変化しなくなるまでデルタを繰り返す（T_eval）。
+    レジスタ出力がクロックになる回路（段クロックを配っていたころの clk_gen など）でも、
+    CLK ↑ → (デルタ1) 派生クロックが変化 → (デルタ2) そのクロックのプロセス、という
+    GHDL と同じ順序で評価されるので、CLK エッジごとの値は RTL シミュレーションと一致する。
+  - std_logic は 2値（0/1）で扱い、'U' は 0 とみなす（cpu15_model.c と同じ前提）。
+
+  【使い方】
+    vhdl2c [-m] [-o out.c] [-c CLK] [-i NAME=V0,E1,V1,...] [-p NAME[:x]]... TOP file.vhd...
+
+      TOP        : トップ entity 名
+      -o out.c   : 出力先（省略時は標準出力）
+      -m         : テスト用の main() も生成する（以下はその設定）
+      -c CLK     : 駆動するクロック入力（既定：CLK）。main は立ち上がりを1エッジと数える
+      -i ...     : 入力の刺激。エッジ0 から V0、エッジ E1 から V1 ...（既定：RESET_N=0,5,1）
+      -p NAME    : エッジごとに表示する信号（階層名 C7__PC など。:x を付けると16進）
+                   省略時はトップの出力ポートを表示する
+
+  生成した main の引数：
+      (なし)     : 400 エッジ分のトレースを表示
+      N          : N エッジ分のトレースを表示
+      -q N       : トレースなしで N エッジ実行し、速度と最終的な出力を表示
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "vhdl_front.h"
+
+static struct vf_design *d;
+static FILE *out;
+static const char *T;           // 生成するモデルの名前（トップ entity 名）
+static int nsite;               // 配列書き込みの代入箇所の通し番号
+
+static const char *ctype(int w, int is_int) {
+    if (is_int) return "uint32_t";
+    if (w <= 8) return "uint8_t";
+    if (w <= 16) return "uint16_t";
+    if (w <= 32) return "uint32_t";
+    return "uint64_t";
+}
+
+static uint64_t wmask(const struct vf_rx *r) {
+    return vf_mask(r->is_int ? 32 : r->w);
+}
+
+static void indent(int n) {
+    while (n-- > 0) fputs("    ", out);
+}
+
+/* 式は常に uint64_t の値として出力する（各ノードの値はビット幅でマスク済み） */
+static void ex(const struct vf_rx *r) {
+    static const char *cop[] = {
+        [OP_AND] = "&", [OP_OR] = "|", [OP_XOR] = "^",
+        [OP_EQ] = "==", [OP_NE] = "!=", [OP_LT] = "<", [OP_LE] = "<=",
+        [OP_GT] = ">", [OP_GE] = ">=",
+        [OP_ADD] = "+", [OP_SUB] = "-", [OP_MUL] = "*"
+    };
+
+    switch (r->k) {
+    case RX_CONST:
+        fprintf(out, "0x%llxull", (unsigned long long)r->val);
+        return;
+    case RX_SIG:
+        fprintf(out, "(uint64_t)s->%s", d->sigs[r->sig].name);
+        return;
+    case RX_ELEM:
+        fprintf(out, "%s_rd_%s(s, ", T, d->sigs[r->sig].name);
+        ex(r->a);
+        fputs(")", out);
+        return;
+    case RX_CARR:
+        fprintf(out, "%s_rom_%s(", T, d->carrs[r->sig].name);
+        ex(r->a);
+        fputs(")", out);
+        return;
+    case RX_SLICE:
+        fputs("((", out);
+        ex(r->a);
+        fprintf(out, " >> %d) & 0x%llxull)", r->lo, (unsigned long long)vf_mask(r->w));
+        return;
+    case RX_BIT:
+        fprintf(out, "%s_bit(", T);
+        ex(r->a);
+        fputs(", ", out);
+        ex(r->b);
+        fputs(")", out);
+        return;
+    case RX_CAT:
+        fputs("((", out);
+        ex(r->a);
+        fprintf(out, " << %d) | ", r->b->w);
+        ex(r->b);
+        fputs(")", out);
+        return;
+    case RX_NOT:
+        fputs("(~", out);
+        ex(r->a);
+        fprintf(out, " & 0x%llxull)", (unsigned long long)vf_mask(r->w));
+        return;
+    case RX_MUX:
+        fputs("(", out);
+        ex(r->c);
+        fputs(" ? ", out);
+        ex(r->a);
+        fputs(" : ", out);
+        ex(r->b);
+        fputs(")", out);
+        return;
+    }
+
+    /* RX_BIN */
+    switch (r->op) {
+    case OP_AND: case OP_OR: case OP_XOR:
+        fputs("(", out);
+        ex(r->a);
+        fprintf(out, " %s ", cop[r->op]);
+        ex(r->b);
+        fputs(")", out);
+        return;
+    case OP_NAND: case OP_NOR: case OP_XNOR:
+        fputs("(~(", out);
+        ex(r->a);
+        fprintf(out, " %s ", r->op == OP_NAND ? "&" : r->op == OP_NOR ? "|" : "^");
+        ex(r->b);
+        fprintf(out, ") & 0x%llxull)", (unsigned long long)vf_mask(r->w));
+        return;
+    case OP_EQ: case OP_NE: case OP_LT: case OP_LE: case OP_GT: case OP_GE:
+        fputs("(uint64_t)(", out);
+        ex(r->a);
+        fprintf(out, " %s ", cop[r->op]);
+        ex(r->b);
+        fputs(")", out);
+        return;
+    case OP_ADD: case OP_SUB: case OP_MUL:
+        fputs("((", out);
+        ex(r->a);
+        fprintf(out, " %s ", cop[r->op]);
+        ex(r->b);
+        fprintf(out, ") & 0x%llxull)", (unsigned long long)wmask(r));
+        return;
+    case OP_DIV: case OP_MOD:
+        fprintf(out, "%s_%s(", T, r->op == OP_DIV ? "div" : "mod");
+        ex(r->a);
+        fputs(", ", out);
+        ex(r->b);
+        fputs(")", out);
+        return;
+    }
+    vf_fatal("internal: operator %d", r->op);
+}
+
+static void stmts(const struct vf_rs *rs, int ind);
+
+static void assign(const struct vf_rs *rs, int ind) {
+    const struct vf_sig *s = &d->sigs[rs->sig];
+    unsigned long long m;
+
+    indent(ind);
+    if (s->len) {
+        int n = nsite++;
+        fprintf(out, "w%d = 1; wi%d = ", n, n);
+        ex(rs->idx);
+        fprintf(out, "; wv%d = ", n);
+        ex(rs->val);
+        fputs(";\n", out);
+        return;
+    }
+    if (rs->w == 0) {
+        fprintf(out, "n_%s = (%s)(", s->name, ctype(s->w, s->is_int));
+        ex(rs->val);
+        fputs(");\n", out);
+        return;
+    }
+    m = (unsigned long long)vf_mask(rs->w);
+    if (rs->idx == NULL) {
+        fprintf(out, "n_%s = (%s)((n_%s & ~(0x%llxull << %d)) | ((", s->name, ctype(s->w, 0), s->name, m, rs->lo);
+        ex(rs->val);
+        fprintf(out, ") << %d));\n", rs->lo);
+        return;
+    }
+    fputs("{\n", out);
+    indent(ind + 1);
+    fputs("uint64_t i_ = ", out);
+    ex(rs->idx);
+    fputs(";\n", out);
+    indent(ind + 1);
+    fprintf(out, "if (i_ < %d) n_%s = (%s)((n_%s & ~(1ull << i_)) | ((", s->w, s->name, ctype(s->w, 0), s->name);
+    ex(rs->val);
+    fputs(") << i_));\n", out);
+    indent(ind);
+    fputs("}\n", out);
+}
+
+static void stmt(const struct vf_rs *rs, int ind) {
+    const struct vf_arm *a;
+    int i, has_others = 0;
+
+    switch (rs->k) {
+    case RS_ASSIGN:
+        assign(rs, ind);
+        return;
+    case RS_IF:
+        indent(ind);
+        fputs("if (", out);
+        ex(rs->cond);
+        fputs(") {\n", out);
+        stmts(rs->then_s, ind + 1);
+        while (rs->else_s && rs->else_s->k == RS_IF && rs->else_s->next == NULL) {
+            rs = rs->else_s;
+            indent(ind);
+            fputs("} else if (", out);
+            ex(rs->cond);
+            fputs(") {\n", out);
+            stmts(rs->then_s, ind + 1);
+        }
+        if (rs->else_s) {
+            indent(ind);
+            fputs("} else {\n", out);
+            stmts(rs->else_s, ind + 1);
+        }
+        indent(ind);
+        fputs("}\n", out);
+        return;
+    case RS_CASE:
+        indent(ind);
+        fputs("switch (", out);
+        ex(rs->sel);
+        fputs(") {\n", out);
+        for (a = rs->arms; a; a = a->next) {
+            for (i = 0; i < a->nch; i++) {
+                indent(ind);
+                fprintf(out, "case 0x%llxull:\n", (unsigned long long)a->ch[i]);
+            }
+            if (a->others) {
+                indent(ind);
+                fputs("default:\n", out);
+                has_others = 1;
+            }
+            stmts(a->body, ind + 1);
+            indent(ind + 1);
+            fputs("break;\n", out);
+        }
+        if (!has_others) {
+            indent(ind);
+            fputs("default:\n", out);
+            indent(ind + 1);
+            fputs("break;\n", out);
+        }
+        indent(ind);
+        fputs("}\n", out);
+        return;
+    }
+}
+
+static void stmts(const struct vf_rs *rs, int ind) {
+    for (; rs; rs = rs->next) stmt(rs, ind);
+}
+
+/* 配列書き込みの代入箇所を数える（デルタ関数の先頭で一時変数を宣言するため） */
+static int count_sites(const struct vf_rs *rs) {
+    const struct vf_arm *a;
+    int n = 0;
+    for (; rs; rs = rs->next) {
+        if (rs->k == RS_ASSIGN && d->sigs[rs->sig].len) n++;
+        if (rs->k == RS_IF) n += count_sites(rs->then_s) + count_sites(rs->else_s);
+        if (rs->k == RS_CASE)
+            for (a = rs->arms; a; a = a->next) n += count_sites(a->body);
+    }
+    return n;
+}
+
+/* 配列書き込み箇所と書き込み先の信号を対応付ける */
+static void site_sigs(const struct vf_rs *rs, int *map, int *n) {
+    const struct vf_arm *a;
+    for (; rs; rs = rs->next) {
+        if (rs->k == RS_ASSIGN && d->sigs[rs->sig].len) map[(*n)++] = rs->sig;
+        if (rs->k == RS_IF) {
+            site_sigs(rs->then_s, map, n);
+            site_sigs(rs->else_s, map, n);
+        }
+        if (rs->k == RS_CASE)
+            for (a = rs->arms; a; a = a->next) site_sigs(a->body, map, n);
+    }
+}
+
+static void emit_model(void) {
+    int i, j, nsites = 0, *site_map;
+
+    for (i = 0; i < d->nproc; i++) nsites += count_sites(d->procs[i].body);
+    site_map = vf_alloc(sizeof(int) * (size_t)(nsites + 1));
+    j = 0;
+    for (i = 0; i < d->nproc; i++) site_sigs(d->procs[i].body, site_map, &j);
+
+    fprintf(out, "/* vhdl2c が %s から生成したサイクルベース C モデル（手で編集しないこと） */\n\n", T);
+    fputs("#include <stdint.h>\n#include <stdio.h>\n#include <stdlib.h>\n#include <string.h>\n\n", out);
+
+    /* 状態 */
+    fprintf(out, "struct %s {\n", T);
+    for (i = 0; i < d->nsig; i++) {
+        const struct vf_sig *s = &d->sigs[i];
+        fprintf(out, "    %s %s", ctype(s->w, s->is_int), s->name);
+        if (s->len) fprintf(out, "[%d]", s->len);
+        fprintf(out, ";%s\n", s->dir == VF_IN ? "  /* in */" : s->dir == VF_OUT ? "  /* out */" : "");
+    }
+    for (i = 0; i < d->nsig; i++)
+        if (d->sigs[i].is_clock) fprintf(out, "    uint8_t prev__%s;\n", d->sigs[i].name);
+    fputs("};\n\n", out);
+
+    /* 補助関数 */
+    fprintf(out, "static inline uint64_t %s_bit(uint64_t v, uint64_t i) { return i < 64 ? (v >> i) & 1 : 0; }\n", T);
+    fprintf(out, "static inline uint64_t %s_div(uint64_t a, uint64_t b) { return b ? a / b : 0; }\n", T);
+    fprintf(out, "static inline uint64_t %s_mod(uint64_t a, uint64_t b) { return b ? a %% b : 0; }\n", T);
+    for (i = 0; i < d->nsig; i++) {
+        const struct vf_sig *s = &d->sigs[i];
+        if (!s->len) continue;
+        fprintf(out, "static inline uint64_t %s_rd_%s(const struct %s *s, uint64_t i) "
+                     "{ return i - %d < %d ? s->%s[i - %d] : 0; }\n",
+                T, s->name, T, s->alo, s->len, s->name, s->alo);
+    }
+    for (i = 0; i < d->ncarr; i++) {
+        const struct vf_carr *c = &d->carrs[i];
+        fprintf(out, "static const %s %s_%s[%d] = {", ctype(c->w, 0), T, c->name, c->len);
+        for (j = 0; j < c->len; j++)
+            fprintf(out, "%s0x%llx", j % 8 ? ", " : (j ? ",\n    " : "\n    "), (unsigned long long)c->v[j]);
+        fputs("\n};\n", out);
+        fprintf(out, "static inline uint64_t %s_rom_%s(uint64_t i) { return i - %d < %d ? %s_%s[i - %d] : 0; }\n",
+                T, c->name, c->alo, c->len, T, c->name, c->alo);
+    }
+    fputs("\n", out);
+
+    /* 1デルタ */
+    fprintf(out, "static int %s_delta(struct %s *s) {\n", T, T);
+    for (i = 0; i < d->nsig; i++)
+        if (d->sigs[i].is_clock)
+            fprintf(out, "    int e_%s = s->%s && !s->prev__%s;\n", d->sigs[i].name, d->sigs[i].name, d->sigs[i].name);
+    for (i = 0; i < d->nsig; i++)
+        if (d->sigs[i].is_clock) fprintf(out, "    s->prev__%s = s->%s;\n", d->sigs[i].name, d->sigs[i].name);
+    for (i = 0; i < d->nsig; i++) {
+        const struct vf_sig *s = &d->sigs[i];
+        if (s->driver >= 0 && !s->len) fprintf(out, "    %s n_%s = s->%s;\n", ctype(s->w, s->is_int), s->name, s->name);
+    }
+    for (j = 0; j < nsites; j++) fprintf(out, "    int w%d = 0; uint64_t wi%d = 0, wv%d = 0;\n", j, j, j);
+    fputs("    int ch = 0;\n", out);
+
+    nsite = 0;
+    for (i = 0; i < d->nproc; i++) {
+        const struct vf_proc *p = &d->procs[i];
+        fprintf(out, "\n    /* %s */\n", p->name);
+        if (p->clk >= 0) {
+            fprintf(out, "    if (e_%s) {\n", d->sigs[p->clk].name);
+            stmts(p->body, 2);
+            fputs("    }\n", out);
+        } else {
+            stmts(p->body, 1);
+        }
+    }
+
+    fputs("\n    /* コミット */\n", out);
+    for (i = 0; i < d->nsig; i++) {
+        const struct vf_sig *s = &d->sigs[i];
+        if (s->driver >= 0 && !s->len)
+            fprintf(out, "    if (n_%s != s->%s) { s->%s = n_%s; ch = 1; }\n", s->name, s->name, s->name, s->name);
+    }
+    for (j = 0; j < nsites; j++) {
+        const struct vf_sig *s = &d->sigs[site_map[j]];
+        fprintf(out, "    if (w%d && wi%d - %d < %d && s->%s[wi%d - %d] != (%s)wv%d) "
+                     "{ s->%s[wi%d - %d] = (%s)wv%d; ch = 1; }\n",
+                j, j, s->alo, s->len, s->name, j, s->alo, ctype(s->w, s->is_int), j,
+                s->name, j, s->alo, ctype(s->w, s->is_int), j);
+    }
+    fputs("    return ch;\n}\n\n", out);
+
+    /* 安定するまでデルタを回す */
+    fprintf(out, "static void %s_eval(struct %s *s) {\n", T, T);
+    fputs("    int n = 0;\n", out);
+    fprintf(out, "    while (%s_delta(s))\n", T);
+    fputs("        if (++n > 1000) { fputs(\"combinational loop does not settle\\n\", stderr); abort(); }\n", out);
+    fputs("}\n\n", out);
+
+    /* 初期化：初期値を入れ、組合せ回路を落ち着かせる（VHDL の初期化フェーズ） */
+    fprintf(out, "static void %s_init(struct %s *s) {\n", T, T);
+    fputs("    memset(s, 0, sizeof(*s));\n", out);
+    for (i = 0; i < d->nsig; i++) {
+        const struct vf_sig *s = &d->sigs[i];
+        if (s->len && s->inits) {
+            for (j = 0; j < s->len; j++)
+                if (s->inits[j]) fprintf(out, "    s->%s[%d] = 0x%llx;\n", s->name, j, (unsigned long long)s->inits[j]);
+        } else if (!s->len && s->init) {
+            fprintf(out, "    s->%s = 0x%llx;\n", s->name, (unsigned long long)s->init);
+            if (s->is_clock) fprintf(out, "    s->prev__%s = 0x%llx;\n", s->name, (unsigned long long)s->init);
+        }
+    }
+    fprintf(out, "    %s_eval(s);\n}\n", T);
+    free(site_map);
+}
+
+/* --- テスト用 main --- */
+struct stim { const char *name; int sig; int n; long long *v; };
+struct probe { const char *name; int sig; int hex; };
+
+static void emit_main(const char *clk, struct stim *st, int nst, struct probe *pr, int npr) {
+    int i, j;
+
+    fputs("\n#include <time.h>\n\n", out);
+    fputs("int main(int argc, char **argv) {\n", out);
+    fprintf(out, "    static struct %s m;\n", T);
+    fputs("    struct " , out);
+    fprintf(out, "%s *s = &m;\n", T);
+    fputs("    long n = 400, e;\n    int quiet = 0;\n    clock_t t0;\n\n", out);
+    fputs("    if (argc > 1 && !strcmp(argv[1], \"-q\")) { quiet = 1; argc--; argv++; }\n", out);
+    fputs("    if (argc > 1) n = strtol(argv[1], NULL, 0);\n", out);
+    fprintf(out, "    %s_init(s);\n", T);
+    fputs("    if (!quiet) printf(\"  edge", out);
+    for (i = 0; i < npr; i++) fprintf(out, "  %s", pr[i].name);
+    fputs("\\n\");\n", out);
+    fputs("    t0 = clock();\n", out);
+    fputs("    for (e = 0; e < n; e++) {\n", out);
+    for (i = 0; i < nst; i++) {
+        fprintf(out, "        s->%s = ", d->sigs[st[i].sig].name);
+        for (j = st[i].n - 1; j >= 1; j -= 2)
+            fprintf(out, "e >= %lld ? 0x%llx : ", st[i].v[j - 1], (unsigned long long)st[i].v[j]);
+        fprintf(out, "0x%llx;\n", (unsigned long long)st[i].v[0]);
+    }
+    fprintf(out, "        s->%s = 1;\n", clk);
+    fprintf(out, "        %s_eval(s);\n", T);
+    fputs("        if (!quiet)\n            printf(\" %6ld", out);
+    for (i = 0; i < npr; i++) fprintf(out, "  %%%d%s", (int)strlen(pr[i].name), pr[i].hex ? "llx" : "llu");
+    fputs("\\n\", e", out);
+    for (i = 0; i < npr; i++) fprintf(out, ", (unsigned long long)s->%s", d->sigs[pr[i].sig].name);
+    fputs(");\n", out);
+    fprintf(out, "        s->%s = 0;\n", clk);
+    fprintf(out, "        %s_eval(s);\n", T);
+    fputs("    }\n", out);
+    fputs("    if (quiet) {\n", out);
+    fputs("        double sec = (double)(clock() - t0) / CLOCKS_PER_SEC;\n", out);
+    fputs("        printf(\"%ld edges, %.3f sec, %.1f Medges/s\\n\", n, sec, sec > 0 ? n / sec / 1e6 : 0.0);\n", out);
+    for (i = 0; i < npr; i++)
+        fprintf(out, "        printf(\"%s = %%llu\\n\", (unsigned long long)s->%s);\n", pr[i].name, d->sigs[pr[i].sig].name);
+    fputs("    }\n    return 0;\n}\n", out);
+}
+
+static void usage(void) {
+    fprintf(stderr, "usage: vhdl2c [-m] [-o out.c] [-c CLK] [-i NAME=V0,E1,V1,...] [-p NAME[:x]]... TOP file.vhd...\n");
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    const char *oname = NULL, *clk = "CLK", *top;
+    int harness = 0, i, nst = 0, npr = 0, ck;
+    struct stim st[16];
+    struct probe pr[64];
+    char *specs[16], *probes[64];
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++) {
+        if (!strcmp(argv[i], "-m")) harness = 1;
+        else if (!strcmp(argv[i], "-o") && i + 1 < argc) oname = argv[++i];
+        else if (!strcmp(argv[i], "-c") && i + 1 < argc) clk = argv[++i];
+        else if (!strcmp(argv[i], "-i") && i + 1 < argc && nst < 16) specs[nst++] = argv[++i];
+        else if (!strcmp(argv[i], "-p") && i + 1 < argc && npr < 64) probes[npr++] = argv[++i];
+        else usage();
+    }
+    if (argc - i < 2) usage();
+    top = argv[i++];
+    for (; i < argc; i++) vf_parse_file(argv[i]);
+    d = vf_elaborate(top);
+    T = d->top;
+
+    out = stdout;
+    if (oname && (out = fopen(oname, "w")) == NULL) vf_fatal("cannot open %s", oname);
+    emit_model();
+
+    if (harness) {
+        ck = vf_lookup(d, clk);
+        if (ck < 0 || d->sigs[ck].dir != VF_IN) vf_fatal("clock input '%s' not found", clk);
+        if (nst == 0 && vf_lookup(d, "RESET_N") >= 0) specs[nst++] = "RESET_N=0,5,1";
+        for (i = 0; i < nst; i++) {
+            char *eq = strchr(specs[i], '='), *p;
+            if (eq == NULL) usage();
+            st[i].name = vf_strdup(specs[i]);
+            ((char *)st[i].name)[eq - specs[i]] = 0;
+            st[i].sig = vf_lookup(d, st[i].name);
+            if (st[i].sig < 0 || d->sigs[st[i].sig].dir != VF_IN) vf_fatal("input '%s' not found", st[i].name);
+            st[i].v = vf_alloc(sizeof(long long) * 64);
+            st[i].n = 0;
+            for (p = eq + 1; *p && st[i].n < 63; ) {
+                st[i].v[st[i].n++] = strtoll(p, &p, 0);
+                if (*p == ',') p++;
+                else if (*p) usage();
+            }
+            if (st[i].n % 2 == 0) usage();
+        }
+        if (npr == 0)
+            for (i = 0; i < d->nsig && npr < 64; i++)
+                if (d->sigs[i].dir == VF_OUT) probes[npr++] = d->sigs[i].name;
+        for (i = 0; i < npr; i++) {
+            char *c = strchr(probes[i], ':');
+            pr[i].name = vf_strdup(probes[i]);
+            pr[i].hex = 0;
+            if (c) {
+                ((char *)pr[i].name)[c - probes[i]] = 0;
+                pr[i].hex = !strcmp(c, ":x");
+            }
+            pr[i].sig = vf_lookup(d, pr[i].name);
+            if (pr[i].sig < 0 || d->sigs[pr[i].sig].len) vf_fatal("signal '%s' not found", pr[i].name);
+        }
+        emit_main(d->sigs[ck].name, st, nst, pr, npr);
+    }
+    if (out != stdout) fclose(out);
+    return 0;
+}
+
+/*
+  【GNUでのコンパイル例（Ubuntu / gcc）】
+    gcc -O2 vhdl2c.c vhdl_front.c -o vhdl2c
+
+  【chapter06 の cpu15 を C モデルにして実行する例】
+    ./vhdl2c -m -o cpu15_gen.c \
+        -p C7__PC -p PROM_OUT:x -p REG_A -p REG_B -p IO64_OUT \
+        cpu15 cpu15_isa.vhd clk_gen.vhd fetch.vhd decode.vhd reg_file.vhd data_ram.vhd \
+        ../chapter05/half_adder.vhd ../chapter05/full_adder.vhd ../chapter05/adder_nbit.vhd exec.vhd cpu15.vhd
+    （cpu15_isa.vhd はオペコード定数のパッケージ、adder_nbit.vhd は exec が使う加算器と
+      adder_nbit_pkg の定数。どちらも使う側より前に渡す）
+    gcc -O2 cpu15_gen.c -o cpu15_gen
+    ./cpu15_gen 280          # 280 エッジ分のトレース（IO64_OUT が 55 になる）
+    ./cpu15_gen -q 10000000  # 速度測定
+
+  【パイプライン版（cpu15_pipe.vhd）】
+    ./vhdl2c -m -o cpu15_pipe_gen.c -p IO64_OUT \
+        cpu15_pipe cpu15_isa.vhd fetch.vhd fetch_pq.vhd reg_file.vhd data_ram.vhd cpu15_pipe.vhd
+    （IO64_OUT が 55 になるのは 72 エッジ目。4相版は 263 エッジ目）
+
+  【chapter09 の cpu15_rom_ram について】
+    fetch_rom は Quartus のメガファンクション（.vhd が無い）なので、
+    代わりに chapter09/fetch_rom_sim.vhd（fetch.vhd を包んだ同じポートの entity）を渡す。
+    ROM の中身は作業ディレクトリの fetch_rom.hex から読む。
+    ../chapter03/CPU_emulator -p blk -o fetch_rom.hex
+    ./vhdl2c -m -o rom_ram_gen.c -p IO64_OUT \
+        cpu15_rom_ram cpu15_isa.vhd clk_gen.vhd fetch.vhd ../chapter09/fetch_rom_sim.vhd \
+        decode.vhd reg_file.vhd ../chapter05/half_adder.vhd ../chapter05/full_adder.vhd ../chapter05/adder_nbit.vhd \
+        exec.vhd data_ram.vhd ../chapter09/ram_dc_wb.vhd ../chapter09/cpu15_rom_ram.vhd
+*/
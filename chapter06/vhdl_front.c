@@ -0,0 +1,2059 @@
+/*
+  vhdl_front.c（VHDL 合成サブセットのフロントエンド）
+
+  【処理の流れ】
+    1) 字句解析   : ファイル全体をトークン列にする（大文字小文字は区別しない）
+    2) 構文解析   : entity / architecture / package を構文木（AST）にして大域リストへ登録する
+    3) エラボレーション :
+         トップ entity から component インスタンスを再帰的に展開し、
+         generic を定数として評価しながら AST を vhdl_front.h の IR に解決する。
+
+  【ポート接続の扱い】
+  - 実引数が「親の信号名そのもの」なら、子のポートは親の信号の“別名”になる
+    （cpu15.vhd の C1..C9 はすべてこの形なので、信号の実体は増えない）。
+  - 実引数が式（PROM_OUT(10 downto 8) や IO65_IN and "...."）の場合は、
+    子側に新しい信号を作り、「新信号 <= 式」という組合せプロセスを親側に追加する。
+    VHDL でもポートに式を渡すと暗黙の信号を経由するので、デルタ遅延も一致する。
+
+  【package の扱い】
+  - package 宣言部の constant / subtype / type だけを読み、エラボレーションの最初に評価する。
+  - use work.<package>.all は読み飛ばし、読み込んだ package の名前はどの entity からも見える
+    （同じ名前を entity 側で宣言すればそちらが優先される）。package body は扱わない。
+
+  【function と string】
+  - function の本体（variable・file・loop を使う）は解析せずに読み飛ばす。
+    呼べるのは定数配列の初期値としての LOAD_ROM(ファイル名, 既定の配列) だけで、
+    fetch.vhd の LOAD_ROM と同じ規則でファイルを読む処理を elab_carr が自前で行う。
+  - string 型は generic（ROM_FILE など）と LOAD_ROM の引数にだけ使える。
+
+  【エラーにするもの（合成サブセットの外）】
+  - wait 文 / variable / 非同期リセット（if RESET then ... elsif CLK'event ...）
+  - ユーザ定義の function の呼び出し（LOAD_ROM を除く）
+  - 複数のプロセスから同じ信号（のビット）を駆動する（マルチドライバ）
+  - 代入の左右でビット幅が一致しない
+  - 見つからない entity（ベンダのメガファンクション fetch_rom など）
+*/
+
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "vhdl_front.h"
+
+/* ============================================================
+   共通ユーティリティ
+   ============================================================ */
+void vf_fatal(const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    fprintf(stderr, "vhdl: ");
+    vfprintf(stderr, fmt, ap);
+    fprintf(stderr, "\n");
+    va_end(ap);
+    exit(1);
+}
+
+void *vf_alloc(size_t n) {
+    void *p = calloc(1, n);
+    if (p == NULL) vf_fatal("out of memory");
+    return p;
+}
+
+char *vf_strdup(const char *s) {
+    char *p = vf_alloc(strlen(s) + 1);
+    strcpy(p, s);
+    return p;
+}
+
+uint64_t vf_mask(int w) {
+    return w >= 64 ? ~(uint64_t)0 : (((uint64_t)1 << w) - 1);
+}
+
+static char *cat3(const char *a, const char *b, const char *c) {
+    char *p = vf_alloc(strlen(a) + strlen(b) + strlen(c) + 1);
+    sprintf(p, "%s%s%s", a, b, c);
+    return p;
+}
+
+/* ============================================================
+   字句解析
+   ============================================================ */
+enum { T_EOF, T_ID, T_INT, T_STR, T_CHR, T_SYM, T_TXT };
+
+struct tok {
+    int k;
+    char *s;        // T_ID: 小文字化した名前 / T_STR: '0','1' の列 / T_SYM: 記号 / T_TXT: 文字列の中身
+    char *orig;     // T_ID: ソース上の綴り（生成コードの名前に使う）
+    uint64_t v;     // T_INT / T_CHR の値（'0' '1' 以外の文字リテラルは VF_CHR_OTHER）
+    int line;
+};
+
+static struct tok *toks;
+static int ntok, pos;
+static const char *cur_file;
+
+static void add_tok(int k, char *s, char *orig, uint64_t v, int line) {
+    static int cap;
+    if (ntok == cap) {
+        cap = cap ? cap * 2 : 1024;
+        toks = realloc(toks, cap * sizeof(*toks));
+        if (toks == NULL) vf_fatal("out of memory");
+    }
+    toks[ntok].k = k;
+    toks[ntok].s = s;
+    toks[ntok].orig = orig;
+    toks[ntok].v = v;
+    toks[ntok].line = line;
+    ntok++;
+}
+
+/* '0' '1' 以外の文字リテラル（読み飛ばす function の本体にだけ現れてよい） */
+#define VF_CHR_OTHER 2
+
+/* 0/1/_ だけでできた空でない文字列か（そうでなければ string 型の文字列リテラル） */
+static int is_bits(const char *p, int n) {
+    int i;
+    if (n == 0) return 0;
+    for (i = 0; i < n; i++)
+        if (p[i] != '0' && p[i] != '1' && p[i] != '_') return 0;
+    return 1;
+}
+
+/* "0101" / X"3F" / O"17" の中身を '0'/'1' の列に展開する */
+static char *bit_string(const char *p, int n, int base, int line) {
+    char *out = vf_alloc(n * 4 + 1), *q = out;
+    int i, b, d;
+    for (i = 0; i < n; i++) {
+        if (p[i] == '_') continue;
+        if (base == 2) {
+            if (p[i] != '0' && p[i] != '1')
+                vf_fatal("%s:%d: unsupported bit value '%c'", cur_file, line, p[i]);
+            *q++ = p[i];
+            continue;
+        }
+        if (!isxdigit((unsigned char)p[i]))
+            vf_fatal("%s:%d: bad digit '%c' in bit string", cur_file, line, p[i]);
+        d = isdigit((unsigned char)p[i]) ? p[i] - '0' : tolower((unsigned char)p[i]) - 'a' + 10;
+        for (b = (base == 16 ? 3 : 2); b >= 0; b--) *q++ = '0' + ((d >> b) & 1);
+    }
+    *q = 0;
+    return out;
+}
+
+/* 式の中で文字リテラルの直前に来うる予約語（識別子は小文字化済み） */
+static int is_reserved(const char *id) {
+    static const char *kw[] = { "else", "when", "then", "and", "or", "xor", "nand", "nor", "xnor",
+                                "not", "return", "is", NULL };
+    int i;
+    for (i = 0; kw[i]; i++)
+        if (!strcmp(id, kw[i])) return 1;
+    return 0;
+}
+
+static void lex(const char *src) {
+    const char *p = src, *s;
+    int line = 1, n;
+    char *id, *orig;
+
+    while (*p) {
+        if (*p == '\n') { line++; p++; continue; }
+        if (isspace((unsigned char)*p)) { p++; continue; }
+        if (p[0] == '-' && p[1] == '-') {
+            while (*p && *p != '\n') p++;
+            continue;
+        }
+        /* ビット列リテラル X"..", O"..", B".." */
+        if (strchr("xXoObB", *p) && p[1] == '"') {
+            int base = tolower((unsigned char)*p) == 'x' ? 16 : tolower((unsigned char)*p) == 'o' ? 8 : 2;
+            s = p += 2;
+            while (*p && *p != '"') p++;
+            if (!*p) vf_fatal("%s:%d: unterminated string", cur_file, line);
+            add_tok(T_STR, bit_string(s, (int)(p - s), base, line), NULL, 0, line);
+            p++;
+            continue;
+        }
+        if (isalpha((unsigned char)*p)) {
+            s = p;
+            while (isalnum((unsigned char)*p) || *p == '_') p++;
+            n = (int)(p - s);
+            orig = vf_alloc(n + 1);
+            memcpy(orig, s, n);
+            id = vf_strdup(orig);
+            for (char *c = id; *c; c++) *c = (char)tolower((unsigned char)*c);
+            add_tok(T_ID, id, orig, 0, line);
+            continue;
+        }
+        if (isdigit((unsigned char)*p)) {
+            uint64_t v = 0;
+            while (isdigit((unsigned char)*p) || *p == '_') {
+                if (*p != '_') v = v * 10 + (uint64_t)(*p - '0');
+                p++;
+            }
+            add_tok(T_INT, NULL, NULL, v, line);
+            continue;
+        }
+        if (*p == '"') {
+            s = ++p;
+            while (*p && *p != '"') p++;
+            if (!*p) vf_fatal("%s:%d: unterminated string", cur_file, line);
+            n = (int)(p - s);
+            if (is_bits(s, n)) {
+                add_tok(T_STR, bit_string(s, n, 2, line), NULL, 0, line);
+            } else {
+                /* ファイル名などの string。generic の値と LOAD_ROM の引数にだけ使える */
+                char *txt = vf_alloc(n + 1);
+                memcpy(txt, s, n);
+                add_tok(T_TXT, txt, NULL, 0, line);
+            }
+            p++;
+            continue;
+        }
+        /* '0' '1' は文字リテラル、CLK'event の ' は属性（直前が名前か ')' なら属性）。
+           else '0' のように直前が予約語のときは名前ではないので文字リテラル */
+        if (*p == '\'' && p[2] == '\'' &&
+            !(ntok > 0 && ((toks[ntok - 1].k == T_ID && !is_reserved(toks[ntok - 1].s)) ||
+                           (toks[ntok - 1].k == T_SYM && strcmp(toks[ntok - 1].s, ")") == 0)))) {
+            add_tok(T_CHR, NULL, NULL, p[1] == '0' || p[1] == '1' ? (uint64_t)(p[1] - '0') : VF_CHR_OTHER, line);
+            p += 3;
+            continue;
+        }
+        {
+            static const char *two[] = { "<=", "=>", ":=", "/=", ">=", "**", NULL };
+            char buf[3] = { p[0], 0, 0 };
+            int i;
+            for (i = 0; two[i]; i++)
+                if (p[0] == two[i][0] && p[1] == two[i][1]) {
+                    buf[1] = p[1];
+                    break;
+                }
+            if (!strchr("()<>=;:,.&+-*/|'", p[0]))
+                vf_fatal("%s:%d: unexpected character '%c'", cur_file, line, p[0]);
+            add_tok(T_SYM, vf_strdup(buf), NULL, 0, line);
+            p += buf[1] ? 2 : 1;
+        }
+    }
+    add_tok(T_EOF, NULL, NULL, 0, line);
+}
+
+/* ============================================================
+   構文木（AST）
+   ============================================================ */
+enum { N_NAME, N_INT, N_STR, N_CHR, N_CALL, N_RANGE, N_ATTR, N_BIN, N_UN,
+       N_OTHERS, N_AGG, N_WHEN, N_OPEN, N_TXT };
+
+struct node {
+    int k, op, line;
+    char *id, *orig;            // N_NAME / N_ATTR（属性名） / N_TXT（文字列の中身）
+    uint64_t v;                 // N_INT / N_CHR
+    char *bits;                 // N_STR
+    struct node *a, *b, *c;     // N_CALL: a=接頭辞, b=引数リスト / N_RANGE: a=左, b=右, op=1:downto
+                                // N_AGG: a=要素リスト（最後は N_OTHERS でもよい）
+    struct node *next;          // 引数・集合体・選択肢のリスト
+};
+
+enum { TY_SL, TY_VEC, TY_INT, TY_NAME, TY_TXT };
+
+struct ty {
+    int k, line, downto;
+    struct node *l, *r;         // TY_VEC: (l downto r)
+    char *id;                   // TY_NAME
+};
+
+enum { D_SIG, D_CONST, D_ARRAY, D_SUBTYPE, D_ENUM };
+
+struct decl {
+    int k, line, downto;
+    char *id, *orig;
+    struct ty *ty;              // 信号・定数の型 / D_ARRAY の要素型 / D_SUBTYPE の元型
+    struct node *init;          // 初期値
+    struct node *l, *r;         // D_ARRAY の添字範囲
+    struct node *lits;          // D_ENUM の列挙子
+    struct decl *next;
+};
+
+struct port {
+    char *id, *orig;
+    int dir, line;              // 0: generic / VF_IN / VF_OUT
+    struct ty *ty;
+    struct node *init;
+    struct port *next;
+};
+
+enum { S_ASSIGN, S_IF, S_CASE };
+
+struct when {
+    struct node *ch;
+    int others;
+    struct sst *body;
+    struct when *next;
+};
+
+struct sst {
+    int k, line;
+    struct node *tgt, *val, *cond, *sel;
+    struct sst *then_s, *else_s;
+    struct when *arms;
+    struct sst *next;
+};
+
+enum { C_PROC, C_ASSIGN, C_INST, C_GEN_FOR, C_GEN_IF };
+
+struct assoc {
+    char *formal;
+    struct node *actual;
+    int line;
+    struct assoc *next;
+};
+
+struct cst {
+    int k, line;
+    char *label, *ent;
+    struct sst *body;
+    struct node *tgt, *val;
+    struct assoc *gmap, *pmap;
+    char *gvar;                 // C_GEN_FOR: ループ変数
+    struct node *l, *r;         // C_GEN_FOR: 範囲（downto なら逆順に回す）
+    int downto;
+    struct node *cond;          // C_GEN_IF: 条件
+    struct cst *gbody;          // C_GEN_FOR / C_GEN_IF: 展開する同時文
+    struct cst *next;
+};
+
+struct arch {
+    char *id, *ent, *file;
+    struct decl *decls;
+    struct cst *body;
+    struct arch *next;
+};
+
+struct entity {
+    char *id, *orig, *file;
+    struct port *generics, *ports;
+    struct entity *next;
+};
+
+struct pkg {
+    char *id, *file;
+    struct decl *decls;
+    struct pkg *next;
+};
+
+static struct entity *entities;
+static struct arch *archs;
+static struct pkg *pkgs, **pkg_tail = &pkgs;    // 読み込んだ順（後の package が前の定数を使えるように）
+
+/* ============================================================
+   構文解析（再帰下降）
+   ============================================================ */
+static struct tok *tk(void) { return &toks[pos]; }
+
+static void perr(const char *what) {
+    struct tok *t = tk();
+    vf_fatal("%s:%d: expected %s near '%s'", cur_file, t->line, what,
+             t->k == T_ID ? t->orig : t->k == T_SYM ? t->s : t->k == T_EOF ? "EOF" : "literal");
+}
+
+static int is_kw(const char *kw) { return tk()->k == T_ID && strcmp(tk()->s, kw) == 0; }
+static int is_sym(const char *s) { return tk()->k == T_SYM && strcmp(tk()->s, s) == 0; }
+
+static int accept_kw(const char *kw) {
+    if (!is_kw(kw)) return 0;
+    pos++;
+    return 1;
+}
+
+static int accept_sym(const char *s) {
+    if (!is_sym(s)) return 0;
+    pos++;
+    return 1;
+}
+
+static void expect_kw(const char *kw) { if (!accept_kw(kw)) perr(kw); }
+static void expect_sym(const char *s) { if (!accept_sym(s)) perr(s); }
+
+static struct tok *expect_id(void) {
+    if (tk()->k != T_ID) perr("identifier");
+    return &toks[pos++];
+}
+
+static struct node *mk(int k) {
+    struct node *n = vf_alloc(sizeof(*n));
+    n->k = k;
+    n->line = tk()->line;
+    return n;
+}
+
+static struct node *bin(int op, struct node *a, struct node *b) {
+    struct node *n = mk(N_BIN);
+    n->op = op;
+    n->a = a;
+    n->b = b;
+    n->line = a->line;
+    return n;
+}
+
+static struct node *expr(void);
+
+/* 引数リスト（添字・スライス・関数引数）：式 [downto|to 式] {, ...} */
+static struct node *arg_list(void) {
+    struct node *head = NULL, **tail = &head, *e, *r;
+    do {
+        e = expr();
+        if (is_kw("downto") || is_kw("to")) {
+            r = mk(N_RANGE);
+            r->op = is_kw("downto");
+            pos++;
+            r->a = e;
+            r->b = expr();
+            e = r;
+        }
+        *tail = e;
+        tail = &e->next;
+    } while (accept_sym(","));
+    return head;
+}
+
+/* 名前：ID { ( 引数 ) } { 'attr } */
+static struct node *name(void) {
+    struct tok *t = expect_id();
+    struct node *n = mk(N_NAME), *c;
+    n->id = t->s;
+    n->orig = t->orig;
+    n->line = t->line;
+    for (;;) {
+        if (is_sym("(")) {
+            pos++;
+            c = mk(N_CALL);
+            c->a = n;
+            c->b = arg_list();
+            expect_sym(")");
+            n = c;
+        } else if (is_sym("'")) {
+            pos++;
+            c = mk(N_ATTR);
+            c->a = n;
+            c->id = expect_id()->s;
+            n = c;
+        } else {
+            return n;
+        }
+    }
+}
+
+/* 括弧：(式) / (others => x) / (a, b, c) / (a, b, others => x) */
+static struct node *paren(void) {
+    struct node *n, *head = NULL, **tail = &head;
+    expect_sym("(");
+    if (accept_kw("others")) {
+        expect_sym("=>");
+        n = mk(N_OTHERS);
+        n->a = expr();
+        expect_sym(")");
+        return n;
+    }
+    n = expr();
+    if (accept_sym(")")) return n;
+    *tail = n;
+    tail = &n->next;
+    while (accept_sym(",")) {
+        if (accept_kw("others")) {
+            /* 残りの要素をすべて x にする。最後の要素にだけ書ける */
+            expect_sym("=>");
+            n = mk(N_OTHERS);
+            n->a = expr();
+            *tail = n;
+            break;
+        }
+        n = expr();
+        *tail = n;
+        tail = &n->next;
+    }
+    expect_sym(")");
+    n = mk(N_AGG);
+    n->a = head;
+    return n;
+}
+
+static struct node *primary(void) {
+    struct node *n;
+    struct tok *t = tk();
+    switch (t->k) {
+    case T_INT: n = mk(N_INT); n->v = t->v; pos++; return n;
+    case T_CHR: n = mk(N_CHR); n->v = t->v; pos++; return n;
+    case T_STR: n = mk(N_STR); n->bits = t->s; pos++; return n;
+    case T_TXT: n = mk(N_TXT); n->id = t->s; pos++; return n;
+    case T_SYM:
+        if (is_sym("(")) return paren();
+        break;
+    case T_ID:
+        if (accept_kw("open")) return mk(N_OPEN);
+        return name();
+    }
+    perr("expression");
+    return NULL;
+}
+
+static struct node *factor(void) {
+    struct node *n;
+    if (accept_kw("not")) {
+        n = mk(N_UN);
+        n->op = OP_NOT;
+        n->a = primary();
+        return n;
+    }
+    n = primary();
+    if (accept_sym("**")) n = bin(OP_POW, n, primary());     // 2**N_BITS のような静的な式だけ（解決時に確かめる）
+    return n;
+}
+
+static struct node *term(void) {
+    struct node *n = factor();
+    for (;;) {
+        if (accept_sym("*")) n = bin(OP_MUL, n, factor());
+        else if (accept_sym("/")) n = bin(OP_DIV, n, factor());
+        else if (accept_kw("mod") || accept_kw("rem")) n = bin(OP_MOD, n, factor());
+        else return n;
+    }
+}
+
+static struct node *simple(void) {
+    struct node *n;
+    if (accept_sym("-")) {
+        n = mk(N_UN);
+        n->op = OP_NEG;
+        n->a = term();
+    } else {
+        accept_sym("+");
+        n = term();
+    }
+    for (;;) {
+        if (accept_sym("+")) n = bin(OP_ADD, n, term());
+        else if (accept_sym("-")) n = bin(OP_SUB, n, term());
+        else if (accept_sym("&")) n = bin(OP_CAT, n, term());
+        else return n;
+    }
+}
+
+static struct node *relation(void) {
+    static const struct { const char *s; int op; } rel[] = {
+        { "=", OP_EQ }, { "/=", OP_NE }, { "<", OP_LT }, { "<=", OP_LE },
+        { ">", OP_GT }, { ">=", OP_GE }, { NULL, 0 }
+    };
+    struct node *n = simple();
+    int i;
+    for (i = 0; rel[i].s; i++)
+        if (accept_sym(rel[i].s)) return bin(rel[i].op, n, simple());
+    return n;
+}
+
+static struct node *expr(void) {
+    static const struct { const char *kw; int op; } lg[] = {
+        { "and", OP_AND }, { "or", OP_OR }, { "xor", OP_XOR },
+        { "nand", OP_NAND }, { "nor", OP_NOR }, { "xnor", OP_XNOR }, { NULL, 0 }
+    };
+    struct node *n = relation();
+    int i;
+again:
+    for (i = 0; lg[i].kw; i++)
+        if (accept_kw(lg[i].kw)) {
+            n = bin(lg[i].op, n, relation());
+            goto again;
+        }
+    return n;
+}
+
+/* 型：std_logic / std_logic_vector(h downto l) / integer [range a to b] / string / 名前 */
+static struct ty *type_mark(void) {
+    struct ty *t = vf_alloc(sizeof(*t));
+    struct tok *id = expect_id();
+    t->line = id->line;
+    if (!strcmp(id->s, "std_logic") || !strcmp(id->s, "std_ulogic") ||
+        !strcmp(id->s, "bit") || !strcmp(id->s, "boolean")) {
+        t->k = TY_SL;
+    } else if (!strcmp(id->s, "std_logic_vector") || !strcmp(id->s, "std_ulogic_vector") ||
+               !strcmp(id->s, "unsigned") || !strcmp(id->s, "bit_vector")) {
+        t->k = TY_VEC;
+        expect_sym("(");
+        t->l = expr();
+        if (accept_kw("downto")) t->downto = 1;
+        else expect_kw("to");
+        t->r = expr();
+        expect_sym(")");
+    } else if (!strcmp(id->s, "integer") || !strcmp(id->s, "natural") ||
+               !strcmp(id->s, "positive")) {
+        t->k = TY_INT;
+        if (accept_kw("range")) {
+            expr();
+            if (!accept_kw("to")) expect_kw("downto");
+            expr();
+        }
+    } else if (!strcmp(id->s, "string")) {
+        t->k = TY_TXT;
+    } else {
+        t->k = TY_NAME;
+        t->id = id->s;
+    }
+    return t;
+}
+
+/* インタフェースリスト（generic / port） */
+static struct port *iface_list(int is_generic) {
+    struct port *head = NULL, **tail = &head, *first, *p;
+    struct ty *ty;
+    struct node *init;
+    int dir;
+
+    expect_sym("(");
+    do {
+        accept_kw("signal");
+        accept_kw("constant");
+        first = NULL;
+        do {
+            struct tok *t = expect_id();
+            p = vf_alloc(sizeof(*p));
+            p->id = t->s;
+            p->orig = t->orig;
+            p->line = t->line;
+            if (first == NULL) first = p;
+            *tail = p;
+            tail = &p->next;
+        } while (accept_sym(","));
+        expect_sym(":");
+        dir = 0;
+        if (!is_generic) {
+            if (accept_kw("in")) dir = VF_IN;
+            else if (accept_kw("out") || accept_kw("buffer")) dir = VF_OUT;
+            else if (is_kw("inout")) perr("in/out (inout is unsupported)");
+            else dir = VF_IN;
+        }
+        ty = type_mark();
+        init = accept_sym(":=") ? expr() : NULL;
+        for (p = first; p; p = p->next) {
+            p->dir = dir;
+            p->ty = ty;
+            p->init = init;
+        }
+    } while (accept_sym(";"));
+    expect_sym(")");
+    expect_sym(";");
+    return head;
+}
+
+static void skip_to_semi(void) {
+    while (!is_sym(";")) {
+        if (tk()->k == T_EOF) perr(";");
+        pos++;
+    }
+    pos++;
+}
+
+/* end [kw] [name] ; */
+static void end_of(const char *kw) {
+    expect_kw("end");
+    if (kw) accept_kw(kw);
+    if (tk()->k == T_ID) pos++;
+    expect_sym(";");
+}
+
+static struct sst *seq_list(void);
+
+static struct sst *if_stmt(void) {
+    struct sst *s = vf_alloc(sizeof(*s));
+    s->k = S_IF;
+    s->line = tk()->line;
+    s->cond = expr();
+    expect_kw("then");
+    s->then_s = seq_list();
+    if (accept_kw("elsif")) {
+        s->else_s = if_stmt();
+        return s;
+    }
+    if (accept_kw("else")) s->else_s = seq_list();
+    expect_kw("end");
+    expect_kw("if");
+    expect_sym(";");
+    return s;
+}
+
+static struct sst *case_stmt(void) {
+    struct sst *s = vf_alloc(sizeof(*s));
+    struct when **tail = &s->arms, *w;
+    struct node **ct, *c;
+
+    s->k = S_CASE;
+    s->line = tk()->line;
+    s->sel = expr();
+    expect_kw("is");
+    while (accept_kw("when")) {
+        w = vf_alloc(sizeof(*w));
+        ct = &w->ch;
+        do {
+            if (accept_kw("others")) {
+                w->others = 1;
+                continue;
+            }
+            c = simple();
+            *ct = c;
+            ct = &c->next;
+        } while (accept_sym("|"));
+        expect_sym("=>");
+        w->body = seq_list();
+        *tail = w;
+        tail = &w->next;
+    }
+    expect_kw("end");
+    expect_kw("case");
+    expect_sym(";");
+    return s;
+}
+
+/* 順序文の並び。end / elsif / else / when の手前で止まる */
+static struct sst *seq_list(void) {
+    struct sst *head = NULL, **tail = &head, *s;
+    for (;;) {
+        if (is_kw("end") || is_kw("elsif") || is_kw("else") || is_kw("when")) return head;
+        if (accept_kw("null")) {
+            expect_sym(";");
+            continue;
+        }
+        if (accept_kw("if")) {
+            s = if_stmt();
+        } else if (accept_kw("case")) {
+            s = case_stmt();
+        } else if (is_kw("wait") || is_kw("for") || is_kw("loop") || is_kw("while")) {
+            perr("a synthesizable statement (wait/loop are unsupported)");
+            return NULL;
+        } else {
+            s = vf_alloc(sizeof(*s));
+            s->k = S_ASSIGN;
+            s->line = tk()->line;
+            s->tgt = name();
+            if (is_sym(":=")) perr("'<=' (variables are unsupported)");
+            expect_sym("<=");
+            s->val = expr();
+            expect_sym(";");
+        }
+        *tail = s;
+        tail = &s->next;
+    }
+}
+
+/* [impure] function ... end [function] [name]; を読み飛ばす。
+   本体（variable・file・loop など）はサブセットの外なので解析しない。
+   使えるのは elab_carr が自前で評価する LOAD_ROM だけ（定数配列の初期値として呼ぶ）。 */
+static void skip_function(void) {
+    int depth = 0;
+    accept_kw("impure");
+    accept_kw("pure");
+    expect_kw("function");
+    /* 宣言だけ（function F(...) return T;）か、本体があるか */
+    for (;;) {
+        if (tk()->k == T_EOF) perr("end function");
+        if (is_sym("(")) depth++;
+        else if (is_sym(")")) depth--;
+        else if (depth == 0 && is_sym(";")) { pos++; return; }
+        else if (depth == 0 && is_kw("is")) { pos++; break; }
+        pos++;
+    }
+    /* end if / end loop / end case / end record は入れ子。それ以外の end が function の終わり */
+    for (;;) {
+        if (tk()->k == T_EOF) perr("end function");
+        if (is_kw("end")) {
+            struct tok *n = &toks[pos + 1];
+            if (n->k == T_ID && (!strcmp(n->s, "if") || !strcmp(n->s, "loop") ||
+                                 !strcmp(n->s, "case") || !strcmp(n->s, "record"))) {
+                pos += 2;
+                continue;
+            }
+            end_of("function");
+            return;
+        }
+        pos++;
+    }
+}
+
+/* architecture / process の宣言部 */
+static struct decl *decls(void) {
+    struct decl *head = NULL, **tail = &head, *d, *first;
+    struct ty *ty;
+    struct node *init;
+    int k;
+
+    for (;;) {
+        if (is_kw("signal") || is_kw("constant")) {
+            k = accept_kw("signal") ? D_SIG : (pos++, D_CONST);
+            first = NULL;
+            do {
+                struct tok *t = expect_id();
+                d = vf_alloc(sizeof(*d));
+                d->k = k;
+                d->id = t->s;
+                d->orig = t->orig;
+                d->line = t->line;
+                if (first == NULL) first = d;
+                *tail = d;
+                tail = &d->next;
+            } while (accept_sym(","));
+            expect_sym(":");
+            ty = type_mark();
+            init = accept_sym(":=") ? expr() : NULL;
+            if (k == D_CONST && init == NULL) perr(":= (constant needs a value)");
+            for (d = first; d; d = d->next) {
+                d->ty = ty;
+                d->init = init;
+            }
+            expect_sym(";");
+        } else if (accept_kw("type")) {
+            struct tok *t = expect_id();
+            d = vf_alloc(sizeof(*d));
+            d->id = t->s;
+            d->orig = t->orig;
+            d->line = t->line;
+            expect_kw("is");
+            if (accept_kw("array")) {
+                d->k = D_ARRAY;
+                expect_sym("(");
+                d->l = expr();
+                if (accept_kw("downto")) d->downto = 1;
+                else expect_kw("to");
+                d->r = expr();
+                expect_sym(")");
+                expect_kw("of");
+                d->ty = type_mark();
+            } else {
+                struct node **lt = &d->lits, *n;
+                d->k = D_ENUM;
+                expect_sym("(");
+                do {
+                    t = expect_id();
+                    n = mk(N_NAME);
+                    n->id = t->s;
+                    n->orig = t->orig;
+                    *lt = n;
+                    lt = &n->next;
+                } while (accept_sym(","));
+                expect_sym(")");
+            }
+            expect_sym(";");
+            *tail = d;
+            tail = &d->next;
+        } else if (accept_kw("subtype")) {
+            struct tok *t = expect_id();
+            d = vf_alloc(sizeof(*d));
+            d->k = D_SUBTYPE;
+            d->id = t->s;
+            d->orig = t->orig;
+            d->line = t->line;
+            expect_kw("is");
+            d->ty = type_mark();
+            expect_sym(";");
+            *tail = d;
+            tail = &d->next;
+        } else if (accept_kw("component")) {
+            /* 宣言は entity 側を正とするので読み飛ばす */
+            while (!is_kw("end")) {
+                if (tk()->k == T_EOF) perr("end component");
+                pos++;
+            }
+            end_of("component");
+        } else if (is_kw("function") || is_kw("impure") || is_kw("pure")) {
+            skip_function();
+        } else if (is_kw("variable") || is_kw("procedure") ||
+                   is_kw("alias") || is_kw("shared")) {
+            perr("a signal/constant/type declaration");
+        } else if (accept_kw("attribute")) {
+            skip_to_semi();
+        } else {
+            return head;
+        }
+    }
+}
+
+static struct assoc *assoc_list(void) {
+    struct assoc *head = NULL, **tail = &head, *a;
+    expect_sym("(");
+    do {
+        a = vf_alloc(sizeof(*a));
+        a->line = tk()->line;
+        if (toks[pos].k != T_ID || toks[pos + 1].k != T_SYM || strcmp(toks[pos + 1].s, "=>"))
+            perr("named association (formal => actual)");
+        a->formal = expect_id()->s;
+        expect_sym("=>");
+        a->actual = expr();
+        *tail = a;
+        tail = &a->next;
+    } while (accept_sym(","));
+    expect_sym(")");
+    return head;
+}
+
+static struct cst *process_stmt(char *label) {
+    struct cst *c = vf_alloc(sizeof(*c));
+    c->k = C_PROC;
+    c->label = label;
+    c->line = tk()->line;
+    if (accept_sym("(")) {
+        do expect_id(); while (accept_sym(","));
+        expect_sym(")");
+    }
+    accept_kw("is");
+    if (decls() != NULL) perr("begin (declarations inside a process are unsupported)");
+    expect_kw("begin");
+    c->body = seq_list();
+    expect_kw("end");
+    expect_kw("process");
+    if (tk()->k == T_ID) pos++;
+    expect_sym(";");
+    return c;
+}
+
+static struct cst *conc_list(void);
+
+/* label : for I in L to R generate ... end generate [label];
+   label : if 条件 generate ... end generate [label];
+   宣言部を持つ generate（generate signal ... begin）は扱わない */
+static struct cst *generate_stmt(char *label) {
+    struct cst *c = vf_alloc(sizeof(*c));
+    c->label = label;
+    c->line = tk()->line;
+    if (label == NULL) perr("a label (generate needs one)");
+    if (accept_kw("for")) {
+        c->k = C_GEN_FOR;
+        c->gvar = expect_id()->s;
+        expect_kw("in");
+        c->l = expr();
+        if (accept_kw("downto")) c->downto = 1;
+        else expect_kw("to");
+        c->r = expr();
+    } else {
+        expect_kw("if");
+        c->k = C_GEN_IF;
+        c->cond = expr();
+    }
+    expect_kw("generate");
+    accept_kw("begin");
+    c->gbody = conc_list();
+    expect_kw("end");
+    expect_kw("generate");
+    if (tk()->k == T_ID) pos++;
+    expect_sym(";");
+    return c;
+}
+
+static struct cst *conc_list(void) {
+    struct cst *head = NULL, **tail = &head, *c;
+    char *label;
+
+    while (!is_kw("end")) {
+        label = NULL;
+        if (tk()->k == T_ID && toks[pos + 1].k == T_SYM && !strcmp(toks[pos + 1].s, ":")) {
+            label = expect_id()->orig;
+            pos++;
+        }
+        if (accept_kw("process")) {
+            c = process_stmt(label);
+        } else if (is_kw("for") || is_kw("if")) {
+            c = generate_stmt(label);
+        } else if (is_kw("entity") || is_kw("component") ||
+                   (label != NULL && tk()->k == T_ID && toks[pos + 1].k == T_ID &&
+                    (!strcmp(toks[pos + 1].s, "port") || !strcmp(toks[pos + 1].s, "generic")))) {
+            c = vf_alloc(sizeof(*c));
+            c->k = C_INST;
+            c->label = label;
+            c->line = tk()->line;
+            if (accept_kw("entity")) {
+                expect_id();            /* work */
+                expect_sym(".");
+            } else {
+                accept_kw("component");
+            }
+            c->ent = expect_id()->s;
+            if (accept_kw("generic")) {
+                expect_kw("map");
+                c->gmap = assoc_list();
+            }
+            expect_kw("port");
+            expect_kw("map");
+            c->pmap = assoc_list();
+            expect_sym(";");
+        } else {
+            /* 同時代入文：X <= A when C else B when D else E; */
+            struct node *v, *w, **vt;
+            c = vf_alloc(sizeof(*c));
+            c->k = C_ASSIGN;
+            c->label = label;
+            c->line = tk()->line;
+            c->tgt = name();
+            expect_sym("<=");
+            v = expr();
+            vt = &c->val;
+            while (accept_kw("when")) {
+                w = mk(N_WHEN);
+                w->a = v;
+                w->c = expr();
+                expect_kw("else");
+                *vt = w;
+                vt = &w->b;
+                v = expr();
+            }
+            *vt = v;
+            expect_sym(";");
+        }
+        *tail = c;
+        tail = &c->next;
+    }
+    return head;
+}
+
+void vf_parse_file(const char *path) {
+    FILE *fp = fopen(path, "rb");
+    long n;
+    char *src;
+
+    if (fp == NULL) vf_fatal("cannot open %s", path);
+    fseek(fp, 0, SEEK_END);
+    n = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    src = vf_alloc((size_t)n + 1);
+    if (fread(src, 1, (size_t)n, fp) != (size_t)n) vf_fatal("cannot read %s", path);
+    fclose(fp);
+
+    cur_file = vf_strdup(path);
+    ntok = pos = 0;
+    lex(src);
+    free(src);
+
+    while (tk()->k != T_EOF) {
+        if (accept_kw("library") || accept_kw("use")) {
+            skip_to_semi();
+        } else if (accept_kw("entity")) {
+            struct entity *e = vf_alloc(sizeof(*e));
+            struct tok *t = expect_id();
+            e->id = t->s;
+            e->orig = t->orig;
+            e->file = (char *)cur_file;
+            expect_kw("is");
+            if (accept_kw("generic")) e->generics = iface_list(1);
+            if (accept_kw("port")) e->ports = iface_list(0);
+            end_of("entity");
+            e->next = entities;
+            entities = e;
+        } else if (accept_kw("architecture")) {
+            struct arch *a = vf_alloc(sizeof(*a));
+            a->id = expect_id()->s;
+            expect_kw("of");
+            a->ent = expect_id()->s;
+            a->file = (char *)cur_file;
+            expect_kw("is");
+            a->decls = decls();
+            expect_kw("begin");
+            a->body = conc_list();
+            end_of("architecture");
+            a->next = archs;
+            archs = a;
+        } else if (accept_kw("package")) {
+            struct pkg *k = vf_alloc(sizeof(*k));
+            if (is_kw("body")) perr("package declaration (package body is unsupported)");
+            k->id = expect_id()->s;
+            k->file = (char *)cur_file;
+            expect_kw("is");
+            k->decls = decls();
+            end_of("package");
+            *pkg_tail = k;
+            pkg_tail = &k->next;
+        } else {
+            perr("entity, architecture or package");
+        }
+    }
+}
+
+/* ============================================================
+   エラボレーション
+   ============================================================ */
+enum { SY_SIG, SY_CONST, SY_TYPE, SY_CARR, SY_TEXT };
+
+struct rtype {
+    int w, is_int;
+    int len, alo;               // 配列型なら要素数と添字下限
+};
+
+struct sym {
+    char *id;
+    int k;
+    int idx;                    // SY_SIG: 信号番号 / SY_CARR: 定数配列番号
+    uint64_t val;               // SY_CONST
+    char *txt;                  // SY_TEXT（string の generic）
+    struct rtype t;
+    struct sym *next;
+};
+
+struct scope {
+    struct sym *syms;
+    const char *prefix;         // 生成する信号名の接頭辞（"C7__" など）
+    const char *file;
+};
+
+static struct vf_design *D;
+static int cap_sig, cap_proc, cap_carr, cap_name;
+static struct scope pkg_scope;                  // package の定数・型（全 entity から見える）
+
+#define GROW(arr, n, cap) do { \
+    if ((n) == (cap)) { \
+        (cap) = (cap) ? (cap) * 2 : 64; \
+        (arr) = realloc((arr), (size_t)(cap) * sizeof(*(arr))); \
+        if ((arr) == NULL) vf_fatal("out of memory"); \
+    } \
+} while (0)
+
+static struct sym *lookup_local(struct scope *sc, const char *id) {
+    struct sym *s;
+    for (s = sc->syms; s; s = s->next)
+        if (!strcmp(s->id, id)) return s;
+    return NULL;
+}
+
+/* entity の中で見つからなければ package を探す */
+static struct sym *lookup(struct scope *sc, const char *id) {
+    struct sym *s = lookup_local(sc, id);
+    if (s == NULL && sc != &pkg_scope) s = lookup_local(&pkg_scope, id);
+    return s;
+}
+
+static struct sym *define(struct scope *sc, const char *id, int k, int line) {
+    struct sym *s;
+    if (lookup_local(sc, id)) vf_fatal("%s:%d: '%s' is declared twice", sc->file, line, id);
+    s = vf_alloc(sizeof(*s));
+    s->id = (char *)id;
+    s->k = k;
+    s->next = sc->syms;
+    sc->syms = s;
+    return s;
+}
+
+static void add_name(const char *name, int sig) {
+    GROW(D->names, D->nname, cap_name);
+    D->names[D->nname].name = (char *)name;
+    D->names[D->nname].sig = sig;
+    D->nname++;
+}
+
+static int new_sig(const char *name, struct rtype t) {
+    struct vf_sig *s;
+    GROW(D->sigs, D->nsig, cap_sig);
+    s = &D->sigs[D->nsig];
+    memset(s, 0, sizeof(*s));
+    s->name = (char *)name;
+    s->w = t.w;
+    s->is_int = t.is_int;
+    s->len = t.len;
+    s->alo = t.alo;
+    s->driver = -1;
+    add_name(name, D->nsig);
+    return D->nsig++;
+}
+
+static int new_proc(const char *name, int clk, struct vf_rs *body) {
+    GROW(D->procs, D->nproc, cap_proc);
+    D->procs[D->nproc].name = (char *)name;
+    D->procs[D->nproc].clk = clk;
+    D->procs[D->nproc].body = body;
+    return D->nproc++;
+}
+
+static struct vf_rx *rx_new(int k, int w) {
+    struct vf_rx *r = vf_alloc(sizeof(*r));
+    r->k = k;
+    r->w = w;
+    return r;
+}
+
+static struct vf_rx *rx_const(uint64_t v, int w, int is_int) {
+    struct vf_rx *r = rx_new(RX_CONST, w);
+    r->val = is_int ? v : v & vf_mask(w);
+    r->is_int = is_int;
+    return r;
+}
+
+static struct vf_rx *resolve(struct scope *sc, struct node *n, int want);
+
+static uint64_t const_int(struct scope *sc, struct node *n) {
+    struct vf_rx *r = resolve(sc, n, 32);
+    if (r->k != RX_CONST) vf_fatal("%s:%d: expression must be static", sc->file, n->line);
+    return r->val;
+}
+
+static struct rtype rtype_of(struct scope *sc, struct ty *t) {
+    struct rtype rt = { 1, 0, 0, 0 };
+    struct sym *s;
+    switch (t->k) {
+    case TY_SL:
+        break;
+    case TY_VEC: {
+        int64_t l = (int64_t)const_int(sc, t->l), r = (int64_t)const_int(sc, t->r);
+        if (!t->downto || r != 0)
+            vf_fatal("%s:%d: only (N downto 0) vectors are supported", sc->file, t->line);
+        if (l < 0 || l >= 64)
+            vf_fatal("%s:%d: vector wider than 64 bits", sc->file, t->line);
+        rt.w = (int)l + 1;
+        break;
+    }
+    case TY_INT:
+        rt.w = 32;
+        rt.is_int = 1;
+        break;
+    case TY_NAME:
+        s = lookup(sc, t->id);
+        if (s == NULL || s->k != SY_TYPE) vf_fatal("%s:%d: unknown type '%s'", sc->file, t->line, t->id);
+        rt = s->t;
+        break;
+    }
+    return rt;
+}
+
+static int is_vec(const struct vf_rx *r) { return !r->is_int; }
+
+/* std_logic_unsigned の算術・比較の結果幅 */
+static int arith_width(struct vf_rx *a, struct vf_rx *b) {
+    if (a->is_int && b->is_int) return 32;
+    if (a->is_int) return b->w;
+    if (b->is_int) return a->w;
+    return a->w > b->w ? a->w : b->w;
+}
+
+static uint64_t fold_bin(int op, uint64_t a, uint64_t b, int w) {
+    uint64_t m = vf_mask(w);
+    switch (op) {
+    case OP_AND: return a & b;
+    case OP_OR: return a | b;
+    case OP_XOR: return a ^ b;
+    case OP_NAND: return ~(a & b) & m;
+    case OP_NOR: return ~(a | b) & m;
+    case OP_XNOR: return ~(a ^ b) & m;
+    case OP_EQ: return a == b;
+    case OP_NE: return a != b;
+    case OP_LT: return a < b;
+    case OP_LE: return a <= b;
+    case OP_GT: return a > b;
+    case OP_GE: return a >= b;
+    case OP_ADD: return (a + b) & m;
+    case OP_SUB: return (a - b) & m;
+    case OP_MUL: return (a * b) & m;
+    case OP_DIV: return b ? a / b : 0;
+    case OP_MOD: return b ? a % b : 0;
+    case OP_POW: { uint64_t p = 1; while (b--) p *= a; return p & m; }
+    }
+    return 0;
+}
+
+/* 信号 / 値 r に添字・スライスを適用する */
+static struct vf_rx *apply_index(struct scope *sc, struct vf_rx *base, struct node *arg, int line) {
+    struct vf_rx *r;
+    if (arg->next) vf_fatal("%s:%d: too many indices", sc->file, line);
+    if (base->is_int) vf_fatal("%s:%d: cannot index an integer", sc->file, line);
+    if (arg->k == N_RANGE) {
+        int64_t l = (int64_t)const_int(sc, arg->a), rr = (int64_t)const_int(sc, arg->b);
+        if (!arg->op) vf_fatal("%s:%d: use (h downto l) slices", sc->file, line);
+        if (rr < 0 || l < rr || l >= base->w)
+            vf_fatal("%s:%d: slice (%lld downto %lld) out of range", sc->file, line, (long long)l, (long long)rr);
+        if (base->k == RX_CONST) return rx_const(base->val >> rr, (int)(l - rr + 1), 0);
+        r = rx_new(RX_SLICE, (int)(l - rr + 1));
+        r->lo = (int)rr;
+        r->a = base;
+        return r;
+    }
+    r = resolve(sc, arg, 32);
+    if (r->k == RX_CONST) {
+        if (r->val >= (uint64_t)base->w) vf_fatal("%s:%d: bit index out of range", sc->file, line);
+        if (base->k == RX_CONST) return rx_const(base->val >> r->val, 1, 0);
+        {
+            struct vf_rx *s = rx_new(RX_SLICE, 1);
+            s->lo = (int)r->val;
+            s->a = base;
+            return s;
+        }
+    }
+    {
+        struct vf_rx *b = rx_new(RX_BIT, 1);
+        b->a = base;
+        b->b = r;
+        return b;
+    }
+}
+
+static struct vf_rx *resolve(struct scope *sc, struct node *n, int want) {
+    struct vf_rx *r, *a, *b;
+    struct sym *s;
+
+    switch (n->k) {
+    case N_INT:
+        return rx_const(n->v, 32, 1);
+    case N_CHR:
+        if (n->v == VF_CHR_OTHER) vf_fatal("%s:%d: unsupported std_logic value", sc->file, n->line);
+        return rx_const(n->v, 1, 0);
+    case N_STR: {
+        int w = (int)strlen(n->bits), i;
+        uint64_t v = 0;
+        if (w == 0 || w > 64) vf_fatal("%s:%d: bit string width %d", sc->file, n->line, w);
+        for (i = 0; i < w; i++) v = (v << 1) | (uint64_t)(n->bits[i] - '0');
+        return rx_const(v, w, 0);
+    }
+    case N_OTHERS:
+        a = resolve(sc, n->a, 1);
+        if (a->k != RX_CONST || a->w != 1 || want <= 0)
+            vf_fatal("%s:%d: (others => ...) needs a '0'/'1' and a known width", sc->file, n->line);
+        return rx_const(a->val ? vf_mask(want) : 0, want, 0);
+    case N_NAME:
+        s = lookup(sc, n->id);
+        if (s == NULL) vf_fatal("%s:%d: unknown name '%s'", sc->file, n->line, n->orig);
+        if (s->k == SY_CONST) return rx_const(s->val, s->t.w, s->t.is_int);
+        if (s->k != SY_SIG || s->t.len)
+            vf_fatal("%s:%d: '%s' cannot be used as a value", sc->file, n->line, n->orig);
+        r = rx_new(RX_SIG, s->t.w);
+        r->is_int = s->t.is_int;
+        r->sig = s->idx;
+        return r;
+    case N_CALL:
+        if (n->a->k == N_NAME) {
+            const char *f = n->a->id;
+            if (!strcmp(f, "conv_integer") || !strcmp(f, "to_integer")) {
+                a = resolve(sc, n->b, 0);
+                r = vf_alloc(sizeof(*r));
+                *r = *a;
+                r->is_int = 1;
+                return r;
+            }
+            if (!strcmp(f, "conv_std_logic_vector") || !strcmp(f, "to_unsigned")) {
+                int w;
+                if (n->b->next == NULL) vf_fatal("%s:%d: %s needs a width", sc->file, n->line, f);
+                a = resolve(sc, n->b, 0);
+                w = (int)const_int(sc, n->b->next);
+                if (w < 1 || w > 64) vf_fatal("%s:%d: bad width", sc->file, n->line);
+                if (a->k == RX_CONST) return rx_const(a->val, w, 0);
+                r = rx_new(RX_SLICE, w);
+                r->a = a;
+                return r;
+            }
+            if (!strcmp(f, "rising_edge"))
+                vf_fatal("%s:%d: rising_edge() outside a clocked process", sc->file, n->line);
+            s = lookup(sc, f);
+            if (s && (s->k == SY_CARR || (s->k == SY_SIG && s->t.len))) {
+                if (n->b->next || n->b->k == N_RANGE)
+                    vf_fatal("%s:%d: array '%s' needs a single index", sc->file, n->line, n->a->orig);
+                r = rx_new(s->k == SY_CARR ? RX_CARR : RX_ELEM, s->t.w);
+                r->sig = s->idx;
+                r->a = resolve(sc, n->b, 32);
+                if (s->k == SY_CARR && r->a->k == RX_CONST) {
+                    struct vf_carr *c = &D->carrs[s->idx];
+                    int64_t i = (int64_t)r->a->val - c->alo;
+                    if (i < 0 || i >= c->len) vf_fatal("%s:%d: index out of range", sc->file, n->line);
+                    return rx_const(c->v[i], c->w, 0);
+                }
+                return r;
+            }
+        }
+        return apply_index(sc, resolve(sc, n->a, 0), n->b, n->line);
+    case N_ATTR:
+        vf_fatal("%s:%d: attribute '%s' outside a clock edge", sc->file, n->line, n->id);
+        return NULL;
+    case N_UN:
+        a = resolve(sc, n->a, want);
+        if (n->op == OP_NOT) {
+            if (a->is_int) vf_fatal("%s:%d: 'not' of an integer", sc->file, n->line);
+            if (a->k == RX_CONST) return rx_const(~a->val, a->w, 0);
+            r = rx_new(RX_NOT, a->w);
+            r->a = a;
+            return r;
+        }
+        if (a->k == RX_CONST) return rx_const(a->is_int ? (uint64_t)(-(int64_t)a->val) : -a->val, a->w, a->is_int);
+        r = rx_new(RX_BIN, a->w);
+        r->op = OP_SUB;
+        r->is_int = a->is_int;
+        r->a = rx_const(0, a->w, a->is_int);
+        r->b = a;
+        return r;
+    case N_WHEN:
+        a = resolve(sc, n->a, want);
+        b = resolve(sc, n->b, want ? want : a->w);
+        r = rx_new(RX_MUX, a->w);
+        r->c = resolve(sc, n->c, 1);
+        if (r->c->w != 1 || r->c->is_int) vf_fatal("%s:%d: condition must be boolean", sc->file, n->line);
+        if (!a->is_int && !b->is_int && a->w != b->w)
+            vf_fatal("%s:%d: width mismatch in when/else (%d vs %d)", sc->file, n->line, a->w, b->w);
+        r->is_int = a->is_int && b->is_int;
+        r->w = a->is_int ? b->w : a->w;
+        r->a = a;
+        r->b = b;
+        if (r->c->k == RX_CONST) return r->c->val ? a : b;
+        return r;
+    case N_AGG:
+        vf_fatal("%s:%d: positional aggregate is only allowed for constant arrays", sc->file, n->line);
+        return NULL;
+    case N_OPEN:
+        vf_fatal("%s:%d: 'open' is only allowed in a port map", sc->file, n->line);
+        return NULL;
+    case N_RANGE:
+        vf_fatal("%s:%d: unexpected range", sc->file, n->line);
+        return NULL;
+    case N_TXT:
+        vf_fatal("%s:%d: a string is only allowed as a generic or a LOAD_ROM argument", sc->file, n->line);
+        return NULL;
+    }
+
+    /* N_BIN */
+    if (n->op == OP_CAT) {
+        a = resolve(sc, n->a, 0);
+        b = resolve(sc, n->b, 0);
+        if (a->is_int || b->is_int) vf_fatal("%s:%d: '&' of an integer", sc->file, n->line);
+        if (a->w + b->w > 64) vf_fatal("%s:%d: concatenation wider than 64 bits", sc->file, n->line);
+        if (a->k == RX_CONST && b->k == RX_CONST) return rx_const((a->val << b->w) | b->val, a->w + b->w, 0);
+        r = rx_new(RX_CAT, a->w + b->w);
+        r->a = a;
+        r->b = b;
+        return r;
+    }
+    a = resolve(sc, n->a, want);
+    b = resolve(sc, n->b, a->is_int ? want : a->w);
+    r = rx_new(RX_BIN, 1);
+    r->op = n->op;
+    r->a = a;
+    r->b = b;
+    switch (n->op) {
+    case OP_AND: case OP_OR: case OP_XOR: case OP_NAND: case OP_NOR: case OP_XNOR:
+        if (a->is_int || b->is_int || a->w != b->w)
+            vf_fatal("%s:%d: operands of a logical operator must have the same width (%d vs %d)",
+                     sc->file, n->line, a->w, b->w);
+        r->w = a->w;
+        break;
+    case OP_EQ: case OP_NE: case OP_LT: case OP_LE: case OP_GT: case OP_GE:
+        r->w = 1;
+        break;
+    case OP_POW:
+        if (!a->is_int || !b->is_int || a->k != RX_CONST || b->k != RX_CONST)
+            vf_fatal("%s:%d: '**' needs static integer operands", sc->file, n->line);
+        r->w = 32;
+        r->is_int = 1;
+        break;
+    case OP_MUL:
+        r->w = (is_vec(a) && is_vec(b)) ? a->w + b->w : arith_width(a, b);
+        if (r->w > 64) vf_fatal("%s:%d: product wider than 64 bits", sc->file, n->line);
+        r->is_int = a->is_int && b->is_int;
+        break;
+    default:
+        r->w = arith_width(a, b);
+        r->is_int = a->is_int && b->is_int;
+        break;
+    }
+    if (a->k == RX_CONST && b->k == RX_CONST)
+        return rx_const(fold_bin(n->op, a->val, b->val, r->is_int ? 64 : r->w), r->w, r->is_int);
+    return r;
+}
+
+/* --- 代入文の解決 --- */
+static int cur_proc;
+
+/* 信号 sig の bits（ビット位置のマスク）を cur_proc が駆動する。
+   for generate で C(i+1) <= ... のようにビットごとに別のプロセスから書くのは許し、
+   同じビットを2つのプロセスが書いたときだけ多重駆動とする。
+   プロセスは1つずつ作って解決するので、それまでのプロセスの分（dmask）と
+   現在のプロセスの分（dcur）に分けて持てば足りる。 */
+static void drive(struct scope *sc, int sig, uint64_t bits, int line) {
+    struct vf_sig *s = &D->sigs[sig];
+    if (s->dir == VF_IN)
+        vf_fatal("%s:%d: input port '%s' is driven", sc->file, line, s->name);
+    if (s->driver >= 0 && s->dproc != cur_proc) {
+        s->dmask |= s->dcur;
+        s->dcur = 0;
+    }
+    if (s->dmask & bits)
+        vf_fatal("%s:%d: '%s' has multiple drivers (%s and %s)", sc->file, line, s->name,
+                 D->procs[s->driver].name, D->procs[cur_proc].name);
+    if (s->driver < 0) s->driver = cur_proc;
+    s->dproc = cur_proc;
+    s->dcur |= bits;
+}
+
+static void check_width(struct scope *sc, int line, int tw, int tint, struct vf_rx *v) {
+    if (tint) return;
+    if (v->is_int) {
+        if (v->k != RX_CONST)
+            vf_fatal("%s:%d: integer assigned to a vector (use conv_std_logic_vector)", sc->file, line);
+        if (v->val > vf_mask(tw)) vf_fatal("%s:%d: constant does not fit in %d bits", sc->file, line, tw);
+        v->is_int = 0;
+        v->w = tw;
+        return;
+    }
+    if (v->w != tw) vf_fatal("%s:%d: width mismatch (target %d bits, value %d bits)", sc->file, line, tw, v->w);
+}
+
+static struct vf_rs *assign(struct scope *sc, struct node *tgt, struct node *val, int line) {
+    struct vf_rs *rs = vf_alloc(sizeof(*rs));
+    struct sym *s;
+    struct node *base = tgt->k == N_CALL ? tgt->a : tgt;
+
+    rs->k = RS_ASSIGN;
+    if (base->k != N_NAME) vf_fatal("%s:%d: unsupported assignment target", sc->file, line);
+    s = lookup(sc, base->id);
+    if (s == NULL || s->k != SY_SIG)
+        vf_fatal("%s:%d: '%s' is not a signal", sc->file, line, base->orig);
+    rs->sig = s->idx;
+
+    if (tgt->k == N_NAME) {
+        if (s->t.len) vf_fatal("%s:%d: whole-array assignment is unsupported", sc->file, line);
+        drive(sc, s->idx, ~(uint64_t)0, line);
+        rs->val = resolve(sc, val, s->t.w);
+        check_width(sc, line, s->t.w, s->t.is_int, rs->val);
+        return rs;
+    }
+    if (tgt->b->next) vf_fatal("%s:%d: too many indices", sc->file, line);
+    if (s->t.len) {
+        /* 配列要素への代入 RAM(i) <= x */
+        if (tgt->b->k == N_RANGE) vf_fatal("%s:%d: array slice assignment is unsupported", sc->file, line);
+        rs->idx = resolve(sc, tgt->b, 32);
+        /* 添字が定数なら要素ごとに駆動を分ける（for generate で A(I) <= ... を別々のプロセスから書く）。
+           dmask は 64bit なので、要素数がそれを超える配列と添字が変数のときは全体を駆動したことにする */
+        if (rs->idx->k == RX_CONST && s->t.len <= 64) {
+            int64_t e = (int64_t)rs->idx->val - s->t.alo;
+            if (e < 0 || e >= s->t.len) vf_fatal("%s:%d: array index out of range", sc->file, line);
+            drive(sc, s->idx, (uint64_t)1 << e, line);
+        } else {
+            drive(sc, s->idx, ~(uint64_t)0, line);
+        }
+        rs->val = resolve(sc, val, s->t.w);
+        check_width(sc, line, s->t.w, s->t.is_int, rs->val);
+        return rs;
+    }
+    if (tgt->b->k == N_RANGE) {
+        int64_t l = (int64_t)const_int(sc, tgt->b->a), r = (int64_t)const_int(sc, tgt->b->b);
+        if (!tgt->b->op || r < 0 || l < r || l >= s->t.w)
+            vf_fatal("%s:%d: bad slice in assignment target", sc->file, line);
+        rs->lo = (int)r;
+        rs->w = (int)(l - r + 1);
+        drive(sc, s->idx, vf_mask(rs->w) << rs->lo, line);
+    } else {
+        struct vf_rx *i = resolve(sc, tgt->b, 32);
+        if (i->k == RX_CONST) {
+            if (i->val >= (uint64_t)s->t.w) vf_fatal("%s:%d: bit index out of range", sc->file, line);
+            rs->lo = (int)i->val;
+            drive(sc, s->idx, (uint64_t)1 << rs->lo, line);
+        } else {
+            rs->idx = i;
+            drive(sc, s->idx, ~(uint64_t)0, line);  /* どのビットか静的に分からない */
+        }
+        rs->w = 1;
+    }
+    rs->val = resolve(sc, val, rs->w);
+    check_width(sc, line, rs->w, 0, rs->val);
+    return rs;
+}
+
+static struct vf_rs *stmts(struct scope *sc, struct sst *s);
+
+static struct vf_rs *stmt(struct scope *sc, struct sst *s) {
+    struct vf_rs *rs;
+    struct when *w;
+    struct vf_arm **tail;
+
+    switch (s->k) {
+    case S_ASSIGN:
+        return assign(sc, s->tgt, s->val, s->line);
+    case S_IF:
+        rs = vf_alloc(sizeof(*rs));
+        rs->k = RS_IF;
+        rs->cond = resolve(sc, s->cond, 1);
+        if (rs->cond->w != 1 || rs->cond->is_int)
+            vf_fatal("%s:%d: condition must be boolean", sc->file, s->line);
+        rs->then_s = stmts(sc, s->then_s);
+        rs->else_s = stmts(sc, s->else_s);
+        return rs;
+    default:
+        rs = vf_alloc(sizeof(*rs));
+        rs->k = RS_CASE;
+        rs->sel = resolve(sc, s->sel, 0);
+        tail = &rs->arms;
+        for (w = s->arms; w; w = w->next) {
+            struct vf_arm *a = vf_alloc(sizeof(*a));
+            struct node *c;
+            int i = 0;
+            a->others = w->others;
+            for (c = w->ch; c; c = c->next) a->nch++;
+            a->ch = vf_alloc(sizeof(uint64_t) * (size_t)(a->nch + 1));
+            for (c = w->ch; c; c = c->next) {
+                struct vf_rx *v = resolve(sc, c, rs->sel->w);
+                if (v->k != RX_CONST) vf_fatal("%s:%d: case choice must be static", sc->file, c->line);
+                if (!rs->sel->is_int && !v->is_int && v->w != rs->sel->w)
+                    vf_fatal("%s:%d: case choice width %d, selector %d", sc->file, c->line, v->w, rs->sel->w);
+                a->ch[i++] = v->val;
+            }
+            a->body = stmts(sc, w->body);
+            *tail = a;
+            tail = &a->next;
+        }
+        return rs;
+    }
+}
+
+static struct vf_rs *stmts(struct scope *sc, struct sst *s) {
+    struct vf_rs *head = NULL, **tail = &head;
+    for (; s; s = s->next) {
+        *tail = stmt(sc, s);
+        while (*tail) tail = &(*tail)->next;
+    }
+    return head;
+}
+
+/* クロックエッジ条件 CLK'event and CLK = '1' / rising_edge(CLK) なら信号番号を返す */
+static int edge_of(struct scope *sc, struct node *c) {
+    struct sym *s;
+    const char *id = NULL;
+    if (c->k == N_CALL && c->a->k == N_NAME && !strcmp(c->a->id, "rising_edge") && c->b->k == N_NAME) {
+        id = c->b->id;
+    } else if (c->k == N_BIN && c->op == OP_AND) {
+        struct node *e = c->a, *l = c->b, *t;
+        if (e->k != N_ATTR) { t = e; e = l; l = t; }
+        if (e->k == N_ATTR && !strcmp(e->id, "event") && e->a->k == N_NAME &&
+            l->k == N_BIN && l->op == OP_EQ && l->a->k == N_NAME && l->b->k == N_CHR &&
+            !strcmp(e->a->id, l->a->id)) {
+            if (l->b->v != 1) vf_fatal("%s:%d: falling edges are unsupported", sc->file, c->line);
+            id = e->a->id;
+        }
+    }
+    if (id == NULL) return -1;
+    s = lookup(sc, id);
+    if (s == NULL || s->k != SY_SIG || s->t.w != 1)
+        vf_fatal("%s:%d: clock '%s' is not a std_logic signal", sc->file, c->line, id);
+    return s->idx;
+}
+
+static int has_edge(struct scope *sc, struct sst *s) {
+    struct when *w;
+    for (; s; s = s->next) {
+        if (s->k == S_IF && (edge_of(sc, s->cond) >= 0 || has_edge(sc, s->then_s) || has_edge(sc, s->else_s)))
+            return 1;
+        if (s->k == S_CASE)
+            for (w = s->arms; w; w = w->next)
+                if (has_edge(sc, w->body)) return 1;
+    }
+    return 0;
+}
+
+static void elab_process(struct scope *sc, struct cst *c) {
+    char buf[32];
+    const char *pname;
+    int clk = -1;
+    struct sst *body = c->body;
+
+    if (c->label) pname = cat3(sc->prefix, c->label, "");
+    else {
+        sprintf(buf, "process@%d", c->line);
+        pname = cat3(sc->prefix, buf, "");
+    }
+    if (body && body->next == NULL && body->k == S_IF && (clk = edge_of(sc, body->cond)) >= 0) {
+        if (body->else_s) vf_fatal("%s:%d: 'else' after a clock edge is unsupported", sc->file, body->line);
+        body = body->then_s;
+    }
+    if (has_edge(sc, body))
+        vf_fatal("%s:%d: unsupported clocked process shape (asynchronous reset?)", sc->file, c->line);
+    cur_proc = new_proc(pname, clk, NULL);
+    if (clk >= 0) D->sigs[clk].is_clock = 1;
+    D->procs[cur_proc].body = stmts(sc, body);
+}
+
+/* 組合せ代入（同時代入文・ポートへの式接続）を1文のプロセスにする */
+static void elab_comb(struct scope *sc, const char *pname, struct node *tgt, struct node *val, int line) {
+    cur_proc = new_proc(pname, -1, NULL);
+    D->procs[cur_proc].body = assign(sc, tgt, val, line);
+}
+
+static struct entity *find_entity(const char *id) {
+    struct entity *e;
+    for (e = entities; e; e = e->next)
+        if (!strcmp(e->id, id)) return e;
+    return NULL;
+}
+
+static struct arch *find_arch(const char *ent) {
+    struct arch *a;
+    for (a = archs; a; a = a->next)     /* 後から読んだもの（リストの先頭）を優先 */
+        if (!strcmp(a->ent, ent)) return a;
+    return NULL;
+}
+
+/* string の値：文字列リテラルか、string の generic の名前 */
+static const char *const_txt(struct scope *sc, struct node *n) {
+    struct sym *s;
+    if (n->k == N_TXT) return n->id;
+    if (n->k == N_NAME && (s = lookup(sc, n->id)) != NULL && s->k == SY_TEXT) return s->txt;
+    vf_fatal("%s:%d: expected a string", sc->file, n->line);
+    return NULL;
+}
+
+/* constant MEM : MEMORY := LOAD_ROM(ROM_FILE, DEF);
+   fetch.vhd の LOAD_ROM と同じ規則でファイルを読む（本体は解析しないので、ここで同じことをする）。
+   - ファイル名が "" なら DEF（定数配列）をそのまま使う
+   - 1行に1語の16進。先頭の空白は飛ばし、16進でない文字で止まる。
+     16進の数字が1つもない行（空行・"--" などのコメント行）は読み飛ばす
+   - 書かれていない残りの語は 0。配列より長いファイルはエラー */
+static void load_rom(struct scope *sc, struct decl *d, struct vf_carr *c) {
+    struct node *a = d->init->b;
+    const char *fn;
+    struct sym *def;
+    FILE *fp;
+    char buf[256], *p;
+    int i = 0;
+
+    if (a == NULL || a->next == NULL || a->next->next != NULL)
+        vf_fatal("%s:%d: LOAD_ROM takes a file name and a default", sc->file, d->line);
+    fn = const_txt(sc, a);
+    if (fn[0] == 0) {
+        def = a->next->k == N_NAME ? lookup(sc, a->next->id) : NULL;
+        if (def == NULL || def->k != SY_CARR || D->carrs[def->idx].len != c->len || D->carrs[def->idx].w != c->w)
+            vf_fatal("%s:%d: the default of LOAD_ROM must be a constant of the same array type", sc->file, d->line);
+        memcpy(c->v, D->carrs[def->idx].v, sizeof(uint64_t) * (size_t)c->len);
+        return;
+    }
+    fp = fopen(fn, "r");
+    if (fp == NULL) vf_fatal("%s:%d: cannot open ROM file '%s'", sc->file, d->line, fn);
+    while (fgets(buf, sizeof(buf), fp)) {
+        uint64_t v = 0;
+        int nd = 0;
+        if (strchr(buf, '\n') == NULL) {       /* 長すぎる行は残りを捨てる */
+            int ch;
+            while ((ch = getc(fp)) != EOF && ch != '\n')
+                ;
+        }
+        for (p = buf; *p == ' ' || *p == '\t'; p++)
+            ;
+        for (; isxdigit((unsigned char)*p); p++, nd++)
+            v = ((v << 4) | (uint64_t)(isdigit((unsigned char)*p) ? *p - '0' : tolower((unsigned char)*p) - 'a' + 10)) & 0xffff;
+        if (nd == 0) continue;
+        if (i >= c->len) vf_fatal("%s: '%s' is longer than the ROM (%d words)", sc->file, fn, c->len);
+        c->v[i++] = v & vf_mask(c->w);
+    }
+    fclose(fp);
+}
+
+/* 定数配列 constant MEM : MEMORY := ( "...", "...", ... [, others => x] ); */
+static void elab_carr(struct scope *sc, struct decl *d, struct rtype t) {
+    struct vf_carr *c;
+    struct node *e;
+    int i = 0;
+
+    GROW(D->carrs, D->ncarr, cap_carr);
+    c = &D->carrs[D->ncarr];
+    c->name = cat3(sc->prefix, d->orig, "");
+    c->w = t.w;
+    c->len = t.len;
+    c->alo = t.alo;
+    c->v = vf_alloc(sizeof(uint64_t) * (size_t)t.len);
+    if (d->init->k == N_OTHERS) {
+        struct vf_rx *v = resolve(sc, d->init->a, t.w);
+        check_width(sc, d->line, t.w, t.is_int, v);
+        for (i = 0; i < t.len; i++) c->v[i] = v->val;
+    } else if (d->init->k == N_CALL && d->init->a->k == N_NAME && !strcmp(d->init->a->id, "load_rom")) {
+        load_rom(sc, d, c);
+    } else {
+        if (d->init->k != N_AGG) vf_fatal("%s:%d: constant array needs an aggregate", sc->file, d->line);
+        for (e = d->init->a; e; e = e->next) {
+            struct vf_rx *v;
+            if (e->k == N_OTHERS) {
+                /* (a, b, others => x)：残りを x で埋める */
+                v = resolve(sc, e->a, t.w);
+                if (v->k != RX_CONST) vf_fatal("%s:%d: element must be static", sc->file, e->line);
+                check_width(sc, e->line, t.w, t.is_int, v);
+                while (i < t.len) c->v[i++] = v->val;
+                break;
+            }
+            v = resolve(sc, e, t.w);
+            if (i >= t.len) vf_fatal("%s:%d: too many elements", sc->file, e->line);
+            if (v->k != RX_CONST) vf_fatal("%s:%d: element must be static", sc->file, e->line);
+            check_width(sc, e->line, t.w, t.is_int, v);
+            c->v[i++] = v->val;
+        }
+        if (i != t.len) vf_fatal("%s:%d: %d elements for an array of %d", sc->file, d->line, i, t.len);
+    }
+    define(sc, d->id, SY_CARR, d->line)->idx = D->ncarr;
+    lookup(sc, d->id)->t = t;
+    D->ncarr++;
+}
+
+static void elab_decls(struct scope *sc, struct decl *d) {
+    struct sym *s;
+    struct rtype t;
+
+    for (; d; d = d->next) {
+        switch (d->k) {
+        case D_SUBTYPE:
+            s = define(sc, d->id, SY_TYPE, d->line);
+            s->t = rtype_of(sc, d->ty);
+            break;
+        case D_ARRAY: {
+            int64_t l = (int64_t)const_int(sc, d->l), r = (int64_t)const_int(sc, d->r);
+            t = rtype_of(sc, d->ty);
+            if (t.len) vf_fatal("%s:%d: arrays of arrays are unsupported", sc->file, d->line);
+            if (d->downto) { int64_t x = l; l = r; r = x; }
+            if (r < l) vf_fatal("%s:%d: empty array range", sc->file, d->line);
+            t.len = (int)(r - l + 1);
+            t.alo = (int)l;
+            s = define(sc, d->id, SY_TYPE, d->line);
+            s->t = t;
+            break;
+        }
+        case D_ENUM: {
+            struct node *n;
+            int cnt = 0, w = 1;
+            for (n = d->lits; n; n = n->next) cnt++;
+            while ((1 << w) < cnt) w++;
+            s = define(sc, d->id, SY_TYPE, d->line);
+            s->t.w = w;
+            cnt = 0;
+            for (n = d->lits; n; n = n->next) {
+                s = define(sc, n->id, SY_CONST, d->line);
+                s->val = (uint64_t)cnt++;
+                s->t.w = w;
+            }
+            break;
+        }
+        case D_CONST:
+            t = rtype_of(sc, d->ty);
+            if (t.len) {
+                elab_carr(sc, d, t);
+            } else {
+                struct vf_rx *v = resolve(sc, d->init, t.w);
+                if (v->k != RX_CONST) vf_fatal("%s:%d: constant must be static", sc->file, d->line);
+                check_width(sc, d->line, t.w, t.is_int, v);
+                s = define(sc, d->id, SY_CONST, d->line);
+                s->val = v->val;
+                s->t = t;
+            }
+            break;
+        case D_SIG: {
+            int idx;
+            t = rtype_of(sc, d->ty);
+            idx = new_sig(cat3(sc->prefix, d->orig, ""), t);
+            s = define(sc, d->id, SY_SIG, d->line);
+            s->idx = idx;
+            s->t = t;
+            if (d->init) {
+                struct vf_rx *v;
+                if (t.len) {
+                    /* 配列は (others => (others => '0')) のような一律の初期値だけ */
+                    int i;
+                    if (d->init->k != N_OTHERS)
+                        vf_fatal("%s:%d: use (others => ...) to initialize a signal array", sc->file, d->line);
+                    v = resolve(sc, d->init->a, t.w);
+                    if (v->k != RX_CONST) vf_fatal("%s:%d: initial value must be static", sc->file, d->line);
+                    check_width(sc, d->line, t.w, t.is_int, v);
+                    D->sigs[idx].inits = vf_alloc(sizeof(uint64_t) * (size_t)t.len);
+                    for (i = 0; i < t.len; i++) D->sigs[idx].inits[i] = v->val;
+                } else {
+                    v = resolve(sc, d->init, t.w);
+                    if (v->k != RX_CONST) vf_fatal("%s:%d: initial value must be static", sc->file, d->line);
+                    check_width(sc, d->line, t.w, t.is_int, v);
+                    D->sigs[idx].init = v->val;
+                }
+            }
+            break;
+        }
+        }
+    }
+}
+
+static void elab_entity(struct entity *e, const char *prefix, struct scope *parent, struct cst *inst);
+
+static void elab_body(struct scope *sc, struct cst *c);
+
+/* generate を展開する。for はループ変数を integer の定数として積んだスコープで本体を回数分解決し、
+   if は条件が真のときだけ解決する。インスタンス・プロセスの名前には
+   "ラベル_i__"（if は "ラベル__"）を前に付けて、回ごとに別の名前にする。 */
+static void elab_generate(struct scope *sc, struct cst *c) {
+    struct scope g = *sc;
+    struct sym var;
+    char buf[64];
+
+    if (c->k == C_GEN_IF) {
+        struct vf_rx *v = resolve(sc, c->cond, 1);
+        if (v->k != RX_CONST || v->w != 1 || v->is_int)
+            vf_fatal("%s:%d: generate condition must be a static boolean", sc->file, c->line);
+        if (v->val) {
+            g.prefix = cat3(sc->prefix, c->label, "__");
+            elab_body(&g, c->gbody);
+        }
+        return;
+    }
+    {
+        int64_t l = (int64_t)(int32_t)const_int(sc, c->l), r = (int64_t)(int32_t)const_int(sc, c->r), i;
+        int64_t step = c->downto ? -1 : 1;
+        memset(&var, 0, sizeof(var));
+        var.id = c->gvar;
+        var.k = SY_CONST;
+        var.t.w = 32;
+        var.t.is_int = 1;
+        var.next = sc->syms;
+        for (i = l; c->downto ? i >= r : i <= r; i += step) {
+            var.val = (uint64_t)i;
+            g.syms = &var;
+            sprintf(buf, "_%lld__", (long long)i);
+            g.prefix = cat3(sc->prefix, c->label, buf);
+            elab_body(&g, c->gbody);
+        }
+    }
+}
+
+static void elab_body(struct scope *sc, struct cst *c) {
+    for (; c; c = c->next) {
+        if (c->k == C_GEN_FOR || c->k == C_GEN_IF) {
+            elab_generate(sc, c);
+        } else if (c->k == C_PROC) {
+            elab_process(sc, c);
+        } else if (c->k == C_ASSIGN) {
+            char buf[32];
+            sprintf(buf, "assign@%d", c->line);
+            elab_comb(sc, cat3(sc->prefix, c->label ? c->label : buf, ""), c->tgt, c->val, c->line);
+        } else {
+            struct entity *e = find_entity(c->ent);
+            if (e == NULL)
+                vf_fatal("%s:%d: entity '%s' (instance %s) not found", sc->file, c->line, c->ent, c->label);
+            elab_entity(e, cat3(sc->prefix, c->label, "__"), sc, c);
+        }
+    }
+}
+
+static void elab_entity(struct entity *e, const char *prefix, struct scope *parent, struct cst *inst) {
+    struct scope sc;
+    struct arch *a = find_arch(e->id);
+    struct port *p;
+    struct assoc *as;
+    struct sym *s;
+    struct rtype t;
+
+    if (a == NULL) vf_fatal("%s: no architecture for entity '%s'", e->file, e->orig);
+    memset(&sc, 0, sizeof(sc));
+    sc.prefix = prefix;
+    sc.file = a->file;
+
+    /* generic：インスタンス側の generic map が優先、なければ既定値 */
+    for (p = e->generics; p; p = p->next) {
+        struct node *v = p->init;
+        struct scope *vs = &sc;
+        if (inst)
+            for (as = inst->gmap; as; as = as->next)
+                if (!strcmp(as->formal, p->id)) { v = as->actual; vs = parent; }
+        if (v == NULL) vf_fatal("%s: generic '%s' of '%s' has no value", e->file, p->orig, e->orig);
+        if (p->ty->k == TY_TXT) {
+            /* string（ROM の初期化ファイル名など）：LOAD_ROM に渡すためだけに持つ */
+            s = define(&sc, p->id, SY_TEXT, p->line);
+            s->txt = (char *)const_txt(vs, v);
+            continue;
+        }
+        t = rtype_of(&sc, p->ty);
+        s = define(&sc, p->id, SY_CONST, p->line);
+        s->val = const_int(vs, v);
+        s->t = t;
+    }
+    if (inst)
+        for (as = inst->gmap; as; as = as->next)
+            if (lookup_local(&sc, as->formal) == NULL)
+                vf_fatal("%s:%d: '%s' has no generic '%s'", parent->file, as->line, e->orig, as->formal);
+
+    /* port：親の信号名がそのまま渡されたら別名、式なら新しい信号 + 組合せ代入 */
+    for (p = e->ports; p; p = p->next) {
+        struct node *act = NULL;
+        t = rtype_of(&sc, p->ty);
+        if (t.len) vf_fatal("%s: array port '%s' is unsupported", e->file, p->orig);
+        if (inst) {
+            for (as = inst->pmap; as; as = as->next)
+                if (!strcmp(as->formal, p->id)) act = as->actual;
+        }
+        s = define(&sc, p->id, SY_SIG, p->line);
+        s->t = t;
+        if (inst == NULL) {
+            s->idx = new_sig(cat3(prefix, p->orig, ""), t);
+            D->sigs[s->idx].dir = p->dir;
+            if (p->init && p->dir == VF_IN) D->sigs[s->idx].init = const_int(&sc, p->init);   // 外から駆動しなければ既定値
+            continue;
+        }
+        if (act && act->k == N_NAME) {
+            struct sym *ps = lookup(parent, act->id);
+            if (ps && ps->k == SY_SIG && !ps->t.len) {
+                if (ps->t.w != t.w || ps->t.is_int != t.is_int)
+                    vf_fatal("%s:%d: port '%s' of %s is %d bits, actual '%s' is %d bits",
+                             parent->file, inst->line, p->orig, inst->label, t.w, act->orig, ps->t.w);
+                s->idx = ps->idx;
+                add_name(cat3(prefix, p->orig, ""), ps->idx);
+                continue;
+            }
+        }
+        s->idx = new_sig(cat3(prefix, p->orig, ""), t);
+        if (p->init && p->dir == VF_IN) D->sigs[s->idx].init = const_int(&sc, p->init);
+        if (act == NULL || act->k == N_OPEN) {
+            if (p->dir == VF_IN && p->init == NULL)
+                vf_fatal("%s:%d: input '%s' of %s is not connected", parent->file, inst->line, p->orig, inst->label);
+            continue;
+        }
+        if (p->dir == VF_IN) {
+            /* 子の入力 <= 親の式（親のスコープで解決し、子の信号へ代入） */
+            struct sym tmp = *s;
+            struct node nn;
+            tmp.id = "\001port";
+            tmp.next = parent->syms;
+            parent->syms = &tmp;
+            memset(&nn, 0, sizeof(nn));
+            nn.k = N_NAME;
+            nn.id = tmp.id;
+            nn.orig = p->orig;
+            nn.line = inst->line;
+            elab_comb(parent, cat3(prefix, p->orig, "@port"), &nn, act, inst->line);
+            parent->syms = tmp.next;
+        } else {
+            /* 親の信号（のスライス）<= 子の出力 */
+            struct sym tmp = *s;
+            struct node nn;
+            tmp.id = "\001port";
+            tmp.next = parent->syms;
+            parent->syms = &tmp;
+            memset(&nn, 0, sizeof(nn));
+            nn.k = N_NAME;
+            nn.id = tmp.id;
+            nn.orig = p->orig;
+            nn.line = inst->line;
+            elab_comb(parent, cat3(prefix, p->orig, "@port"), act, &nn, inst->line);
+            parent->syms = tmp.next;
+        }
+    }
+    if (inst)
+        for (as = inst->pmap; as; as = as->next)
+            if (lookup_local(&sc, as->formal) == NULL)
+                vf_fatal("%s:%d: '%s' has no port '%s'", parent->file, as->line, e->orig, as->formal);
+
+    elab_decls(&sc, a->decls);
+    elab_body(&sc, a->body);
+}
+
+struct vf_design *vf_elaborate(const char *top) {
+    struct entity *e;
+    char *lt = vf_strdup(top);
+    for (char *c = lt; *c; c++) *c = (char)tolower((unsigned char)*c);
+    e = find_entity(lt);
+    if (e == NULL) vf_fatal("top entity '%s' not found", top);
+    D = vf_alloc(sizeof(*D));
+    D->top = e->orig;
+    for (struct pkg *k = pkgs; k; k = k->next) {
+        struct decl *d;
+        for (d = k->decls; d; d = d->next)
+            if (d->k == D_SIG) vf_fatal("%s:%d: signals in a package are unsupported", k->file, d->line);
+        pkg_scope.prefix = "";
+        pkg_scope.file = k->file;
+        elab_decls(&pkg_scope, k->decls);
+    }
+    elab_entity(e, "", NULL, NULL);
+    return D;
+}
+
+int vf_lookup(const struct vf_design *d, const char *hier_name) {
+    int i;
+    for (i = 0; i < d->nname; i++)
+        if (!strcasecmp(d->names[i].name, hier_name)) return d->names[i].sig;
+    return -1;
+}
@@ -0,0 +1,149 @@
+/*
+  vhdl_front.h（VHDL 合成サブセットのフロントエンド / 字句解析・構文解析・エラボレーション）
+
+  【役割】
+  - chapter05/06/08/09 の RTL が使っている「小さな合成サブセット」を読み込み、
+    階層（component + port map）を展開した“フラットな回路”に変換する。
+  - 出力は次の3種類だけで構成される中間表現（IR）である。
+      1) 信号（struct vf_sig）     : std_logic / std_logic_vector / integer / 配列
+      2) プロセス（struct vf_proc）: クロック同期プロセス or 組合せプロセス
+      3) 定数配列（struct vf_carr）: fetch.vhd の MEM のような ROM 定数
+  - バックエンド（vhdl2c.c など）はこの IR だけを見てコードを生成する。
+
+  【対応しているサブセット】
+  - entity（generic は integer のみ / port は in, out）
+  - architecture 内の signal / constant / type ... is array / subtype / component 宣言
+  - package 宣言部の constant / type / subtype（use work.xxx.all は読み飛ばし、全 entity から見える）
+  - process：
+      if (CLK'event and CLK = '1') then ... end if;   （または rising_edge(CLK)）
+    だけを本体に持つものをクロック同期プロセス、'event を含まないものを組合せプロセスとする
+  - 順序文：信号代入 / if-elsif-else / case-when（| で複数選択、others）/ null
+  - 同時代入文：X <= 式; と X <= A when 条件 else B;
+  - for ... generate / if ... generate（宣言部なし）。ビットごと（配列なら定数添字の要素ごと）に別のプロセスから駆動してよい
+  - 式：and or xor nand nor xnor not / = /= < <= > >= / + - * & / スライス・添字 /
+        conv_integer / (others => 'x') / ビット列 "0101", X"3F" / 文字 '0' '1' / 整数
+  - std_logic_unsigned の算術（符号なし、結果幅は長い方のオペランド幅）
+*/
+
+#ifndef VHDL_FRONT_H
+#define VHDL_FRONT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* --- 式（解決済み IR） --- */
+enum {
+    RX_CONST,       // 定数（val）
+    RX_SIG,         // 信号（sig）
+    RX_ELEM,        // 配列信号の要素 sig(a)
+    RX_CARR,        // 定数配列の要素 carr(a)
+    RX_SLICE,       // a(lo+w-1 downto lo)（静的スライス・静的ビット選択）
+    RX_BIT,         // a(b)（動的ビット選択）
+    RX_CAT,         // a & b
+    RX_NOT,         // not a
+    RX_BIN,         // a op b
+    RX_MUX          // a when c else b
+};
+
+enum {
+    OP_AND, OP_OR, OP_XOR, OP_NAND, OP_NOR, OP_XNOR,
+    OP_EQ, OP_NE, OP_LT, OP_LE, OP_GT, OP_GE,
+    OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_MOD, OP_CAT, OP_NOT, OP_NEG, OP_POW
+};
+
+struct vf_rx {
+    int k;                  // RX_*
+    int op;                 // RX_BIN の演算子（OP_*）
+    int w;                  // 結果のビット幅（integer は 32）
+    int is_int;             // integer 型として扱う値か（マスクしない）
+    int sig;                // RX_SIG/RX_ELEM: 信号番号、RX_CARR: 定数配列番号
+    int lo;                 // RX_SLICE: 最下位ビット位置
+    uint64_t val;           // RX_CONST: 値
+    struct vf_rx *a, *b, *c;
+};
+
+/* --- 信号 --- */
+struct vf_sig {
+    char *name;             // 階層名（例：C7__PC）
+    int w;                  // ビット幅（配列なら要素幅）
+    int is_int;             // integer 型
+    int len;                // 配列要素数（0 ならスカラ）
+    int alo;                // 配列添字の下限
+    uint64_t init;          // 初期値（スカラ）
+    uint64_t *inits;        // 初期値（配列、NULL なら全0）
+    int dir;                // トップのポートなら VF_IN / VF_OUT、それ以外は 0
+    int driver;             // 駆動するプロセス番号（-1: 未駆動。ビットごとに分けて駆動するなら最初のプロセス）
+    int dproc;              // 以下はフロントエンドの多重駆動の検査用：dcur を駆動しているプロセス
+    uint64_t dmask, dcur;   //   それまでのプロセスが駆動したビット / dproc が駆動しているビット（配列なら要素）
+    int is_clock;           // どこかのプロセスのクロックとして使われている
+};
+
+enum { VF_IN = 1, VF_OUT = 2 };
+
+/* --- 順序文 --- */
+enum { RS_ASSIGN, RS_IF, RS_CASE };
+
+struct vf_arm {
+    int others;             // when others
+    int nch;                // 選択肢の数
+    uint64_t *ch;           // 選択肢の値
+    struct vf_rs *body;
+    struct vf_arm *next;
+};
+
+struct vf_rs {
+    int k;                  // RS_*
+    /* RS_ASSIGN */
+    int sig;                // 代入先の信号
+    struct vf_rx *idx;      // 配列要素/動的ビット選択の添字（NULL ならなし）
+    int lo, w;              // 静的スライス代入なら最下位ビットと幅（w=0 なら全体）
+    struct vf_rx *val;      // 右辺
+    /* RS_IF */
+    struct vf_rx *cond;
+    struct vf_rs *then_s, *else_s;
+    /* RS_CASE */
+    struct vf_rx *sel;
+    struct vf_arm *arms;
+    struct vf_rs *next;
+};
+
+/* --- プロセス --- */
+struct vf_proc {
+    char *name;             // 診断用の名前（インスタンス階層 + ラベル）
+    int clk;                // クロック信号番号（-1 なら組合せプロセス）
+    struct vf_rs *body;
+};
+
+/* --- 定数配列（ROM） --- */
+struct vf_carr {
+    char *name;
+    int w, len, alo;
+    uint64_t *v;
+};
+
+/* --- 階層名 → 信号番号（別名を含む。プローブ指定に使う） --- */
+struct vf_name {
+    char *name;
+    int sig;
+};
+
+/* --- エラボレーション結果（フラットな回路） --- */
+struct vf_design {
+    char *top;
+    struct vf_sig  *sigs;  int nsig;
+    struct vf_proc *procs; int nproc;
+    struct vf_carr *carrs; int ncarr;
+    struct vf_name *names; int nname;
+};
+
+void vf_parse_file(const char *path);
+struct vf_design *vf_elaborate(const char *top);
+int vf_lookup(const struct vf_design *d, const char *hier_name);
+
+/* 共通ユーティリティ */
+void vf_fatal(const char *fmt, ...);
+void *vf_alloc(size_t n);
+char *vf_strdup(const char *s);
+uint64_t vf_mask(int w);
+
+#endif
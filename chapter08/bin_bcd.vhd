@@ -0,0 +1,133 @@
+-- bin_bcd.vhd（詳細コメント版：逐次型 double-dabble による 16bit 2進 → 10進5桁 変換）
+--
+-- 【このモジュールの目的】
+-- - cpu_dec.vhd で IO64_OUT（16bit）を 7セグの 10進5桁（万/千/百/十/一）に分解する回路。
+-- - 以前は bin_dec10000 → bin_dec1000 → bin_dec100 → bin_dec10 の4段を組合せ回路で直列につなぎ、
+--   「÷10000 の商と余り → 余りを ÷1000 → …」と割り算を4回重ねていた。
+--   割り算は比較と引き算の連鎖なので、4段つなぐと表示系の中で一番長い組合せ経路になり、
+--   同じ CLK で動く CPU コアの Fmax まで押さえてしまう。
+-- - ここでは割り算を使わず、double-dabble（shift-add-3）で1クロックに1bitずつ変換する。
+--   1クロックの論理は「4bit の比較と +3 を5桁ぶん並べる」＋「1bit シフト」だけなので、
+--   CPU コアの経路より十分短い。
+--
+-- 【double-dabble のアルゴリズム】
+-- - BCD（4bit×5桁＝20bit）と 2進値 SR を並べた1本のシフトレジスタを、左へ 16 回シフトする。
+-- - 各シフトの前に、BCD の各桁が 5 以上なら 3 を足す（shift-add-3）。
+--   左シフトは 2 倍なので、5 以上の桁は 2 倍すると 10 以上になって桁上がりが要る。
+--   先に 3 を足しておくと、2 倍したときに 16（4bit の桁上がり）= 10 + 6 となり、
+--   桁上がりが次の BCD 桁に入り、残りが 0〜9 に収まる。
+-- - 16 回シフトし終えたとき、BCD に 10進5桁が入っている（65535 でも万の位は 6 で 4bit に収まる）。
+--
+-- 【逐次型（1クロック 1bit）の動き】
+-- - CNT が 0〜15 を巡回し、毎クロック1回 shift-add-3 を行う。
+-- - CNT=15 のクロック（16回目のシフト）で
+--     - シフト結果を出力レジスタ DEC_OUT4..DEC_OUT0 に書き、DONE を1クロックだけ '1' にする
+--     - 同じクロックで次の入力 BIN_IN を SR に取り込み、BCD を 0 に戻す
+--   ので、変換は切れ目なく 16 クロックごとに1回終わる（スループット：16 クロックに1値）。
+-- - レイテンシ：BIN_IN を取り込んでから 16 クロック後に出力に出る。
+--   BIN_IN が変わってから出力に出るまでは、取り込み待ちを含めて最大 32 クロック。
+-- - 表示用なので、出力が遅れることは問題にならない（50MHz なら 32 クロックは 0.64μs）。
+--   IO64_OUT が 16 クロックより短い間隔で変わったときは、途中の値を飛ばして最新の値を表示する。
+--
+-- 【パイプライン型にしない理由】
+-- - 1bit ごとに段を分けたパイプライン型（16 段）なら毎クロック1値を変換できるが、
+--   段ごとに BCD と SR（36bit 程度）のレジスタが要り、表示のためには過剰である。
+-- - 逐次型はレジスタが BCD＋SR＋CNT＋出力の 60bit 程度で、論理も1段分だけで済む。
+
+
+library IEEE;
+use IEEE.std_logic_1164.all;
+use IEEE.std_logic_unsigned.all;
+
+-- ============================================================
+-- entity: 16bit 2進 → 10進5桁（BCD）
+-- ============================================================
+entity bin_bcd is
+    port
+    (
+        CLK      : in  std_logic;                          -- ベースクロック（CPU と同じ）
+        BIN_IN   : in  std_logic_vector(15 downto 0);      -- 変換する値（CNT=15 のクロックで取り込む）
+
+        DEC_OUT4 : out std_logic_vector(3 downto 0);       -- 万の位
+        DEC_OUT3 : out std_logic_vector(3 downto 0);       -- 千の位
+        DEC_OUT2 : out std_logic_vector(3 downto 0);       -- 百の位
+        DEC_OUT1 : out std_logic_vector(3 downto 0);       -- 十の位
+        DEC_OUT0 : out std_logic_vector(3 downto 0);       -- 一の位
+        DONE     : out std_logic                           -- DEC_OUTx を更新した次の1クロックだけ '1'
+    );
+end bin_bcd;
+
+-- ============================================================
+-- architecture RTL: 1クロックに1回 shift-add-3
+-- ============================================================
+architecture RTL of bin_bcd is
+
+    -- 変換中の値：BCD（5桁）と、まだシフトしていない 2進値
+    signal BCD  : std_logic_vector(19 downto 0) := (others => '0');
+    signal SR   : std_logic_vector(15 downto 0) := (others => '0');
+
+    -- シフト回数（0〜15 を巡回）
+    signal CNT  : std_logic_vector(3 downto 0) := "0000";
+
+    -- 各桁に shift-add-3 の補正（5 以上なら +3）をかけた値（ADJ0 が一の位）
+    signal ADJ0 : std_logic_vector(3 downto 0);
+    signal ADJ1 : std_logic_vector(3 downto 0);
+    signal ADJ2 : std_logic_vector(3 downto 0);
+    signal ADJ3 : std_logic_vector(3 downto 0);
+    signal ADJ4 : std_logic_vector(3 downto 0);
+
+    -- 補正した BCD を1bit シフトした値
+    signal NXT  : std_logic_vector(19 downto 0);
+
+    -- 出力レジスタ
+    signal DEC  : std_logic_vector(19 downto 0) := (others => '0');
+    signal DV   : std_logic := '0';
+
+begin
+
+    -- ========================================================
+    -- shift-add-3：桁ごとに独立した 4bit の比較と加算（桁の間に桁上がりの伝搬はない）
+    -- ========================================================
+    ADJ0 <= BCD(3 downto 0)   + "0011" when BCD(3 downto 0)   >= "0101" else BCD(3 downto 0);
+    ADJ1 <= BCD(7 downto 4)   + "0011" when BCD(7 downto 4)   >= "0101" else BCD(7 downto 4);
+    ADJ2 <= BCD(11 downto 8)  + "0011" when BCD(11 downto 8)  >= "0101" else BCD(11 downto 8);
+    ADJ3 <= BCD(15 downto 12) + "0011" when BCD(15 downto 12) >= "0101" else BCD(15 downto 12);
+    ADJ4 <= BCD(19 downto 16) + "0011" when BCD(19 downto 16) >= "0101" else BCD(19 downto 16);
+
+    -- 補正した BCD と SR を1本として左へ1bit シフト（SR の MSB が BCD の LSB に入る）
+    -- 万の位は最後のシフトの前でも 3 以下（65535 → 6）なので、ADJ4 の MSB は捨ててよい。
+    NXT <= ADJ4(2 downto 0) & ADJ3 & ADJ2 & ADJ1 & ADJ0 & SR(15);
+
+    -- ========================================================
+    -- 逐次制御：16 回シフトしたら出力して、次の値を取り込む
+    -- ========================================================
+    process(CLK)
+    begin
+        if (CLK'event and CLK = '1') then
+            if (CNT = "1111") then
+                DEC <= NXT;
+                DV  <= '1';
+                BCD <= (others => '0');
+                SR  <= BIN_IN;
+            else
+                DV  <= '0';
+                BCD <= NXT;
+                SR  <= SR(14 downto 0) & '0';
+            end if;
+            CNT <= CNT + 1;
+        end if;
+    end process;
+
+    DEC_OUT4 <= DEC(19 downto 16);
+    DEC_OUT3 <= DEC(15 downto 12);
+    DEC_OUT2 <= DEC(11 downto 8);
+    DEC_OUT1 <= DEC(7 downto 4);
+    DEC_OUT0 <= DEC(3 downto 0);
+    DONE     <= DV;
+
+end RTL;
+
+-- 【検証の観点】
+-- - 0〜65535 のすべての値で、DEC_OUT4..DEC_OUT0 が 10進の各桁に一致すること（bin_bcd_sim.vhd）。
+-- - DONE が 16 クロックごとに立ち、BIN_IN の変化から最大 32 クロックで出力に出ること。
+-- - 合成レポートで、bin_bcd の中の最長経路が CPU コアの最長経路より短いこと。
@@ -0,0 +1,193 @@
+-- bin_bcd_sim.vhd（詳細コメント版：bin_bcd のレイテンシ・スループットと全値の一致を確かめるテストベンチ）
+--
+-- 【このファイルの目的】
+-- - bin_bcd（逐次型 double-dabble）が
+--   1) 0〜65535 のすべての値を正しく 10進5桁に分解すること
+--   2) 16 クロックごとに1値を変換すること（スループット）
+--   3) BIN_IN が変わってから 32 クロック以内に出力に出ること（レイテンシ）
+--   を assert で確かめる。
+--
+-- 【検証のしかた】
+-- - 期待値は integer の割り算で作る（v / 10000 mod 10, v / 1000 mod 10, …）。
+--   回路の側は割り算を使わないので、別のアルゴリズムどうしの突き合わせになる。
+-- - 前半（レイテンシ）：DONE と関係ない半端なエッジで BIN_IN を 12345 に変え、
+--   HEX に相当する5桁が 1,2,3,4,5 になるまでのクロック数を数える。
+-- - 後半（スループットと全値）：DONE を見たエッジで BIN_IN を次の値に変える。
+--   bin_bcd は DONE を立てたエッジで BIN_IN を取り込むので、
+--   次に DONE を見たときの出力は「1つ前に DONE を見たときに BIN_IN に出していた値」の変換結果になる。
+--   DONE の間隔も数えて、16 クロックであることを確かめる。
+--
+-- 【使い方】
+-- - 解析順：bin_bcd.vhd → 本ファイル。トップは bin_bcd_sim。
+-- - 全値の走査は 65536 × 16 クロック（20ns 周期で約 21ms）かかる。
+--   短く済ませたいときは N_ALL を小さくする。
+
+
+library IEEE;
+use IEEE.std_logic_1164.all;
+use IEEE.std_logic_arith.all;
+use IEEE.std_logic_unsigned.all;
+
+entity bin_bcd_sim is
+end bin_bcd_sim;
+
+architecture SIM of bin_bcd_sim is
+
+    component bin_bcd
+        port
+        (
+            CLK      : in  std_logic;
+            BIN_IN   : in  std_logic_vector(15 downto 0);
+            DEC_OUT4 : out std_logic_vector(3 downto 0);
+            DEC_OUT3 : out std_logic_vector(3 downto 0);
+            DEC_OUT2 : out std_logic_vector(3 downto 0);
+            DEC_OUT1 : out std_logic_vector(3 downto 0);
+            DEC_OUT0 : out std_logic_vector(3 downto 0);
+            DONE     : out std_logic
+        );
+    end component;
+
+    constant CLK_PERIOD : time    := 20 ns;
+    constant N_ALL      : integer := 65536;     -- 全値の走査で変換する値の個数（0 から）
+    constant MAX_LAT    : integer := 32;        -- レイテンシの上限（取り込み待ち 16 ＋ 変換 16）
+    constant THRU       : integer := 16;        -- DONE の間隔
+
+    signal CLK      : std_logic := '0';
+    signal BIN_IN   : std_logic_vector(15 downto 0) := (others => '0');
+    signal DEC_OUT4 : std_logic_vector(3 downto 0);
+    signal DEC_OUT3 : std_logic_vector(3 downto 0);
+    signal DEC_OUT2 : std_logic_vector(3 downto 0);
+    signal DEC_OUT1 : std_logic_vector(3 downto 0);
+    signal DEC_OUT0 : std_logic_vector(3 downto 0);
+    signal DONE     : std_logic;
+
+    signal FINISHED : boolean := false;
+
+begin
+
+    C1 : bin_bcd
+        port map(
+            CLK      => CLK,
+            BIN_IN   => BIN_IN,
+            DEC_OUT4 => DEC_OUT4,
+            DEC_OUT3 => DEC_OUT3,
+            DEC_OUT2 => DEC_OUT2,
+            DEC_OUT1 => DEC_OUT1,
+            DEC_OUT0 => DEC_OUT0,
+            DONE     => DONE
+        );
+
+    -- ========================================================
+    -- クロック（FINISHED で止める）
+    -- ========================================================
+    process
+    begin
+        while (not FINISHED) loop
+            CLK <= '1';
+            wait for CLK_PERIOD / 2;
+            CLK <= '0';
+            wait for CLK_PERIOD / 2;
+        end loop;
+        wait;
+    end process;
+
+    -- ========================================================
+    -- 刺激と判定
+    -- ========================================================
+    process
+        variable k      : integer;
+        variable lat    : integer;
+        variable t0     : time;
+        variable gap    : integer;
+        variable exp_v  : integer;
+        variable n_err  : integer := 0;
+
+        -- 出力5桁が 10進の v に一致するか
+        impure function match(x : integer) return boolean is
+        begin
+            return conv_integer(DEC_OUT4) = (x / 10000) mod 10 and
+                   conv_integer(DEC_OUT3) = (x / 1000) mod 10 and
+                   conv_integer(DEC_OUT2) = (x / 100) mod 10 and
+                   conv_integer(DEC_OUT1) = (x / 10) mod 10 and
+                   conv_integer(DEC_OUT0) = x mod 10;
+        end function;
+
+    begin
+        -- ----------------------------------------------------
+        -- 前半：レイテンシ（DONE とずらしたエッジで入力を変える）
+        -- ----------------------------------------------------
+        for i in 1 to 21 loop                       -- 16 の倍数からずらす
+            wait until CLK'event and CLK = '1';
+        end loop;
+        -- 出力は立ち下がりで見る（立ち上がりで更新した値が確定している）
+        BIN_IN <= conv_std_logic_vector(12345, 16);
+        t0 := now;
+        loop
+            wait until CLK'event and CLK = '0';
+            lat := (now - t0) / CLK_PERIOD;         -- 入力を変えてから過ぎた立ち上がりの数
+            exit when match(12345) or lat > MAX_LAT;
+        end loop;
+        assert lat <= MAX_LAT
+            report "レイテンシが長すぎる: " & integer'image(lat) & " クロック"
+            severity error;
+        report "レイテンシ: " & integer'image(lat) & " クロック（上限 " & integer'image(MAX_LAT) & "）"
+            severity note;
+
+        -- ----------------------------------------------------
+        -- 後半：スループットと全値の一致
+        -- ----------------------------------------------------
+        -- DONE を見るまで進め、そこから1値ずつ入れ替える
+        loop
+            wait until CLK'event and CLK = '1';
+            exit when DONE = '1';
+        end loop;
+        BIN_IN <= conv_std_logic_vector(0, 16);
+        exp_v := -1;                                -- まだ 0 は取り込まれていない
+        k     := 0;
+        while (k <= N_ALL) loop
+            gap := 0;
+            loop
+                wait until CLK'event and CLK = '1';
+                gap := gap + 1;
+                exit when DONE = '1';
+            end loop;
+            assert gap = THRU
+                report "DONE の間隔が " & integer'image(gap) & " クロック（期待値 " & integer'image(THRU) & "）"
+                severity error;
+
+            if (exp_v >= 0 and not match(exp_v)) then
+                n_err := n_err + 1;
+                assert n_err > 10                   -- 最初の 10 個だけ表示する
+                    report "変換が違う: " & integer'image(exp_v) & " → " &
+                           integer'image(conv_integer(DEC_OUT4)) & integer'image(conv_integer(DEC_OUT3)) &
+                           integer'image(conv_integer(DEC_OUT2)) & integer'image(conv_integer(DEC_OUT1)) &
+                           integer'image(conv_integer(DEC_OUT0))
+                    severity error;
+            end if;
+
+            -- このエッジで取り込まれた値が、次の DONE の出力になる
+            exp_v := conv_integer(BIN_IN);
+            k     := k + 1;
+            if (k < N_ALL) then
+                BIN_IN <= conv_std_logic_vector(k, 16);
+            end if;
+        end loop;
+
+        assert n_err = 0
+            report integer'image(n_err) & " 個の値で変換が違う"
+            severity error;
+        if (n_err = 0) then
+            report "一致: " & integer'image(N_ALL) & " 個の値、スループット 1値 / " &
+                   integer'image(THRU) & " クロック"
+                severity note;
+        end if;
+
+        FINISHED <= true;
+        wait;
+    end process;
+
+end SIM;
+
+-- 【期待される結果】
+-- - レイテンシは入力を変えたエッジと CNT の関係で 17〜32 クロックになる（前半は 27 クロック）。
+-- - 全値で一致し、DONE は 16 クロックごとに立つ。
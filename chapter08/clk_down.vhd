@@ -1,7 +1,9 @@
 -- clk_down.vhd（詳細コメント版）
 --
 -- 【この回路の目的（CPU設計・FPGA観点）】
--- - 入力クロック CLK_IN を分周して、より遅いクロック CLK_OUT を作る回路である。
+-- - 入力クロック CLK_IN を分周して、2^21 クロックに1回だけ '1' になるクロックイネーブル CE_OUT を作る回路である。
+-- - 新しいクロックは作らない。遅く動かしたい回路は CLK_IN をそのままクロックにし、
+--   CE_OUT='1' のエッジだけ状態を更新する（単一クロックドメイン）。
 -- - FPGAボードの基準クロック（例：50MHz, 100MHz）は人間の目には速すぎるため、
 --   自作CPUの bring-up（動作確認）では、
 --   - 7セグ表示の変化を目視できる速度に落とす
@@ -14,35 +16,34 @@
 --
 --   たとえば COUNT(0) は毎クロックで 0/1 を反転するので、CLK_IN の 1/2 周波数になる。
 --   COUNT(1) は 1/4、COUNT(2) は 1/8 ……
---   つまり COUNT(n) を出力に選ぶと、CLK_IN を 2^(n+1) 分周したクロックが得られる。
+--   つまり COUNT(n) は、CLK_IN を 2^(n+1) 分周したトグル信号になる。
 --
--- - この設計では COUNT(20) を出力にしているため、分周比は 2^(21) である。
+-- - この設計では COUNT(20 downto 0) がすべて '1' のときに CE_OUT='1' にする。
+--   これは 2^21 クロックに1回、1クロック幅だけ立つパルスで、
+--   以前の CLK_OUT（COUNT(20) のトグル）の立ち上がりと同じ頻度になる。
 --
 -- 【周波数の例（イメージ）】
 -- - もし CLK_IN = 50MHz なら、
---     CLK_OUT = 50,000,000 / 2^21 ≒ 23.84 Hz
+--     CE_OUT の頻度 = 50,000,000 / 2^21 ≒ 23.84 Hz
 --   となり、LEDや7セグの更新を目で追えるレベルになる。
 --
 -- 【CPU設計観点での注意点（重要）】
--- - この方式で作る CLK_OUT は、厳密には “一般的なクロックネットワークに乗った高品質クロック”
---   ではなく、カウンタのビットを直接出しているだけの “分周トグル信号” である。
--- - FPGAでは、クロックはPLL/DCM/Clock Enable で扱うのが推奨であり、
+-- - 以前はカウンタのビット COUNT(20) をそのまま CLK_OUT として出し、CPU のクロックにしていた。
+--   これは “一般的なクロックネットワークに乗った高品質クロック” ではなく “分周トグル信号” であり、
 --   ロジックで生成したクロックを別ドメインとして配ると、
 --   - スキュー
 --   - タイミング制約の難化
 --   - 望まないグリッチの扱い
---   などが問題になる場合がある。
+--   などが問題になる。
+-- - FPGAでは、クロックはPLL/DCM/Clock Enable で扱うのが推奨なので、ここではクロックイネーブルを出す。
+--   CE_OUT はふつうのフリップフロップの出力ではなく COUNT の比較なので、
+--   受け側は必ず CLK_IN のエッジでだけ見ること（クロックとして使わない）。
 --
---   ただし「教育用途」「低速で動かす」「小規模で単純」な自作CPUのデモでは、
---   このような簡易分周器が使われることも多い。
---
--- 【より安全な代替（発展）】
--- - “新しいクロックを作る” のではなく、
---   1) COUNT(20) を Clock Enable（CE）として使い、
---   2) CPUは元のCLK_INで同期しつつ、CE=1の周期だけ状態更新する
---   という方式にすると、クロック品質の問題を避けられる（推奨）。
---
---   ただし、現状の回路は「分周原理の理解」と「目視デバッグ」には十分役立つ。
+-- 【CPU を遅く動かすとき】
+-- - CPU も CLK_IN で動かし、段イネーブルを CE_OUT で間引く。
+--   cpu15 では clk_gen の段の切り替え（PH の回転）を「CE_OUT='1' のときだけ」にしているので、
+--   各段のイネーブルも CE_OUT のエッジにしか立たなくなり、CPU 全体が 2^21 倍遅く進む。
+--   （clk_gen と cpu15 の CE 入力。chapter08 の cpu_dec.vhd が CE_OUT を cpu15 の CE につないでいる）
 
 
 library IEEE;
@@ -50,13 +51,13 @@ use IEEE.std_logic_1164.all;
 use IEEE.std_logic_unsigned.all;  -- COUNT <= COUNT + 1 のために加算演算を許可している（環境によっては非推奨）
 
 -- ============================================================
--- entity：入力クロックを受けて、分周したクロックを出力する
+-- entity：入力クロックを受けて、分周したクロックイネーブルを出力する
 -- ============================================================
 entity clk_down is
     port
     (
         CLK_IN  : in  std_logic;  -- 入力クロック（ボードの基準クロック等）
-        CLK_OUT : out std_logic   -- 出力クロック（低速化したクロック）
+        CE_OUT  : out std_logic   -- クロックイネーブル（2^21 クロックに1回、1クロック幅の '1'）
     );
 end clk_down;
 
@@ -70,7 +71,7 @@ architecture RTL of clk_down is
     -- 21bit幅（20 downto 0）なので、0〜2^21-1 までカウントしてオーバーフローする。
     -- 各ビットは入力クロックでトグルするため、
     -- COUNT(0) が 1/2、COUNT(1) が 1/4、…、COUNT(20) が 1/2^21 周波数を表す。
-    signal COUNT : std_logic_vector(20 downto 0);
+    signal COUNT : std_logic_vector(20 downto 0) := (others => '0');
 
 begin
 
@@ -91,11 +92,10 @@ begin
     -- --------------------------------------------------------
     -- 分周出力（組合せ代入）
     -- --------------------------------------------------------
-    -- COUNT(20) は 2^(20+1)=2^21 分周されたトグル信号。
-    -- このビットをそのまま CLK_OUT として外へ出す。
+    -- COUNT が全ビット '1'（2^21-1）のクロックだけ '1'。次のエッジで COUNT は 0 に戻る。
     --
-    -- CPUのデモでは、このCLK_OUTをCPUのCLKに入れることで
+    -- CPUのデモでは、このCE_OUTで CPU の状態更新を間引くことで
     -- 命令の進行や表示の更新を遅くして目視確認できる。
-    CLK_OUT <= COUNT(20);
+    CE_OUT <= '1' when COUNT = "111111111111111111111" else '0';
 
 end RTL;
@@ -1,12 +1,12 @@
 -- cpu_dec.vhd（詳細コメント版）
 --
 -- 【このモジュールの目的（CPUを“動かして見せる”ための周辺回路）】
--- - cpu15（15bit命令/16bitデータの簡易CPUコア）を実体化し、
+-- - cpu15（16bit命令/16bitデータの簡易CPUコア）を実体化し、
 --   CPUが外部に出力する IO64_OUT（16bit）を「人間が読める形」に変換して表示する。
 --
 --   具体的には：
 --   1) cpu15 から IO64_OUT_TP（16bit）を受け取る
---   2) 16bitの2進値を 10進の各桁（万/千/百/十/一）へ分解する（bin_dec10000,1000,100,10）
+--   2) 16bitの2進値を 10進の各桁（万/千/百/十/一）へ分解する（bin_bcd：逐次型 double-dabble）
 --   3) 各桁（0〜9）を 7セグ表示パターンへ変換する（dec_7seg）
 --   4) HEX4..HEX0（7seg×5桁）へ出力する
 --
@@ -21,6 +21,18 @@
 --   IO65_IN (外部入力) ─┐
 --                         ├→ cpu15 → IO64_OUT_TP(16bit) → 10進分解 → 7seg変換 → HEX4..HEX0
 --   RESET_N/CLK ─────────┘
+--   CLK → clk_down → CE_OUT（2^21 クロックに1回）→ cpu15 の CE
+--
+-- 【CPU を目で追える速さで動かす】
+-- - cpu15 も表示系も同じ CLK で動かし、cpu15 の CE に clk_down の CE_OUT をつなぐ。
+--   cpu15 の段が1つ進むのは CE_OUT='1' のエッジだけなので、50MHz なら1秒に約24段（約6命令）になる。
+-- - 表示系（bin_bcd）は毎エッジ動くので、IO64_OUT_TP が変われば次の段より前に HEX に出る。
+--
+-- 【10進分解を逐次型にした理由】
+-- - 以前は bin_dec10000 → bin_dec1000 → bin_dec100 → bin_dec10 の割り算4段を組合せ回路で直列につないでおり、
+--   表示系の中で一番長い経路として CPU と同じ CLK の Fmax を押さえていた。
+-- - bin_bcd は1クロックに1bit ずつ shift-add-3 で変換するので、1クロックの論理は短い。
+--   そのかわり、IO64_OUT_TP が変わってから HEX に出るまで最大 32 クロック遅れる（目では分からない）。
 --
 -- 【注意：本コード中の `IO65_IN and "0000001111111111"` について】
 -- - ここは “入力を下位10bitだけ有効にするマスク” の意図と推測できる。
@@ -28,7 +40,7 @@
 --   ライブラリ/ツールチェーンによっては型解釈が厳しくてエラーになる可能性がある。
 --   （このファイルでは std_logic_unsigned を use していないため特に注意）
 -- - 合成・シミュレーションの互換性を高めるなら、マスク定数を別signal/constantにして
-vv--   ビット幅を明示し、必要なら numeric_std を使って論理演算の意図を明確にすると良い。
+--   ビット幅を明示し、必要なら numeric_std を使って論理演算の意図を明確にすると良い。
 
 
 library IEEE;
@@ -66,6 +78,7 @@ architecture RTL of cpu_dec is
         port
         (
             CLK      : in  std_logic;
+            CE       : in  std_logic;                        -- '1' のエッジだけ CPU が進む
             RESET_N  : in  std_logic;
             IO65_IN  : in  std_logic_vector(15 downto 0);
             IO64_OUT : out std_logic_vector(15 downto 0)
@@ -73,52 +86,38 @@ architecture RTL of cpu_dec is
     end component;
 
     -- --------------------------------------------------------
-    -- 2進→10進桁分解ブロック群
-    --
-    -- ここでは “除算/剰余” を段階的に行うイメージ：
-    --  - bin_dec10000 : 入力 / 10000 の商（万の位）と余り
-    --  - bin_dec1000  : 余り / 1000  の商（千の位）と余り
-    --  - bin_dec100   : 余り / 100   の商（百の位）と余り
-    --  - bin_dec10    : 余り / 10    の商（十の位）と余り（=一の位）
-    --
-    -- CPU設計観点：
-    --  - CPU自体に “10進表示” 命令は普通入れない。
-    --    表示やデバッグのための変換は周辺回路に逃がすのが典型。
+    -- clk_down：2^21 クロックに1回だけ '1' になるクロックイネーブル（clk_down.vhd）
     -- --------------------------------------------------------
-
-    component bin_dec10000
-        port
-        (
-            BIN_IN    : in  std_logic_vector(15 downto 0);   -- 16bit入力
-            DEC_OUT4  : out std_logic_vector(3 downto 0);    -- 万の位（0〜9想定）
-            REMINDER4 : out std_logic_vector(13 downto 0)    -- 余り（0〜9999相当を入れるため14bit程度）
-        );
-    end component;
-
-    component bin_dec1000
+    component clk_down
         port
         (
-            BIN_IN3    : in  std_logic_vector(13 downto 0);   -- 前段余り
-            DEC_OUT3   : out std_logic_vector(3 downto 0);    -- 千の位
-            REMINDER3  : out std_logic_vector(9 downto 0)     -- 余り（0〜999相当）
+            CLK_IN  : in  std_logic;
+            CE_OUT  : out std_logic
         );
     end component;
 
-    component bin_dec100
-        port
-        (
-            BIN_IN2    : in  std_logic_vector(9 downto 0);    -- 前段余り
-            DEC_OUT2   : out std_logic_vector(3 downto 0);    -- 百の位
-            REMINDER2  : out std_logic_vector(6 downto 0)     -- 余り（0〜99相当）
-        );
-    end component;
-
-    component bin_dec10
+    -- --------------------------------------------------------
+    -- 2進→10進桁分解ブロック（bin_bcd.vhd）
+    --
+    -- 割り算を使わず、double-dabble（shift-add-3）で1クロックに1bitずつ変換する：
+    --  - 16 クロックで1値を変換し、終わるたびに次の BIN_IN を取り込む
+    --  - DEC_OUT4..DEC_OUT0 は出力レジスタ（変換が終わるまで前の値を保持）
+    --
+    -- CPU設計観点：
+    --  - CPU自体に “10進表示” 命令は普通入れない。
+    --    表示やデバッグのための変換は周辺回路に逃がすのが典型。
+    -- --------------------------------------------------------
+    component bin_bcd
         port
         (
-            BIN_IN1    : in  std_logic_vector(6 downto 0);    -- 前段余り
-            DEC_OUT1   : out std_logic_vector(3 downto 0);    -- 十の位
-            REMINDER1  : out std_logic_vector(3 downto 0)     -- 一の位（0〜9）
+            CLK      : in  std_logic;
+            BIN_IN   : in  std_logic_vector(15 downto 0);    -- 16bit入力
+            DEC_OUT4 : out std_logic_vector(3 downto 0);     -- 万の位
+            DEC_OUT3 : out std_logic_vector(3 downto 0);     -- 千の位
+            DEC_OUT2 : out std_logic_vector(3 downto 0);     -- 百の位
+            DEC_OUT1 : out std_logic_vector(3 downto 0);     -- 十の位
+            DEC_OUT0 : out std_logic_vector(3 downto 0);     -- 一の位
+            DONE     : out std_logic                         -- 変換完了（ここでは使わない）
         );
     end component;
 
@@ -134,9 +133,12 @@ architecture RTL of cpu_dec is
     end component;
 
     -- --------------------------------------------------------
-    -- 内部信号（CPU出力・10進各桁・余り伝搬）
+    -- 内部信号（CPU出力・10進各桁）
     -- --------------------------------------------------------
 
+    -- CPU を進めるエッジ（clk_down → cpu15）
+    signal CPU_CE      : std_logic;
+
     -- CPUからの生の16bit出力（後段の表示変換に入れる）
     signal IO64_OUT_TP : std_logic_vector(15 downto 0);
 
@@ -145,15 +147,19 @@ architecture RTL of cpu_dec is
     signal DEC_OUT3 : std_logic_vector(3 downto 0);  -- 千の位
     signal DEC_OUT2 : std_logic_vector(3 downto 0);  -- 百の位
     signal DEC_OUT1 : std_logic_vector(3 downto 0);  -- 十の位
-    signal DEC_OUT0 : std_logic_vector(3 downto 0);  -- 一の位（bin_dec10のREMINDER1を接続）
-
-    -- 段階除算の“余り”を伝搬する信号
-    signal REMINDER4 : std_logic_vector(13 downto 0); -- 0..9999相当
-    signal REMINDER3 : std_logic_vector(9 downto 0);  -- 0..999相当
-    signal REMINDER2 : std_logic_vector(6 downto 0);  -- 0..99相当
+    signal DEC_OUT0 : std_logic_vector(3 downto 0);  -- 一の位
 
 begin
 
+    -- ========================================================
+    -- 0) CPU を遅く動かすイネーブル
+    -- ========================================================
+    C0 : clk_down
+        port map(
+            CLK_IN => CLK,
+            CE_OUT => CPU_CE
+        );
+
     -- ========================================================
     -- 1) CPUコア（cpu15）を実体化
     -- ========================================================
@@ -165,6 +171,7 @@ begin
     C1 : cpu15
         port map(
             CLK      => CLK,
+            CE       => CPU_CE,
             RESET_N  => RESET_N,
 
             -- 入力マスク：上位6bitを0に落として下位10bitのみ通す意図
@@ -180,36 +187,17 @@ begin
     -- 2) 16bit値（IO64_OUT_TP）を10進各桁へ分解
     -- ========================================================
 
-    -- 万の位を取り出し、余り（0〜9999）を REMINDER4 に渡す
-    C2 : bin_dec10000
+    -- 5桁を同時に取り出す（16 クロックごとに IO64_OUT_TP を取り込んで変換する）
+    C2 : bin_bcd
         port map(
-            BIN_IN    => IO64_OUT_TP,
-            DEC_OUT4  => DEC_OUT4,
-            REMINDER4 => REMINDER4
-        );
-
-    -- 千の位を取り出し、余り（0〜999）を REMINDER3 に渡す
-    C3 : bin_dec1000
-        port map(
-            BIN_IN3    => REMINDER4,
-            DEC_OUT3   => DEC_OUT3,
-            REMINDER3  => REMINDER3
-        );
-
-    -- 百の位を取り出し、余り（0〜99）を REMINDER2 に渡す
-    C4 : bin_dec100
-        port map(
-            BIN_IN2    => REMINDER3,
-            DEC_OUT2   => DEC_OUT2,
-            REMINDER2  => REMINDER2
-        );
-
-    -- 十の位を取り出し、余り（=一の位）を DEC_OUT0 に渡す
-    C5 : bin_dec10
-        port map(
-            BIN_IN1    => REMINDER2,
-            DEC_OUT1   => DEC_OUT1,
-            REMINDER1  => DEC_OUT0
+            CLK      => CLK,
+            BIN_IN   => IO64_OUT_TP,
+            DEC_OUT4 => DEC_OUT4,
+            DEC_OUT3 => DEC_OUT3,
+            DEC_OUT2 => DEC_OUT2,
+            DEC_OUT1 => DEC_OUT1,
+            DEC_OUT0 => DEC_OUT0,
+            DONE     => open
         );
 
     -- ========================================================
@@ -260,7 +248,8 @@ begin
 end RTL;
 
 -- 【この設計をCPU bring-upに使うときの見方】
--- - cpu15 が ST 命令などで IO64_OUT_TP を更新すると、同時にこの周辺回路が10進分解して7セグへ表示する。
+-- - cpu15 が ST 命令などで IO64_OUT_TP を更新すると、最大 32 クロック後にこの周辺回路が10進分解して7セグへ表示する。
 -- - まずは波形で IO64_OUT_TP が期待値（例：55）になっていることを確認し、
+--   （cpu_dec のままだと CPU は 2^21 倍遅いので、波形で見るときは cpu15 単体を CE なしで動かす：cpu15_sim.vhd）
 --   次に HEX0..HEX4 が正しい数字を表示しているかを確認すると、
 --   “CPU側の問題” と “表示変換側の問題” を切り分けやすい。
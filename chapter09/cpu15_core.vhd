@@ -0,0 +1,330 @@
+-- cpu15_core.vhd（詳細コメント版：共有メモリにつなぐための cpu15 の1コア）
+-- =============================================================================
+-- 【このモジュールの位置づけ】
+-- - cpu15_rom_ram から「データメモリ（ram_dc_wb）」を外に出し、残り（段イネーブル / 命令ROM /
+--   デコード / レジスタファイル / 実行部）を1つのコアにまとめたもの。
+--   マルチコアのトップ cpu15_multi が、このコアを N_CORES 個並べて1つの共有メモリにつなぐ。
+-- - 命令ROM はコアごとに持つ（フェッチは他のコアと取り合わない）。
+--   cpu15_rom_ram の fetch_rom（Quartus のメガファンクション）は generic を持たず、中身は .mif で
+--   1つに決まるので、ここでは chapter06 の fetch（A_BITS=8、ROM_FILE から LOAD_ROM で初期化）を
+--   直接使う。シミュレーションでも合成でも、コアごとに ROM_FILE で中身を選べる。
+--
+-- 【メモリポート（コア → 共有メモリ）】
+-- - ram_dc_wb と同じく、DC で読み、WB で書く。番地の選び方（SP / レジスタ間接 / 命令の下位8bit）も同じ。
+--   そのときに「この段でメモリを使う」ことを要求として出す。
+--     M_RD  : DC で読む（LD/LDR/POP/RET/SWAP。exec が RAM_OUT を使う命令だけ）
+--     M_WR  : WB で書く（exec の RAM_WEN）
+--     M_BLK : WB でブロック転送を始める（exec の BLK_REQ）
+--   要求は PH（段）で修飾済みで、要求していない段では '0' になる。
+-- - SWAP は DC で読み WB で書く。M_LOCK='1' は「この読みから同じ命令の WB の書きまで、
+--   他のコアにメモリを使わせない」ことの要求で、SWAP の DC の読みと一緒に出す。
+-- - 共有メモリの調停で負けると WAIT='1' が返る。WAIT='1' の間、
+--     - 段の輪（PH）を止め、同じ段に留まる（次の CLK でもう一度要求する）
+--     - CE_DC / CE_WB を落とし、reg_file / decode / ID の取り込みを許可が出たエッジの1回だけにする
+--   FT/EX は要求を出さないので止まらない。EX で RAM_OUT を取り込むのは、読みの許可が出た
+--   DC の次の CLK であり、共有メモリの出力レジスタはそのエッジまで自分の読んだ値を保持している。
+-- - 段の輪は clk_gen と同じものを、WAIT で止められるようにしてここに持つ
+--   （1コアの SoC が使う clk_gen は変えない）。
+--
+-- 【コア番号（66/67 番地）】
+-- - 全コアが同じ ROM イメージを実行し、コア番号で仕事を分ける（SPMD）。
+--   LD/LDR で 66 番地を読むと CORE_ID、67 番地を読むと N_CORES が返る
+--   （エミュレータ chapter03 の cpu15.h の core_info と同じ）。
+-- - 読み出しは共有メモリにも要求するが、DC でこの番地だと分かったら ID_SEL を立て、
+--   EX に渡す RAM_OUT をコア内の定数に差し替える。スタック命令（POP/RET）は差し替えない。
+-- =============================================================================
+
+library IEEE;
+use IEEE.std_logic_1164.all;
+use IEEE.std_logic_arith.all;
+use IEEE.std_logic_unsigned.all;
+use work.cpu15_isa.all;
+
+entity cpu15_core is
+	generic(
+		CORE_ID  : integer := 0;                             -- 66 番地で読めるコア番号
+		N_CORES  : integer := 1;                             -- 67 番地で読めるコア数
+		ROM_FILE : string  := "fetch_rom.hex"                -- このコアの命令ROM の中身
+	);
+	port(
+		CLK      : in  std_logic;
+		RESET_N  : in  std_logic;
+
+		-- 共有メモリへの要求（段で修飾済み）と番地・データ
+		M_RD     : out std_logic;                            -- DC で読む
+		M_WR     : out std_logic;                            -- WB で書く
+		M_BLK    : out std_logic;                            -- WB でブロック転送を始める
+		M_LOCK   : out std_logic;                            -- この読みから WB の書きまでロックする（SWAP）
+		M_ADDR   : out std_logic_vector(7 downto 0);
+		M_DIN    : out std_logic_vector(15 downto 0);
+		M_DOUT   : in  std_logic_vector(15 downto 0);        -- 読んだ値（許可が出た DC の次の CLK から）
+		WAIT_IN  : in  std_logic;                            -- 要求が通らなかった（同じ段に留まる）
+
+		-- ブロック転送の引数と、転送中（自分が始めた転送のときだけ '1'）
+		BLK_FILL : out std_logic;
+		BLK_DST  : out std_logic_vector(7 downto 0);
+		BLK_SRC  : out std_logic_vector(15 downto 0);
+		BLK_N    : out std_logic_vector(7 downto 0);
+		BLK_BUSY : in  std_logic
+	);
+end cpu15_core;
+
+architecture RTL of cpu15_core is
+
+	-- 命令ROM（chapter06 の fetch。256語を ROM_FILE から初期化し、CE_FT のエッジで読む）
+	component fetch
+		generic(
+			A_BITS   : integer;
+			ROM_FILE : string
+		);
+		port(
+			CLK      : in  std_logic;
+			CE_FT    : in  std_logic;
+			P_COUNT  : in  std_logic_vector(7 downto 0);
+			PROM_OUT : out std_logic_vector(15 downto 0)
+		);
+	end component;
+
+	component decode
+		port(
+			CLK      : in  std_logic;
+			CE_DC    : in  std_logic;
+			PROM_OUT : in  std_logic_vector(15 downto 0);
+			OP_CODE  : out std_logic_vector(4 downto 0);
+			OP_CC    : out std_logic_vector(2 downto 0);
+			OP_DATA  : out std_logic_vector(7 downto 0)
+		);
+	end component;
+
+	component reg_file
+		generic(
+			N_BITS     : integer
+		);
+		port(
+			CLK        : in  std_logic;
+			CE_DC      : in  std_logic;
+			CE_WB      : in  std_logic;
+			RESET_N    : in  std_logic;
+			N_REG_A_IN : in  std_logic_vector(N_BITS - 1 downto 0);
+			N_REG_B_IN : in  std_logic_vector(N_BITS - 1 downto 0);
+			N_REG_A    : out std_logic_vector(N_BITS - 1 downto 0);
+			N_REG_B    : out std_logic_vector(N_BITS - 1 downto 0);
+			REG_A      : out std_logic_vector(15 downto 0);
+			REG_B      : out std_logic_vector(15 downto 0);
+			N_REG_C    : in  std_logic_vector(N_BITS - 1 downto 0);
+			REG_C      : out std_logic_vector(15 downto 0);
+			N_REG_W    : in  std_logic_vector(N_BITS - 1 downto 0);
+			REG_IN     : in  std_logic_vector(15 downto 0);
+			REG_WEN    : in  std_logic
+		);
+	end component;
+
+	component exec
+		port(
+			CLK      : in  std_logic;
+			CE_EX    : in  std_logic;
+			RESET_N  : in  std_logic;
+			OP_CODE  : in  std_logic_vector(4 downto 0);
+			OP_CC    : in  std_logic_vector(2 downto 0);
+			REG_A    : in  std_logic_vector(15 downto 0);
+			REG_B    : in  std_logic_vector(15 downto 0);
+			OP_DATA  : in  std_logic_vector(7 downto 0);
+			RAM_OUT  : in  std_logic_vector(15 downto 0);
+			P_COUNT  : out std_logic_vector(7 downto 0);
+			REG_IN   : out std_logic_vector(15 downto 0);
+			RAM_IN   : out std_logic_vector(15 downto 0);
+			REG_WEN  : out std_logic;
+			RAM_WEN  : out std_logic;
+			SP_OUT   : out std_logic_vector(7 downto 0);
+			REG_IN_B : out std_logic_vector(15 downto 0);
+			REG_WEN_B: out std_logic;
+			BLK_REQ  : out std_logic;
+			BLK_BUSY : in  std_logic
+		);
+	end component;
+
+	-- 段の輪（clk_gen と同じ。WAIT_IN='1' の間は止まる）
+	signal PH           : std_logic_vector(3 downto 0) := "0001";
+	signal CE_FT        : std_logic;
+	signal CE_DC        : std_logic;
+	signal CE_EX        : std_logic;
+	signal CE_WB        : std_logic;
+
+	signal P_COUNT      : std_logic_vector(7 downto 0);
+	signal PROM_OUT     : std_logic_vector(15 downto 0);
+	signal OP           : std_logic_vector(4 downto 0);      -- PROM_OUT(15 downto 11)
+	signal OP_CODE      : std_logic_vector(4 downto 0);
+	signal OP_CC        : std_logic_vector(2 downto 0);
+	signal OP_DATA      : std_logic_vector(7 downto 0);
+
+	signal N_REG_A      : std_logic_vector(2 downto 0);
+	signal N_REG_B      : std_logic_vector(2 downto 0);
+	signal REG_IN       : std_logic_vector(15 downto 0);
+	signal REG_A        : std_logic_vector(15 downto 0);
+	signal REG_B        : std_logic_vector(15 downto 0);
+	signal REG_WEN      : std_logic;
+	signal REG_IN_B     : std_logic_vector(15 downto 0);
+	signal REG_WEN_B    : std_logic;
+	signal N_REG_W      : std_logic_vector(2 downto 0);
+	signal REG_W        : std_logic_vector(15 downto 0);
+	signal REG_WE       : std_logic;
+	signal N_REG_C      : std_logic_vector(2 downto 0);
+	signal REG_C        : std_logic_vector(15 downto 0);
+
+	signal RAM_IN       : std_logic_vector(15 downto 0);
+	signal RAM_OUT      : std_logic_vector(15 downto 0);
+	signal RAM_WEN      : std_logic;
+	signal SP           : std_logic_vector(7 downto 0);
+	signal STACK_OP     : std_logic;
+	signal IND_OP       : std_logic;
+	signal LOAD_OP      : std_logic;                         -- LD/LDR（66/67 番地を差し替える命令）
+	signal ADDR         : std_logic_vector(7 downto 0);
+	signal BLK_REQ      : std_logic;
+
+	-- 66/67 番地の読み出し（"01" ならコア番号、"10" ならコア数を RAM_OUT に出す）
+	signal ID_SEL       : std_logic_vector(1 downto 0) := "00";
+
+begin
+
+	-- =========================================================================
+	-- (1) 段イネーブル：FT → DC → EX → WB。要求が通らなければ同じ段に留まる
+	-- =========================================================================
+	process(CLK)
+	begin
+		if (CLK'event and CLK = '1') then
+			if (WAIT_IN = '0') then
+				PH <= PH(2 downto 0) & PH(3);
+			end if;
+		end if;
+	end process;
+
+	CE_FT <= PH(0);
+	CE_DC <= PH(1) and not WAIT_IN;
+	CE_EX <= PH(2);
+	CE_WB <= PH(3) and not WAIT_IN;
+
+	-- =========================================================================
+	-- (2)〜(6) cpu15_rom_ram と同じ配線（ROM はコアごと）
+	-- =========================================================================
+	C2 : fetch
+		generic map(
+			A_BITS   => 8,
+			ROM_FILE => ROM_FILE
+		)
+		port map(
+			CLK      => CLK,
+			CE_FT    => CE_FT,
+			P_COUNT  => P_COUNT,
+			PROM_OUT => PROM_OUT
+		);
+
+	C3 : decode
+		port map(
+			CLK      => CLK,
+			CE_DC    => CE_DC,
+			PROM_OUT => PROM_OUT,
+			OP_CODE  => OP_CODE,
+			OP_CC    => OP_CC,
+			OP_DATA  => OP_DATA
+		);
+
+	C4 : reg_file
+		generic map(
+			N_BITS     => 3
+		)
+		port map(
+			CLK        => CLK,
+			CE_DC      => CE_DC,
+			CE_WB      => CE_WB,
+			RESET_N    => RESET_N,
+			N_REG_A_IN => PROM_OUT(10 downto 8),
+			N_REG_B_IN => PROM_OUT(7 downto 5),
+			N_REG_A    => N_REG_A,
+			N_REG_B    => N_REG_B,
+			REG_A      => REG_A,
+			REG_B      => REG_B,
+			N_REG_C    => N_REG_C,
+			REG_C      => REG_C,
+			N_REG_W    => N_REG_W,
+			REG_IN     => REG_W,
+			REG_WEN    => REG_WE
+		);
+
+	C6 : exec
+		port map(
+			CLK      => CLK,
+			CE_EX    => CE_EX,
+			RESET_N  => RESET_N,
+			OP_CODE  => OP_CODE,
+			OP_CC    => OP_CC,
+			REG_A    => REG_A,
+			REG_B    => REG_B,
+			OP_DATA  => OP_DATA,
+			RAM_OUT  => RAM_OUT,
+			P_COUNT  => P_COUNT,
+			REG_IN   => REG_IN,
+			RAM_IN   => RAM_IN,
+			REG_WEN  => REG_WEN,
+			RAM_WEN  => RAM_WEN,
+			SP_OUT   => SP,
+			REG_IN_B => REG_IN_B,
+			REG_WEN_B=> REG_WEN_B,
+			BLK_REQ  => BLK_REQ,
+			BLK_BUSY => BLK_BUSY
+		);
+
+	N_REG_W <= N_REG_B  when REG_WEN_B = '1' else N_REG_A;
+	REG_W   <= REG_IN_B when REG_WEN_B = '1' else REG_IN;
+	REG_WE  <= REG_WEN or REG_WEN_B;
+
+	-- =========================================================================
+	-- (7) メモリポート：番地の選び方は ram_dc_wb と同じ
+	-- =========================================================================
+	OP       <= PROM_OUT(15 downto 11);
+	STACK_OP <= '1' when OP = OP_CALL or OP = OP_RET or OP = OP_PUSH or OP = OP_POP else '0';
+	IND_OP   <= '1' when OP = OP_LDR or OP = OP_STR or OP = OP_SWAP else '0';
+	LOAD_OP  <= '1' when OP = OP_LD or OP = OP_LDR else '0';
+	N_REG_C  <= PROM_OUT(4 downto 2) when OP = OP_MCPY or OP = OP_MSET else
+	            PROM_OUT(7 downto 5);
+
+	ADDR <= SP                 when STACK_OP = '1' else
+	        REG_C(7 downto 0)  when IND_OP = '1' else
+	        PROM_OUT(7 downto 0);
+
+	-- 読み出しの要求は exec が RAM_OUT を使う命令だけにする（他の命令の DC で共有メモリを取り合わない）
+	M_RD   <= PH(1) when LOAD_OP = '1' or OP = OP_POP or OP = OP_RET or OP = OP_SWAP else '0';
+	M_LOCK <= PH(1) when OP = OP_SWAP else '0';
+	M_WR   <= PH(3) and RAM_WEN;
+	M_BLK  <= PH(3) and BLK_REQ;
+	M_ADDR <= ADDR;
+	M_DIN  <= RAM_IN;
+
+	BLK_FILL <= PROM_OUT(11);                               -- MCPY "11100" / MSET "11101"
+	BLK_DST  <= REG_A(7 downto 0);
+	BLK_SRC  <= REG_B;
+	BLK_N    <= REG_C(7 downto 0);
+
+	-- =========================================================================
+	-- (8) コア番号 / コア数（66/67 番地）
+	-- =========================================================================
+	-- 読みの許可が出た DC のエッジで番地を見ておき、EX が取り込む RAM_OUT を差し替える
+	process(CLK)
+	begin
+		if (CLK'event and CLK = '1') then
+			if (CE_DC = '1') then
+				if (LOAD_OP = '1' and ADDR = "01000010") then
+					ID_SEL <= "01";
+				elsif (LOAD_OP = '1' and ADDR = "01000011") then
+					ID_SEL <= "10";
+				else
+					ID_SEL <= "00";
+				end if;
+			end if;
+		end if;
+	end process;
+
+	RAM_OUT <= conv_std_logic_vector(CORE_ID, 16) when ID_SEL(0) = '1' else
+	           conv_std_logic_vector(N_CORES, 16) when ID_SEL(1) = '1' else
+	           M_DOUT;
+
+end RTL;
@@ -0,0 +1,340 @@
+-- cpu15_multi.vhd（詳細コメント版：共有データメモリを持つマルチコア cpu15 の SoC）
+-- =============================================================================
+-- 【このモジュールの位置づけ】
+-- - cpu15_rom_ram（1コア）のデータメモリを、N_CORES 個のコア（cpu15_core）で共有する SoC。
+--     コア      : cpu15_core を for generate で並べる。命令ROM はコアごとに持ち、
+--                 全コアが同じ ROM_FILE を実行する（コア番号は 66 番地、コア数は 67 番地で読める）
+--     共有メモリ: data_ram 1つ（256語・2ポート、64/65 番地の I/O を含む）と、
+--                 ram_dc_wb と同じブロック転送（MCPY/MSET）の回路1つ
+--     調停      : ラウンドロビン。1つの CLK でポートAを使えるのは1コアだけ
+-- - エミュレータ chapter03 の mcore.c と同じプログラム（CPU_emulator -p psum -o psum.hex）が動く。
+--   mcore はクォンタムごとに書き込みを交換するが、ここでは1語ごとに即座に見える。
+--
+-- 【調停（ラウンドロビン）】
+-- - 各コアはメモリを使う段（DC の読み、WB の書き・転送開始）で REQ を立てる（cpu15_core 参照）。
+-- - GNT は REQ のうち「前回許可したコア（LAST）より番号が大きいもの」の最下位ビット、
+--   なければ REQ 全体の最下位ビット。
+--     MASKED = REQ and not (LAST or (LAST - 1))       -- LAST より上のビットだけ残す
+--     GNT    = X and not (X - 1)                      -- X の最下位の '1' だけ残す
+--   LAST は許可したエッジで GNT に更新する。どのコアも、自分より前に許可された
+--   コアが一巡すれば必ず許可されるので、待ち続けることはない。
+-- - 許可されなかったコアには WAIT（= 要求 and not GNT）を返し、コアは同じ段に留まる。
+-- - GNT は one-hot なので、許可したコアの番号 GI を generate の連鎖（GI_C）で作り、
+--   番地・データ・転送の引数はコアごとの配列を GI で引いて選ぶ。
+--
+-- 【不可分な入れ替え（SWAP）】
+-- - SWAP は DC で読み、同じ命令の WB で書く。その間に別のコアが同じ番地を書くと
+--   入れ替えが不可分でなくなる（2つのコアが同時にロックを取れてしまう）。
+-- - そこで SWAP の読み（M_LOCK='1'）を許可したら LOCKED='1' にし、LK_OWN にそのコアの番号を取る。
+--   LOCKED の間は LK_OWN のコアの要求だけを調停に通し、その書き（WB）を許可したら LOCKED='0' に戻す
+--   （ロックした読みから書きまでのメモリ全体の read-modify-write）。
+--   リセット中はロックを取らない（exec が SWAP を実行せず、書きが来ないまま残るため）。
+-- - ロックの間に他のコアが待つのは、持ち主の EX と WB の2 CLK だけ。
+--
+-- 【ブロック転送（MCPY/MSET）】
+-- - 転送の回路は ram_dc_wb と同じ（読み段 BUSY / 書き段 W_V の2段、FWD による前方転送）。
+--   開始要求（WB の BLK_REQ）を許可したエッジで引数と OWNER（始めたコアの番号）を取り込む。
+-- - 転送中はポートAを書き段が使うので、どのコアにも許可を出さない（メモリ全体をロックする）。
+--   転送を始めたコアは exec が BLK_BUSY を見て PC を止めて待ち、他のコアはメモリを使う段で待つ。
+--   BLK_BUSY は OWNER のコアにだけ返す（他のコアの exec が止まらないように）。
+--
+-- 【IO】
+-- - IO64_OUT / IO65_IN は cpu15_rom_ram と同じ（上位6bit の反転、入力の下位10bit のマスク）。
+-- =============================================================================
+
+library IEEE;
+use IEEE.std_logic_1164.all;
+use IEEE.std_logic_arith.all;
+use IEEE.std_logic_unsigned.all;
+
+entity cpu15_multi is
+	generic(
+		N_CORES  : integer := 4;                             -- コア数（1〜8）
+		ROM_FILE : string  := "fetch_rom.hex"                -- 全コアの命令ROM の中身
+	);
+	port(
+		CLK        : in  std_logic;
+		RESET_N    : in  std_logic;
+		IO65_IN    : in  std_logic_vector(15 downto 0);
+		IO64_OUT   : out std_logic_vector(15 downto 0)
+	);
+end cpu15_multi;
+
+architecture RTL of cpu15_multi is
+
+	component cpu15_core
+		generic(
+			CORE_ID  : integer;
+			N_CORES  : integer;
+			ROM_FILE : string
+		);
+		port(
+			CLK      : in  std_logic;
+			RESET_N  : in  std_logic;
+			M_RD     : out std_logic;
+			M_WR     : out std_logic;
+			M_BLK    : out std_logic;
+			M_LOCK   : out std_logic;
+			M_ADDR   : out std_logic_vector(7 downto 0);
+			M_DIN    : out std_logic_vector(15 downto 0);
+			M_DOUT   : in  std_logic_vector(15 downto 0);
+			WAIT_IN  : in  std_logic;
+			BLK_FILL : out std_logic;
+			BLK_DST  : out std_logic_vector(7 downto 0);
+			BLK_SRC  : out std_logic_vector(15 downto 0);
+			BLK_N    : out std_logic_vector(7 downto 0);
+			BLK_BUSY : in  std_logic
+		);
+	end component;
+
+	component data_ram
+		generic(
+			A_BITS   : integer := 8
+		);
+		port(
+			CLK      : in  std_logic;
+			EN_A     : in  std_logic;
+			ADDR_A   : in  std_logic_vector(7 downto 0);
+			DIN_A    : in  std_logic_vector(15 downto 0);
+			WE_A     : in  std_logic;
+			DOUT_A   : out std_logic_vector(15 downto 0);
+			EN_B     : in  std_logic;
+			ADDR_B   : in  std_logic_vector(7 downto 0);
+			DIN_B    : in  std_logic_vector(15 downto 0);
+			WE_B     : in  std_logic;
+			DOUT_B   : out std_logic_vector(15 downto 0);
+			IO65_IN  : in  std_logic_vector(15 downto 0);
+			IO64_OUT : out std_logic_vector(15 downto 0)
+		);
+	end component;
+
+	-- コアごとの番地・データ・転送の引数（GI で引く）
+	type ADDRS is array (0 to N_CORES - 1) of std_logic_vector(7 downto 0);
+	type WORDS is array (0 to N_CORES - 1) of std_logic_vector(15 downto 0);
+	type IDXS  is array (0 to N_CORES) of std_logic_vector(2 downto 0);
+
+	constant NONE : std_logic_vector(N_CORES - 1 downto 0) := (others => '0');
+
+	-- コア → 調停（要求）
+	signal RD       : std_logic_vector(N_CORES - 1 downto 0);
+	signal WR       : std_logic_vector(N_CORES - 1 downto 0);
+	signal BLK      : std_logic_vector(N_CORES - 1 downto 0);
+	signal LOCK     : std_logic_vector(N_CORES - 1 downto 0);
+	signal M_ADDR   : ADDRS;
+	signal M_DIN    : WORDS;
+	signal B_FILL   : std_logic_vector(N_CORES - 1 downto 0);
+	signal B_DST    : ADDRS;
+	signal B_SRC    : WORDS;
+	signal B_N      : ADDRS;
+
+	-- 調停 → コア
+	signal WAIT_V   : std_logic_vector(N_CORES - 1 downto 0);
+	signal BUSY_V   : std_logic_vector(N_CORES - 1 downto 0);
+	signal RAM_OUT  : std_logic_vector(15 downto 0);        -- ポートAの読み出し値（全コア共通）
+
+	-- 調停（ラウンドロビン）
+	signal ANY_REQ  : std_logic_vector(N_CORES - 1 downto 0);
+	signal REQ      : std_logic_vector(N_CORES - 1 downto 0);
+	signal MASKED   : std_logic_vector(N_CORES - 1 downto 0);
+	signal PICK     : std_logic_vector(N_CORES - 1 downto 0);
+	signal GNT      : std_logic_vector(N_CORES - 1 downto 0);
+	signal LAST     : std_logic_vector(N_CORES - 1 downto 0) := (others => '0');
+	signal GI_C     : IDXS;
+	signal GI       : std_logic_vector(2 downto 0);         -- 許可したコアの番号
+	signal G_RD     : std_logic;                             -- 許可したのは読み / 書き / 転送開始
+	signal G_WR     : std_logic;
+	signal G_BLK    : std_logic;
+
+	-- SWAP のロック（LOCKED の間は LK_OWN のコアだけがメモリを使える）
+	signal LOCKED   : std_logic := '0';
+	signal LK_OWN   : std_logic_vector(2 downto 0) := "000";
+	signal LK_MASK  : std_logic_vector(N_CORES - 1 downto 0);
+
+	-- data_ram のポートA
+	signal ADDR_A   : std_logic_vector(7 downto 0);
+	signal DIN_A    : std_logic_vector(15 downto 0);
+	signal WE_A     : std_logic;
+	signal IO64_TMP : std_logic_vector(15 downto 0);
+
+	-- ブロック転送（ram_dc_wb と同じ）
+	signal BUSY     : std_logic := '0';
+	signal FILL     : std_logic;
+	signal DST      : std_logic_vector(7 downto 0);
+	signal SRC      : std_logic_vector(7 downto 0);
+	signal CNT      : std_logic_vector(7 downto 0);
+	signal VAL      : std_logic_vector(15 downto 0);
+	signal RD_SRC   : std_logic_vector(15 downto 0);
+	signal W_V      : std_logic := '0';
+	signal W_DST    : std_logic_vector(7 downto 0);
+	signal FWD      : std_logic := '0';
+	signal FWD_VAL  : std_logic_vector(15 downto 0);
+	signal BLK_WORD : std_logic_vector(15 downto 0);
+	signal OWNER    : std_logic_vector(2 downto 0) := "000"; -- 転送を始めたコア
+
+begin
+
+	-- =========================================================================
+	-- (1) コア
+	-- =========================================================================
+	CORES : for I in 0 to N_CORES - 1 generate
+		U : cpu15_core
+			generic map(
+				CORE_ID  => I,
+				N_CORES  => N_CORES,
+				ROM_FILE => ROM_FILE
+			)
+			port map(
+				CLK      => CLK,
+				RESET_N  => RESET_N,
+				M_RD     => RD(I),
+				M_WR     => WR(I),
+				M_BLK    => BLK(I),
+				M_LOCK   => LOCK(I),
+				M_ADDR   => M_ADDR(I),
+				M_DIN    => M_DIN(I),
+				M_DOUT   => RAM_OUT,
+				WAIT_IN  => WAIT_V(I),
+				BLK_FILL => B_FILL(I),
+				BLK_DST  => B_DST(I),
+				BLK_SRC  => B_SRC(I),
+				BLK_N    => B_N(I),
+				BLK_BUSY => BUSY_V(I)
+			);
+
+		-- 許可されなかった要求は待たせる（ロック中に締め出した要求も）。転送中は始めたコアにだけ BLK_BUSY を返す
+		WAIT_V(I) <= ANY_REQ(I) and not GNT(I);
+		LK_MASK(I) <= '1' when LOCKED = '0' or LK_OWN = conv_std_logic_vector(I, 3) else '0';
+		BUSY_V(I) <= (BUSY or W_V) when OWNER = conv_std_logic_vector(I, 3) else '0';
+
+		-- one-hot の GNT から番号を作る
+		GI_C(I + 1) <= conv_std_logic_vector(I, 3) when GNT(I) = '1' else GI_C(I);
+	end generate;
+
+	-- =========================================================================
+	-- (2) 調停（ラウンドロビン）。転送中はポートAを書き段が使うので誰にも許可しない
+	-- =========================================================================
+	ANY_REQ <= RD or WR or BLK;
+	REQ     <= ANY_REQ and LK_MASK;
+	MASKED <= REQ and not (LAST or (LAST - 1));
+	PICK   <= MASKED and not (MASKED - 1) when MASKED /= NONE else
+	          REQ and not (REQ - 1);
+	GNT    <= PICK when BUSY = '0' and W_V = '0' else NONE;
+
+	GI_C(0) <= "000";
+	GI      <= GI_C(N_CORES);
+	G_RD    <= '1' when GNT /= NONE and RD(conv_integer(GI)) = '1' else '0';
+	G_WR    <= '1' when GNT /= NONE and WR(conv_integer(GI)) = '1' else '0';
+	G_BLK   <= '1' when GNT /= NONE and BLK(conv_integer(GI)) = '1' else '0';
+
+	process(CLK)
+	begin
+		if (CLK'event and CLK = '1') then
+			if (GNT /= NONE) then
+				LAST <= GNT;
+			end if;
+
+			-- SWAP の読みを許可したらロックし、その持ち主の書きを許可したら外す
+			if (RESET_N = '0') then
+				LOCKED <= '0';
+			elsif (G_RD = '1' and LOCK(conv_integer(GI)) = '1') then
+				LOCKED <= '1';
+				LK_OWN <= GI;
+			elsif (G_WR = '1' and LOCKED = '1') then
+				LOCKED <= '0';
+			end if;
+		end if;
+	end process;
+
+	-- =========================================================================
+	-- (3) 共有メモリ本体（chapter06 の data_ram）
+	-- =========================================================================
+	-- ポートA は許可したコアの読み（EN_A）・書き（WE_A）と、転送の書き段。ポートB は転送の読み段。
+	ADDR_A <= W_DST    when W_V = '1' else M_ADDR(conv_integer(GI));
+	DIN_A  <= BLK_WORD when W_V = '1' else M_DIN(conv_integer(GI));
+	WE_A   <= '1'      when W_V = '1' else G_WR;
+
+	M0 : data_ram
+		generic map(
+			A_BITS   => 8
+		)
+		port map(
+			CLK      => CLK,
+			EN_A     => G_RD,
+			ADDR_A   => ADDR_A,
+			DIN_A    => DIN_A,
+			WE_A     => WE_A,
+			DOUT_A   => RAM_OUT,
+			EN_B     => BUSY,
+			ADDR_B   => SRC,
+			DIN_B    => "0000000000000000",
+			WE_B     => '0',
+			DOUT_B   => RD_SRC,
+			IO65_IN  => IO65_IN and "0000001111111111",
+			IO64_OUT => IO64_TMP
+		);
+
+	-- =========================================================================
+	-- (4) ブロック転送（ram_dc_wb と同じ。開始は許可した転送要求、引数は GI のコアから）
+	-- =========================================================================
+	BLK_WORD <= VAL     when FILL = '1' else
+	            FWD_VAL when FWD = '1' else
+	            RD_SRC;
+
+	process(CLK)
+	begin
+		if (CLK'event and CLK = '1') then
+			if (BUSY = '1') then
+				W_V   <= '1';
+				W_DST <= DST;
+				DST   <= DST + 1;
+				SRC   <= SRC + 1;
+				CNT   <= CNT - 1;
+				if (CNT = "00000001") then
+					BUSY <= '0';
+				end if;
+
+			elsif (G_BLK = '1') then
+				OWNER <= GI;
+				FILL  <= B_FILL(conv_integer(GI));
+				DST   <= B_DST(conv_integer(GI));
+				SRC   <= B_SRC(conv_integer(GI))(7 downto 0);
+				VAL   <= B_SRC(conv_integer(GI));
+				CNT   <= B_N(conv_integer(GI));
+				if (B_N(conv_integer(GI)) /= "00000000") then
+					BUSY <= '1';
+				end if;
+				W_V   <= '0';
+
+			else
+				W_V   <= '0';
+			end if;
+
+			if (W_V = '1' and W_DST = SRC) then
+				FWD     <= '1';
+				FWD_VAL <= BLK_WORD;
+			else
+				FWD     <= '0';
+			end if;
+		end if;
+	end process;
+
+	IO64_OUT <= IO64_TMP xor "1111110000000000";
+
+end RTL;
+
+-- ============================================================
+-- 追加の設計メモ
+-- ============================================================
+--
+-- (1) 読み出し値の受け渡し
+-- - data_ram のポートA は出力レジスタ付きなので、許可した DC のエッジで読んだ値は次の CLK に出る。
+--   そのコアの EX はちょうどその次のエッジで、それまでに DOUT_A を変える（EN_A='1' になる）のは
+--   同じエッジで許可された別のコアの読みだけなので、RAM_OUT を全コアで共有してよい。
+--
+-- (2) 整合性
+-- - メモリは1つでキャッシュもないので、書いた値は次の CLK から全コアに見える。
+--   同じ CLK に読みと書きは1つずつしか通らないので、アクセスは許可の順に並ぶ（逐次一貫）。
+--
+-- (3) 性能
+-- - コアは4段のうち最大2段でしかメモリを使わない。LD/ST の少ないループなら
+--   4コアでもほとんど待たない（テストベンチ cpu15_multi_sim が1コアと比べて表示する）。
@@ -0,0 +1,170 @@
+-- cpu15_multi_sim.vhd（詳細コメント版：マルチコア cpu15_multi で並列総和を動かすテストベンチ）
+--
+-- 【このファイルの目的】
+-- - cpu15_multi を 1コアと N_CORES コアの2つ並べ、同じ並列総和のプログラム（SPMD）を実行させる。
+--     各コアは 66/67 番地で自分の番号とコア数を読み、ram[128..255] を等分して 1..128 を並べて足す。
+--     部分和を ram[96 + id] に書いてフラグ ram[112 + id] を立て、
+--     コア 0 が他のコアのフラグを待って部分和を足し、合計 8256 を 64 番地（IO64）に書く。
+--   プログラムの中身はエミュレータ chapter03 の cpu15.h の cpu15_load_psum と同じ。
+-- - 両方の IO64_OUT が 8256 になることと、その時刻を確かめる。
+--   N_CORES コアのほうが早く終わるはずで、かかった CLK 数を並べて報告する。
+-- - TIMEOUT までに 8256 にならなければ error にする（調停で止まったまま、など）。
+-- - もう1つ N_CORES コアの cpu15_multi で SWAP のロックのプログラム（cpu15.h の cpu15_load_lock）を動かし、
+--   共有カウンタが N_CORES × 100 になることを確かめる。SWAP の読みから書きまでを
+--   調停がロックしていないと、2つのコアが同時にロックを取って +1 が消え、これより小さくなる。
+--
+-- 【使い方】
+-- - ROM イメージを作る：CPU_emulator -p psum -o psum.hex、CPU_emulator -p lock -o lock.hex（chapter03）
+-- - 解析順：cpu15_isa.vhd → fetch.vhd → decode / reg_file / exec
+--   （exec が使う chapter05 の half_adder / full_adder / adder_nbit を先に）→ data_ram.vhd
+--   → cpu15_core.vhd → cpu15_multi.vhd → 本ファイル。トップは cpu15_multi_sim。
+
+
+library IEEE;
+use IEEE.std_logic_1164.all;
+use IEEE.std_logic_unsigned.all;
+
+entity cpu15_multi_sim is
+end cpu15_multi_sim;
+
+architecture SIM of cpu15_multi_sim is
+
+    component cpu15_multi
+        generic(
+            N_CORES  : integer;
+            ROM_FILE : string
+        );
+        port(
+            CLK      : in  std_logic;
+            RESET_N  : in  std_logic;
+            IO65_IN  : in  std_logic_vector(15 downto 0);
+            IO64_OUT : out std_logic_vector(15 downto 0)
+        );
+    end component;
+
+    constant N_CORES  : integer := 4;
+    constant ROM_FILE : string  := "psum.hex";
+    constant LOCK_ROM : string  := "lock.hex";
+    constant PERIOD   : time    := 20 ns;
+    constant TIMEOUT  : time    := 1 ms;
+
+    -- 8256 を IO64_OUT に出したときの値（上位6bit は cpu15_multi が反転して出す）
+    constant EXPECT   : std_logic_vector(15 downto 0) := "0010000001000000" xor "1111110000000000";
+    constant LOCK_EXP : integer := N_CORES * 100;           -- lock.hex は各コア 100 回 +1 する
+
+    signal CLK       : std_logic;
+    signal RESET_N   : std_logic;
+    signal IO65_IN   : std_logic_vector(15 downto 0) := (others => '0');
+
+    signal IO64_ONE  : std_logic_vector(15 downto 0);
+    signal IO64_MUL  : std_logic_vector(15 downto 0);
+    signal IO64_LCK  : std_logic_vector(15 downto 0);
+
+begin
+
+    -- ========================================================
+    -- DUT：並列総和の1コアと N_CORES コア（ROM は同じ）、ロックの N_CORES コア
+    -- ========================================================
+    U_ONE : cpu15_multi
+        generic map(N_CORES => 1, ROM_FILE => ROM_FILE)
+        port map(
+            CLK      => CLK,
+            RESET_N  => RESET_N,
+            IO65_IN  => IO65_IN,
+            IO64_OUT => IO64_ONE
+        );
+
+    U_MUL : cpu15_multi
+        generic map(N_CORES => N_CORES, ROM_FILE => ROM_FILE)
+        port map(
+            CLK      => CLK,
+            RESET_N  => RESET_N,
+            IO65_IN  => IO65_IN,
+            IO64_OUT => IO64_MUL
+        );
+
+    U_LCK : cpu15_multi
+        generic map(N_CORES => N_CORES, ROM_FILE => LOCK_ROM)
+        port map(
+            CLK      => CLK,
+            RESET_N  => RESET_N,
+            IO65_IN  => IO65_IN,
+            IO64_OUT => IO64_LCK
+        );
+
+    -- ========================================================
+    -- テスト刺激（cpu15_sim.vhd と同じ）
+    -- ========================================================
+    process
+    begin
+        CLK <= '1';
+        wait for PERIOD / 2;
+        CLK <= '0';
+        wait for PERIOD / 2;
+    end process;
+
+    process
+    begin
+        RESET_N <= '0';
+        wait for 100 ns;
+        RESET_N <= '1';
+        wait;
+    end process;
+
+    -- ========================================================
+    -- 判定：両方が 8256 を出し、ロックのカウンタが LOCK_EXP になるまで待つ
+    -- ========================================================
+    process
+        variable t_one, t_mul, t_lck : time := 0 ns;
+    begin
+        wait until RESET_N = '1';
+
+        while (t_one = 0 ns or t_mul = 0 ns or t_lck = 0 ns) and now < TIMEOUT loop
+            wait until rising_edge(CLK);
+            if (t_one = 0 ns and IO64_ONE = EXPECT) then
+                t_one := now;
+            end if;
+            if (t_mul = 0 ns and IO64_MUL = EXPECT) then
+                t_mul := now;
+            end if;
+            if (t_lck = 0 ns and conv_integer(IO64_LCK xor "1111110000000000") = LOCK_EXP) then
+                t_lck := now;
+            end if;
+        end loop;
+
+        assert t_one /= 0 ns
+            report "1コア: IO64_OUT が 8256 にならない（" & integer'image(conv_integer(IO64_ONE)) & "）"
+            severity error;
+        assert t_mul /= 0 ns
+            report integer'image(N_CORES) & "コア: IO64_OUT が 8256 にならない（" &
+                   integer'image(conv_integer(IO64_MUL)) & "）"
+            severity error;
+
+        assert t_lck /= 0 ns
+            report "ロック: カウンタが " & integer'image(LOCK_EXP) & " にならない（" &
+                   integer'image(conv_integer(IO64_LCK xor "1111110000000000")) & "）"
+            severity error;
+        if (t_lck /= 0 ns) then
+            report "ロック: " & integer'image(N_CORES) & "コアで " & integer'image(LOCK_EXP) & " 回の +1 が消えずに残った（" &
+                   integer'image((t_lck - 100 ns) / PERIOD) & " CLK）"
+                severity note;
+        end if;
+
+        if (t_one /= 0 ns and t_mul /= 0 ns) then
+            report "合計 8256。1コア " & integer'image((t_one - 100 ns) / PERIOD) & " CLK、" &
+                   integer'image(N_CORES) & "コア " & integer'image((t_mul - 100 ns) / PERIOD) & " CLK"
+                severity note;
+        end if;
+
+        wait;
+    end process;
+
+end SIM;
+
+-- 【期待される結果】
+-- - 「合計 8256。1コア 約4700 CLK、4コア 約1400 CLK」の note が出る
+--   （vhdl2c で cpu15_multi を変換したモデルでは、リセット解除から 1コア 4806、4コア 1474 CLK）。
+-- - 4コアで約3.3倍速い。各コアの仕事（データを並べて足す）は 1/4 になるが、
+--   最初に 66/67 番地を読んで区間を求める部分と、コア 0 が部分和を集める部分は減らない。
+-- - 「ロック: 4コアで 400 回の +1 が消えずに残った（約20000 CLK）」の note が出る（vhdl2c では 20455 CLK）。
+--   ロックは1つなので +1 は1コアずつしか進まず、取り合う分だけ1コアで 100 回（4466 CLK）より遅い。
@@ -9,14 +9,14 @@
 -- 重要なのは「各ブロックのアルゴリズムが、段（FT/DC/EX/WB）でどう連携するか」。
 -- ここでは以下の“マイクロアーキテクチャの流れ”が実体配線として表れている：
 --
---   (1) clk_gen が 1つの外部CLKから、4段の段クロックを順に生成
+--   (1) clk_gen が 1つの外部CLKから、4段の段イネーブルを順に生成（全ブロックは CLK だけで動く）
 --   (2) Fetch（FT）: fetch_rom が PC(P_COUNT) を使って命令語 PROM_OUT を出す
 --   (3) Decode（DC）: decode が PROM_OUT を OP_CODE / OP_DATA に分解
---   (4) Operand Read（DC）: reg_dc が命令に指定されたレジスタ番号から REG_A/REG_B を読み出す
+--   (4) Operand Read（DC）: reg_file が命令に指定されたレジスタ番号から REG_A/REG_B を読み出す
 --   (5) Execute（EX）: exec が OP_CODE, REG_A, REG_B, OP_DATA, RAM_OUT を使って
 --                     次PC / 書き戻し値 / RAM書込値 / 書込イネーブルを決める
 --   (6) Write Back（WB）:
---       - reg_wb が REG_WEN に従って REG_IN をレジスタファイルに反映
+--       - reg_file が REG_WEN に従って REG_IN をレジスタファイルに反映
 --       - ram_dc_wb が RAM_WEN に従って RAM_IN をRAMまたはIOへ反映
 --
 -- つまり「制御（OP_CODE/OP_DATA）とデータパス（REG/RAM）の結線」を見れば、
@@ -26,10 +26,11 @@
 library IEEE;
 use IEEE.std_logic_1164.all;
 use IEEE.std_logic_unsigned.all;
+use work.cpu15_isa.all;
 
 -- =============================================================================
 -- 入出力（外部から見たCPU）
-vv-- =============================================================================
+-- =============================================================================
 entity cpu15_rom_ram is
 	port(
 		CLK        : in  std_logic;                         -- 外部クロック（基準クロック）
@@ -46,7 +47,8 @@ architecture RTL of cpu15_rom_ram is
 	-- =========================================================================
 
 	-- clk_gen:
-	-- 1つの外部CLKから、FT/DC/EX/WBの4段クロックを順番に1パルスずつ立てる。
+	-- 1つの外部CLKから、FT/DC/EX/WBの4段イネーブルを順番に1エッジずつ立てる。
+	-- クロックは CLK の1本だけで、各ブロックは自分の段のイネーブルが '1' のエッジだけ動く。
 	-- 自作CPU観点では「段を時間分割している」ので、
 	--   - 配線の分かりやすさ
 	--   - 教材としての追跡しやすさ
@@ -54,54 +56,69 @@ architecture RTL of cpu15_rom_ram is
 	component clk_gen
 		port(
 			CLK     : in  std_logic;
-			CLK_FT  : out std_logic;
-			CLK_DC  : out std_logic;
-			CLK_EX  : out std_logic;
-			CLK_WB  : out std_logic
+			CE_FT   : out std_logic;
+			CE_DC   : out std_logic;
+			CE_EX   : out std_logic;
+			CE_WB   : out std_logic
 		);
 	end component;
 
 	-- fetch_rom:
 	-- 命令ROM（PROM）をFPGAのメガファンクションで実装したもの。
 	-- address(PC) を与えると 命令語(q) が出てくる。
-	-- ここでは clock に CLK_FT を与えることで「Fetch段のタイミングで読む」構造にしている。
+	-- ここでは clock に CLK、clken に CE_FT を与えることで「Fetch段のタイミングで読む」構造にしている。
+	-- ※メガファンクションは「clken（クロックイネーブル）」ポートを付けて作り直すこと。
+	-- ※命令語を16bit（5bitオペコード）に広げたので、メガファンクションも q を16bit幅で
+	--   作り直すこと（従来の .mif の内容は MSB に 0 を足すだけでそのまま使える）。
+	-- ※シミュレーションでは、同じポートの fetch_rom_sim.vhd（chapter06 の fetch.vhd を包んだもの）を
+	--   代わりに解析する。中身は fetch_rom.hex（CPU_emulator -o で書き出したイメージ）から読む。
 	component fetch_rom
 		port(
 			address : in  std_logic_vector(7 downto 0);      -- PC（8bit）で命令アドレス指定
-			clock   : in  std_logic;                         -- ROM読み出しのクロック（ここではCLK_FT）
-			q       : out std_logic_vector(14 downto 0)      -- 命令語（15bit）※このCPUの命令幅
+			clock   : in  std_logic;                         -- ROM読み出しのクロック（CLK）
+			clken   : in  std_logic;                         -- 読み出しのイネーブル（ここではCE_FT）
+			q       : out std_logic_vector(15 downto 0)      -- 命令語（16bit）※このCPUの命令幅
 		);
 	end component;
 
 	-- decode:
-	-- 命令語(15bit)から、実行部が使う OP_CODE(4bit) と 即値/アドレス OP_DATA(8bit) を切り出す。
+	-- 命令語(16bit)から、実行部が使う OP_CODE(5bit)・条件コード OP_CC(3bit)・即値/アドレス OP_DATA(8bit) を切り出す。
 	-- 自作CPU観点では「命令フォーマットの仕様」をそのまま回路化している部分。
 	component decode
 		port(
-			CLK_DC   : in  std_logic;                        -- Decode段クロック
-			PROM_OUT : in  std_logic_vector(14 downto 0);     -- Fetchで得た命令語
-			OP_CODE  : out std_logic_vector(3 downto 0);      -- 命令の種類
+			CLK      : in  std_logic;                        -- 基準クロック
+			CE_DC    : in  std_logic;                        -- Decode段イネーブル
+			PROM_OUT : in  std_logic_vector(15 downto 0);     -- Fetchで得た命令語
+			OP_CODE  : out std_logic_vector(4 downto 0);      -- 命令の種類
+			OP_CC    : out std_logic_vector(2 downto 0);      -- 条件コード（JCC 用）
 			OP_DATA  : out std_logic_vector(7 downto 0)       -- 即値/アドレス等（下位8bit）
 		);
 	end component;
 
-	-- reg_dc:
-	-- レジスタファイル（REG_0..REG_7）から、指定番号のレジスタ値を取り出す“読み出し多重化器”。
-	-- 命令語にはレジスタ番号が2つ含まれるので、同じreg_dcを2個使い REG_A/REG_B を得る。
-	component reg_dc
+	-- reg_file:
+	-- レジスタを配列に持つレジスタファイル（合成では分散RAMになる）。
+	-- 読み出しA/B（CE_DC のエッジでラッチ）で REG_A/REG_B を得て、書き込み1ポート（CE_WB のエッジ）で書き戻す。
+	-- 読み出しC は非同期で、間接アドレス（IND_ADDR）とブロック転送の語数（BLK_N）に使う。
+	component reg_file
+		generic(
+			N_BITS     : integer                                  -- レジスタ番号のビット数（2**N_BITS 本）
+		);
 		port(
-			CLK_DC   : in  std_logic;
-			N_REG_IN : in  std_logic_vector(2 downto 0);      -- どのレジスタを読むか（3bitで0..7）
-			REG_0    : in  std_logic_vector(15 downto 0);
-			REG_1    : in  std_logic_vector(15 downto 0);
-			REG_2    : in  std_logic_vector(15 downto 0);
-			REG_3    : in  std_logic_vector(15 downto 0);
-			REG_4    : in  std_logic_vector(15 downto 0);
-			REG_5    : in  std_logic_vector(15 downto 0);
-			REG_6    : in  std_logic_vector(15 downto 0);
-			REG_7    : in  std_logic_vector(15 downto 0);
-			N_REG_OUT: out std_logic_vector(2 downto 0);      -- 入力番号を次段へ“通す”（段間でレジスタ番号を保持）
-			REG_OUT  : out std_logic_vector(15 downto 0)      -- 読み出したレジスタ値
+			CLK        : in  std_logic;
+			CE_DC      : in  std_logic;
+			CE_WB      : in  std_logic;
+			RESET_N    : in  std_logic;
+			N_REG_A_IN : in  std_logic_vector(N_BITS - 1 downto 0);  -- 読むレジスタ番号（A側）
+			N_REG_B_IN : in  std_logic_vector(N_BITS - 1 downto 0);  -- 読むレジスタ番号（B側）
+			N_REG_A    : out std_logic_vector(N_BITS - 1 downto 0);  -- 番号を次段へ“通す”（段間でレジスタ番号を保持）
+			N_REG_B    : out std_logic_vector(N_BITS - 1 downto 0);
+			REG_A      : out std_logic_vector(15 downto 0);          -- 読み出したレジスタ値
+			REG_B      : out std_logic_vector(15 downto 0);
+			N_REG_C    : in  std_logic_vector(N_BITS - 1 downto 0);  -- 非同期読み出しの番号
+			REG_C      : out std_logic_vector(15 downto 0);
+			N_REG_W    : in  std_logic_vector(N_BITS - 1 downto 0);  -- 書き込み先
+			REG_IN     : in  std_logic_vector(15 downto 0);
+			REG_WEN    : in  std_logic
 		);
 	end component;
 
@@ -114,9 +131,11 @@ architecture RTL of cpu15_rom_ram is
 	-- を生成する。
 	component exec
 		port(
-			CLK_EX   : in  std_logic;
+			CLK      : in  std_logic;
+			CE_EX    : in  std_logic;
 			RESET_N  : in  std_logic;
-			OP_CODE  : in  std_logic_vector(3 downto 0);
+			OP_CODE  : in  std_logic_vector(4 downto 0);
+			OP_CC    : in  std_logic_vector(2 downto 0);
 			REG_A    : in  std_logic_vector(15 downto 0);
 			REG_B    : in  std_logic_vector(15 downto 0);
 			OP_DATA  : in  std_logic_vector(7 downto 0);
@@ -125,39 +144,34 @@ architecture RTL of cpu15_rom_ram is
 			REG_IN   : out std_logic_vector(15 downto 0);      -- 書き戻す値
 			RAM_IN   : out std_logic_vector(15 downto 0);      -- Storeする値
 			REG_WEN  : out std_logic;                          -- レジスタ書込Enable
-			RAM_WEN  : out std_logic                           -- RAM/IO書込Enable
-		);
-	end component;
-
-	-- reg_wb:
-	-- WriteBack段でレジスタファイルを更新する。
-	-- execが生成した REG_IN を、レジスタ番号 N_REG に従って REG_0..REG_7 のどれかへ書く。
-	component reg_wb
-		port(
-			CLK_WB : in  std_logic;
-			RESET_N: in  std_logic;
-			N_REG  : in  std_logic_vector(2 downto 0);
-			REG_IN : in  std_logic_vector(15 downto 0);
-			REG_WEN: in  std_logic;
-			REG_0  : out std_logic_vector(15 downto 0);
-			REG_1  : out std_logic_vector(15 downto 0);
-			REG_2  : out std_logic_vector(15 downto 0);
-			REG_3  : out std_logic_vector(15 downto 0);
-			REG_4  : out std_logic_vector(15 downto 0);
-			REG_5  : out std_logic_vector(15 downto 0);
-			REG_6  : out std_logic_vector(15 downto 0);
-			REG_7  : out std_logic_vector(15 downto 0)
+			RAM_WEN  : out std_logic;                          -- RAM/IO書込Enable
+			SP_OUT   : out std_logic_vector(7 downto 0);       -- スタックポインタ（スタック命令のRAMアドレス）
+			REG_IN_B : out std_logic_vector(15 downto 0);      -- ポストインクリメント値（REG_B+1）
+			REG_WEN_B: out std_logic;                          -- その書込Enable
+			BLK_REQ  : out std_logic;                          -- ブロック転送（MCPY/MSET）の要求
+			BLK_BUSY : in  std_logic                           -- ブロック転送中（ram_dc_wb から）
 		);
 	end component;
 
 	-- ram_dc_wb:
-	-- Dataメモリ＋MMIOを「DC段読み出し」「WB段書き込み」で統合したRAMブロック。
+	-- Dataメモリ（data_ram：256語・2ポート）＋MMIOを「DC段読み出し」「WB段書き込み」で統合したRAMブロック。
 	-- ここを経由することで、Load/Store命令だけで外部入出力（IO64/IO65）が実現できる。
 	component ram_dc_wb
 		port(
-			CLK_DC   : in  std_logic;
-			CLK_WB   : in  std_logic;
+			CLK      : in  std_logic;                         -- 読み書きとブロック転送は基準クロックで行う
+			CE_DC    : in  std_logic;                         -- CE_DC='1' の CLK 立ち上がり = DC
+			CE_WB    : in  std_logic;                         -- CE_WB='1' の CLK 立ち上がり = WB
 			RAM_ADDR : in  std_logic_vector(7 downto 0);      -- アドレス（命令の下位8bitをそのまま使う設計）
+			SP_IN    : in  std_logic_vector(7 downto 0);      -- スタック命令のときはこちらをアドレスに使う
+			STACK_OP : in  std_logic;                         -- CALL/RET/PUSH/POP のとき '1'
+			IND_IN   : in  std_logic_vector(7 downto 0);      -- LDR/STR のときはこちらをアドレスに使う
+			IND_OP   : in  std_logic;                         -- LDR/STR/SWAP のとき '1'
+			BLK_REQ  : in  std_logic;                         -- ブロック転送の開始要求（exec）
+			BLK_FILL : in  std_logic;                         -- '1' なら MSET
+			BLK_DST  : in  std_logic_vector(7 downto 0);      -- 転送先
+			BLK_SRC  : in  std_logic_vector(15 downto 0);     -- 転送元 / 埋める値
+			BLK_N    : in  std_logic_vector(7 downto 0);      -- 語数
+			BLK_BUSY : out std_logic;                         -- 転送中
 			RAM_IN   : in  std_logic_vector(15 downto 0);     -- Storeデータ
 			IO65_IN  : in  std_logic_vector(15 downto 0);     -- MMIO入力（addr=65）
 			RAM_WEN  : in  std_logic;                         -- Store有効
@@ -169,15 +183,16 @@ architecture RTL of cpu15_rom_ram is
 	-- =========================================================================
 	-- 内部信号（段間配線）
 	-- =========================================================================
-	signal CLK_FT       : std_logic;
-	signal CLK_DC       : std_logic;
-	signal CLK_EX       : std_logic;
-	signal CLK_WB       : std_logic;
+	signal CE_FT        : std_logic;                        -- 段イネーブル（clk_gen → 各段）
+	signal CE_DC        : std_logic;
+	signal CE_EX        : std_logic;
+	signal CE_WB        : std_logic;
 
 	signal P_COUNT      : std_logic_vector(7 downto 0);     -- Program Counter（8bit）
-	signal PROM_OUT     : std_logic_vector(14 downto 0);    -- 命令語（Fetch→Decode）
+	signal PROM_OUT     : std_logic_vector(15 downto 0);    -- 命令語（Fetch→Decode）
 
-	signal OP_CODE      : std_logic_vector(3 downto 0);     -- 命令種別（Decode→Exec）
+	signal OP_CODE      : std_logic_vector(4 downto 0);     -- 命令種別（Decode→Exec）
+	signal OP_CC        : std_logic_vector(2 downto 0);     -- 条件コード（Decode→Exec、JCC 用）
 	signal OP_DATA      : std_logic_vector(7 downto 0);     -- 即値/アドレス（Decode→Exec）
 
 	signal N_REG_A      : std_logic_vector(2 downto 0);     -- 命令で指定されたA側レジスタ番号
@@ -187,16 +202,17 @@ architecture RTL of cpu15_rom_ram is
 	signal REG_A        : std_logic_vector(15 downto 0);    -- DCで読んだオペランドA
 	signal REG_B        : std_logic_vector(15 downto 0);    -- DCで読んだオペランドB
 	signal REG_WEN      : std_logic;                        -- レジスタ書込Enable
+	signal REG_IN_B     : std_logic_vector(15 downto 0);    -- LDR/STR のポストインクリメント値（REG_B+1）
+	signal REG_WEN_B    : std_logic;                        -- その書込Enable（宛先は N_REG_B）
+
+	-- レジスタファイルの書き込みポート（ポストインクリメントのときだけ B 側を選ぶ）
+	signal N_REG_W      : std_logic_vector(2 downto 0);
+	signal REG_W        : std_logic_vector(15 downto 0);
+	signal REG_WE       : std_logic;
 
-	-- レジスタファイル実体（reg_wbが保持する）
-	signal REG_0        : std_logic_vector(15 downto 0);
-	signal REG_1        : std_logic_vector(15 downto 0);
-	signal REG_2        : std_logic_vector(15 downto 0);
-	signal REG_3        : std_logic_vector(15 downto 0);
-	signal REG_4        : std_logic_vector(15 downto 0);
-	signal REG_5        : std_logic_vector(15 downto 0);
-	signal REG_6        : std_logic_vector(15 downto 0);
-	signal REG_7        : std_logic_vector(15 downto 0);
+	-- レジスタファイルの非同期読み出し（間接アドレス / ブロック転送の語数）
+	signal N_REG_C      : std_logic_vector(2 downto 0);
+	signal REG_C        : std_logic_vector(15 downto 0);
 
 	-- Data RAM/IO系（exec ↔ ram_dc_wb）
 	signal RAM_IN       : std_logic_vector(15 downto 0);    -- Storeデータ
@@ -204,21 +220,30 @@ architecture RTL of cpu15_rom_ram is
 	signal RAM_WEN      : std_logic;                        -- Store有効
 	signal IO64_OUT_TMP : std_logic_vector(15 downto 0);    -- MMIO出力の“生”値（あとで表示用に加工する）
 
+	signal SP           : std_logic_vector(7 downto 0);     -- スタックポインタ（Exec→RAM）
+	signal STACK_OP     : std_logic;                        -- 実行中の命令が CALL/RET/PUSH/POP か
+	signal IND_ADDR     : std_logic_vector(7 downto 0);     -- レジスタ間接アドレス（PROM_OUT(7..5) 番レジスタの下位8bit）
+	signal IND_OP       : std_logic;                        -- 実行中の命令が LDR/STR か
+	signal BLK_REQ      : std_logic;                        -- ブロック転送の要求（Exec→RAM）
+	signal BLK_BUSY     : std_logic;                        -- ブロック転送中（RAM→Exec）
+	signal BLK_N        : std_logic_vector(7 downto 0);     -- 語数（PROM_OUT(4..2) 番レジスタの下位8bit）
+
 begin
 
 	-- =========================================================================
-	-- (1) 段クロック生成：外部CLK → FT/DC/EX/WB の順に1パルス
+	-- (1) 段イネーブル生成：外部CLK → FT/DC/EX/WB の順に1エッジずつ
 	-- =========================================================================
-	-- 自作CPUの教材でよくやる「マルチフェーズクロック（4相）」方式。
-	-- 同一のCLKをそのまま全ブロックに配るのではなく、段を時間的に分離して
+	-- 自作CPUの教材でよくやる「4相」方式を、クロックイネーブルで実現している。
+	-- 同一のCLKを全ブロックに配り、段ごとのイネーブルで段を時間的に分離して
 	-- “どの段で何が確定するか” を波形で追いやすくしている。
+	-- 論理で作ったクロックを配らないので、クロックドメインは CLK の1つだけになる。
 	C1 : clk_gen
 		port map(
-			CLK    => CLK,
-			CLK_FT => CLK_FT,
-			CLK_DC => CLK_DC,
-			CLK_EX => CLK_EX,
-			CLK_WB => CLK_WB
+			CLK   => CLK,
+			CE_FT => CE_FT,
+			CE_DC => CE_DC,
+			CE_EX => CE_EX,
+			CE_WB => CE_WB
 		);
 
 	-- =========================================================================
@@ -226,24 +251,27 @@ begin
 	-- =========================================================================
 	-- address=PC(P_COUNT) を与えて、命令語 q(PROM_OUT) を取得する。
 	-- fetch_rom は FPGAのROM megafunction なので、一般的に同期読み出しになる。
-	-- ここでは CLK_FT で駆動して「Fetch段の立上りで命令語が更新される」形。
+	-- ここでは CE_FT='1' の CLK の立上りで「Fetch段で命令語が更新される」形。
 	C2 : fetch_rom
 		port map(
 			address => P_COUNT,
-			clock   => CLK_FT,
+			clock   => CLK,
+			clken   => CE_FT,
 			q       => PROM_OUT
 		);
 
 	-- =========================================================================
 	-- (3) Decode段：命令語から OP_CODE / OP_DATA を抽出
 	-- =========================================================================
-	-- PROM_OUT(14..11) = OP_CODE、PROM_OUT(7..0) = OP_DATA という命令フォーマットに依存。
+	-- PROM_OUT(15..11) = OP_CODE、PROM_OUT(10..8) = OP_CC、PROM_OUT(7..0) = OP_DATA という命令フォーマットに依存。
 	-- 自作CPUでは「命令セットの仕様（ビット割り当て）」がここで固定される。
 	C3 : decode
 		port map(
-			CLK_DC   => CLK_DC,
+			CLK      => CLK,
+			CE_DC    => CE_DC,
 			PROM_OUT => PROM_OUT,
 			OP_CODE  => OP_CODE,
+			OP_CC    => OP_CC,
 			OP_DATA  => OP_DATA
 		);
 
@@ -254,43 +282,30 @@ begin
 	--   - PROM_OUT(10..8) : レジスタA番号
 	--   - PROM_OUT(7..5)  : レジスタB番号
 	--
-	-- reg_dc は「指定番号に応じてREG_0..REG_7のどれかを出す」多重化器。
-	-- 同じモジュールを2つ並べることで、2オペランドを同時に読む構成にしている。
-
-	-- reg_dc(1): A側オペランドの読み出し
-	-- ※N_REG_OUT は次段へ番号を渡すための段間保持。ここでは exec→reg_wb へ
-	--   “書き戻し先レジスタ番号”として使われる（設計としてAフィールドが宛先）。
-	C4 : reg_dc
+	-- reg_file はレジスタを配列で持ち、番号で添字して読む（8:1 MUX を並べない）。
+	-- 読み出しポートを2つ持つので、2オペランドを同時に読める。
+	-- ※N_REG_A は次段へ番号を渡すための段間保持。書き戻し先レジスタ番号として使われる
+	--   （設計としてAフィールドが宛先）。
+	C4 : reg_file
+		generic map(
+			N_BITS     => 3
+		)
 		port map(
-			CLK_DC   => CLK_DC,
-			N_REG_IN => PROM_OUT(10 downto 8),
-			REG_0    => REG_0,
-			REG_1    => REG_1,
-			REG_2    => REG_2,
-			REG_3    => REG_3,
-			REG_4    => REG_4,
-			REG_5    => REG_5,
-			REG_6    => REG_6,
-			REG_7    => REG_7,
-			N_REG_OUT=> N_REG_A,
-			REG_OUT  => REG_A
-		);
-
-	-- reg_dc(2): B側オペランドの読み出し
-	C5 : reg_dc
-		port map(
-			CLK_DC   => CLK_DC,
-			N_REG_IN => PROM_OUT(7 downto 5),
-			REG_0    => REG_0,
-			REG_1    => REG_1,
-			REG_2    => REG_2,
-			REG_3    => REG_3,
-			REG_4    => REG_4,
-			REG_5    => REG_5,
-			REG_6    => REG_6,
-			REG_7    => REG_7,
-			N_REG_OUT=> N_REG_B,
-			REG_OUT  => REG_B
+			CLK        => CLK,
+			CE_DC      => CE_DC,
+			CE_WB      => CE_WB,
+			RESET_N    => RESET_N,
+			N_REG_A_IN => PROM_OUT(10 downto 8),
+			N_REG_B_IN => PROM_OUT(7 downto 5),
+			N_REG_A    => N_REG_A,
+			N_REG_B    => N_REG_B,
+			REG_A      => REG_A,
+			REG_B      => REG_B,
+			N_REG_C    => N_REG_C,
+			REG_C      => REG_C,
+			N_REG_W    => N_REG_W,
+			REG_IN     => REG_W,
+			REG_WEN    => REG_WE
 		);
 
 	-- =========================================================================
@@ -307,9 +322,11 @@ begin
 	--   - RAM_IN/RAM_WEN（Store）
 	C6 : exec
 		port map(
-			CLK_EX   => CLK_EX,
+			CLK      => CLK,
+			CE_EX    => CE_EX,
 			RESET_N  => RESET_N,
 			OP_CODE  => OP_CODE,
+			OP_CC    => OP_CC,
 			REG_A    => REG_A,
 			REG_B    => REG_B,
 			OP_DATA  => OP_DATA,
@@ -318,30 +335,24 @@ begin
 			REG_IN   => REG_IN,
 			RAM_IN   => RAM_IN,
 			REG_WEN  => REG_WEN,
-			RAM_WEN  => RAM_WEN
+			RAM_WEN  => RAM_WEN,
+			SP_OUT   => SP,
+			REG_IN_B => REG_IN_B,
+			REG_WEN_B=> REG_WEN_B,
+			BLK_REQ  => BLK_REQ,
+			BLK_BUSY => BLK_BUSY
 		);
 
 	-- =========================================================================
 	-- (6) WriteBack段：レジスタファイル更新（副作用の確定の一部）
 	-- =========================================================================
-	-- REG_WEN=1 のときだけ、REG_IN を N_REG_A で指定されたレジスタに書く。
+	-- REG_WEN=1 のときは REG_IN を N_REG_A で指定されたレジスタに書く。
+	-- LDR/STR のポストインクリメント（REG_WEN_B=1）のときは REG_IN_B を N_REG_B に書く。
+	-- exec は2つを同時に立てないので、reg_file の書き込みポート1本で足りる。
 	-- ここが「CPU内部状態（レジスタ）の確定点」。
-	C7 : reg_wb
-		port map(
-			CLK_WB  => CLK_WB,
-			RESET_N => RESET_N,
-			N_REG   => N_REG_A,
-			REG_IN  => REG_IN,
-			REG_WEN => REG_WEN,
-			REG_0   => REG_0,
-			REG_1   => REG_1,
-			REG_2   => REG_2,
-			REG_3   => REG_3,
-			REG_4   => REG_4,
-			REG_5   => REG_5,
-			REG_6   => REG_6,
-			REG_7   => REG_7
-		);
+	N_REG_W <= N_REG_B  when REG_WEN_B = '1' else N_REG_A;
+	REG_W   <= REG_IN_B when REG_WEN_B = '1' else REG_IN;
+	REG_WE  <= REG_WEN or REG_WEN_B;
 
 	-- =========================================================================
 	-- (7) Data RAM + MMIO：DCで読み、WBで書く（副作用の確定のもう一部）
@@ -355,11 +366,40 @@ begin
 	-- IO65_IN and "0000001111111111" は入力をマスクしている。
 	--   - 上位ビットを0化して扱う（ボードのスイッチ等で使うビット範囲を制限）
 	--   - 自作CPUの“外部仕様（どのビットが意味を持つか）”をここで規定している
+	--
+	-- スタック命令（CALL/RET/PUSH/POP = "10010"〜"10101"）のときは SP をアドレスにする。
+	-- PROM_OUT は FT で取り込んだあと次の FT まで変わらないので、DC でも WB でも同じ判定になる。
+	STACK_OP <= '1' when PROM_OUT(15 downto 11) = OP_CALL or PROM_OUT(15 downto 11) = OP_RET or
+	                     PROM_OUT(15 downto 11) = OP_PUSH or PROM_OUT(15 downto 11) = OP_POP else '0';
+
+	-- LDR/STR（"10110"/"10111"）と SWAP（"11110"）は B 側レジスタの値をアドレスにする。
+	-- reg_file が REG_B を取り込むのと RAM を読むのは同じ DC のエッジなので、
+	-- 同期読み出しの REG_B ではなく、非同期の読み出しC（REG_C）で選ぶ。
+	-- MCPY/MSET の語数は3つ目のレジスタ番号 PROM_OUT(4 downto 2) で指定する。
+	-- LDR/STR とブロック転送が同時に来ることはないので、読み出しC の番号を命令で切り替えて共用する。
+	IND_OP   <= '1' when PROM_OUT(15 downto 11) = OP_LDR or PROM_OUT(15 downto 11) = OP_STR or
+	                     PROM_OUT(15 downto 11) = OP_SWAP else '0';
+	N_REG_C  <= PROM_OUT(4 downto 2) when PROM_OUT(15 downto 11) = OP_MCPY or PROM_OUT(15 downto 11) = OP_MSET else
+	            PROM_OUT(7 downto 5);
+	IND_ADDR <= REG_C(7 downto 0);
+	BLK_N    <= REG_C(7 downto 0);
+
 	C8 : ram_dc_wb
 		port map(
-			CLK_DC   => CLK_DC,
-			CLK_WB   => CLK_WB,
+			CLK      => CLK,
+			CE_DC    => CE_DC,
+			CE_WB    => CE_WB,
 			RAM_ADDR => PROM_OUT(7 downto 0),
+			SP_IN    => SP,
+			STACK_OP => STACK_OP,
+			IND_IN   => IND_ADDR,
+			IND_OP   => IND_OP,
+			BLK_REQ  => BLK_REQ,
+			BLK_FILL => PROM_OUT(11),                   -- MCPY "11100" / MSET "11101"
+			BLK_DST  => REG_A(7 downto 0),
+			BLK_SRC  => REG_B,
+			BLK_N    => BLK_N,
+			BLK_BUSY => BLK_BUSY,
 			RAM_IN   => RAM_IN,
 			IO65_IN  => IO65_IN and "0000001111111111",
 			RAM_WEN  => RAM_WEN,
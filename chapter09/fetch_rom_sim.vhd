@@ -0,0 +1,68 @@
+-- fetch_rom_sim.vhd
+-- =============================================================================
+-- 【このモジュールの位置づけ】
+-- cpu15_rom_ram.vhd の fetch_rom（Quartus のROMメガファンクション）の代わりに、
+-- シミュレーション（と vhdl2c での C モデル化）で使う命令ROM。
+-- メガファンクションの .vhd はベンダのライブラリが無いと解析できないので、
+-- 同じポート（address / clock / clken / q）を持つ entity をここで用意する。
+--
+-- 中身は chapter06 の fetch.vhd（256語、ROM_FILE から初期化）をそのまま使う。
+--   - ROM_FILE の既定は "fetch_rom.hex"（シミュレータの作業ディレクトリから読む）
+--   - 作り方：chapter03 のエミュレータで ROM イメージを書き出す
+--         CPU_emulator -p blk -o fetch_rom.hex
+--   - .mif と同じく「clken='1' のクロックの立ち上がりで address の語を q に出す」1サイクルROMなので、
+--     タイミングはメガファンクション版と変わらない。
+--
+-- 【使い方】
+-- - 解析順：chapter06 の cpu15_isa.vhd → fetch.vhd → 本ファイル → cpu15_rom_ram.vhd。
+--   実機（Quartus）では本ファイルを入れず、メガファンクションの fetch_rom を使う。
+-- - 別のファイル名を使うときは、シミュレータの generic 上書き（-gROM_FILE=...）か、
+--   本ファイルの既定値を書き換える。
+-- =============================================================================
+
+library IEEE;
+use IEEE.std_logic_1164.all;
+
+entity fetch_rom is
+	generic(
+		ROM_FILE : string := "fetch_rom.hex"                -- ROM の初期化ファイル（fetch.vhd の形式）
+	);
+	port(
+		address : in  std_logic_vector(7 downto 0);      -- PC（8bit）で命令アドレス指定
+		clock   : in  std_logic;                         -- ROM読み出しのクロック
+		clken   : in  std_logic;                         -- 読み出しのイネーブル（fetch の CE_FT）
+		q       : out std_logic_vector(15 downto 0)      -- 命令語（16bit）
+	);
+end fetch_rom;
+
+architecture SIM of fetch_rom is
+
+	component fetch
+		generic(
+			A_BITS   : integer;
+			ROM_FILE : string
+		);
+		port(
+			CLK      : in  std_logic;
+			CE_FT    : in  std_logic;
+			P_COUNT  : in  std_logic_vector(7 downto 0);
+			PROM_OUT : out std_logic_vector(15 downto 0)
+		);
+	end component;
+
+begin
+
+	-- 8bit アドレス全体（256語）を ROM_FILE から初期化する
+	F0 : fetch
+		generic map(
+			A_BITS   => 8,
+			ROM_FILE => ROM_FILE
+		)
+		port map(
+			CLK      => clock,
+			CE_FT    => clken,
+			P_COUNT  => address,
+			PROM_OUT => q
+		);
+
+end SIM;
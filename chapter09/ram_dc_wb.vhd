@@ -1,33 +1,64 @@
 -- ram_dc_wb.vhd（詳細コメント版）
 --
 -- 【このモジュールの役割（CPU設計観点）】
--- - これは「RAMの読み出し（Decode側/DC）と書き込み（WriteBack側/WB）を1つにまとめた」周辺回路である。
+-- - これは「RAMの読み出し（Decode側/DC）と書き込み（WriteBack側/WB）」と
+--   ブロック転送（MCPY/MSET）をまとめたデータメモリの制御回路である。
 -- - CPUの典型的なデータメモリアクセスは、
 --     - Load命令：メモリ → レジスタ（読み出し）
 --     - Store命令：レジスタ → メモリ（書き込み）
 --   という2種類に分かれる。
 --
--- - この設計では、読み出しは DC クロック（CLK_DC）で行い、
---   書き込みは WB クロック（CLK_WB）で行う。
---   つまり “擬似的な多段パイプライン” のように段ごとのクロックを分けて、
---   読みと書きを衝突しにくくしている。
+-- - メモリ本体は chapter06 の data_ram（256語、真の2ポート、ブロックRAM 推論）で、
+--   このモジュールは番地の選択とブロック転送の順序制御だけを持つ。
+--   以前は 64語の配列 RAM_ARRAY をこの中に持ち、DC の段クロックで非同期に近い形で読んでいたが、
+--   data_ram は出力レジスタ付き（1サイクルレイテンシ）なので、
+--   読み出しは DC のタイミング（CE_DC='1' のベースクロック CLK の立ち上がり）で番地を渡し、
+--   EX で RAM_OUT を受け取る形になる。
+-- - 書き込みは WB のタイミング（CE_WB='1' のベースクロック CLK の立ち上がり）で行う。
 --
 -- 【メモリマップ（ここがCPU作りで超重要）】
--- - アドレス空間のうち、次のようなルールが埋め込まれている：
+-- - アドレス空間のうち、次のようなルールが埋め込まれている（data_ram が処理する）：
 --
---   0〜63 : 内部RAM（RAM_ARRAY）にアクセス
---   64    : 出力I/O（IO64_OUT）に書き込むと外部へ出力（メモリマップドI/O）
---   65    : 入力I/O（IO65_IN）を読むと外部入力を取得（メモリマップドI/O）
+--   0〜63, 66〜255 : 内部RAM
+--   64             : 出力I/O（IO64_OUT）に書き込むと外部へ出力（メモリマップドI/O）。読むと最後に書いた値
+--   65             : 入力I/O（IO65_IN）を読むと外部入力を取得（メモリマップドI/O）
 --
 -- - これは「メモリとI/Oを同じ“アドレス”で扱う」メモリマップドI/Oの最小例である。
 --   自作CPUにおいては、ロード/ストア命令でI/Oできるようになるので便利。
 --
--- 【注意：このモジュールは2クロックドメイン】
--- - CLK_DC と CLK_WB の2つのクロックで同じアドレス（ADDR_INT）を参照している。
--- - ここでの前提は「CLK_GEN が段クロックを順番に1周期ずつ立てる」ような構造で、
---   DC段とWB段が同時に立たず、かつアドレスが安定している、ということ。
--- - もしクロックが非同期だったり重なったりすると、CDC（Clock Domain Crossing）問題が発生する。
---   その場合は、アドレスやデータを各段でラッチする（パイプラインレジスタ化する）などが必要になる。
+-- 【スタック命令のアドレス】
+-- - CALL/RET/PUSH/POP のとき（STACK_OP='1'）は、命令の下位8bit（RAM_ADDR）ではなく
+--   exec の SP（SP_IN）をアドレスに使う。スタックは 63 番地から下へ伸びる。
+-- - SP は EX 段で更新されるが、DC（読み）は更新前、WB（書き）は更新後の SP を見ることになり、
+--   それがちょうど POP/RET の読み出し番地、PUSH/CALL の書き込み番地になる（exec.vhd 参照）。
+-- - LDR/STR/SWAP（IND_OP='1'）は、レジスタ B の下位8bit（IND_IN）をアドレスに使う。
+--   SWAP は同じ番地を DC で読み WB で書く（1コアなので間に他のアクセスは入らない）。
+--   ポストインクリメントは WB で書き戻されるので、同じ WB で書く STR も更新前の番地を見る。
+--
+-- 【ポートの割り当て】
+-- - data_ram のポートA：CPU の読み出し（DC）と書き込み（WB）、ブロック転送の書き込み
+-- - data_ram のポートB：ブロック転送の読み出し
+--
+-- 【ブロック転送（MCPY/MSET）】
+-- - exec が BLK_REQ='1' を出した命令の WB で、転送先 BLK_DST・転送元/値 BLK_SRC・語数 BLK_N を取り込み、
+--   以後はベースクロック CLK の1周期ごとに1語ずつ動かす（BLK_FILL='1' なら BLK_SRC の値で埋める）。
+-- - 読み出しに1サイクルかかるので、2段の流れ作業にする。
+--     読み段（BUSY='1'）  : ポートBに SRC を出す（次の CLK で DOUT_B に出る）
+--     書き段（W_V='1'）   : 1つ前の CLK で読んだ語をポートAで W_DST に書く
+--   2つの段は重なって動くので、n 語は n+1 周期で終わる。転送中は BLK_BUSY='1'。
+--   exec はその間 PC を進めずに待つ。
+-- - 番地は 8bit で 255 の次は 0 に戻る。64/65 番地は通常の読み書きと同じく I/O として扱う
+--   （エミュレータ chapter03 の cpu15_block() と同じ）。
+-- - 1語ずつ前から順に動かすので、重なった領域を後ろへずらすコピーは
+--   LD/ST のループと同じ結果（先頭の語が繰り返される）になる。
+--   そのためには「いま書いている番地」を同じ CLK で読んだとき、書く前の値（data_ram は read-first）
+--   ではなく書いた値が要る。この場合は書いた値をラッチしておき（FWD/FWD_VAL）、次の書き段で使う。
+--
+-- 【クロック】
+-- - data_ram を含めて、すべてベースクロック CLK の1クロックドメインで動く。
+--   段のタイミングは clk_gen の段イネーブル（CE_DC / CE_WB）で「その CLK の立ち上がりがどの段か」を選ぶ。
+--   CPU の他の段（decode / reg_file / exec）と同じイネーブルなので、
+--   Load/Store のタイミングは段クロックを配っていたころと変わらない。
 
 library IEEE;
 use IEEE.std_logic_1164.all;
@@ -35,18 +66,37 @@ use IEEE.std_logic_unsigned.all;
 
 entity ram_dc_wb is
     port (
-        -- DC段（Decode/Memory Read段）のクロック
+        -- ベースクロック（読み出し・書き込み・ブロック転送はすべてこのクロックで行う）
+        CLK      : in std_logic;
+
+        -- Decode段のイネーブル。CE_DC='1' の CLK 立ち上がりが DC（読み出し）のタイミングになる
         -- Load命令などで「メモリを読む」タイミングに対応する想定。
-        CLK_DC   : in std_logic;
+        CE_DC    : in std_logic;
 
-        -- WB段（WriteBack/Memory Write段）のクロック
+        -- WriteBack段のイネーブル。CE_WB='1' の CLK の立ち上がりが WB のタイミングになる
         -- Store命令などで「メモリへ書く」タイミングに対応する想定。
-        CLK_WB   : in std_logic;
+        CE_WB    : in std_logic;
 
         -- メモリアドレス（8bit）
-        -- 0〜255 を表現できるが、内部RAMは 0〜63 だけを実装している。
+        -- 64/65 番地（I/O）を除く 0〜255 がすべて内部RAM。
         RAM_ADDR : in std_logic_vector(7 downto 0);
 
+        -- スタックポインタ（exec の SP_OUT）と、スタック命令かどうか
+        SP_IN    : in std_logic_vector(7 downto 0);
+        STACK_OP : in std_logic;
+
+        -- レジスタ間接アドレス（REG_B の下位8bit）と、LDR/STR/SWAP かどうか
+        IND_IN   : in std_logic_vector(7 downto 0);
+        IND_OP   : in std_logic;
+
+        -- ブロック転送（MCPY/MSET）の要求と引数
+        BLK_REQ  : in std_logic;                          -- この命令の WB で転送を始める
+        BLK_FILL : in std_logic;                          -- '1' なら MSET（BLK_SRC の値で埋める）
+        BLK_DST  : in std_logic_vector(7 downto 0);       -- 転送先の先頭番地
+        BLK_SRC  : in std_logic_vector(15 downto 0);      -- 転送元の先頭番地（下位8bit）/ 埋める値
+        BLK_N    : in std_logic_vector(7 downto 0);       -- 語数（0 なら何もしない）
+        BLK_BUSY : out std_logic;                         -- 転送中
+
         -- 書き込みデータ（Store時にRAMへ入る値）
         RAM_IN   : in std_logic_vector(15 downto 0);
 
@@ -56,7 +106,7 @@ entity ram_dc_wb is
         -- 書き込み許可（Store命令のときだけ 1 になる想定）
         RAM_WEN  : in std_logic;
 
-        -- 読み出しデータ（Load時にCPUへ返す値）
+        -- 読み出しデータ（Load時にCPUへ返す値。DC の次の CLK から出る）
         RAM_OUT  : out std_logic_vector(15 downto 0);
 
         -- 出力I/O（アドレス=64に書くと外部へ出る値）
@@ -66,90 +116,134 @@ end ram_dc_wb;
 
 architecture RTL of ram_dc_wb is
 
-    -- 【内部RAMの表現】
-    -- - 16bit幅のワードを持つRAMとして扱う。
-    -- - 実体は “配列” なので、FPGA合成でブロックRAMに推論されるかはツール/記述に依存する。
-    -- - ここでは 64ワード（0..63）と小さいため、最適化でレジスタ配列として実装される場合もある。
-    subtype RAM_WORD is std_logic_vector(15 downto 0);
-    type RAM_ARRAY_TYPE is array (0 to 63) of RAM_WORD;
-
-    signal RAM_ARRAY : RAM_ARRAY_TYPE;
-
-    -- 【アドレスの整数化】
-    -- - VHDLでは配列のインデックスに integer を使うことが多いため、
-    --   std_logic_vector のアドレスを integer に変換して使う。
-    -- - 0..255 の範囲として宣言しているが、実際にRAM_ARRAYで参照するのは 0..63 だけ。
-    --
-    -- 注意：
-    -- - conv_integer は std_logic_unsigned 由来の変換関数。
-    -- - numeric_std を使う流儀では to_integer(unsigned(...)) に置き換えるのが一般的。
-    signal ADDR_INT  : integer range 0 to 255;
+    component data_ram
+        generic
+        (
+            A_BITS   : integer := 8
+        );
+        port
+        (
+            CLK      : in  std_logic;
+            EN_A     : in  std_logic;
+            ADDR_A   : in  std_logic_vector(7 downto 0);
+            DIN_A    : in  std_logic_vector(15 downto 0);
+            WE_A     : in  std_logic;
+            DOUT_A   : out std_logic_vector(15 downto 0);
+            EN_B     : in  std_logic;
+            ADDR_B   : in  std_logic_vector(7 downto 0);
+            DIN_B    : in  std_logic_vector(15 downto 0);
+            WE_B     : in  std_logic;
+            DOUT_B   : out std_logic_vector(15 downto 0);
+            IO65_IN  : in  std_logic_vector(15 downto 0);
+            IO64_OUT : out std_logic_vector(15 downto 0)
+        );
+    end component;
 
-begin
-    -- RAM_ADDR を整数へ変換
-    -- ※この代入は組合せ的に見えるので、RAM_ADDRが変わるたびに ADDR_INT も更新される。
-    ADDR_INT <= conv_integer(RAM_ADDR);
+    -- 【CPU のアクセス番地】
+    -- - RAM_ADDR（スタック命令なら SP_IN、LDR/STR なら IND_IN）。
+    signal ADDR      : std_logic_vector(7 downto 0);
 
-    -- =========================================================
-    -- 読み出し（DC段）
-    -- =========================================================
-    -- - CLK_DC の立ち上がりで RAM_OUT を更新する。
-    -- - “同期読み出し”として扱っている（クロックで出力が切り替わる）。
-    --
-    -- CPU設計観点：
-    -- - Load命令では、この RAM_OUT を exec段などで受け取り、次のWBでレジスタへ書き戻す。
-    -- - メモリマップドI/Oの読み（ADDR=65）もここで処理するため、
-    --   CPU側からは「普通のロード命令」で入力値を読める。
-    process (CLK_DC)
-    begin
-        if (CLK_DC'event and CLK_DC = '1') then
-            if (ADDR_INT < 64) then
-                -- 0..63 は内部RAM領域：RAM_ARRAYからデータを読む
-                RAM_OUT <= RAM_ARRAY(ADDR_INT);
+    -- 【data_ram のポートA（CPU とブロック転送の書き込み）】
+    signal ADDR_A    : std_logic_vector(7 downto 0);
+    signal DIN_A     : std_logic_vector(15 downto 0);
+    signal WE_A      : std_logic;
 
-            elsif (ADDR_INT = 65) then
-                -- 65 は入力I/O領域：外部入力(IO65_IN)を読む
-                -- 自作CPU的には「IN命令」等を作らずとも Load で入力が読める。
-                RAM_OUT <= IO65_IN;
+    -- 【ブロック転送の状態：読み段】
+    signal BUSY      : std_logic := '0';
+    signal FILL      : std_logic;
+    signal DST       : std_logic_vector(7 downto 0);
+    signal SRC       : std_logic_vector(7 downto 0);
+    signal CNT       : std_logic_vector(7 downto 0);
+    signal VAL       : std_logic_vector(15 downto 0);
+    signal RD_SRC    : std_logic_vector(15 downto 0);   -- ポートBの読み出し値（1つ前の CLK の SRC）
 
-            end if;
+    -- 【ブロック転送の状態：書き段】
+    signal W_V       : std_logic := '0';                -- この CLK で W_DST に書く
+    signal W_DST     : std_logic_vector(7 downto 0);
+    signal FWD       : std_logic := '0';                -- 読んだ番地をその CLK で書いていた
+    signal FWD_VAL   : std_logic_vector(15 downto 0);   -- そのとき書いた値
+    signal BLK_WORD  : std_logic_vector(15 downto 0);   -- この CLK で W_DST に書く語
 
-            -- 注意：
-            -- - 64（出力I/O）は “読む”処理が書かれていないので、
-            --   ADDR_INT=64 のとき RAM_OUT は更新されない（前の値保持になり得る）。
-            -- - “読み出し無効時はRAM_OUTを0にする”などを決めたい場合は else を追加する。
-        end if;
-    end process;
+begin
+    ADDR <= SP_IN  when STACK_OP = '1' else
+            IND_IN when IND_OP = '1' else
+            RAM_ADDR;
 
     -- =========================================================
-    -- 書き込み（WB段）
+    -- データメモリ本体（chapter06 の data_ram）
     -- =========================================================
-    -- - CLK_WB の立ち上がりで、RAM_WEN=1 のときのみ書き込みを行う。
-    -- - Store命令のコミット（確定）段としてWB段で書く設計思想。
-    --
-    -- CPU設計観点：
-    -- - “書き込みはWBで確定”にすると、命令の副作用が揃いやすい（パイプライン風の整理）。
-    -- - ADDR=64 のときは内部RAMではなく IO64_OUT へ出力する（メモリマップド出力）。
-    process (CLK_WB)
-    begin
-        if (CLK_WB'event and CLK_WB = '1') then
-            if (RAM_WEN = '1') then
+    -- - ポートA は DC で読み（EN_A=CE_DC）、WB で書く。ブロック転送の書き段もポートA を使う。
+    --   転送中は exec が PC を止めているので、CPU の Store とブロック転送の書き込みは重ならない。
+    -- - ポートB はブロック転送の読み段だけが使う。
+    ADDR_A <= W_DST    when W_V = '1' else ADDR;
+    DIN_A  <= BLK_WORD when W_V = '1' else RAM_IN;
+    WE_A   <= '1'      when W_V = '1' else CE_WB and RAM_WEN;
 
-                if (ADDR_INT < 64) then
-                    -- 0..63 は内部RAM：RAM_IN をRAMに書く
-                    -- Store命令の典型動作。
-                    RAM_ARRAY(ADDR_INT) <= RAM_IN;
+    M0 : data_ram
+        generic map(
+            A_BITS   => 8
+        )
+        port map(
+            CLK      => CLK,
+            EN_A     => CE_DC,
+            ADDR_A   => ADDR_A,
+            DIN_A    => DIN_A,
+            WE_A     => WE_A,
+            DOUT_A   => RAM_OUT,
+            EN_B     => BUSY,
+            ADDR_B   => SRC,
+            DIN_B    => "0000000000000000",
+            WE_B     => '0',
+            DOUT_B   => RD_SRC,
+            IO65_IN  => IO65_IN,
+            IO64_OUT => IO64_OUT
+        );
 
-                elsif (ADDR_INT = 64) then
-                    -- 64 は出力I/O：RAM_IN を外部出力(IO64_OUT)に反映
-                    -- たとえば7セグ表示、LED、UART送信レジスタなどの“出力レジスタ”に相当。
-                    IO64_OUT <= RAM_IN;
+    -- =========================================================
+    -- ブロック転送
+    -- =========================================================
+    -- 書く語：MSET は値そのもの、MCPY は1つ前の CLK で読んだ語（書いていた番地ならそのとき書いた値）
+    BLK_WORD <= VAL     when FILL = '1' else
+                FWD_VAL when FWD = '1' else
+                RD_SRC;
+    BLK_BUSY <= BUSY or W_V;
 
+    process (CLK)
+    begin
+        if (CLK'event and CLK = '1') then
+            if (BUSY = '1') then
+                -- 読み段：SRC を読み（ポートB）、次の CLK で DST に書くよう書き段へ渡す
+                W_V   <= '1';
+                W_DST <= DST;
+                DST   <= DST + 1;
+                SRC   <= SRC + 1;
+                CNT   <= CNT - 1;
+                if (CNT = "00000001") then
+                    BUSY <= '0';
+                end if;
+
+            elsif (CE_WB = '1' and BLK_REQ = '1') then
+                -- 転送の開始（この命令の WB）。語数 0 なら何もしない
+                FILL <= BLK_FILL;
+                DST  <= BLK_DST;
+                SRC  <= BLK_SRC(7 downto 0);
+                VAL  <= BLK_SRC;
+                CNT  <= BLK_N;
+                if (BLK_N /= "00000000") then
+                    BUSY <= '1';
                 end if;
+                W_V  <= '0';
+
+            else
+                W_V  <= '0';
+            end if;
 
-                -- 注意：
-                -- - ADDR=65（入力I/O）への書き込みは定義していない（無視）。
-                -- - “入力I/OはRead Only”として自然な設計。
+            -- いま読む番地をこの CLK で書き段が書いているなら、書いた値を次の書き段へ回す
+            if (W_V = '1' and W_DST = SRC) then
+                FWD     <= '1';
+                FWD_VAL <= BLK_WORD;
+            else
+                FWD     <= '0';
             end if;
         end if;
     end process;
@@ -161,24 +255,24 @@ end RTL;
 -- ============================================================
 --
 -- (1) アドレスの安定性
--- - ADDR_INT はRAM_ADDRから組合せ変換されており、DC/WBの両プロセスで参照される。
+-- - ADDR はRAM_ADDR/SP_IN/IND_IN から組合せで選ばれ、DC（読み）と WB（書き）の両方で data_ram に渡される。
 -- - 「DC段のアドレス」と「WB段のアドレス」が別物であるなら、
 --   本来は各段でアドレスをラッチ（例：ADDR_DC、ADDR_WB）し、段ごとに固定すべきである。
 -- - この設計が成立する前提は、
---   “段クロックが順番に立ち、アドレスがその間ずっと同じ”というマイクロシーケンスである。
+--   “段イネーブルが順番に立ち、アドレスがその間ずっと同じ”というマイクロシーケンスである。
+--   （SP だけは EX で変わるが、それが POP/RET と PUSH/CALL の番地の違いとしてちょうど使われている）
 --
--- (2) RAM_OUT の未定義（保持）問題
--- - ADDR=64 や ADDR>65 のとき RAM_OUT を更新していないため、
---   シミュレーションで意図しない保持が見える可能性がある。
--- - 動作を明確にしたいなら、
---     else RAM_OUT <= (others => '0');
---   のようにデフォルトを与える方がデバッグしやすい。
+-- (2) RAM_OUT の値
+-- - data_ram は RAM でも I/O でもない番地を持たない（256語のうち 64/65 以外はすべて RAM）ので、
+--   以前のように「読み出しで RAM_OUT が更新されず前の値が残る」ことはない。
+-- - 64 番地を読むと最後に IO64_OUT に書いた値が返る。
 --
 -- (3) std_logic_unsigned の依存
 -- - 今後の拡張で numeric_std に寄せるなら、
 --   conv_integer や + 演算の扱いを統一するのが望ましい。
 --
 -- (4) 合成時のメモリ推論
--- - RAM_ARRAY のような配列RAMは、書き方によってはブロックRAM推論に失敗し、
---   レジスタの塊として実装されることがある。
--- - 実機で容量を増やす/周波数を上げるなら、altsyncram等の明示IP化も検討対象になる。
+-- - RAM 本体は data_ram に分けてあり、I/O のデコードやブロック転送の制御は RAM の外にある。
+--   読み出しは出力レジスタ付きなので、ブロックRAM（真の2ポート）として推論される。
+-- - 合成レポートで推論に失敗してレジスタの塊になっていないか確認すること
+--   （その場合は altsyncram 等の明示IP化も検討対象になる）。